@@ -0,0 +1,1180 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkMathBench.cpp
+// Desc : Math Microbenchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkMath.h>
+#include <asvkAllocator.h>
+#include <asvkTransformHierarchy.h>
+#include <asvkAnimation.h>
+#include <asvkSpline.h>
+#include <asvkGeometry.h>
+#include <asvkBvh.h>
+#include <asvkSpatialHash.h>
+#include <asvkBroadphase.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if ASVK_IS_OPENMP
+#include <omp.h>
+#endif
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Using Statements
+//-------------------------------------------------------------------------------------------------
+using namespace asvk;
+using Clock = std::chrono::steady_clock;
+
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr size_t     BENCH_DEFAULT_COUNT     = 1024;     //!< 1パスで処理する既定の要素数です.
+static constexpr double     BENCH_DEFAULT_WARMUP    = 0.05;     //!< 既定のウォームアップ時間(秒)です.
+static constexpr double     BENCH_DEFAULT_MIN_TIME  = 0.25;     //!< 1項目あたりの既定の計測時間(秒)です.
+static constexpr int        BENCH_DEFAULT_REPEAT    = 5;        //!< 既定のサンプル数です(中央値を採用します).
+static constexpr uint32_t   BENCH_BONE_COUNT        = 64;       //!< スキニングで使うボーン数です.
+static constexpr uint32_t   BENCH_KEY_COUNT         = 32;       //!< アニメーションのトラックごとのキー数です.
+static constexpr uint32_t   BENCH_DIRTY_STRIDE      = 100;      //!< 階層構造の部分更新で変更するノードの割合の逆数です(1%).
+static constexpr uint32_t   BENCH_HIERARCHY_SIZES[] = { 1000, 10000, 100000 };  //!< 階層構造のノード数です(--count によらず固定).
+static constexpr uint32_t   BENCH_SPLINE_POINTS     = 64;       //!< スプラインの制御点数です.
+static constexpr uint32_t   BENCH_RAY_COUNT         = 256;      //!< BVHの交差判定で1パスに飛ばすレイの数です.
+static constexpr float      BENCH_RAY_DISTANCE      = 400.0f;   //!< BVHの交差判定の最大距離です.
+static constexpr uint32_t   BENCH_RAY_GRID          = 16;       //!< パケット判定に使うレイの格子の1辺の本数です.
+static constexpr uint32_t   BENCH_QUERY_COUNT       = 64;       //!< 空間インデックスの検索で1パスに行う検索の数です.
+static constexpr float      BENCH_QUERY_RADIUS      = 10.0f;    //!< 空間インデックスの範囲検索の半径です.
+static constexpr uint32_t   BENCH_NEAREST_COUNT     = 8;        //!< 空間インデックスの近傍検索で求める数です.
+static constexpr float      BENCH_CELL_SIZE         = 8.0f;     //!< 空間インデックスのセルの大きさです(球の最大直径).
+static constexpr float      BENCH_JITTER            = 0.5f;     //!< ブロードフェーズで1パスごとに物体を動かす最大の距離です.
+static constexpr uint64_t   BENCH_SEED              = 0x5eed;   //!< 入力データを生成する乱数の種です.
+
+#ifndef ASVK_BENCH_REVISION
+#define ASVK_BENCH_REVISION     "unknown"
+#endif//ASVK_BENCH_REVISION
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchOption structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BenchOption
+{
+    size_t          Count;          //!< 1パスで処理する要素数です.
+    double          Warmup;         //!< ウォームアップ時間(秒)です.
+    double          MinTime;        //!< 1項目あたりの計測時間(秒)です.
+    int             Repeat;         //!< サンプル数です.
+    const char*     Filter;         //!< 名前に含まれる文字列で項目を絞り込みます(nullptrの場合は全項目).
+    const char*     JsonPath;       //!< JSONの出力先です("-" の場合は標準出力, nullptrの場合は出力しません).
+    bool            List;           //!< 項目名の一覧だけを表示する場合は true.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    BenchOption()
+    : Count     ( BENCH_DEFAULT_COUNT )
+    , Warmup    ( BENCH_DEFAULT_WARMUP )
+    , MinTime   ( BENCH_DEFAULT_MIN_TIME )
+    , Repeat    ( BENCH_DEFAULT_REPEAT )
+    , Filter    ( nullptr )
+    , JsonPath  ( nullptr )
+    , List      ( false )
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchEntry structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BenchEntry
+{
+    std::string                 Name;       //!< 計測対象の名前です.
+    const char*                 Form;       //!< "scalar" または "batch" です.
+    std::function<size_t()>     Pass;       //!< 1パス分の処理を行い，処理した要素数を返す関数です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchResult structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BenchResult
+{
+    const BenchEntry*   Entry;          //!< 計測した項目です.
+    double              NsPerOp;        //!< 1要素あたりの時間(ナノ秒, サンプルの中央値)です.
+    double              MinNsPerOp;     //!< 1要素あたりの時間(ナノ秒, サンプルの最小値)です.
+    double              OpsPerSec;      //!< 1秒あたりの処理要素数です(中央値から算出).
+    uint64_t            Ops;            //!< 計測中に処理した総要素数です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BenchData structure
+// 全項目で共有する入力と出力の配列です. 乱数の種を固定しているため毎回同じ入力になります.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BenchData
+{
+    std::vector<float>              Floats;
+    std::vector<float>              Params;
+    std::vector<float>              Distances;
+    std::vector<half>               Halves;
+    std::vector<uint32_t>           Packed;
+    std::vector<uint32_t>           U32s;
+    std::vector<Vector3>            Vec3s;
+    std::vector<Vector3>            Normals;
+    std::vector<Vector3>            OutVec3s;
+    std::vector<Vector3>            OutNormals;
+    AlignedVector<Vector4>          Vec4s;
+    AlignedVector<Vector4>          OutVec4s;
+    AlignedVector<Matrix>           MatricesA;
+    AlignedVector<Matrix>           MatricesB;
+    AlignedVector<Matrix>           OutMatrices;
+    std::vector<int32_t>            Parents;
+    AlignedVector<Matrix3x4>        Affines;
+    AlignedVector<Matrix3x4>        OutAffines;
+    AlignedVector<Quaternion>       QuatsA;
+    AlignedVector<Quaternion>       QuatsB;
+    AlignedVector<Quaternion>       OutQuats;
+    std::vector<OrthonormalBasis>   Bases;
+    AlignedVector<Matrix>           BoneMatrices;
+    AlignedVector<DualQuaternion>   BoneDualQuats;
+    std::vector<uint16_t>           BoneIndices;
+    std::vector<float>              BoneWeights;
+    std::vector<Vector3>            Translations;
+    std::vector<Vector3>            Scales;
+    std::vector<float>              KeyTimes;
+    std::vector<Vector3>            KeyTranslations;
+    AlignedVector<Quaternion>       KeyRotations;
+    std::vector<Vector3>            KeyScales;
+    Matrix                          Transform;
+    Random                          Rng;
+    RandomStream                    Stream;
+    std::vector<TransformHierarchy> Hierarchies;    // BENCH_HIERARCHY_SIZES のノード数の階層構造.
+    AnimationClip                   Clip;
+    AnimationCursor                 Cursor;
+    Spline                          Curve;
+    std::vector<BoundingSphere>     Spheres;
+    std::vector<BoundingBox>        Boxes;
+    std::vector<float>              BoundsX[3];     // 球の中心 / 箱の最小値 (SoA).
+    std::vector<float>              BoundsY[3];
+    std::vector<float>              BoundsZ[3];
+    std::vector<float>              Radii;
+    std::vector<uint32_t>           VisibleMask;
+    ViewFrustum                     Frustum;
+    Bvh                             BoxBvh;
+    Bvh                             LinearBvh;      // BoxBvh と同じ箱を Morton 順で構築したもの.
+    std::vector<Ray>                Rays;
+    std::vector<Ray>                GridRays;       // 4x2 のタイル順に並べた格子状のレイ.
+    std::vector<RayPacket8>         GridPackets;    // GridRays を8本ずつまとめたもの.
+    std::vector<Triangle>           Triangles;
+    asvk::Frustum                   Planes;         // Frustum と同じ錐台を6平面で表したもの.
+    SpatialHash                     Grid;           // Spheres を登録した空間インデックス.
+    std::vector<Vector3>            QueryPoints;
+    std::vector<uint32_t>           QueryHandles;
+    std::vector<float>              QueryDistances;
+    Broadphase                      Sweep;
+    std::vector<BoundingSphere>     MovedSpheres;   // Spheres を少しずつ動かしたもの.
+    std::vector<OverlapPair>        Overlaps;
+    float                           Time;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    BenchData()
+    : Rng   ( static_cast<int>( BENCH_SEED ) )
+    , Stream( BENCH_SEED )
+    , Time  ( 0.0f )
+    { /* DO_NOTHING */ }
+};
+
+
+//-------------------------------------------------------------------------------------------------
+//      値を使用済みにして最適化による計算の削除を防ぎます.
+//-------------------------------------------------------------------------------------------------
+template<typename T>
+inline void DoNotOptimize( const T& value )
+{
+#if defined(_MSC_VER)
+    static volatile const void* s_Sink = nullptr;
+    s_Sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile( "" : : "g"( &value ) : "memory" );
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      経過時間を秒単位で求めます.
+//-------------------------------------------------------------------------------------------------
+inline double Seconds( Clock::time_point begin, Clock::time_point end )
+{ return std::chrono::duration<double>( end - begin ).count(); }
+
+//-------------------------------------------------------------------------------------------------
+//      ランダムな単位四元数を生成します.
+//-------------------------------------------------------------------------------------------------
+inline Quaternion RandomRotation( RandomStream& rng )
+{
+    return Quaternion::CreateFromYawPitchRoll(
+        rng.GetAsF32( -F_PI, F_PI ),
+        rng.GetAsF32( -F_PI, F_PI ),
+        rng.GetAsF32( -F_PI, F_PI ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ランダムな剛体変換行列を生成します.
+//-------------------------------------------------------------------------------------------------
+inline Matrix RandomRigid( RandomStream& rng )
+{
+    auto result = Matrix::CreateFromQuaternion( RandomRotation( rng ) );
+    result._41 = rng.GetAsF32( -10.0f, 10.0f );
+    result._42 = rng.GetAsF32( -10.0f, 10.0f );
+    result._43 = rng.GetAsF32( -10.0f, 10.0f );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      入力データを生成します.
+//-------------------------------------------------------------------------------------------------
+void InitData( BenchData& data, size_t count )
+{
+    RandomStream rng( BENCH_SEED );
+
+    data.Floats     .resize( count );
+    data.Params     .resize( count );
+    data.Distances  .resize( count );
+    data.Halves     .resize( count );
+    data.Packed     .resize( count );
+    data.U32s       .resize( count );
+    data.Vec3s      .resize( count );
+    data.Normals    .resize( count );
+    data.OutVec3s   .resize( count );
+    data.OutNormals .resize( count );
+    data.Vec4s      .resize( count );
+    data.OutVec4s   .resize( count );
+    data.MatricesA  .resize( count );
+    data.MatricesB  .resize( count );
+    data.OutMatrices.resize( count );
+    data.Parents    .resize( count );
+    data.Affines    .resize( count );
+    data.OutAffines .resize( count );
+    data.QuatsA     .resize( count );
+    data.QuatsB     .resize( count );
+    data.OutQuats   .resize( count );
+    data.Bases      .resize( count );
+    data.BoneIndices.resize( count * 4 );
+    data.BoneWeights.resize( count * 4 );
+
+    for( size_t i=0; i<count; ++i )
+    {
+        data.Floats[i]  = rng.GetAsF32( -4.0f, 4.0f );
+        data.Vec3s[i]   = Vector3( rng.GetAsF32( -10.0f, 10.0f ), rng.GetAsF32( -10.0f, 10.0f ), rng.GetAsF32( -10.0f, 10.0f ) );
+        data.Vec4s[i]   = Vector4( data.Vec3s[i], 1.0f );
+        data.MatricesA[i] = RandomRigid( rng );
+        data.MatricesB[i] = RandomRigid( rng );
+        data.Affines[i] = Matrix3x4( data.MatricesA[i] );
+        data.QuatsA[i]  = RandomRotation( rng );
+        data.QuatsB[i]  = RandomRotation( rng );
+        data.Parents[i] = ( i == 0 ) ? -1 : static_cast<int32_t>( rng.GetAsU32() % i );
+
+        // 重みの大きい順に4ボーンまで.
+        float sum = 0.0f;
+        for( auto j=0; j<4; ++j )
+        {
+            data.BoneIndices[i * 4 + j] = static_cast<uint16_t>( rng.GetAsU32() % BENCH_BONE_COUNT );
+            data.BoneWeights[i * 4 + j] = rng.GetAsF32( 0.0f, 1.0f ) / float( j + 1 );
+            sum += data.BoneWeights[i * 4 + j];
+        }
+        for( auto j=0; j<4; ++j )
+        { data.BoneWeights[i * 4 + j] /= sum; }
+    }
+    Random( static_cast<int>( BENCH_SEED ) ).FillUnitVector3( data.Normals.data(), count );
+    F32ToF16( data.Floats.data(), data.Halves.data(), count );
+    EncodeOctahedral16( data.Normals.data(), data.Packed.data(), count );
+    data.Transform = RandomRigid( rng );
+
+    // スキニング用のボーン.
+    data.BoneMatrices .resize( BENCH_BONE_COUNT );
+    data.BoneDualQuats.resize( BENCH_BONE_COUNT );
+    for( auto i=0u; i<BENCH_BONE_COUNT; ++i )
+    {
+        auto rotation    = RandomRotation( rng );
+        auto translation = Vector3( rng.GetAsF32( -1.0f, 1.0f ), rng.GetAsF32( -1.0f, 1.0f ), rng.GetAsF32( -1.0f, 1.0f ) );
+        data.BoneMatrices[i] = Matrix::CreateFromQuaternion( rotation );
+        data.BoneMatrices[i]._41 = translation.x;
+        data.BoneMatrices[i]._42 = translation.y;
+        data.BoneMatrices[i]._43 = translation.z;
+        data.BoneDualQuats[i] = DualQuaternion::CreateFromRotationTranslation( rotation, translation );
+    }
+
+    // 階層構造 (ノード0がルートで，その他のノードは前方のノードを親に持つ).
+    // ノード数による差を見るため, 要素数によらず BENCH_HIERARCHY_SIZES の大きさで作る.
+    // 他の項目の入力が変わらないように別の乱数列を使う.
+    RandomStream hierarchyRng( BENCH_SEED + 1 );
+    data.Hierarchies.clear();
+    data.Hierarchies.resize( sizeof(BENCH_HIERARCHY_SIZES) / sizeof(BENCH_HIERARCHY_SIZES[0]) );
+    for( size_t h=0; h<data.Hierarchies.size(); ++h )
+    {
+        auto& hierarchy = data.Hierarchies[h];
+        auto  nodeCount = BENCH_HIERARCHY_SIZES[h];
+        hierarchy.Reserve( nodeCount );
+        for( auto i=0u; i<nodeCount; ++i )
+        {
+            auto parent = ( i == 0 ) ? TransformHierarchy::INVALID_HANDLE : hierarchyRng.GetAsU32() % i;
+            auto translation = Vector3( hierarchyRng.GetAsF32( -1.0f, 1.0f ), hierarchyRng.GetAsF32( -1.0f, 1.0f ), hierarchyRng.GetAsF32( -1.0f, 1.0f ) );
+            hierarchy.Add( parent, translation, RandomRotation( hierarchyRng ), Vector3( 1.0f, 1.0f, 1.0f ) );
+        }
+        hierarchy.Update();
+    }
+
+    // アニメーション (要素数分のトラック).
+    data.KeyTimes       .resize( BENCH_KEY_COUNT );
+    data.KeyTranslations.resize( count * BENCH_KEY_COUNT );
+    data.KeyRotations   .resize( count * BENCH_KEY_COUNT );
+    data.KeyScales      .resize( count * BENCH_KEY_COUNT );
+    for( auto k=0u; k<BENCH_KEY_COUNT; ++k )
+    { data.KeyTimes[k] = float( k ) / 30.0f; }
+
+    std::vector<AnimationTrack> tracks( count );
+    for( size_t i=0; i<count; ++i )
+    {
+        for( auto k=0u; k<BENCH_KEY_COUNT; ++k )
+        {
+            auto index = i * BENCH_KEY_COUNT + k;
+            data.KeyTranslations[index] = Vector3( rng.GetAsF32( -1.0f, 1.0f ), rng.GetAsF32( -1.0f, 1.0f ), rng.GetAsF32( -1.0f, 1.0f ) );
+            data.KeyRotations   [index] = RandomRotation( rng );
+            data.KeyScales      [index] = Vector3( rng.GetAsF32( 0.5f, 2.0f ), rng.GetAsF32( 0.5f, 2.0f ), rng.GetAsF32( 0.5f, 2.0f ) );
+        }
+        tracks[i].Times         = data.KeyTimes.data();
+        tracks[i].Translations  = &data.KeyTranslations[i * BENCH_KEY_COUNT];
+        tracks[i].Rotations     = &data.KeyRotations   [i * BENCH_KEY_COUNT];
+        tracks[i].Scales        = &data.KeyScales      [i * BENCH_KEY_COUNT];
+        tracks[i].KeyCount      = BENCH_KEY_COUNT;
+    }
+    data.Clip.Build( tracks.data(), tracks.size() );
+    data.Clip.ResetCursor( data.Cursor );
+    data.Translations.resize( count );
+    data.Scales      .resize( count );
+
+    // スプライン.
+    std::vector<Vector3> points( BENCH_SPLINE_POINTS );
+    for( auto i=0u; i<BENCH_SPLINE_POINTS; ++i )
+    { points[i] = Vector3( float( i ) * 2.0f, rng.GetAsF32( -3.0f, 3.0f ), rng.GetAsF32( -3.0f, 3.0f ) ); }
+    data.Curve.Build( points.data(), points.size(), false );
+    for( size_t i=0; i<count; ++i )
+    {
+        data.Params[i]    = rng.GetAsF32( 0.0f, float( data.Curve.GetSegmentCount() ) );
+        data.Distances[i] = rng.GetAsF32( 0.0f, data.Curve.GetLength() );
+    }
+
+    // 錐台カリング (箱の中に散らばった物体を外縁付近から見る配置).
+    data.Frustum.SetPerspective( ToRadian( 60.0f ), 16.0f / 9.0f, 0.1f, 100.0f );
+    data.Frustum.SetLookTo( Vector3( 0.0f, 0.0f, -50.0f ), Vector3( 0.0f, 0.0f, 1.0f ), Vector3( 0.0f, 1.0f, 0.0f ) );
+    data.Spheres.resize( count );
+    data.Boxes  .resize( count );
+    data.Radii  .resize( count );
+    data.VisibleMask.resize( ( count + 31 ) / 32 );
+    for( auto j=0; j<3; ++j )
+    {
+        data.BoundsX[j].resize( count );
+        data.BoundsY[j].resize( count );
+        data.BoundsZ[j].resize( count );
+    }
+    for( size_t i=0; i<count; ++i )
+    {
+        auto center  = Vector3( rng.GetAsF32( -100.0f, 100.0f ), rng.GetAsF32( -100.0f, 100.0f ), rng.GetAsF32( -100.0f, 100.0f ) );
+        auto extent  = Vector3( rng.GetAsF32( 0.1f, 4.0f ), rng.GetAsF32( 0.1f, 4.0f ), rng.GetAsF32( 0.1f, 4.0f ) );
+        data.Spheres[i] = BoundingSphere( center, extent.x );
+        data.Boxes  [i] = BoundingBox( center - extent, center + extent );
+        data.Radii  [i] = extent.x;
+        data.BoundsX[0][i] = center.x; data.BoundsX[1][i] = center.x - extent.x; data.BoundsX[2][i] = center.x + extent.x;
+        data.BoundsY[0][i] = center.y; data.BoundsY[1][i] = center.y - extent.y; data.BoundsY[2][i] = center.y + extent.y;
+        data.BoundsZ[0][i] = center.z; data.BoundsZ[1][i] = center.z - extent.z; data.BoundsZ[2][i] = center.z + extent.z;
+    }
+
+    // BVH (錐台カリングと同じ箱に, 外側から内側へ向けてレイを飛ばす).
+    data.BoxBvh.Build( data.Boxes.data(), data.Boxes.size() );
+    data.LinearBvh.BuildLinear( data.Boxes.data(), data.Boxes.size() );
+    data.Rays.reserve( BENCH_RAY_COUNT );
+    for( auto i=0u; i<BENCH_RAY_COUNT; ++i )
+    {
+        auto origin = Vector3( rng.GetAsF32( -150.0f, 150.0f ), rng.GetAsF32( -150.0f, 150.0f ), -150.0f );
+        auto target = Vector3( rng.GetAsF32( -100.0f, 100.0f ), rng.GetAsF32( -100.0f, 100.0f ), rng.GetAsF32( -100.0f, 100.0f ) );
+        data.Rays.emplace_back( origin, Vector3::Normalize( target - origin ) );
+    }
+
+    // レイパケット (ピッキングのように1点から格子状に飛ばす, 方向の揃ったレイ).
+    data.GridRays.reserve( BENCH_RAY_GRID * BENCH_RAY_GRID );
+    for( auto ty=0u; ty<BENCH_RAY_GRID; ty+=2 )
+    {
+        for( auto tx=0u; tx<BENCH_RAY_GRID; tx+=4 )
+        {
+            RayPacket8 packet;
+            for( auto lane=0u; lane<RayPacket8::WIDTH; ++lane )
+            {
+                auto x = float( tx + lane % 4 ) / float( BENCH_RAY_GRID - 1 );
+                auto y = float( ty + lane / 4 ) / float( BENCH_RAY_GRID - 1 );
+                auto origin = Vector3( 0.0f, 0.0f, -150.0f );
+                auto target = Vector3( x * 40.0f - 20.0f, y * 40.0f - 20.0f, 0.0f );
+                data.GridRays.emplace_back( origin, Vector3::Normalize( target - origin ) );
+                packet.Set( lane, data.GridRays.back() );
+            }
+            data.GridPackets.push_back( packet );
+        }
+    }
+
+    data.Triangles.resize( count );
+    for( size_t i=0; i<count; ++i )
+    {
+        const auto& box = data.Boxes[i];
+        data.Triangles[i] = Triangle( box.mini, Vector3( box.maxi.x, box.mini.y, box.maxi.z ), Vector3( box.mini.x, box.maxi.y, box.maxi.z ) );
+    }
+
+    // 空間インデックス (錐台カリングと同じ球を登録し, 範囲内の点から検索する).
+    data.Planes.SetMatrix( Matrix::Multiply(
+        Matrix::CreateLookAt( Vector3( 0.0f, 0.0f, -50.0f ), Vector3( 0.0f, 0.0f, 0.0f ), Vector3( 0.0f, 1.0f, 0.0f ) ),
+        Matrix::CreatePerspectiveFieldOfView( ToRadian( 60.0f ), 16.0f / 9.0f, 0.1f, 100.0f ) ) );
+    data.Grid.Init( BENCH_CELL_SIZE, uint32_t( count ) );
+    data.Grid.Reserve( count );
+    for( size_t i=0; i<count; ++i )
+    { data.Grid.Insert( data.Spheres[i] ); }
+    data.QueryPoints.resize( BENCH_QUERY_COUNT );
+    for( auto i=0u; i<BENCH_QUERY_COUNT; ++i )
+    { data.QueryPoints[i] = Vector3( rng.GetAsF32( -100.0f, 100.0f ), rng.GetAsF32( -100.0f, 100.0f ), rng.GetAsF32( -100.0f, 100.0f ) ); }
+    data.QueryHandles  .resize( count );
+    data.QueryDistances.resize( count );
+
+    // ブロードフェーズ (錐台カリングと同じ球を, 1パスごとに Spheres と MovedSpheres で入れ替える).
+    data.MovedSpheres.resize( count );
+    for( size_t i=0; i<count; ++i )
+    {
+        auto offset = Vector3( rng.GetAsF32( -BENCH_JITTER, BENCH_JITTER ), rng.GetAsF32( -BENCH_JITTER, BENCH_JITTER ), rng.GetAsF32( -BENCH_JITTER, BENCH_JITTER ) );
+        data.MovedSpheres[i] = BoundingSphere( data.Spheres[i].center + offset, data.Spheres[i].radius );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      計測項目を登録します.
+//-------------------------------------------------------------------------------------------------
+void RegisterEntries( BenchData& d, size_t n, std::vector<BenchEntry>& entries )
+{
+    auto add = [&]( const char* name, const char* form, std::function<size_t()> pass )
+    {
+        BenchEntry entry;
+        entry.Name = name;
+        entry.Form = form;
+        entry.Pass = std::move( pass );
+        entries.push_back( std::move( entry ) );
+    };
+
+    // Vector3
+    add( "Vector3::Normalize", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = Vector3::Normalize( d.Vec3s[i] ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3::NormalizeFast", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = Vector3::NormalizeFast( d.Vec3s[i] ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3::Cross", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = Vector3::Cross( d.Vec3s[i], d.Normals[i] ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3::Transform", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = Vector3::Transform( d.Vec3s[i], d.Transform ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3::Transform", "batch", [&d, n]{
+        Vector3::Transform( d.Vec3s.data(), d.Transform, d.OutVec3s.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3::TransformNormal", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = Vector3::TransformNormal( d.Normals[i], d.Transform ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3::TransformNormal", "batch", [&d, n]{
+        Vector3::TransformNormal( d.Normals.data(), d.Transform, d.OutVec3s.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3::TransformCoord", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = Vector3::TransformCoord( d.Vec3s[i], d.Transform ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3::TransformCoord", "batch", [&d, n]{
+        Vector3::TransformCoord( d.Vec3s.data(), d.Transform, d.OutVec3s.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Vector3x4::Transform", "batch", [&d, n]{
+        size_t i = 0;
+        for( ; i + 4 <= n; i += 4 )
+        {
+            Vector3x4 soa( &d.Vec3s[i] );
+            Vector3x4::Transform( soa, d.Transform, soa );
+            soa.Store( &d.OutVec3s[i] );
+        }
+        DoNotOptimize( d.OutVec3s[0] ); return i; } );
+
+    // Vector4
+    add( "Vector4::Normalize", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec4s[i] = Vector4::Normalize( d.Vec4s[i] ); }
+        DoNotOptimize( d.OutVec4s[0] ); return n; } );
+    add( "Vector4::Transform", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec4s[i] = Vector4::Transform( d.Vec4s[i], d.Transform ); }
+        DoNotOptimize( d.OutVec4s[0] ); return n; } );
+
+    // Matrix
+    add( "Matrix::Multiply", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Matrix::Multiply( d.MatricesA[i], d.MatricesB[i], d.OutMatrices[i] ); }
+        DoNotOptimize( d.OutMatrices[0] ); return n; } );
+    add( "Matrix::Multiply", "batch", [&d, n]{
+        Matrix::MultiplyBatch( d.MatricesA.data(), d.MatricesB.data(), d.OutMatrices.data(), n );
+        DoNotOptimize( d.OutMatrices[0] ); return n; } );
+    add( "Matrix::MultiplyHierarchy", "batch", [&d, n]{
+        Matrix::MultiplyHierarchy( d.MatricesA.data(), d.Parents.data(), d.OutMatrices.data(), n );
+        DoNotOptimize( d.OutMatrices[0] ); return n; } );
+    add( "Matrix::Transpose", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Matrix::Transpose( d.MatricesA[i], d.OutMatrices[i] ); }
+        DoNotOptimize( d.OutMatrices[0] ); return n; } );
+    add( "Matrix::Invert", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Matrix::Invert( d.MatricesA[i], d.OutMatrices[i] ); }
+        DoNotOptimize( d.OutMatrices[0] ); return n; } );
+    add( "Matrix::InvertAffine", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Matrix::InvertAffine( d.MatricesA[i], d.OutMatrices[i] ); }
+        DoNotOptimize( d.OutMatrices[0] ); return n; } );
+    add( "Matrix::InvertRigid", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Matrix::InvertRigid( d.MatricesA[i], d.OutMatrices[i] ); }
+        DoNotOptimize( d.OutMatrices[0] ); return n; } );
+    add( "Matrix::CreateFromQuaternion", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutMatrices[i] = Matrix::CreateFromQuaternion( d.QuatsA[i] ); }
+        DoNotOptimize( d.OutMatrices[0] ); return n; } );
+    add( "Matrix3x4::Multiply", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Matrix3x4::Multiply( d.Affines[i], d.Affines[n - 1 - i], d.OutAffines[i] ); }
+        DoNotOptimize( d.OutAffines[0] ); return n; } );
+
+    // Quaternion
+    add( "Quaternion::Multiply", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Quaternion::Multiply( d.QuatsA[i], d.QuatsB[i], d.OutQuats[i] ); }
+        DoNotOptimize( d.OutQuats[0] ); return n; } );
+    add( "Quaternion::Normalize", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Quaternion::Normalize( d.QuatsA[i], d.OutQuats[i] ); }
+        DoNotOptimize( d.OutQuats[0] ); return n; } );
+    add( "Quaternion::NormalizeFast", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Quaternion::NormalizeFast( d.QuatsA[i], d.OutQuats[i] ); }
+        DoNotOptimize( d.OutQuats[0] ); return n; } );
+    add( "Quaternion::Slerp", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Quaternion::Slerp( d.QuatsA[i], d.QuatsB[i], 0.3f, d.OutQuats[i] ); }
+        DoNotOptimize( d.OutQuats[0] ); return n; } );
+    add( "Quaternion::CreateFromYawPitchRoll", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Quaternion::CreateFromYawPitchRoll( d.Vec3s[i].x, d.Vec3s[i].y, d.Vec3s[i].z, d.OutQuats[i] ); }
+        DoNotOptimize( d.OutQuats[0] ); return n; } );
+    add( "Quaternion::CreateFromYawPitchRollFast", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { Quaternion::CreateFromYawPitchRollFast( d.Vec3s[i].x, d.Vec3s[i].y, d.Vec3s[i].z, d.OutQuats[i] ); }
+        DoNotOptimize( d.OutQuats[0] ); return n; } );
+
+    // 高速近似関数.
+    add( "SinCosFast", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { SinCosFast( d.Floats[i], d.OutVec3s[i].x, d.OutVec3s[i].y ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "RsqrtFast", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i].x = RsqrtFast( fabsf( d.Floats[i] ) + 1.0f ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Atan2Fast", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i].x = Atan2Fast( d.Vec3s[i].y, d.Vec3s[i].x ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+
+    // 変換とパッキング.
+    add( "F32ToF16", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.Halves[i] = F32ToF16( d.Floats[i] ); }
+        DoNotOptimize( d.Halves[0] ); return n; } );
+    add( "F32ToF16", "batch", [&d, n]{
+        F32ToF16( d.Floats.data(), d.Halves.data(), n );
+        DoNotOptimize( d.Halves[0] ); return n; } );
+    add( "F16ToF32", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.Floats[i] = F16ToF32( d.Halves[i] ); }
+        DoNotOptimize( d.Floats[0] ); return n; } );
+    add( "F16ToF32", "batch", [&d, n]{
+        F16ToF32( d.Halves.data(), d.Floats.data(), n );
+        DoNotOptimize( d.Floats[0] ); return n; } );
+    add( "EncodeOctahedral16", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.Packed[i] = EncodeOctahedral16( d.Normals[i] ); }
+        DoNotOptimize( d.Packed[0] ); return n; } );
+    add( "EncodeOctahedral16", "batch", [&d, n]{
+        EncodeOctahedral16( d.Normals.data(), d.Packed.data(), n );
+        DoNotOptimize( d.Packed[0] ); return n; } );
+    add( "DecodeOctahedral16", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = DecodeOctahedral16( d.Packed[i] ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "DecodeOctahedral16", "batch", [&d, n]{
+        DecodeOctahedral16( d.Packed.data(), d.OutVec3s.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+
+    // 乱数.
+    add( "Random::GetAsU32", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.U32s[i] = d.Rng.GetAsU32(); }
+        DoNotOptimize( d.U32s[0] ); return n; } );
+    add( "Random::GetAsF32", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.Floats[i] = d.Rng.GetAsF32(); }
+        DoNotOptimize( d.Floats[0] ); return n; } );
+    add( "Random::FillU32", "batch", [&d, n]{
+        d.Rng.FillU32( d.U32s.data(), n );
+        DoNotOptimize( d.U32s[0] ); return n; } );
+    add( "Random::FillF32", "batch", [&d, n]{
+        d.Rng.FillF32( d.Floats.data(), n, 0.0f, 1.0f );
+        DoNotOptimize( d.Floats[0] ); return n; } );
+    add( "Random::FillUnitVector3", "batch", [&d, n]{
+        d.Rng.FillUnitVector3( d.OutVec3s.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "RandomStream::GetAsF32", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.Floats[i] = d.Stream.GetAsF32(); }
+        DoNotOptimize( d.Floats[0] ); return n; } );
+    add( "RandomStream::FillF32", "batch", [&d, n]{
+        d.Stream.FillF32( d.Floats.data(), n, 0.0f, 1.0f );
+        DoNotOptimize( d.Floats[0] ); return n; } );
+
+    // 正規直交基底.
+    add( "OrthonormalBasis::InitFromW", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.Bases[i].InitFromW( d.Normals[i] ); }
+        DoNotOptimize( d.Bases[0] ); return n; } );
+    add( "OrthonormalBasis::CreateFromW", "batch", [&d, n]{
+        OrthonormalBasis::CreateFromW( d.Normals.data(), d.Bases.data(), n );
+        DoNotOptimize( d.Bases[0] ); return n; } );
+
+    // スキニング (頂点あたり).
+    add( "DualQuaternion::Blend+Transform", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i )
+        {
+            DualQuaternion bones[4];
+            for( auto j=0; j<4; ++j ) { bones[j] = d.BoneDualQuats[d.BoneIndices[i * 4 + j]]; }
+            auto blend = DualQuaternion::Blend( bones, &d.BoneWeights[i * 4], 4 );
+            d.OutVec3s[i]   = DualQuaternion::Transform( d.Vec3s[i], blend );
+            d.OutNormals[i] = DualQuaternion::TransformNormal( d.Normals[i], blend );
+        }
+        DoNotOptimize( d.OutVec3s[0] ); DoNotOptimize( d.OutNormals[0] ); return n; } );
+    add( "DualQuaternion::Skin", "batch", [&d, n]{
+        DualQuaternion::Skin( d.BoneDualQuats.data(), d.Vec3s.data(), d.Normals.data(),
+            d.BoneIndices.data(), d.BoneWeights.data(), d.OutVec3s.data(), d.OutNormals.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); DoNotOptimize( d.OutNormals[0] ); return n; } );
+    add( "Matrix::Skin", "batch", [&d, n]{
+        Matrix::Skin( d.BoneMatrices.data(), d.Vec3s.data(), d.Normals.data(),
+            d.BoneIndices.data(), d.BoneWeights.data(), d.OutVec3s.data(), d.OutNormals.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); DoNotOptimize( d.OutNormals[0] ); return n; } );
+
+    // 階層構造 (ノード数ごと, ノードあたり).
+    // Update はルートを変更して全ノードを更新し, UpdatePartial は無作為に選んだ1%のノードを変更して子孫だけを更新する.
+    for( size_t h=0; h<d.Hierarchies.size(); ++h )
+    {
+        auto pHierarchy = &d.Hierarchies[h];
+        auto nodeCount  = BENCH_HIERARCHY_SIZES[h];
+        auto suffix     = "(" + std::to_string( nodeCount / 1000 ) + "k)";
+
+        add( ( "TransformHierarchy::Update" + suffix ).c_str(), "batch", [&d, pHierarchy, nodeCount]{
+            pHierarchy->SetRotation( 0, d.QuatsA[0] );
+            pHierarchy->Update();
+            DoNotOptimize( *pHierarchy->GetWorldMatrices() ); return size_t( nodeCount ); } );
+        add( ( "TransformHierarchy::UpdatePartial" + suffix ).c_str(), "batch", [&d, pHierarchy, nodeCount]{
+            for( auto i=0u; i<nodeCount; i+=BENCH_DIRTY_STRIDE )
+            {
+                auto handle = d.Stream.GetAsU32() % nodeCount;
+                pHierarchy->SetRotation( handle, d.QuatsA[handle % d.QuatsA.size()] );
+            }
+            pHierarchy->Update();
+            DoNotOptimize( *pHierarchy->GetWorldMatrices() ); return size_t( nodeCount ); } );
+    }
+
+    // アニメーション (トラックあたり).
+    add( "AnimationClip::Sample", "batch", [&d, n]{
+        d.Time += 1.0f / 60.0f;
+        if ( d.Time > d.Clip.GetDuration() )
+        { d.Time = 0.0f; }
+        d.Clip.Sample( d.Time, d.Cursor, d.Translations.data(), d.OutQuats.data(), d.Scales.data() );
+        DoNotOptimize( d.OutQuats[0] ); return n; } );
+
+    // スプライン.
+    add( "Spline::Evaluate", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = d.Curve.Evaluate( d.Params[i] ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Spline::Evaluate", "batch", [&d, n]{
+        d.Curve.Evaluate( d.Params.data(), d.OutVec3s.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Spline::EvaluateAtDistance", "scalar", [&d, n]{
+        for( size_t i=0; i<n; ++i ) { d.OutVec3s[i] = d.Curve.EvaluateAtDistance( d.Distances[i] ); }
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+    add( "Spline::EvaluateAtDistance", "batch", [&d, n]{
+        d.Curve.EvaluateAtDistance( d.Distances.data(), d.OutVec3s.data(), n );
+        DoNotOptimize( d.OutVec3s[0] ); return n; } );
+
+    // 錐台カリング (オブジェクトあたり).
+    add( "ViewFrustum::CullSpheres", "scalar", [&d, n]{
+        size_t visible = 0;
+        for( size_t i=0; i<n; ++i ) { visible += d.Frustum.Contains( d.Spheres[i] ) ? 1 : 0; }
+        DoNotOptimize( visible ); return n; } );
+    add( "ViewFrustum::CullSpheres", "batch", [&d, n]{
+        d.Frustum.CullSpheres( d.BoundsX[0].data(), d.BoundsY[0].data(), d.BoundsZ[0].data(), d.Radii.data(), n, d.VisibleMask.data() );
+        DoNotOptimize( d.VisibleMask[0] ); return n; } );
+    add( "ViewFrustum::CullBoxes", "scalar", [&d, n]{
+        size_t visible = 0;
+        for( size_t i=0; i<n; ++i ) { visible += d.Frustum.Contains( d.Boxes[i] ) ? 1 : 0; }
+        DoNotOptimize( visible ); return n; } );
+    add( "ViewFrustum::CullBoxes", "batch", [&d, n]{
+        d.Frustum.CullBoxes(
+            d.BoundsX[1].data(), d.BoundsY[1].data(), d.BoundsZ[1].data(),
+            d.BoundsX[2].data(), d.BoundsY[2].data(), d.BoundsZ[2].data(), n, d.VisibleMask.data() );
+        DoNotOptimize( d.VisibleMask[0] ); return n; } );
+
+    // BVH (構築は箱あたり, 交差判定はレイあたり. scalar は全ての箱との総当たり).
+    add( "Bvh::Build", "batch", [&d, n]{
+        d.BoxBvh.Build( d.Boxes.data(), n );
+        DoNotOptimize( d.BoxBvh.GetNodes()[0] ); return n; } );
+    add( "Bvh::BuildLinear(30bit)", "batch", [&d, n]{
+        d.LinearBvh.BuildLinear( d.Boxes.data(), n, MortonPrecision::Bits30 );
+        DoNotOptimize( d.LinearBvh.GetNodes()[0] ); return n; } );
+    add( "Bvh::BuildLinear(63bit)", "batch", [&d, n]{
+        d.LinearBvh.BuildLinear( d.Boxes.data(), n, MortonPrecision::Bits63 );
+        DoNotOptimize( d.LinearBvh.GetNodes()[0] ); return n; } );
+    add( "Bvh::IntersectClosest", "scalar", [&d, n]{
+        float sum = 0.0f;
+        for( const auto& ray : d.Rays )
+        {
+            auto closest = BENCH_RAY_DISTANCE;
+            float distance;
+            for( size_t i=0; i<n; ++i )
+            {
+                if ( d.Boxes[i].Intersects( ray, closest, distance ) )
+                { closest = distance; }
+            }
+            sum += closest;
+        }
+        DoNotOptimize( sum ); return d.Rays.size(); } );
+    add( "Bvh::IntersectClosest", "batch", [&d]{
+        float  sum = 0.0f;
+        BvhHit hit;
+        for( const auto& ray : d.Rays )
+        { sum += d.BoxBvh.IntersectClosest( ray, BENCH_RAY_DISTANCE, hit ) ? hit.distance : BENCH_RAY_DISTANCE; }
+        DoNotOptimize( sum ); return d.Rays.size(); } );
+    add( "Bvh::IntersectClosest(Linear)", "batch", [&d]{
+        float  sum = 0.0f;
+        BvhHit hit;
+        for( const auto& ray : d.Rays )
+        { sum += d.LinearBvh.IntersectClosest( ray, BENCH_RAY_DISTANCE, hit ) ? hit.distance : BENCH_RAY_DISTANCE; }
+        DoNotOptimize( sum ); return d.Rays.size(); } );
+    add( "Bvh::IntersectAny", "scalar", [&d, n]{
+        size_t hits = 0;
+        for( const auto& ray : d.Rays )
+        {
+            float distance;
+            for( size_t i=0; i<n; ++i )
+            {
+                if ( d.Boxes[i].Intersects( ray, BENCH_RAY_DISTANCE, distance ) )
+                { hits++; break; }
+            }
+        }
+        DoNotOptimize( hits ); return d.Rays.size(); } );
+    add( "Bvh::IntersectAny", "batch", [&d]{
+        size_t hits = 0;
+        for( const auto& ray : d.Rays )
+        { hits += d.BoxBvh.IntersectAny( ray, BENCH_RAY_DISTANCE ) ? 1 : 0; }
+        DoNotOptimize( hits ); return d.Rays.size(); } );
+
+    // レイパケット (判定はレイとプリミティブの組あたり, 走査はレイあたり. scalar は1本ずつ).
+    add( "RayPacket8::Intersects(BoundingBox)", "scalar", [&d, n]{
+        size_t hits = 0;
+        float  distance;
+        for( const auto& ray : d.GridRays )
+        {
+            for( size_t i=0; i<n; ++i )
+            { hits += d.Boxes[i].Intersects( ray, BENCH_RAY_DISTANCE, distance ) ? 1 : 0; }
+        }
+        DoNotOptimize( hits ); return d.GridRays.size() * n; } );
+    add( "RayPacket8::Intersects(BoundingBox)", "batch", [&d, n]{
+        uint32_t hits = 0;
+        float    limit[RayPacket8::WIDTH];
+        float    distance[RayPacket8::WIDTH];
+        std::fill( limit, limit + RayPacket8::WIDTH, BENCH_RAY_DISTANCE );
+        for( const auto& packet : d.GridPackets )
+        {
+            for( size_t i=0; i<n; ++i )
+            { hits |= packet.Intersects( d.Boxes[i], limit, distance ); }
+        }
+        DoNotOptimize( hits ); return d.GridRays.size() * n; } );
+    add( "RayPacket8::Intersects(Triangle)", "scalar", [&d, n]{
+        size_t hits = 0;
+        float  distance;
+        for( const auto& ray : d.GridRays )
+        {
+            for( size_t i=0; i<n; ++i )
+            { hits += d.Triangles[i].Intersects( ray, BENCH_RAY_DISTANCE, distance ) ? 1 : 0; }
+        }
+        DoNotOptimize( hits ); return d.GridRays.size() * n; } );
+    add( "RayPacket8::Intersects(Triangle)", "batch", [&d, n]{
+        uint32_t hits = 0;
+        float    limit[RayPacket8::WIDTH];
+        float    distance[RayPacket8::WIDTH];
+        std::fill( limit, limit + RayPacket8::WIDTH, BENCH_RAY_DISTANCE );
+        for( const auto& packet : d.GridPackets )
+        {
+            for( size_t i=0; i<n; ++i )
+            { hits |= packet.Intersects( d.Triangles[i], limit, distance ); }
+        }
+        DoNotOptimize( hits ); return d.GridRays.size() * n; } );
+    add( "Bvh::IntersectClosest(RayPacket8)", "scalar", [&d]{
+        float  sum = 0.0f;
+        BvhHit hit;
+        for( const auto& ray : d.GridRays )
+        { sum += d.BoxBvh.IntersectClosest( ray, BENCH_RAY_DISTANCE, hit ) ? hit.distance : BENCH_RAY_DISTANCE; }
+        DoNotOptimize( sum ); return d.GridRays.size(); } );
+    add( "Bvh::IntersectClosest(RayPacket8)", "batch", [&d]{
+        float  sum = 0.0f;
+        float  limit[RayPacket8::WIDTH];
+        BvhHit hits[RayPacket8::WIDTH];
+        std::fill( limit, limit + RayPacket8::WIDTH, BENCH_RAY_DISTANCE );
+        for( const auto& packet : d.GridPackets )
+        {
+            auto mask = d.BoxBvh.IntersectClosest( packet, limit, hits );
+            for( auto lane=0u; lane<RayPacket8::WIDTH; ++lane )
+            { sum += ( ( mask >> lane ) & 0x1 ) ? hits[lane].distance : BENCH_RAY_DISTANCE; }
+        }
+        DoNotOptimize( sum ); return d.GridRays.size(); } );
+    add( "Bvh::IntersectAny(RayPacket8)", "scalar", [&d]{
+        size_t hits = 0;
+        for( const auto& ray : d.GridRays )
+        { hits += d.BoxBvh.IntersectAny( ray, BENCH_RAY_DISTANCE ) ? 1 : 0; }
+        DoNotOptimize( hits ); return d.GridRays.size(); } );
+    add( "Bvh::IntersectAny(RayPacket8)", "batch", [&d]{
+        uint32_t hits = 0;
+        float    limit[RayPacket8::WIDTH];
+        std::fill( limit, limit + RayPacket8::WIDTH, BENCH_RAY_DISTANCE );
+        for( const auto& packet : d.GridPackets )
+        { hits += d.BoxBvh.IntersectAny( packet, limit ); }
+        DoNotOptimize( hits ); return d.GridRays.size(); } );
+
+    // 空間インデックス (範囲検索と近傍検索は検索あたり, 錐台と移動は球あたり. scalar は全ての球との総当たり).
+    add( "SpatialHash::QuerySphere", "scalar", [&d, n]{
+        size_t hits = 0;
+        for( const auto& point : d.QueryPoints )
+        {
+            for( size_t i=0; i<n; ++i )
+            {
+                auto dist   = Vector3::Distance( d.Spheres[i].center, point );
+                auto radius = d.Spheres[i].radius + BENCH_QUERY_RADIUS;
+                hits += ( dist <= radius ) ? 1 : 0;
+            }
+        }
+        DoNotOptimize( hits ); return d.QueryPoints.size(); } );
+    add( "SpatialHash::QuerySphere", "batch", [&d]{
+        size_t hits = 0;
+        for( const auto& point : d.QueryPoints )
+        {
+            hits += d.Grid.QuerySphere( BoundingSphere( point, BENCH_QUERY_RADIUS ),
+                d.QueryHandles.data(), uint32_t( d.QueryHandles.size() ) );
+        }
+        DoNotOptimize( hits ); return d.QueryPoints.size(); } );
+    add( "SpatialHash::QueryNearest", "scalar", [&d, n]{
+        float sum = 0.0f;
+        for( const auto& point : d.QueryPoints )
+        {
+            float nearest[BENCH_NEAREST_COUNT];
+            std::fill( nearest, nearest + BENCH_NEAREST_COUNT, F32_MAX );
+            for( size_t i=0; i<n; ++i )
+            {
+                auto dist = Vector3::Distance( d.Spheres[i].center, point );
+                if ( dist >= nearest[BENCH_NEAREST_COUNT - 1] )
+                { continue; }
+                auto pos = BENCH_NEAREST_COUNT - 1;
+                for( ; pos > 0 && nearest[pos - 1] > dist; --pos )
+                { nearest[pos] = nearest[pos - 1]; }
+                nearest[pos] = dist;
+            }
+            sum += nearest[0];
+        }
+        DoNotOptimize( sum ); return d.QueryPoints.size(); } );
+    add( "SpatialHash::QueryNearest", "batch", [&d]{
+        float sum = 0.0f;
+        for( const auto& point : d.QueryPoints )
+        {
+            auto count = d.Grid.QueryNearest( point, F32_MAX,
+                d.QueryHandles.data(), d.QueryDistances.data(), BENCH_NEAREST_COUNT );
+            sum += ( count > 0 ) ? d.QueryDistances[0] : 0.0f;
+        }
+        DoNotOptimize( sum ); return d.QueryPoints.size(); } );
+    add( "SpatialHash::QueryFrustum", "scalar", [&d, n]{
+        size_t visible = 0;
+        for( size_t i=0; i<n; ++i ) { visible += d.Planes.Contains( d.Spheres[i] ) ? 1 : 0; }
+        DoNotOptimize( visible ); return n; } );
+    add( "SpatialHash::QueryFrustum", "batch", [&d, n]{
+        auto visible = d.Grid.QueryFrustum( d.Planes, d.QueryHandles.data(), uint32_t( d.QueryHandles.size() ) );
+        DoNotOptimize( visible ); return n; } );
+    add( "SpatialHash::Move", "batch", [&d, n, sign = 1.0f]() mutable {
+        // 往復させて, 登録位置が毎回同じ分布に戻るようにする.
+        auto offset = Vector3( 0.5f, -0.25f, 0.125f ) * sign;
+        for( size_t i=0; i<n; ++i )
+        {
+            auto sphere = d.Grid.GetSphere( uint32_t( i ) );
+            sphere.center = sphere.center + offset;
+            d.Grid.Move( uint32_t( i ), sphere );
+        }
+        sign = -sign;
+        DoNotOptimize( d.Grid.GetCount() ); return n; } );
+
+    // ブロードフェーズ (物体あたり. scalar は全ての組の総当たり).
+    add( "Broadphase::FindPairs(Sphere)", "scalar", [&d, n]{
+        size_t pairs = 0;
+        for( size_t i=0; i<n; ++i )
+        {
+            for( size_t j=i+1; j<n; ++j )
+            { pairs += d.Spheres[i].Contains( d.Spheres[j] ) ? 1 : 0; }
+        }
+        DoNotOptimize( pairs ); return n; } );
+    add( "Broadphase::FindPairs(Sphere)", "batch", [&d, n]{
+        auto pairs = d.Sweep.FindPairs( d.Spheres.data(), n, d.Overlaps );
+        DoNotOptimize( pairs ); return n; } );
+    add( "Broadphase::FindPairs(Box)", "scalar", [&d, n]{
+        size_t pairs = 0;
+        for( size_t i=0; i<n; ++i )
+        {
+            for( size_t j=i+1; j<n; ++j )
+            { pairs += d.Boxes[i].Contains( d.Boxes[j] ) ? 1 : 0; }
+        }
+        DoNotOptimize( pairs ); return n; } );
+    add( "Broadphase::FindPairs(Box)", "batch", [&d, n]{
+        auto pairs = d.Sweep.FindPairs( d.Boxes.data(), n, d.Overlaps );
+        DoNotOptimize( pairs ); return n; } );
+    add( "Broadphase::FindPairs(Moving)", "batch", [&d, n, moved = false]() mutable {
+        // 動かした球と交互に渡して, 毎回並べ直しが起こるようにする.
+        const auto& spheres = moved ? d.MovedSpheres : d.Spheres;
+        auto pairs = d.Sweep.FindPairs( spheres.data(), n, d.Overlaps );
+        moved = !moved;
+        DoNotOptimize( pairs ); return n; } );
+
+#if ASVK_IS_OPENMP
+    // スレッド数を1から2倍ずつ既定の数まで増やして計測する (計測後は既定のスレッド数に戻す).
+    auto maxThreads = omp_get_max_threads();
+    for( auto threads=1; ; threads=std::min( threads * 2, maxThreads ) )
+    {
+        auto name = "Broadphase::FindPairs(Moving,threads=" + std::to_string( threads ) + ")";
+        add( name.c_str(), "batch", [&d, n, threads, maxThreads, moved = false]() mutable {
+            omp_set_num_threads( threads );
+            const auto& spheres = moved ? d.MovedSpheres : d.Spheres;
+            auto pairs = d.Sweep.FindPairs( spheres.data(), n, d.Overlaps );
+            moved = !moved;
+            omp_set_num_threads( maxThreads );
+            DoNotOptimize( pairs ); return n; } );
+
+        if ( threads == maxThreads )
+        { break; }
+    }
+#endif//ASVK_IS_OPENMP
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1項目を計測します.
+//-------------------------------------------------------------------------------------------------
+BenchResult Run( const BenchEntry& entry, const BenchOption& option )
+{
+    // ウォームアップしつつ1パスの時間を見積もる.
+    size_t passes = 0;
+    auto begin = Clock::now();
+    auto end   = begin;
+    do
+    {
+        entry.Pass();
+        ++passes;
+        end = Clock::now();
+    }
+    while ( Seconds( begin, end ) < option.Warmup );
+
+    auto perPass      = Seconds( begin, end ) / double( passes );
+    auto sampleTime   = option.MinTime / double( option.Repeat );
+    auto samplePasses = std::max<size_t>( 1, static_cast<size_t>( std::ceil( sampleTime / std::max( perPass, 1e-9 ) ) ) );
+
+    BenchResult result = {};
+    result.Entry = &entry;
+
+    std::vector<double> samples;
+    samples.reserve( option.Repeat );
+    for( auto r=0; r<option.Repeat; ++r )
+    {
+        uint64_t ops = 0;
+        begin = Clock::now();
+        for( size_t p=0; p<samplePasses; ++p )
+        { ops += entry.Pass(); }
+        end = Clock::now();
+
+        samples.push_back( Seconds( begin, end ) * 1e9 / double( std::max<uint64_t>( ops, 1 ) ) );
+        result.Ops += ops;
+    }
+
+    std::sort( samples.begin(), samples.end() );
+    result.NsPerOp    = samples[samples.size() / 2];
+    result.MinNsPerOp = samples.front();
+    result.OpsPerSec  = ( result.NsPerOp > 0.0 ) ? 1e9 / result.NsPerOp : 0.0;
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      コンパイラ名を取得します.
+//-------------------------------------------------------------------------------------------------
+std::string GetCompilerName()
+{
+    char buffer[64] = {};
+#if defined(__clang__)
+    snprintf( buffer, sizeof(buffer), "clang %d.%d.%d", __clang_major__, __clang_minor__, __clang_patchlevel__ );
+#elif defined(__GNUC__)
+    snprintf( buffer, sizeof(buffer), "gcc %d.%d.%d", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__ );
+#elif defined(_MSC_VER)
+    snprintf( buffer, sizeof(buffer), "msvc %d", _MSC_FULL_VER );
+#else
+    snprintf( buffer, sizeof(buffer), "unknown" );
+#endif
+    return buffer;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      計測結果をJSON形式で出力します.
+//-------------------------------------------------------------------------------------------------
+void WriteJson( FILE* pFile, const BenchOption& option, const std::vector<BenchResult>& results )
+{
+    fprintf( pFile, "{\n" );
+    fprintf( pFile, "  \"revision\": \"%s\",\n", ASVK_BENCH_REVISION );
+    fprintf( pFile, "  \"compiler\": \"%s\",\n", GetCompilerName().c_str() );
+    fprintf( pFile, "  \"simd\": %s,\n",   ASVK_IS_SIMD   ? "true" : "false" );
+    fprintf( pFile, "  \"avx\": %s,\n",    ASVK_IS_AVX    ? "true" : "false" );
+    fprintf( pFile, "  \"f16c\": %s,\n",   ASVK_IS_F16C   ? "true" : "false" );
+    fprintf( pFile, "  \"openmp\": %s,\n", ASVK_IS_OPENMP ? "true" : "false" );
+    fprintf( pFile, "  \"count\": %zu,\n", option.Count );
+    fprintf( pFile, "  \"repeat\": %d,\n", option.Repeat );
+    fprintf( pFile, "  \"results\": [\n" );
+    for( size_t i=0; i<results.size(); ++i )
+    {
+        const auto& r = results[i];
+        fprintf( pFile,
+            "    { \"name\": \"%s\", \"form\": \"%s\", \"ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, \"ops_per_sec\": %.1f, \"ops\": %llu }%s\n",
+            r.Entry->Name.c_str(),
+            r.Entry->Form,
+            r.NsPerOp,
+            r.MinNsPerOp,
+            r.OpsPerSec,
+            static_cast<unsigned long long>( r.Ops ),
+            ( i + 1 < results.size() ) ? "," : "" );
+    }
+    fprintf( pFile, "  ]\n" );
+    fprintf( pFile, "}\n" );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使い方を表示します.
+//-------------------------------------------------------------------------------------------------
+void PrintUsage( const char* program )
+{
+    fprintf( stderr,
+        "usage: %s [options]\n"
+        "  --filter <text>     run only entries whose name contains <text>\n"
+        "  --json <path|->     write results as JSON to <path> (or stdout for '-')\n"
+        "  --count <n>         elements per pass (4 or more, default %zu)\n"
+        "  --min-time <sec>    measuring time per entry (default %.2f)\n"
+        "  --warmup <sec>      warm-up time per entry (default %.2f)\n"
+        "  --repeat <n>        samples per entry, median is reported (default %d)\n"
+        "  --list              list entry names and exit\n",
+        program, BENCH_DEFAULT_COUNT, BENCH_DEFAULT_MIN_TIME, BENCH_DEFAULT_WARMUP, BENCH_DEFAULT_REPEAT );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      コマンドライン引数を解析します.
+//-------------------------------------------------------------------------------------------------
+bool ParseArgs( int argc, char** argv, BenchOption& option )
+{
+    for( auto i=1; i<argc; ++i )
+    {
+        auto arg     = argv[i];
+        auto hasNext = ( i + 1 < argc );
+
+        if ( strcmp( arg, "--filter" ) == 0 && hasNext )
+        { option.Filter = argv[++i]; }
+        else if ( strcmp( arg, "--json" ) == 0 && hasNext )
+        { option.JsonPath = argv[++i]; }
+        else if ( strcmp( arg, "--count" ) == 0 && hasNext )
+        { option.Count = static_cast<size_t>( strtoull( argv[++i], nullptr, 10 ) ); }
+        else if ( strcmp( arg, "--min-time" ) == 0 && hasNext )
+        { option.MinTime = atof( argv[++i] ); }
+        else if ( strcmp( arg, "--warmup" ) == 0 && hasNext )
+        { option.Warmup = atof( argv[++i] ); }
+        else if ( strcmp( arg, "--repeat" ) == 0 && hasNext )
+        { option.Repeat = atoi( argv[++i] ); }
+        else if ( strcmp( arg, "--list" ) == 0 )
+        { option.List = true; }
+        else
+        { return false; }
+    }
+
+    if ( option.Count < 4 )
+    { return false; }
+
+    return option.Repeat > 0 && option.MinTime > 0.0 && option.Warmup >= 0.0;
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-------------------------------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+    BenchOption option;
+    if ( !ParseArgs( argc, argv, option ) )
+    {
+        PrintUsage( argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<BenchData> data( new BenchData() );
+    InitData( *data, option.Count );
+
+    std::vector<BenchEntry> entries;
+    RegisterEntries( *data, option.Count, entries );
+
+    // JSONを標準出力に書く場合は表を標準エラーに出す.
+    auto pTable = ( option.JsonPath != nullptr && strcmp( option.JsonPath, "-" ) == 0 ) ? stderr : stdout;
+
+    std::vector<BenchResult> results;
+    for( const auto& entry : entries )
+    {
+        if ( option.Filter != nullptr && entry.Name.find( option.Filter ) == std::string::npos )
+        { continue; }
+
+        if ( option.List )
+        {
+            fprintf( pTable, "%s (%s)\n", entry.Name.c_str(), entry.Form );
+            continue;
+        }
+
+        auto result = Run( entry, option );
+        fprintf( pTable, "%-40s %-6s %10.3f ns/op %14.0f ops/s\n",
+            entry.Name.c_str(), entry.Form, result.NsPerOp, result.OpsPerSec );
+        fflush( pTable );
+        results.push_back( result );
+    }
+
+    if ( option.JsonPath != nullptr && !option.List )
+    {
+        auto toStdout = ( strcmp( option.JsonPath, "-" ) == 0 );
+        auto pFile    = toStdout ? stdout : fopen( option.JsonPath, "w" );
+        if ( pFile == nullptr )
+        {
+            fprintf( stderr, "Error : Failed to open %s\n", option.JsonPath );
+            return EXIT_FAILURE;
+        }
+
+        WriteJson( pFile, option, results );
+
+        if ( !toStdout )
+        { fclose( pFile ); }
+    }
+
+    return EXIT_SUCCESS;
+}
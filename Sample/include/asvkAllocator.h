@@ -0,0 +1,158 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkAllocator.h
+// Desc : Aligned Allocator.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+
+namespace asvk {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr size_t SIMD_ALIGNMENT = 16;    //!< SIMDレジスタ(128bit)のアライメントです.
+
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      アライメントを指定してメモリを確保します.
+//!
+//! @param [in]     size        確保するバイト数.
+//! @param [in]     alignment   アライメント(2のべき乗).
+//! @return     確保したメモリへのポインタを返却します. 失敗した場合は nullptr を返却します.
+//-------------------------------------------------------------------------------------------------
+inline void* AlignedMalloc( size_t size, size_t alignment )
+{
+#if defined(_MSC_VER)
+    return _aligned_malloc( size, alignment );
+#else
+    // posix_memalign() はポインタサイズ未満のアライメントを受け付けない.
+    void* ptr = nullptr;
+    if ( posix_memalign( &ptr, ( alignment < sizeof(void*) ) ? sizeof(void*) : alignment, size ) != 0 )
+    { return nullptr; }
+    return ptr;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      AlignedMalloc() で確保したメモリを解放します.
+//!
+//! @param [in]     ptr         解放するメモリへのポインタ.
+//-------------------------------------------------------------------------------------------------
+inline void AlignedFree( void* ptr )
+{
+#if defined(_MSC_VER)
+    _aligned_free( ptr );
+#else
+    free( ptr );
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AlignedAllocator class
+// 標準コンテナ用のアロケータです. 要素の先頭を Alignment バイト境界に配置します.
+// C++14 の std::allocator は alignof(std::max_align_t) を超えるアライメントを保証しないため，
+// ASVK_USE_ALIGNED_TYPES 有効時の Matrix や Quaternion の配列にはこちらを使用します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T, size_t Alignment = ( alignof(T) > SIMD_ALIGNMENT ) ? alignof(T) : SIMD_ALIGNMENT>
+class AlignedAllocator
+{
+    static_assert( ( Alignment & ( Alignment - 1 ) ) == 0, "Alignment must be a power of two." );
+    static_assert( Alignment >= alignof(T), "Alignment must not be smaller than alignof(T)." );
+
+public:
+    //=============================================================================================
+    // public variables
+    //=============================================================================================
+    using value_type        = T;
+    using size_type         = size_t;
+    using difference_type   = ptrdiff_t;
+    using pointer           = T*;
+    using const_pointer     = const T*;
+    using reference         = T&;
+    using const_reference   = const T&;
+
+    //! アライメントが非型テンプレート引数のため，rebind を明示します.
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    //=============================================================================================
+    // public methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    AlignedAllocator() ASVK_NOTHROW = default;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      別の要素型のアロケータから変換します.
+    //---------------------------------------------------------------------------------------------
+    template<typename U>
+    AlignedAllocator( const AlignedAllocator<U, Alignment>& ) ASVK_NOTHROW
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリを確保します.
+    //!
+    //! @param [in]     count       要素数.
+    //! @return     確保したメモリへのポインタを返却します.
+    //! @exception  std::bad_alloc  確保に失敗しました.
+    //---------------------------------------------------------------------------------------------
+    T* allocate( size_t count )
+    {
+        if ( count > size_t(-1) / sizeof(T) )
+        { throw std::bad_alloc(); }
+
+        auto ptr = AlignedMalloc( count * sizeof(T), Alignment );
+        if ( ptr == nullptr )
+        { throw std::bad_alloc(); }
+
+        return static_cast<T*>( ptr );
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      メモリを解放します.
+    //!
+    //! @param [in]     ptr         allocate() で確保したメモリへのポインタ.
+    //---------------------------------------------------------------------------------------------
+    void deallocate( T* ptr, size_t ) ASVK_NOTHROW
+    { AlignedFree( ptr ); }
+};
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      等価比較演算子です. 状態を持たないため常に等しくなります.
+//-------------------------------------------------------------------------------------------------
+template<typename T, typename U, size_t Alignment>
+inline bool operator == ( const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>& )
+{ return true; }
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      非等価比較演算子です.
+//-------------------------------------------------------------------------------------------------
+template<typename T, typename U, size_t Alignment>
+inline bool operator != ( const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>& )
+{ return false; }
+
+//-------------------------------------------------------------------------------------------------
+//! @typedef    AlignedVector
+//! @brief      要素をSIMDアライメントで配置する可変長配列です.
+//-------------------------------------------------------------------------------------------------
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+} // namespace asvk
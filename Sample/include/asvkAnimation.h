@@ -0,0 +1,223 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkAnimation.h
+// Desc : Keyframe Animation Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkMath.h>
+#include <vector>
+
+
+namespace asvk {
+
+//-------------------------------------------------------------------------------------------------
+// Forward Declarations.
+//-------------------------------------------------------------------------------------------------
+class AnimationClip;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AnimationTrack structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct AnimationTrack
+{
+    const float*        Times;          //!< キーの時刻の配列です(狭義単調増加).
+    const Vector3*      Translations;   //!< キーの平行移動量の配列です.
+    const Quaternion*   Rotations;      //!< キーの回転(単位四元数)の配列です.
+    const Vector3*      Scales;         //!< キーの拡大縮小率の配列です.
+    uint32_t            KeyCount;       //!< キー数です(1以上).
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    AnimationTrack()
+    : Times         ( nullptr )
+    , Translations  ( nullptr )
+    , Rotations     ( nullptr )
+    , Scales        ( nullptr )
+    , KeyCount      ( 0 )
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AnimationCursor class
+// トラックごとに直前にサンプリングしたキーの位置を保持し，前方向への連続サンプリングをO(1)にします.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class AnimationCursor
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    friend class AnimationClip;
+
+public:
+    //=============================================================================================
+    // public variables
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    AnimationCursor();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~AnimationCursor();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      先頭のキーに戻します.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+private:
+    //=============================================================================================
+    // private variables
+    //=============================================================================================
+    std::vector<uint32_t>   m_Keys;     //!< トラックごとの直前のキー番号(トラック内の番号)です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AnimationClip class
+// キーの時刻・平行移動量・回転・拡大縮小率を別々の配列(SoA)に格納します.
+// 回転は smallest-three 形式の48bit，平行移動量と拡大縮小率はトラックごとの範囲で16bitに量子化します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class AnimationClip
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    AnimationClip();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~AnimationClip();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      キーフレームを量子化してクリップを構築します.
+    //!
+    //! @param [in]     pTracks     トラック(ジョイント)の配列.
+    //! @param [in]     count       トラック数.
+    //! @retval true    構築に成功しました.
+    //! @retval false   構築に失敗しました(キー数が0, または時刻が昇順でない).
+    //---------------------------------------------------------------------------------------------
+    bool Build( const AnimationTrack* pTracks, size_t count );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのデータを破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Clear();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      カーソルをこのクリップ用に初期化します.
+    //!
+    //! @param [out]    cursor      初期化するカーソル.
+    //---------------------------------------------------------------------------------------------
+    void ResetCursor( AnimationCursor& cursor ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全トラックを指定時刻でサンプリングします.
+    //!
+    //! @param [in]     time            サンプリングする時刻. トラックの範囲外はクランプされます.
+    //! @param [in,out] cursor          ResetCursor() で初期化したカーソル.
+    //! @param [out]    pTranslations   平行移動量の格納先(トラック数分).
+    //! @param [out]    pRotations      回転の格納先(トラック数分).
+    //! @param [out]    pScales         拡大縮小率の格納先(トラック数分).
+    //! @note       回転は最短経路の正規化線形補間(nlerp)で補間します. キー間の回転角が40°を超える場合は
+    //!             球面線形補間(Quaternion::Slerp())に切り替えるため，slerpとの差は量子化の誤差を除いて0.08°以内です.
+    //!             SIMD有効時は4トラックずつ補間しますが，結果はスカラー版とビット単位で一致します.
+    //---------------------------------------------------------------------------------------------
+    void Sample(
+        float               time,
+        AnimationCursor&    cursor,
+        Vector3*            pTranslations,
+        Quaternion*         pRotations,
+        Vector3*            pScales ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      トラック数を取得します.
+    //!
+    //! @return     トラック数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetTrackCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      総キー数を取得します.
+    //!
+    //! @return     全トラックのキー数の合計を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetKeyCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      再生時間を取得します.
+    //!
+    //! @return     全トラックの最後のキーの時刻の最大値を返却します.
+    //---------------------------------------------------------------------------------------------
+    float GetDuration() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      クリップが使用しているメモリ量を取得します.
+    //!
+    //! @return     キーとトラック情報が占めるバイト数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetMemorySize() const;
+
+private:
+    //=============================================================================================
+    // private variables
+    //=============================================================================================
+    std::vector<uint32_t>   m_KeyOffset;            //!< トラックごとの先頭キー番号です(末尾は総キー数).
+    std::vector<float>      m_Times;                //!< キーの時刻です.
+    std::vector<uint16_t>   m_Rotations;            //!< 量子化した回転です(1キーあたり3要素).
+    std::vector<uint16_t>   m_Translations;         //!< 量子化した平行移動量です(1キーあたり3要素).
+    std::vector<uint16_t>   m_Scales;               //!< 量子化した拡大縮小率です(1キーあたり3要素).
+    std::vector<Vector3>    m_TranslationMin;       //!< トラックごとの平行移動量の最小値です.
+    std::vector<Vector3>    m_TranslationStep;      //!< トラックごとの平行移動量の量子化幅です.
+    std::vector<Vector3>    m_ScaleMin;             //!< トラックごとの拡大縮小率の最小値です.
+    std::vector<Vector3>    m_ScaleStep;            //!< トラックごとの拡大縮小率の量子化幅です.
+    float                   m_Duration;             //!< 再生時間です.
+
+    //=============================================================================================
+    // private methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定時刻を挟むキーを探します.
+    //!
+    //! @param [in]     track       トラック番号.
+    //! @param [in]     time        時刻.
+    //! @param [in,out] key         直前のキー番号. 探索結果で更新されます.
+    //! @return     補間係数を返却します.
+    //---------------------------------------------------------------------------------------------
+    float Seek( size_t track, float time, uint32_t& key ) const;
+};
+
+} // namespace asvk
@@ -0,0 +1,134 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkBroadphase.h
+// Desc : Broadphase Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkMath.h>
+#include <asvkGeometry.h>
+#include <asvkAllocator.h>
+#include <vector>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OverlapPair structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct OverlapPair
+{
+    uint32_t    a;      //!< 小さい方の物体の番号(FindPairs() に渡した配列の添え字)です.
+    uint32_t    b;      //!< 大きい方の物体の番号です.
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Broadphase class
+// 全ての物体の組から重なるものを求める, Sweep and Prune によるブロードフェーズです.
+// 中心の分散が最も大きい軸で区間の始点を並べ, 区間が重なる物体だけを残りの軸と形状で判定します.
+// 前回の並び順を保持しておき, 物体が少しずつ動く場合は挿入ソートでほぼ線形時間で並べ直します.
+// 組の検索は並びを固定数に分割して並列に行い, 分割の順に連結するため結果はスレッド数に依存しません.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class Broadphase
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables
+    //=============================================================================================
+    /* NOTHING */
+
+    //=============================================================================================
+    // public methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    Broadphase();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~Broadphase();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      重なるバウンディングスフィアの組を求めます.
+    //!
+    //! @param [in]     pSpheres    バウンディングスフィアの配列.
+    //! @param [in]     count       バウンディングスフィアの数.
+    //! @param [out]    pairs       重なる組の格納先. 以前の内容は破棄します.
+    //! @return     重なる組の数を返却します.
+    //! @note       BoundingSphere::Contains( const BoundingSphere& ) が true になる組を求めます.
+    //!             組の順序は入力だけで決まり, スレッド数や前回の呼び出しには依存しません.
+    //!             NaN を含む球と半径が負の球はどの物体とも重ならないものとします.
+    //---------------------------------------------------------------------------------------------
+    size_t FindPairs( const BoundingSphere* pSpheres, size_t count, std::vector<OverlapPair>& pairs );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      重なるバウンディングボックスの組を求めます.
+    //!
+    //! @param [in]     pBoxes      バウンディングボックスの配列.
+    //! @param [in]     count       バウンディングボックスの数.
+    //! @param [out]    pairs       重なる組の格納先. 以前の内容は破棄します.
+    //! @return     重なる組の数を返却します.
+    //! @note       BoundingBox::Contains( const BoundingBox& ) が true になる組を求めます.
+    //!             組の順序は入力だけで決まり, スレッド数や前回の呼び出しには依存しません.
+    //!             NaN を含む箱と最小値が最大値を超える箱はどの物体とも重ならないものとします.
+    //---------------------------------------------------------------------------------------------
+    size_t FindPairs( const BoundingBox* pBoxes, size_t count, std::vector<OverlapPair>& pairs );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      保持している並び順を破棄します.
+    //!
+    //! @note       次の FindPairs() は並べ直しを全て行います. 結果は変わりません.
+    //---------------------------------------------------------------------------------------------
+    void Reset();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      直前の FindPairs() で区間を並べた軸を取得します.
+    //!
+    //! @return     0 : X軸, 1 : Y軸, 2 : Z軸 を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetAxis() const;
+
+private:
+    //=============================================================================================
+    // private variables
+    //=============================================================================================
+    std::vector<uint64_t>                   m_Keys;         //!< 始点の順序を表すビット列を上位に, 物体の番号を下位に持つ並べ替えのキーです.
+    std::vector<float, AlignedAllocator<float, 32>> m_Mini[3];  //!< 並べた順の区間の始点です([0] が並べた軸. 末尾は NaN で埋めます).
+    std::vector<float, AlignedAllocator<float, 32>> m_Maxi[3];  //!< 並べた順の区間の終点です.
+    std::vector<uint32_t>                   m_Index;        //!< 並べた順の物体の番号です.
+    std::vector<std::vector<OverlapPair>>   m_Chunks;       //!< 分割ごとの重なる組です.
+    size_t                                  m_Count;        //!< 前回の物体数です.
+    uint32_t                                m_Axis;         //!< 区間を並べた軸です.
+
+    //=============================================================================================
+    // private methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      区間を並べ, 重なる組を求めます.
+    //!
+    //! @note       getBounds は bool( size_t index, float* pMini, float* pMaxi ) の形式で, 物体の各軸の区間を返し, 空の区間や NaN を含む場合は false を返します.
+    //!             narrowTest は bool( uint32_t a, uint32_t b ) の形式で, 区間が重なる組の形状を判定します.
+    //---------------------------------------------------------------------------------------------
+    template<typename GetBounds, typename NarrowTest>
+    size_t Sweep(
+        size_t                      count,
+        GetBounds&&                 getBounds,
+        NarrowTest&&                narrowTest,
+        std::vector<OverlapPair>&   pairs );
+};
+
+} // namespace asvk
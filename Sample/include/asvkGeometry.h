@@ -21,9 +21,24 @@ namespace asvk {
 struct Ray;
 struct BoundingBox;
 struct BoundingSphere;
+struct Triangle;
+struct RayPacket4;
+struct RayPacket8;
+class  ViewFrustum;
 class  Frustum;
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Containment enum
+///////////////////////////////////////////////////////////////////////////////////////////////////
+enum class Containment : uint32_t
+{
+    Outside = 0,        //!< 完全に外側にあります.
+    Intersect,          //!< 境界と交差しています.
+    Inside,             //!< 完全に内側にあります.
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Ray structure
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -118,7 +133,7 @@ struct BoundingBox
     //! @retval true    ボックス内です.
     //! @retval false   ボックス外です.
     //---------------------------------------------------------------------------------------------
-    bool Contains( const Vector3* pVertices, const u32 count ) const;
+    bool Contains( const Vector3* pVertices, const uint32_t count ) const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      バウンディングスフィアを含むか判定します.
@@ -145,6 +160,17 @@ struct BoundingBox
     //---------------------------------------------------------------------------------------------
     void Merge( const Vector3& value );
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レイと交差するか判定します.
+    //!
+    //! @param[in]      ray         判定するレイです.
+    //! @param[in]      maxDistance 判定する最大距離です(レイの方向ベクトルの長さを単位とします).
+    //! @param[out]     distance    交差区間の始点までの距離です. レイの始点が内側にある場合は0になります.
+    //! @retval true    [0, maxDistance] の範囲で交差します.
+    //! @retval false   交差しません.
+    //---------------------------------------------------------------------------------------------
+    bool Intersects( const Ray& ray, float maxDistance, float& distance ) const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      マージします.
     //!
@@ -208,7 +234,7 @@ struct BoundingSphere
     //! @retval true    スフィア内です.
     //! @retval false   スフィア外です.
     //---------------------------------------------------------------------------------------------
-    bool Contains( const Vector3* pVertices, const u32 count ) const;
+    bool Contains( const Vector3* pVertices, const uint32_t count ) const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      バウンディングボックスを含むか判定します.
@@ -239,6 +265,182 @@ struct BoundingSphere
 };
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Triangle structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct Triangle
+{
+    Vector3   v0;         //!< 頂点0です.
+    Vector3   v1;         //!< 頂点1です.
+    Vector3   v2;         //!< 頂点2です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    Triangle();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param[in]      _v0         頂点0です.
+    //! @param[in]      _v1         頂点1です.
+    //! @param[in]      _v2         頂点2です.
+    //---------------------------------------------------------------------------------------------
+    Triangle( const Vector3& _v0, const Vector3& _v1, const Vector3& _v2 );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コピーコンストラクタです.
+    //!
+    //! @param[in]      value       コピー元の値です.
+    //---------------------------------------------------------------------------------------------
+    Triangle( const Triangle& value );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レイと交差するか判定します. 裏面も交差として扱います.
+    //!
+    //! @param[in]      ray         判定するレイです.
+    //! @param[in]      maxDistance 判定する最大距離です(レイの方向ベクトルの長さを単位とします).
+    //! @param[out]     distance    交差点までの距離です.
+    //! @retval true    [0, maxDistance] の範囲で交差します.
+    //! @retval false   交差しません.
+    //---------------------------------------------------------------------------------------------
+    bool Intersects( const Ray& ray, float maxDistance, float& distance ) const;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RayPacket4 structure
+// 4本のレイを成分ごとの配列(SoA)にまとめたものです. SSE2 で4本同時に判定します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct RayPacket4
+{
+    static constexpr uint32_t WIDTH = 4;    //!< レイの本数です.
+
+    float       posX   [WIDTH];     //!< 位置座標のX成分です.
+    float       posY   [WIDTH];     //!< 位置座標のY成分です.
+    float       posZ   [WIDTH];     //!< 位置座標のZ成分です.
+    float       dirX   [WIDTH];     //!< 方向ベクトルのX成分です.
+    float       dirY   [WIDTH];     //!< 方向ベクトルのY成分です.
+    float       dirZ   [WIDTH];     //!< 方向ベクトルのZ成分です.
+    float       invDirX[WIDTH];     //!< 方向ベクトルの逆数のX成分です.
+    float       invDirY[WIDTH];     //!< 方向ベクトルの逆数のY成分です.
+    float       invDirZ[WIDTH];     //!< 方向ベクトルの逆数のZ成分です.
+    uint32_t    signX  [WIDTH];     //!< X方向が負の場合は全ビットが1になります.
+    uint32_t    signY  [WIDTH];     //!< Y方向が負の場合は全ビットが1になります.
+    uint32_t    signZ  [WIDTH];     //!< Z方向が負の場合は全ビットが1になります.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです. 全ての成分を0で初期化します.
+    //---------------------------------------------------------------------------------------------
+    RayPacket4();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レイを設定します.
+    //!
+    //! @param[in]      lane        設定するレーン番号です.
+    //! @param[in]      ray         設定するレイです.
+    //---------------------------------------------------------------------------------------------
+    void Set( uint32_t lane, const Ray& ray );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レイを取得します.
+    //!
+    //! @param[in]      lane        取得するレーン番号です.
+    //! @return     指定レーンのレイを返却します. 方向ベクトルの逆数と符号は Set() で設定した値をそのまま使います.
+    //---------------------------------------------------------------------------------------------
+    Ray GetRay( uint32_t lane ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バウンディングボックスと交差するか判定します.
+    //!
+    //! @param[in]      box             判定するバウンディングボックスです.
+    //! @param[in]      pMaxDistance    レーンごとの判定する最大距離です(WIDTH 個). 負の値のレーンは交差しません.
+    //! @param[out]     pDistance       レーンごとの交差区間の始点までの距離です(WIDTH 個).
+    //! @return     交差したレーンのビットを立てたマスクを返却します.
+    //!             各レーンの結果は BoundingBox::Intersects() と一致します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Intersects( const BoundingBox& box, const float* pMaxDistance, float* pDistance ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      三角形と交差するか判定します.
+    //!
+    //! @param[in]      triangle        判定する三角形です.
+    //! @param[in]      pMaxDistance    レーンごとの判定する最大距離です(WIDTH 個). 負の値のレーンは交差しません.
+    //! @param[out]     pDistance       レーンごとの交差点までの距離です(WIDTH 個). 交差したレーンのみ有効です.
+    //! @return     交差したレーンのビットを立てたマスクを返却します.
+    //!             各レーンの結果は Triangle::Intersects() と一致します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Intersects( const Triangle& triangle, const float* pMaxDistance, float* pDistance ) const;
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RayPacket8 structure
+// 8本のレイを成分ごとの配列(SoA)にまとめたものです.
+// AVX 有効時は8本同時に, それ以外は4本ずつ判定します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct RayPacket8
+{
+    static constexpr uint32_t WIDTH = 8;    //!< レイの本数です.
+
+    float       posX   [WIDTH];     //!< 位置座標のX成分です.
+    float       posY   [WIDTH];     //!< 位置座標のY成分です.
+    float       posZ   [WIDTH];     //!< 位置座標のZ成分です.
+    float       dirX   [WIDTH];     //!< 方向ベクトルのX成分です.
+    float       dirY   [WIDTH];     //!< 方向ベクトルのY成分です.
+    float       dirZ   [WIDTH];     //!< 方向ベクトルのZ成分です.
+    float       invDirX[WIDTH];     //!< 方向ベクトルの逆数のX成分です.
+    float       invDirY[WIDTH];     //!< 方向ベクトルの逆数のY成分です.
+    float       invDirZ[WIDTH];     //!< 方向ベクトルの逆数のZ成分です.
+    uint32_t    signX  [WIDTH];     //!< X方向が負の場合は全ビットが1になります.
+    uint32_t    signY  [WIDTH];     //!< Y方向が負の場合は全ビットが1になります.
+    uint32_t    signZ  [WIDTH];     //!< Z方向が負の場合は全ビットが1になります.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです. 全ての成分を0で初期化します.
+    //---------------------------------------------------------------------------------------------
+    RayPacket8();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レイを設定します.
+    //!
+    //! @param[in]      lane        設定するレーン番号です.
+    //! @param[in]      ray         設定するレイです.
+    //---------------------------------------------------------------------------------------------
+    void Set( uint32_t lane, const Ray& ray );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      レイを取得します.
+    //!
+    //! @param[in]      lane        取得するレーン番号です.
+    //! @return     指定レーンのレイを返却します. 方向ベクトルの逆数と符号は Set() で設定した値をそのまま使います.
+    //---------------------------------------------------------------------------------------------
+    Ray GetRay( uint32_t lane ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バウンディングボックスと交差するか判定します.
+    //!
+    //! @param[in]      box             判定するバウンディングボックスです.
+    //! @param[in]      pMaxDistance    レーンごとの判定する最大距離です(WIDTH 個). 負の値のレーンは交差しません.
+    //! @param[out]     pDistance       レーンごとの交差区間の始点までの距離です(WIDTH 個).
+    //! @return     交差したレーンのビットを立てたマスクを返却します.
+    //!             各レーンの結果は BoundingBox::Intersects() と一致します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Intersects( const BoundingBox& box, const float* pMaxDistance, float* pDistance ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      三角形と交差するか判定します.
+    //!
+    //! @param[in]      triangle        判定する三角形です.
+    //! @param[in]      pMaxDistance    レーンごとの判定する最大距離です(WIDTH 個). 負の値のレーンは交差しません.
+    //! @param[out]     pDistance       レーンごとの交差点までの距離です(WIDTH 個). 交差したレーンのみ有効です.
+    //! @return     交差したレーンのビットを立てたマスクを返却します.
+    //!             各レーンの結果は Triangle::Intersects() と一致します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Intersects( const Triangle& triangle, const float* pMaxDistance, float* pDistance ) const;
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // ViewFrustum
 // ※ Game Programing Gems 5. "Improved Frustum Culling", pp.65-77 を参照.
@@ -334,7 +536,7 @@ public:
     //! @retval true    錐台内です.
     //! @retval fasle   錐台外です.
     //---------------------------------------------------------------------------------------------
-    bool Contains( const Vector3* pVertices, const u32 count ) const;
+    bool Contains( const Vector3* pVertices, const uint32_t count ) const;
 
     //---------------------------------------------------------------------------------------------
     //! @brief      バウンディングスフィアを含むか判定します.
@@ -354,6 +556,49 @@ public:
     //---------------------------------------------------------------------------------------------
     bool Contains( const BoundingBox& box ) const;
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      複数のバウンディングスフィアをまとめて判定します.
+    //!
+    //! @param[in]      pCenterX        中心のX座標の配列です.
+    //! @param[in]      pCenterY        中心のY座標の配列です.
+    //! @param[in]      pCenterZ        中心のZ座標の配列です.
+    //! @param[in]      pRadius         半径の配列です.
+    //! @param[in]      count           要素数です.
+    //! @param[out]     pVisibleMask    判定結果の格納先です. 要素 i の結果を pVisibleMask[i / 32] のビット (i % 32) に格納します.
+    //!                                 (count + 31) / 32 個の要素が必要です.
+    //! @note       結果は Contains( const BoundingSphere& ) とビット単位で一致します.
+    //---------------------------------------------------------------------------------------------
+    void CullSpheres(
+        const float*    pCenterX,
+        const float*    pCenterY,
+        const float*    pCenterZ,
+        const float*    pRadius,
+        size_t          count,
+        uint32_t*       pVisibleMask ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      複数のバウンディングボックスをまとめて判定します.
+    //!
+    //! @param[in]      pMinX           最小値のX座標の配列です.
+    //! @param[in]      pMinY           最小値のY座標の配列です.
+    //! @param[in]      pMinZ           最小値のZ座標の配列です.
+    //! @param[in]      pMaxX           最大値のX座標の配列です.
+    //! @param[in]      pMaxY           最大値のY座標の配列です.
+    //! @param[in]      pMaxZ           最大値のZ座標の配列です.
+    //! @param[in]      count           要素数です.
+    //! @param[out]     pVisibleMask    判定結果の格納先です. 形式は CullSpheres() と同じです.
+    //! @note       結果は Contains( const BoundingBox& ) とビット単位で一致します.
+    //---------------------------------------------------------------------------------------------
+    void CullBoxes(
+        const float*    pMinX,
+        const float*    pMinY,
+        const float*    pMinZ,
+        const float*    pMaxX,
+        const float*    pMaxY,
+        const float*    pMaxZ,
+        size_t          count,
+        uint32_t*       pVisibleMask ) const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      8角の頂点を取得します.
     //!
@@ -371,10 +616,138 @@ private:
     Vector3 m_Upward;       //!< 基底ベクトル(上)
     float     m_FactorR;      //!< rFactor
     float     m_FactorU;      //!< uFactor
+    float     m_SphereFactorR;    //!< 球判定用の sqrt( 1 + rFactor^2 )
+    float     m_SphereFactorU;    //!< 球判定用の sqrt( 1 + uFactor^2 )
     float     m_NearClip;     //!< ニアクリップ平面までの距離.
     float     m_FarClip;      //!< ファークリップ平面までの距離.
 };
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Frustum class
+// ビュー射影行列から抽出した6平面で表す錐台です.
+// 正射影やオフセンターの射影行列も扱えます. 平面の法線は内側を向いています.
+// ※ Gribb, Hartmann. "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix" を参照.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class Frustum
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables.
+    //=============================================================================================
+    static constexpr uint32_t PLANE_LEFT    = 0;        //!< 左平面の番号です.
+    static constexpr uint32_t PLANE_RIGHT   = 1;        //!< 右平面の番号です.
+    static constexpr uint32_t PLANE_BOTTOM  = 2;        //!< 下平面の番号です.
+    static constexpr uint32_t PLANE_TOP     = 3;        //!< 上平面の番号です.
+    static constexpr uint32_t PLANE_NEAR    = 4;        //!< 近平面の番号です.
+    static constexpr uint32_t PLANE_FAR     = 5;        //!< 遠平面の番号です.
+    static constexpr uint32_t PLANE_COUNT   = 6;        //!< 平面の数です.
+    static constexpr uint32_t ALL_PLANES    = 0x3f;     //!< 全平面を判定対象とするマスクです.
+
+    //=============================================================================================
+    // public methods.
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    Frustum();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param[in]      viewProjection  ビュー行列と射影行列を乗算した行列です.
+    //---------------------------------------------------------------------------------------------
+    explicit Frustum( const Matrix& viewProjection );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      行列から6平面を抽出します.
+    //!
+    //! @param[in]      viewProjection  ビュー行列と射影行列を乗算した行列です.
+    //!                                 クリップ空間の深度は Matrix::CreatePerspectiveFieldOfView() などと同じく [0, 1] とします.
+    //! @note       遠平面が無限遠の射影行列のように法線が0となる平面は判定から除外します.
+    //---------------------------------------------------------------------------------------------
+    void SetMatrix( const Matrix& viewProjection );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      平面を取得します.
+    //!
+    //! @param[in]      index       平面番号(PLANE_LEFT ～ PLANE_FAR)です.
+    //! @return     正規化された平面方程式 (x, y, z) = 法線, w = 距離 を返却します.
+    //---------------------------------------------------------------------------------------------
+    Vector4 GetPlane( uint32_t index ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バウンディングスフィアとの包含関係を判定します.
+    //!
+    //! @param[in]      sphere      判定するバウンディングスフィアです.
+    //! @return     包含関係を返却します.
+    //---------------------------------------------------------------------------------------------
+    Containment Classify( const BoundingSphere& sphere ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      判定する平面を限定して，バウンディングスフィアとの包含関係を判定します.
+    //!
+    //! @param[in]      sphere      判定するバウンディングスフィアです.
+    //! @param[in,out]  planeMask   判定する平面のビットマスクです. 完全に内側にある平面のビットを落として返却します.
+    //!                             親が内側にある平面を子の判定から除外する階層カリングに使用します.
+    //! @return     包含関係を返却します. planeMask に含まれない平面は内側にあるものとして扱います.
+    //---------------------------------------------------------------------------------------------
+    Containment Classify( const BoundingSphere& sphere, uint32_t& planeMask ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バウンディングボックスとの包含関係を判定します.
+    //!
+    //! @param[in]      box         判定するバウンディングボックスです.
+    //! @return     包含関係を返却します.
+    //---------------------------------------------------------------------------------------------
+    Containment Classify( const BoundingBox& box ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      判定する平面を限定して，バウンディングボックスとの包含関係を判定します.
+    //!
+    //! @param[in]      box         判定するバウンディングボックスです.
+    //! @param[in,out]  planeMask   判定する平面のビットマスクです. 完全に内側にある平面のビットを落として返却します.
+    //! @return     包含関係を返却します. planeMask に含まれない平面は内側にあるものとして扱います.
+    //---------------------------------------------------------------------------------------------
+    Containment Classify( const BoundingBox& box, uint32_t& planeMask ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バウンディングスフィアの一部でも含むか判定します.
+    //!
+    //! @param[in]      sphere      判定するバウンディングスフィアです.
+    //! @retval true    錐台内です.
+    //! @retval false   錐台外です.
+    //---------------------------------------------------------------------------------------------
+    bool Contains( const BoundingSphere& sphere ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バウンディングボックスの一部でも含むか判定します.
+    //!
+    //! @param[in]      box         判定するバウンディングボックスです.
+    //! @retval true    錐台内です.
+    //! @retval false   錐台外です.
+    //---------------------------------------------------------------------------------------------
+    bool Contains( const BoundingBox& box ) const;
+
+private:
+    //=============================================================================================
+    // private variables.
+    //=============================================================================================
+    static constexpr uint32_t PADDED_COUNT = 8;     //!< SIMD判定用に詰めた平面数です.
+
+    float   m_NormalX  [PADDED_COUNT];   //!< 平面の法線のX成分です(6, 7番目は0, 1番目の複製).
+    float   m_NormalY  [PADDED_COUNT];   //!< 平面の法線のY成分です.
+    float   m_NormalZ  [PADDED_COUNT];   //!< 平面の法線のZ成分です.
+    float   m_Distance [PADDED_COUNT];   //!< 平面の原点からの距離です.
+    uint32_t m_PlaneMask;                //!< 判定に使う平面のビットマスクです(法線が0の平面を除きます).
+};
+
 }// namespace asvk
 
 
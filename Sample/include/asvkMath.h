@@ -14,6 +14,15 @@
 #include <cassert>
 #include <cstring>
 #include <climits>
+#include <type_traits>
+
+#if ASVK_IS_SIMD
+    #if ASVK_IS_AVX
+        #include <immintrin.h>
+    #else
+        #include <emmintrin.h>
+    #endif//ASVK_IS_AVX
+#endif//ASVK_IS_SIMD
 
 
 namespace asvk {
@@ -24,8 +33,12 @@ namespace asvk {
 struct Vector2;
 struct Vector3;
 struct Vector4;
+struct Vector3x4;
+struct Vector3x8;
 struct Matrix;
+struct Matrix3x4;
 struct Quaternion;
+struct DualQuaternion;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -50,6 +63,7 @@ static constexpr double D_PIDIV6  = 0.52359877559829887307710723054658;     //!<
 static constexpr double D_EPSILON = 2.2204460492503131e-016;                //!< マシンイプシロン(double)
 
 static constexpr float ONB_EPSILON = 0.01f;                                //!< 正規直交規定を算出する際に用いるイプシロン値です.
+static constexpr float RIGID_EPSILON = 1e-5f;                              //!< 剛体変換かどうかを判定する際に用いるイプシロン値です.
 
 
 //--------------------------------------------------------------------------------------------------
@@ -220,7 +234,7 @@ double     Hypot( double x, double y, double z, double w );
 //! @param [in]     number      階乗を計算する値.
 //! @return     (number)!を計算した値を返却します.
 //--------------------------------------------------------------------------------------------------
-uint32_t     Fact( uint32_t number );
+constexpr uint32_t     Fact( uint32_t number );
 
 //--------------------------------------------------------------------------------------------------
 //! @brief      2重階乗を計算します.
@@ -228,7 +242,7 @@ uint32_t     Fact( uint32_t number );
 //! @param [in]     number      2重階乗を計算する値.
 //! @return     (number)!!を計算した値を返却します.
 //--------------------------------------------------------------------------------------------------
-uint32_t     DblFact( uint32_t number );
+constexpr uint32_t     DblFact( uint32_t number );
 
 //--------------------------------------------------------------------------------------------------
 //! @brief      順列を計算します.
@@ -237,7 +251,7 @@ uint32_t     DblFact( uint32_t number );
 //! @param [in]     r       選択数.
 //! @return     n個のものからr個とった順列を返却します.
 //--------------------------------------------------------------------------------------------------
-uint32_t     Perm( uint32_t n, uint32_t r );
+constexpr uint32_t     Perm( uint32_t n, uint32_t r );
 
 //--------------------------------------------------------------------------------------------------
 //! @brief      組合せを計算します.
@@ -246,7 +260,7 @@ uint32_t     Perm( uint32_t n, uint32_t r );
 //! @param [in]     r       選択数.
 //! @return     n個のものからr個とった組合せを返却します.
 //--------------------------------------------------------------------------------------------------
-uint32_t     Comb( uint32_t n, uint32_t r );
+constexpr uint32_t     Comb( uint32_t n, uint32_t r );
 
 //--------------------------------------------------------------------------------------------------
 //! @brief      float型からhalf型に変換します.
@@ -264,6 +278,161 @@ half     F32ToF16( float value );
 //--------------------------------------------------------------------------------------------------
 float     F16ToF32( half value );
 
+//--------------------------------------------------------------------------------------------------
+//! @brief      float型の配列をまとめてhalf型に変換します.
+//!
+//! @param [in]     pValues     変換するfloat型の配列.
+//! @param [out]    pResults    変換結果を格納するhalf型の配列.
+//! @param [in]     count       変換する要素数.
+//! @note       結果はF32ToF16()と一致します(F16C有効時はF16C命令，SIMD有効時はSSE2で処理します).
+//--------------------------------------------------------------------------------------------------
+void     F32ToF16( const float* pValues, half* pResults, size_t count );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      half型の配列をまとめてfloat型に変換します.
+//!
+//! @param [in]     pValues     変換するhalf型の配列.
+//! @param [out]    pResults    変換結果を格納するfloat型の配列.
+//! @param [in]     count       変換する要素数.
+//! @note       結果はF16ToF32()と一致します(F16C有効時はF16C命令，SIMD有効時はSSE2で処理します).
+//--------------------------------------------------------------------------------------------------
+void     F16ToF32( const half* pValues, float* pResults, size_t count );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      単位ベクトルを八面体写像で2x16bit (R16G16_SNORM) に符号化します.
+//!
+//! @param [in]     value       符号化する単位ベクトル.
+//! @return     下位16bitにX，上位16bitにYを格納した値を返却します.
+//! @note       復号後の角度誤差は最大0.004度程度です.
+//--------------------------------------------------------------------------------------------------
+uint32_t    EncodeOctahedral16( const Vector3& value );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      2x16bit の八面体写像から単位ベクトルを復号します.
+//!
+//! @param [in]     value       EncodeOctahedral16() で符号化した値.
+//! @return     正規化済みのベクトルを返却します.
+//--------------------------------------------------------------------------------------------------
+Vector3     DecodeOctahedral16( uint32_t value );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      単位ベクトルを八面体写像で2x8bit (R8G8_SNORM) に符号化します.
+//!
+//! @param [in]     value       符号化する単位ベクトル.
+//! @return     下位8bitにX，上位8bitにYを格納した値を返却します.
+//! @note       復号後の角度誤差は最大1度程度です.
+//--------------------------------------------------------------------------------------------------
+uint16_t    EncodeOctahedral8( const Vector3& value );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      2x8bit の八面体写像から単位ベクトルを復号します.
+//!
+//! @param [in]     value       EncodeOctahedral8() で符号化した値.
+//! @return     正規化済みのベクトルを返却します.
+//--------------------------------------------------------------------------------------------------
+Vector3     DecodeOctahedral8( uint16_t value );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      接線空間を表す回転を32bitに符号化します(QTangent).
+//!
+//! @param [in]     rotation        接線空間の回転(X軸が接線，Z軸が法線に対応する単位四元数).
+//! @param [in]     handedness      従接線の向き(負の場合に反転).
+//! @return     最大成分を除く3成分(各9bit)，最大成分の番号(2bit)，反転フラグ(1bit)を
+//!             下位から順に格納した値を返却します.
+//! @note       復号後の法線・接線の角度誤差は最大0.5度程度です.
+//--------------------------------------------------------------------------------------------------
+uint32_t    EncodeQTangent( const Quaternion& rotation, float handedness );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      法線と接線を32bitに符号化します(QTangent).
+//!
+//! @param [in]     normal      単位法線ベクトル.
+//! @param [in]     tangent     単位接線ベクトル(wに従接線の向きとして+1または-1を格納).
+//! @return     符号化した値を返却します.
+//! @note       接線は法線に直交化してから符号化します.
+//--------------------------------------------------------------------------------------------------
+uint32_t    EncodeQTangent( const Vector3& normal, const Vector4& tangent );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      QTangent から接線空間の回転を復号します.
+//!
+//! @param [in]     value           EncodeQTangent() で符号化した値.
+//! @param [out]    rotation        接線空間の回転.
+//! @param [out]    handedness      従接線の向き(+1または-1).
+//--------------------------------------------------------------------------------------------------
+void        DecodeQTangent( uint32_t value, Quaternion& rotation, float& handedness );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      QTangent から法線と接線を復号します.
+//!
+//! @param [in]     value       EncodeQTangent() で符号化した値.
+//! @param [out]    normal      法線ベクトル.
+//! @param [out]    tangent     接線ベクトル(wに従接線の向きを格納).
+//--------------------------------------------------------------------------------------------------
+void        DecodeQTangent( uint32_t value, Vector3& normal, Vector4& tangent );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      単位ベクトルの配列をまとめて2x16bitの八面体写像に符号化します.
+//!
+//! @param [in]     pValues     符号化する単位ベクトルの配列.
+//! @param [out]    pResults    符号化結果を格納する配列.
+//! @param [in]     count       要素数.
+//! @note       結果はEncodeOctahedral16()と一致します.
+//--------------------------------------------------------------------------------------------------
+void        EncodeOctahedral16( const Vector3* pValues, uint32_t* pResults, size_t count );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      2x16bitの八面体写像の配列をまとめて単位ベクトルに復号します.
+//!
+//! @param [in]     pValues     復号する値の配列.
+//! @param [out]    pResults    復号結果を格納する配列.
+//! @param [in]     count       要素数.
+//! @note       結果はDecodeOctahedral16()と一致します.
+//--------------------------------------------------------------------------------------------------
+void        DecodeOctahedral16( const uint32_t* pValues, Vector3* pResults, size_t count );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      単位ベクトルの配列をまとめて2x8bitの八面体写像に符号化します.
+//!
+//! @param [in]     pValues     符号化する単位ベクトルの配列.
+//! @param [out]    pResults    符号化結果を格納する配列.
+//! @param [in]     count       要素数.
+//! @note       結果はEncodeOctahedral8()と一致します.
+//--------------------------------------------------------------------------------------------------
+void        EncodeOctahedral8( const Vector3* pValues, uint16_t* pResults, size_t count );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      2x8bitの八面体写像の配列をまとめて単位ベクトルに復号します.
+//!
+//! @param [in]     pValues     復号する値の配列.
+//! @param [out]    pResults    復号結果を格納する配列.
+//! @param [in]     count       要素数.
+//! @note       結果はDecodeOctahedral8()と一致します.
+//--------------------------------------------------------------------------------------------------
+void        DecodeOctahedral8( const uint16_t* pValues, Vector3* pResults, size_t count );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      接線空間の回転の配列をまとめてQTangentに符号化します.
+//!
+//! @param [in]     pRotations      接線空間の回転の配列.
+//! @param [in]     pHandedness     従接線の向きの配列.
+//! @param [out]    pResults        符号化結果を格納する配列.
+//! @param [in]     count           要素数.
+//! @note       結果はEncodeQTangent()と一致します.
+//--------------------------------------------------------------------------------------------------
+void        EncodeQTangent( const Quaternion* pRotations, const float* pHandedness, uint32_t* pResults, size_t count );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      QTangentの配列をまとめて接線空間の回転に復号します.
+//!
+//! @param [in]     pValues         復号する値の配列.
+//! @param [out]    pRotations      接線空間の回転を格納する配列.
+//! @param [out]    pHandedness     従接線の向きを格納する配列.
+//! @param [in]     count           要素数.
+//! @note       結果はDecodeQTangent()と一致します.
+//--------------------------------------------------------------------------------------------------
+void        DecodeQTangent( const uint32_t* pValues, Quaternion* pRotations, float* pHandedness, size_t count );
+
 //--------------------------------------------------------------------------------------------------
 //! @brief      線形補間を行います.
 //!
@@ -284,6 +453,45 @@ constexpr float     Lerp( float a, float b, float amount ) noexcept;
 //--------------------------------------------------------------------------------------------------
 constexpr double     Lerp( double a, double b, double amount ) noexcept;
 
+//--------------------------------------------------------------------------------------------------
+//! @brief      正弦と余弦を同時に求めます.
+//!
+//! @param [in]     radian      角度(ラジアン).
+//! @param [out]    s           正弦.
+//! @param [out]    c           余弦.
+//--------------------------------------------------------------------------------------------------
+void    SinCos( float radian, float& s, float& c );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      正弦と余弦を多項式近似で同時に求めます.
+//!
+//! @param [in]     radian      角度(ラジアン). |radian| <= 1e5 であること.
+//! @param [out]    s           正弦.
+//! @param [out]    c           余弦.
+//! @note       最大絶対誤差は |radian| <= π で 3e-7，|radian| <= 1e5 で 2e-6 です.
+//--------------------------------------------------------------------------------------------------
+void    SinCosFast( float radian, float& s, float& c );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      逆平方根を近似計算します.
+//!
+//! @param [in]     value       入力値 (正規化数であること).
+//! @return     1/sqrt(value)の近似値を返却します.
+//! @note       最大相対誤差は SIMD有効時 5e-7，無効時 5e-6 です.
+//!             非正規化数, 0, 無限大では結果は不定です(SIMD有効時は -inf または NaN になります).
+//--------------------------------------------------------------------------------------------------
+float   RsqrtFast( float value );
+
+//--------------------------------------------------------------------------------------------------
+//! @brief      逆正接を多項式近似で求めます.
+//!
+//! @param [in]     y           Y成分.
+//! @param [in]     x           X成分.
+//! @return     atan2(y, x)の近似値を返却します. x, y が共に0の場合は0を返却します.
+//! @note       最大絶対誤差は 5e-7 ラジアンです. atan2 と同様に y = -0, x < 0 では -π を返却します.
+//--------------------------------------------------------------------------------------------------
+float   Atan2Fast( float y, float x );
+
 //--------------------------------------------------------------------------------------------------
 //! @brief      2つの値のうち，大きい方を返却します.
 //!
@@ -371,7 +579,7 @@ public:
     //----------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //----------------------------------------------------------------------------------------------
-    Vector2();
+    Vector2() = default;
 
     //----------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -386,7 +594,7 @@ public:
     //! @param [in]     nx           X成分.
     //! @param [in]     ny           Y成分.
     //----------------------------------------------------------------------------------------------
-    Vector2( float nx, float ny );
+    constexpr Vector2( float nx, float ny );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      float*型への演算子です.
@@ -969,7 +1177,7 @@ public:
     //----------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //----------------------------------------------------------------------------------------------
-    Vector3();
+    Vector3() = default;
 
     //----------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -984,7 +1192,7 @@ public:
     //! @param [in]     value       2次元ベクトル.
     //! @param [in]     nz          Z成分.
     //----------------------------------------------------------------------------------------------
-    Vector3( const Vector2& value, float nz );
+    constexpr Vector3( const Vector2& value, float nz );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -993,7 +1201,7 @@ public:
     //! @param [in]     ny           Y成分.
     //! @param [in]     nz           Z成分.
     //----------------------------------------------------------------------------------------------
-    Vector3( float nx, float ny, float nz );
+    constexpr Vector3( float nx, float ny, float nz );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      float*型への演算子です.
@@ -1140,6 +1348,14 @@ public:
     //----------------------------------------------------------------------------------------------
     Vector3&        SafeNormalize   ( const Vector3& );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      逆平方根の近似を用いてベクトルを正規化します.
+    //!
+    //! @return     正規化したベクトルを返却します.
+    //! @note       各成分の最大誤差はRsqrtFast()の相対誤差程度です.
+    //----------------------------------------------------------------------------------------------
+    Vector3&        NormalizeFast   ();
+
 
     //----------------------------------------------------------------------------------------------
     //! @brief      各成分の絶対値を求めます.
@@ -1300,6 +1516,23 @@ public:
     //----------------------------------------------------------------------------------------------
     static void     SafeNormalize( const Vector3& value, const Vector3& set, Vector3& result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      逆平方根の近似を用いてベクトルを正規化します.
+    //!
+    //! @param [in]     value       正規化するベクトル.
+    //! @return     正規化したベクトルを返却します.
+    //! @note       各成分の最大誤差はRsqrtFast()の相対誤差程度です.
+    //----------------------------------------------------------------------------------------------
+    static Vector3  NormalizeFast( const Vector3& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      逆平方根の近似を用いてベクトルを正規化します.
+    //!
+    //! @param [in]     value       正規化するベクトル.
+    //! @param [out]    result      正規化したベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void     NormalizeFast( const Vector3& value, Vector3& result );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      三角形の法線ベクトルを求めます.
     //!
@@ -1600,6 +1833,36 @@ public:
     //----------------------------------------------------------------------------------------------
     static void    TransformCoord( const Vector3& coord, const Matrix& matrix, Vector3& result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，複数のベクトルをまとめて変換します.
+    //!
+    //! @param [in]     pPositions  入力ベクトル配列.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pResults    変換後ベクトルの格納先 (pPositionsと同じ配列を指定可能).
+    //! @param [in]     count       要素数.
+    //----------------------------------------------------------------------------------------------
+    static void    Transform( const Vector3* pPositions, const Matrix& matrix, Vector3* pResults, size_t count );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，複数の法線ベクトルをまとめて変換します.
+    //!
+    //! @param [in]     pNormals    入力法線ベクトル配列.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pResults    変換後法線ベクトルの格納先 (pNormalsと同じ配列を指定可能).
+    //! @param [in]     count       要素数.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformNormal( const Vector3* pNormals, const Matrix& matrix, Vector3* pResults, size_t count );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて複数のベクトルをまとめて変換し，変換結果をw=1に射影します.
+    //!
+    //! @param [in]     pCoords     入力ベクトル配列.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pResults    変換後ベクトルの格納先 (pCoordsと同じ配列を指定可能).
+    //! @param [in]     count       要素数.
+    //----------------------------------------------------------------------------------------------
+    static void    TransformCoord( const Vector3* pCoords, const Matrix& matrix, Vector3* pResults, size_t count );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      スカラー3重積を計算します.
     //!
@@ -1682,7 +1945,7 @@ public:
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Vector4 structure
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-struct Vector4
+struct ASVK_SIMD_ALIGN Vector4
 {
     //==============================================================================================
     // list of friend classes and methods.
@@ -1713,7 +1976,7 @@ public:
     //----------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //----------------------------------------------------------------------------------------------
-    Vector4();
+    Vector4() = default;
 
     //----------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -1729,7 +1992,7 @@ public:
     //! @param [in]     nz          Z成分.
     //! @param [in]     nw          W成分.
     //----------------------------------------------------------------------------------------------
-    Vector4( const Vector2& value, float nz, float nw );
+    constexpr Vector4( const Vector2& value, float nz, float nw );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -1737,7 +2000,7 @@ public:
     //! @param [in]     value       3次元ベクトル.
     //! @param [in]     nw          W成分.
     //----------------------------------------------------------------------------------------------
-    Vector4( const Vector3& value, float nw );
+    constexpr Vector4( const Vector3& value, float nw );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -1747,7 +2010,7 @@ public:
     //! @param [in]     nz           Z成分.
     //! @param [in]     nw           W成分.
     //----------------------------------------------------------------------------------------------
-    Vector4( float nx, float ny, float nz, float nw );
+    constexpr Vector4( float nx, float ny, float nz, float nw );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      float*型への演算子です.
@@ -2222,11 +2485,160 @@ public:
 
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Vector3x4 structure
+// 4要素分のVector3を構造体配列(SoA)形式で保持します.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+struct ASVK_SIMD_ALIGN Vector3x4
+{
+public:
+    //==============================================================================================
+    // public variables
+    //==============================================================================================
+    float x[4];     //!< X成分です.
+    float y[4];     //!< Y成分です.
+    float z[4];     //!< Z成分です.
+
+    //==============================================================================================
+    // public methods
+    //==============================================================================================
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //----------------------------------------------------------------------------------------------
+    Vector3x4() = default;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param [in]     pValues     要素数4のVector3配列.
+    //----------------------------------------------------------------------------------------------
+    explicit Vector3x4( const Vector3* pValues );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      Vector3配列(AoS)から読み込みます.
+    //!
+    //! @param [in]     pValues     要素数4のVector3配列.
+    //----------------------------------------------------------------------------------------------
+    void Load( const Vector3* pValues );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      Vector3配列(AoS)に書き出します.
+    //!
+    //! @param [out]    pValues     要素数4のVector3配列.
+    //----------------------------------------------------------------------------------------------
+    void Store( Vector3* pValues ) const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトルを変換します.
+    //!
+    //! @param [in]     position    入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      変換されたベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void Transform( const Vector3x4& position, const Matrix& matrix, Vector3x4& result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，法線ベクトルを変換します.
+    //!
+    //! @param [in]     normal      入力法線ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      変換された法線ベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void TransformNormal( const Vector3x4& normal, const Matrix& matrix, Vector3x4& result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いてベクトルを変換し，変換結果をw=1に射影します.
+    //!
+    //! @param [in]     coord       入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      行列変換後，w=1に射影されたベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void TransformCoord( const Vector3x4& coord, const Matrix& matrix, Vector3x4& result );
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Vector3x8 structure
+// 8要素分のVector3を構造体配列(SoA)形式で保持します.
+// アライメントは他の数学型と同じ16byteのままなので，AVX有効時も256bitの読み書きは
+// 非アライメント命令(_mm256_loadu_ps/_mm256_storeu_ps)で行います.
+// (AVXの有無でアライメントを変えると，ビルド設定の異なる翻訳単位間でレイアウトが食い違うため.)
+////////////////////////////////////////////////////////////////////////////////////////////////////
+struct ASVK_SIMD_ALIGN Vector3x8
+{
+public:
+    //==============================================================================================
+    // public variables
+    //==============================================================================================
+    float x[8];     //!< X成分です.
+    float y[8];     //!< Y成分です.
+    float z[8];     //!< Z成分です.
+
+    //==============================================================================================
+    // public methods
+    //==============================================================================================
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //----------------------------------------------------------------------------------------------
+    Vector3x8() = default;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param [in]     pValues     要素数8のVector3配列.
+    //----------------------------------------------------------------------------------------------
+    explicit Vector3x8( const Vector3* pValues );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      Vector3配列(AoS)から読み込みます.
+    //!
+    //! @param [in]     pValues     要素数8のVector3配列.
+    //----------------------------------------------------------------------------------------------
+    void Load( const Vector3* pValues );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      Vector3配列(AoS)に書き出します.
+    //!
+    //! @param [out]    pValues     要素数8のVector3配列.
+    //----------------------------------------------------------------------------------------------
+    void Store( Vector3* pValues ) const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトルを変換します.
+    //!
+    //! @param [in]     position    入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      変換されたベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void Transform( const Vector3x8& position, const Matrix& matrix, Vector3x8& result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，法線ベクトルを変換します.
+    //!
+    //! @param [in]     normal      入力法線ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      変換された法線ベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void TransformNormal( const Vector3x8& normal, const Matrix& matrix, Vector3x8& result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された行列を用いてベクトルを変換し，変換結果をw=1に射影します.
+    //!
+    //! @param [in]     coord       入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      行列変換後，w=1に射影されたベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void TransformCoord( const Vector3x8& coord, const Matrix& matrix, Vector3x8& result );
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Matrix structure
 // 行列クラス    (列優先行列 row-major)
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-struct Matrix
+struct ASVK_SIMD_ALIGN Matrix
 {
     //==============================================================================================
     // list of friend classes and methods.
@@ -2264,7 +2676,7 @@ public:
     //----------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //----------------------------------------------------------------------------------------------
-    Matrix();
+    Matrix() = default;
 
     //----------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -2293,10 +2705,10 @@ public:
     //! @param [in]     m43         4行3列の値.
     //! @param [in]     m44         4行4列の値.
     //----------------------------------------------------------------------------------------------
-    explicit Matrix ( float m11, float m12, float m13, float m14,
-             float m21, float m22, float m23, float m24,
-             float m31, float m32, float m33, float m34,
-             float m41, float m42, float m43, float m44 );
+    constexpr explicit Matrix ( float m11, float m12, float m13, float m14,
+                                float m21, float m22, float m23, float m24,
+                                float m31, float m32, float m33, float m34,
+                                float m41, float m42, float m43, float m44 );
 
     //---------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -2306,7 +2718,14 @@ public:
     //! @param[in]      v2      3行目の値です.
     //! @param[in]      v3      4行目の値です.
     //---------------------------------------------------------------------------------------------
-    explicit Matrix( const Vector4& v1, const Vector4& v2, const Vector4& v3, const Vector4& v4 );
+    constexpr explicit Matrix( const Vector4& v1, const Vector4& v2, const Vector4& v3, const Vector4& v4 );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      アフィン変換行列から変換します.
+    //!
+    //! @param[in]      value   変換元の行列. 4列目は(0, 0, 0, 1)になります.
+    //---------------------------------------------------------------------------------------------
+    constexpr explicit Matrix( const Matrix3x4& value );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      インデクサです.
@@ -2478,7 +2897,7 @@ public:
     //!
     //! @return     単位行列を返却します.
     //----------------------------------------------------------------------------------------------
-    static Matrix   CreateIdentity();
+    static constexpr Matrix   CreateIdentity();
 
     //----------------------------------------------------------------------------------------------
     //! @brief      単位行列であるか判定します.
@@ -2559,6 +2978,50 @@ public:
     //----------------------------------------------------------------------------------------------
     static void    MultiplyTranspose( const Matrix& a, const Matrix& b, Matrix &result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      複数の行列の乗算をまとめて行います.
+    //!
+    //! @param [in]     pA          乗算される行列の配列.
+    //! @param [in]     pB          乗算する行列の配列.
+    //! @param [out]    pResults    乗算結果 pResults[i] = pA[i] * pB[i] の格納先 (pA, pBと同じ配列を指定可能).
+    //! @param [in]     count       要素数.
+    //! @note       要素数が多い場合はOpenMPで並列化されます.
+    //----------------------------------------------------------------------------------------------
+    static void    MultiplyBatch( const Matrix* pA, const Matrix* pB, Matrix* pResults, size_t count );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      平坦化された階層構造の行列を親から順に乗算します.
+    //!
+    //! @param [in]     pLocals     ローカル行列の配列.
+    //! @param [in]     pParents    親のインデックスの配列. 親を持たない場合は負の値. pParents[i] < i であること.
+    //! @param [out]    pResults    乗算結果 pResults[i] = pLocals[i] * pResults[pParents[i]] の格納先.
+    //! @param [in]     count       要素数.
+    //! @note       親が既に確定している連続区間ごとにOpenMPで並列化されます.
+    //----------------------------------------------------------------------------------------------
+    static void    MultiplyHierarchy( const Matrix* pLocals, const int32_t* pParents, Matrix* pResults, size_t count );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      行列パレットによる線形ブレンドスキニングをまとめて行います.
+    //!
+    //! @param [in]     pBones              ボーンの変換行列の配列.
+    //! @param [in]     pPositions          入力位置座標の配列.
+    //! @param [in]     pNormals            入力法線ベクトルの配列. 不要な場合は nullptr.
+    //! @param [in]     pIndices            頂点ごとに4つのボーン番号を並べた配列.
+    //! @param [in]     pWeights            頂点ごとに4つの重みを並べた配列.
+    //! @param [out]    pResultPositions    変換後の位置座標の格納先.
+    //! @param [out]    pResultNormals      変換後の法線ベクトル(正規化済み)の格納先. pNormals が nullptr の場合は無視されます.
+    //! @param [in]     count               頂点数.
+    //----------------------------------------------------------------------------------------------
+    static void    Skin(
+        const Matrix*       pBones,
+        const Vector3*      pPositions,
+        const Vector3*      pNormals,
+        const uint16_t*     pIndices,
+        const float*        pWeights,
+        Vector3*            pResultPositions,
+        Vector3*            pResultNormals,
+        size_t              count );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      逆行列を求めます.
     //!
@@ -2575,38 +3038,83 @@ public:
     static void    Invert( const Matrix& value, Matrix &result );
 
     //----------------------------------------------------------------------------------------------
-    //! @brief      拡大縮小行列を生成します.
+    //! @brief      剛体変換行列(回転+平行移動)の逆行列を求めます.
     //!
-    //! @param [in]     scale      拡大縮小値.
-    //! @return     拡大縮小行列を返却します.
+    //! @param [in]     value       逆行列を求める値. 左上3x3が正規直交，4列目が(0, 0, 0, 1)であること.
+    //! @return     逆行列を返却します.
+    //! @note       左上3x3を転置し，平行移動成分のみを補正します.
     //----------------------------------------------------------------------------------------------
-    static Matrix  CreateScale( float scale );
+    static Matrix  InvertRigid( const Matrix& value );
 
     //----------------------------------------------------------------------------------------------
-    //! @brief      拡大縮小行列を生成します.
+    //! @brief      剛体変換行列(回転+平行移動)の逆行列を求めます.
     //!
-    //! @param [in]     scale       拡大縮小値.
-    //! @param [out]    result      拡大縮小行列.
+    //! @param [in]     value       逆行列を求める値. 左上3x3が正規直交，4列目が(0, 0, 0, 1)であること.
+    //! @param [out]    result      逆行列.
     //----------------------------------------------------------------------------------------------
-    static void    CreateScale( float scale, Matrix &result );
+    static void    InvertRigid( const Matrix& value, Matrix &result );
 
     //----------------------------------------------------------------------------------------------
-    //! @brief      拡大縮小行列を生成します.
+    //! @brief      アフィン変換行列の逆行列を求めます.
     //!
-    //! @param [in]     sx          X成分の拡大縮小値.
-    //! @param [in]     sy          Y成分の拡大縮小値.
-    //! @param [in]     sz          Z成分の拡大縮小値.
-    //! @return     拡大縮小行列を返却します.
+    //! @param [in]     value       逆行列を求める値. 4列目が(0, 0, 0, 1)であること.
+    //! @return     逆行列を返却します.
+    //! @note       左上3x3の逆行列と平行移動成分の補正のみを計算します.
     //----------------------------------------------------------------------------------------------
-    static Matrix  CreateScale( float sx, float sy, float sz );
+    static Matrix  InvertAffine( const Matrix& value );
 
     //----------------------------------------------------------------------------------------------
-    //! @brief      拡大縮小行列を生成します.
+    //! @brief      アフィン変換行列の逆行列を求めます.
     //!
-    //! @param [in]     sx          X成分の拡大縮小値.
-    //! @param [in]     sy          Y成分の拡大縮小値.
-    //! @param [in]     sz          Z成分の拡大縮小値.
-    //! @param [out]    result      拡大縮小行列.
+    //! @param [in]     value       逆行列を求める値. 4列目が(0, 0, 0, 1)であること.
+    //! @param [out]    result      逆行列.
+    //----------------------------------------------------------------------------------------------
+    static void    InvertAffine( const Matrix& value, Matrix &result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      行列の種類を判定し，最も軽い方法で逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める値.
+    //! @param [out]    result      逆行列. 失敗時は変更されません.
+    //! @retval true    逆行列が求まりました.
+    //! @retval false   行列が特異なため，逆行列が求まりませんでした.
+    //! @note       剛体変換ならInvertRigid()，アフィン変換ならInvertAffine()，それ以外はInvert()を使用します.
+    //----------------------------------------------------------------------------------------------
+    static bool    SafeInvert( const Matrix& value, Matrix &result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      拡大縮小行列を生成します.
+    //!
+    //! @param [in]     scale      拡大縮小値.
+    //! @return     拡大縮小行列を返却します.
+    //----------------------------------------------------------------------------------------------
+    static constexpr Matrix  CreateScale( float scale );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      拡大縮小行列を生成します.
+    //!
+    //! @param [in]     scale       拡大縮小値.
+    //! @param [out]    result      拡大縮小行列.
+    //----------------------------------------------------------------------------------------------
+    static void    CreateScale( float scale, Matrix &result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      拡大縮小行列を生成します.
+    //!
+    //! @param [in]     sx          X成分の拡大縮小値.
+    //! @param [in]     sy          Y成分の拡大縮小値.
+    //! @param [in]     sz          Z成分の拡大縮小値.
+    //! @return     拡大縮小行列を返却します.
+    //----------------------------------------------------------------------------------------------
+    static constexpr Matrix  CreateScale( float sx, float sy, float sz );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      拡大縮小行列を生成します.
+    //!
+    //! @param [in]     sx          X成分の拡大縮小値.
+    //! @param [in]     sy          Y成分の拡大縮小値.
+    //! @param [in]     sz          Z成分の拡大縮小値.
+    //! @param [out]    result      拡大縮小行列.
     //----------------------------------------------------------------------------------------------
     static void    CreateScale( float sx, float sy, float sz, Matrix &result );
 
@@ -2616,7 +3124,7 @@ public:
     //! @param [in]     scale       拡大縮小値.
     //! @return     拡大縮小行列を返却します.
     //----------------------------------------------------------------------------------------------
-    static Matrix  CreateScale( const Vector3& scale );
+    static constexpr Matrix  CreateScale( const Vector3& scale );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      拡大縮小行列を生成します.
@@ -2634,7 +3142,7 @@ public:
     //! @param [in]     tz          Z成分の平行移動値.
     //! @return     平行移動行列を返却します.
     //----------------------------------------------------------------------------------------------
-    static Matrix  CreateTranslation( float tx, float ty, float tz );
+    static constexpr Matrix  CreateTranslation( float tx, float ty, float tz );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      平行移動行列を生成します.
@@ -2652,7 +3160,7 @@ public:
     //! @param [in]     translate   平行移動値.
     //! @return     平行移動行列を返却します.
     //----------------------------------------------------------------------------------------------
-    static Matrix  CreateTranslation( const Vector3& translate );
+    static constexpr Matrix  CreateTranslation( const Vector3& translate );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      平行移動行列を生成します.
@@ -2764,6 +3272,27 @@ public:
     //----------------------------------------------------------------------------------------------
     static void    CreateRotationFromYawPitchRoll( float yaw, float pitch, float roll, Matrix& result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      SinCosFast()を用いてヨー・ピッチ・ロール角から回転行列を生成します.
+    //!
+    //! @param [in]     yaw         ヨー角(ラジアン).
+    //! @param [in]     pitch       ピッチ角(ラジアン).
+    //! @param [in]     roll        ロール角(ラジアン).
+    //! @return     生成した回転行列を返却します.
+    //! @note       |角度| <= 2π で各成分の最大絶対誤差は 4e-6 です.
+    //----------------------------------------------------------------------------------------------
+    static Matrix  CreateRotationFromYawPitchRollFast( float yaw, float pitch, float roll );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      SinCosFast()を用いてヨー・ピッチ・ロール角から回転行列を生成します.
+    //!
+    //! @param [in]     yaw         ヨー角(ラジアン).
+    //! @param [in]     pitch       ピッチ角(ラジアン).
+    //! @param [in]     roll        ロール角(ラジアン).
+    //! @param [out]    result      生成した回転行列.
+    //----------------------------------------------------------------------------------------------
+    static void    CreateRotationFromYawPitchRollFast( float yaw, float pitch, float roll, Matrix& result );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      ビュー行列を生成します.
     //!
@@ -2976,10 +3505,211 @@ public:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Matrix3x4 structure
+// アフィン変換行列クラス (3行4列, row-major)
+//
+// Matrix の転置の上3行を保持します (_ij = Matrix::_ji).
+// 各行は (回転・スケール成分, 平行移動成分) で，列ベクトルに対して p' = M * (p, 1) となります.
+// メモリ配置は GLSL (std140/std430) の mat3x4 と一致するので，そのまま定数バッファに memcpy できます.
+// シェーダ側では vec4(p, 1.0) * m で変換してください.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+struct ASVK_SIMD_ALIGN Matrix3x4
+{
+public:
+    //==============================================================================================
+    // public variables.
+    //==============================================================================================
+    union
+    {
+        struct
+        {
+            float _11, _12, _13, _14;
+            float _21, _22, _23, _24;
+            float _31, _32, _33, _34;
+        };
+        float m[3][4];
+    };
+
+    //==============================================================================================
+    // public methods.
+    //==============================================================================================
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //----------------------------------------------------------------------------------------------
+    Matrix3x4() = default;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param [in]     pValues     要素数12の配列.
+    //----------------------------------------------------------------------------------------------
+    explicit Matrix3x4( const float* pValues );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param [in]     m11         1行1列の値.
+    //! @param [in]     m12         1行2列の値.
+    //! @param [in]     m13         1行3列の値.
+    //! @param [in]     m14         1行4列の値.
+    //! @param [in]     m21         2行1列の値.
+    //! @param [in]     m22         2行2列の値.
+    //! @param [in]     m23         2行3列の値.
+    //! @param [in]     m24         2行4列の値.
+    //! @param [in]     m31         3行1列の値.
+    //! @param [in]     m32         3行2列の値.
+    //! @param [in]     m33         3行3列の値.
+    //! @param [in]     m34         3行4列の値.
+    //----------------------------------------------------------------------------------------------
+    constexpr explicit Matrix3x4( float m11, float m12, float m13, float m14,
+                                  float m21, float m22, float m23, float m24,
+                                  float m31, float m32, float m33, float m34 );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      4x4行列から変換します.
+    //!
+    //! @param [in]     value       変換元の行列. 4列目は(0, 0, 0, 1)とみなして破棄します.
+    //----------------------------------------------------------------------------------------------
+    explicit Matrix3x4( const Matrix& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      float*型へのキャストです.
+    //----------------------------------------------------------------------------------------------
+    operator       float* ();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      const float*型へのキャストです.
+    //----------------------------------------------------------------------------------------------
+    operator const float* () const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      乗算代入演算子です.
+    //!
+    //! @param [in]     value       乗算する値.
+    //! @return     乗算結果を返却します.
+    //----------------------------------------------------------------------------------------------
+    Matrix3x4& operator *= ( const Matrix3x4& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      乗算演算子です.
+    //!
+    //! @param [in]     value       乗算する値.
+    //! @return     乗算結果を返却します.
+    //----------------------------------------------------------------------------------------------
+    Matrix3x4  operator *  ( const Matrix3x4& value ) const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      等価比較演算子です.
+    //!
+    //! @param [in]     value       比較する値.
+    //! @retval true    等価です.
+    //! @retval false   非等価です.
+    //----------------------------------------------------------------------------------------------
+    bool    operator == ( const Matrix3x4& value ) const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      非等価比較演算子です.
+    //!
+    //! @param [in]     value       比較する値.
+    //! @retval true    非等価です.
+    //! @retval false   等価です.
+    //----------------------------------------------------------------------------------------------
+    bool    operator != ( const Matrix3x4& value ) const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      単位行列化します.
+    //!
+    //! @return     単位行列を返却します.
+    //----------------------------------------------------------------------------------------------
+    Matrix3x4& Identity();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      単位行列を生成します.
+    //!
+    //! @return     単位行列を返却します.
+    //----------------------------------------------------------------------------------------------
+    static constexpr Matrix3x4  CreateIdentity();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      行列を合成します.
+    //!
+    //! @param [in]     a           先に適用する変換.
+    //! @param [in]     b           後に適用する変換.
+    //! @return     aの後にbを適用する変換を返却します (Matrix::Multiply( a, b ) と同じ意味です).
+    //! @note       SIMD有効時も結果はスカラー版とビット単位で一致します(-0 も保持します).
+    //----------------------------------------------------------------------------------------------
+    static Matrix3x4  Multiply( const Matrix3x4& a, const Matrix3x4& b );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      行列を合成します.
+    //!
+    //! @param [in]     a           先に適用する変換.
+    //! @param [in]     b           後に適用する変換.
+    //! @param [out]    result      aの後にbを適用する変換.
+    //! @note       SIMD有効時も結果はスカラー版とビット単位で一致します(-0 も保持します).
+    //----------------------------------------------------------------------------------------------
+    static void       Multiply( const Matrix3x4& a, const Matrix3x4& b, Matrix3x4& result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める行列 (正則であること).
+    //! @return     逆行列を返却します.
+    //----------------------------------------------------------------------------------------------
+    static Matrix3x4  InvertAffine( const Matrix3x4& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      逆行列を求めます.
+    //!
+    //! @param [in]     value       逆行列を求める行列 (正則であること).
+    //! @param [out]    result      逆行列.
+    //----------------------------------------------------------------------------------------------
+    static void       InvertAffine( const Matrix3x4& value, Matrix3x4& result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      位置ベクトルを変換します.
+    //!
+    //! @param [in]     coord       入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @return     変換されたベクトルを返却します (Vector3::Transform()と同じ結果です).
+    //----------------------------------------------------------------------------------------------
+    static Vector3    TransformCoord( const Vector3& coord, const Matrix3x4& matrix );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      位置ベクトルを変換します.
+    //!
+    //! @param [in]     coord       入力ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      変換されたベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void       TransformCoord( const Vector3& coord, const Matrix3x4& matrix, Vector3& result );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      法線ベクトルを変換します.
+    //!
+    //! @param [in]     normal      入力法線ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @return     変換された法線ベクトルを返却します.
+    //----------------------------------------------------------------------------------------------
+    static Vector3    TransformNormal( const Vector3& normal, const Matrix3x4& matrix );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      法線ベクトルを変換します.
+    //!
+    //! @param [in]     normal      入力法線ベクトル.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    result      変換された法線ベクトル.
+    //----------------------------------------------------------------------------------------------
+    static void       TransformNormal( const Vector3& normal, const Matrix3x4& matrix, Vector3& result );
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quaternion structure
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-struct Quaternion
+struct ASVK_SIMD_ALIGN Quaternion
 {
     //==============================================================================================
     // list of friend classes and methods.
@@ -3010,7 +3740,7 @@ public:
     //----------------------------------------------------------------------------------------------
     //! @brief      コンストラクタです.
     //----------------------------------------------------------------------------------------------
-    Quaternion();
+    Quaternion() = default;
 
     //----------------------------------------------------------------------------------------------
     //! @brief      引数付きコンストラクタです.
@@ -3027,7 +3757,7 @@ public:
     //! @param [in]     nz          Z成分.
     //! @param [in]     nw          W成分.
     //----------------------------------------------------------------------------------------------
-    Quaternion( float nx, float ny, float nz, float nw );
+    constexpr Quaternion( float nx, float ny, float nz, float nw );
 
     //----------------------------------------------------------------------------------------------
     //! @brief      float*型へのキャストです.
@@ -3184,6 +3914,14 @@ public:
     //----------------------------------------------------------------------------------------------
     Quaternion& SafeNormalize( const Quaternion& );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      逆平方根の近似を用いて正規化します.
+    //!
+    //! @return     正規化した四元数を返却します.
+    //! @note       各成分の最大誤差はRsqrtFast()の相対誤差程度です.
+    //----------------------------------------------------------------------------------------------
+    Quaternion& NormalizeFast();
+
     //----------------------------------------------------------------------------------------------
     //! @brief      単位四元数化します.
     //!
@@ -3197,7 +3935,7 @@ public:
     //!
     //! @return     単位四元数を返却します.
     //----------------------------------------------------------------------------------------------
-    static Quaternion   CreateIdentity();
+    static constexpr Quaternion   CreateIdentity();
 
     //----------------------------------------------------------------------------------------------
     //! @brief      単位四元数かどうかチェックします.
@@ -3222,6 +3960,7 @@ public:
     //! @param [in]     a           入力四元数.
     //! @param [in]     b           入力四元数.
     //! @return     乗算結果を返却します.
+    //! @note       a を適用してから b を適用する回転となります(回転行列の積 a * b と同じ順序).
     //----------------------------------------------------------------------------------------------
     static Quaternion  Multiply( const Quaternion& a, const Quaternion& b );
 
@@ -3231,6 +3970,7 @@ public:
     //! @param [in]     a           入力四元数.
     //! @param [in]     b           入力四元数.
     //! @param [out]    result      乗算結果.
+    //! @note       a を適用してから b を適用する回転となります(回転行列の積 a * b と同じ順序).
     //----------------------------------------------------------------------------------------------
     static void        Multiply( const Quaternion& a, const Quaternion& b, Quaternion &result );
 
@@ -3302,6 +4042,23 @@ public:
     //----------------------------------------------------------------------------------------------
     static void         SafeNormalize( const Quaternion& value, const Quaternion& set, Quaternion& result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      逆平方根の近似を用いて正規化します.
+    //!
+    //! @param [in]     value       正規化する四元数.
+    //! @return     正規化した四元数を返却します.
+    //! @note       各成分の最大誤差はRsqrtFast()の相対誤差程度です.
+    //----------------------------------------------------------------------------------------------
+    static Quaternion   NormalizeFast( const Quaternion& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      逆平方根の近似を用いて正規化します.
+    //!
+    //! @param [in]     value       正規化する四元数.
+    //! @param [out]    result      正規化した四元数.
+    //----------------------------------------------------------------------------------------------
+    static void         NormalizeFast( const Quaternion& value, Quaternion& result );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      ヨー・ピッチ・ロール角から四元数を生成します.
     //!
@@ -3322,6 +4079,27 @@ public:
     //----------------------------------------------------------------------------------------------
     static void        CreateFromYawPitchRoll( float yaw, float pitch, float roll, Quaternion &result );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      SinCosFast()を用いてヨー・ピッチ・ロール角から四元数を生成します.
+    //!
+    //! @param [in]     yaw         ヨー角(ラジアン).
+    //! @param [in]     pitch       ピッチ角(ラジアン).
+    //! @param [in]     roll        ロール角(ラジアン).
+    //! @return     生成した四元数を返却します.
+    //! @note       |角度| <= 2π で各成分の最大絶対誤差は 1e-6 です.
+    //----------------------------------------------------------------------------------------------
+    static Quaternion  CreateFromYawPitchRollFast( float yaw, float pitch, float roll );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      SinCosFast()を用いてヨー・ピッチ・ロール角から四元数を生成します.
+    //!
+    //! @param [in]     yaw         ヨー角(ラジアン).
+    //! @param [in]     pitch       ピッチ角(ラジアン).
+    //! @param [in]     roll        ロール角(ラジアン).
+    //! @param [out]    result      生成した四元数.
+    //----------------------------------------------------------------------------------------------
+    static void        CreateFromYawPitchRollFast( float yaw, float pitch, float roll, Quaternion &result );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      指定された軸と角度から四元数を生成します.
     //!
@@ -3419,6 +4197,162 @@ public:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// DualQuaternion structure
+// 実部を回転, 双対部を 0.5 * t * real (tは平行移動を表す純虚四元数) とする剛体変換です.
+// 合成順序は Quaternion と同様に Multiply( a, b ) が「aを適用してからbを適用する」です.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+struct ASVK_SIMD_ALIGN DualQuaternion
+{
+    //==============================================================================================
+    // list of friend classes and methods.
+    //==============================================================================================
+    /* NOTHING */
+
+public:
+    //==============================================================================================
+    // public variables.
+    //==============================================================================================
+    Quaternion real;    //!< 実部(回転)です.
+    Quaternion dual;    //!< 双対部(平行移動)です.
+
+    //==============================================================================================
+    // public methods.
+    //==============================================================================================
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //----------------------------------------------------------------------------------------------
+    DualQuaternion() = default;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      引数付きコンストラクタです.
+    //!
+    //! @param [in]     nreal       実部.
+    //! @param [in]     ndual       双対部.
+    //----------------------------------------------------------------------------------------------
+    constexpr DualQuaternion( const Quaternion& nreal, const Quaternion& ndual );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      正規化します.
+    //!
+    //! @return     実部の長さで実部と双対部を除算した結果を返却します.
+    //----------------------------------------------------------------------------------------------
+    DualQuaternion& Normalize();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      平行移動量を取得します.
+    //!
+    //! @return     平行移動量を返却します.
+    //! @note       正規化されている必要があります.
+    //----------------------------------------------------------------------------------------------
+    Vector3 GetTranslation() const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      恒等変換を生成します.
+    //!
+    //! @return     恒等変換を表す双対四元数を返却します.
+    //----------------------------------------------------------------------------------------------
+    static constexpr DualQuaternion CreateIdentity();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      回転と平行移動から双対四元数を生成します.
+    //!
+    //! @param [in]     rotation        回転(単位四元数).
+    //! @param [in]     translation     回転後に適用する平行移動量.
+    //! @return     生成した双対四元数を返却します.
+    //----------------------------------------------------------------------------------------------
+    static DualQuaternion CreateFromRotationTranslation( const Quaternion& rotation, const Vector3& translation );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      剛体変換行列から双対四元数を生成します.
+    //!
+    //! @param [in]     value       回転と平行移動のみからなる変換行列.
+    //! @return     生成した双対四元数を返却します.
+    //! @note       拡大縮小成分は考慮されません.
+    //----------------------------------------------------------------------------------------------
+    static DualQuaternion CreateFromMatrix( const Matrix& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      双対四元数同士の乗算を行います.
+    //!
+    //! @param [in]     a           先に適用する変換.
+    //! @param [in]     b           後に適用する変換.
+    //! @return     乗算結果を返却します.
+    //----------------------------------------------------------------------------------------------
+    static DualQuaternion Multiply( const DualQuaternion& a, const DualQuaternion& b );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      共役な双対四元数を求めます.
+    //!
+    //! @param [in]     value       入力値.
+    //! @return     実部と双対部の共役を返却します. 正規化されていれば逆変換になります.
+    //----------------------------------------------------------------------------------------------
+    static DualQuaternion Conjugate( const DualQuaternion& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      正規化を行います.
+    //!
+    //! @param [in]     value       入力値.
+    //! @return     正規化した双対四元数を返却します.
+    //----------------------------------------------------------------------------------------------
+    static DualQuaternion Normalize( const DualQuaternion& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      重み付きで線形補間し，正規化します(Dual quaternion Linear Blending).
+    //!
+    //! @param [in]     pValues     入力値の配列.
+    //! @param [in]     pWeights    重みの配列.
+    //! @param [in]     count       要素数(1以上).
+    //! @return     ブレンドして正規化した双対四元数を返却します.
+    //! @note       pValues[0] と逆半球にある要素は符号を反転して最短経路でブレンドします.
+    //----------------------------------------------------------------------------------------------
+    static DualQuaternion Blend( const DualQuaternion* pValues, const float* pWeights, size_t count );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      位置座標を変換します.
+    //!
+    //! @param [in]     position    入力位置座標.
+    //! @param [in]     value       正規化された双対四元数.
+    //! @return     変換された位置座標を返却します.
+    //----------------------------------------------------------------------------------------------
+    static Vector3 Transform( const Vector3& position, const DualQuaternion& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      法線ベクトルを変換します.
+    //!
+    //! @param [in]     normal      入力法線ベクトル.
+    //! @param [in]     value       正規化された双対四元数.
+    //! @return     回転のみを適用した法線ベクトルを返却します.
+    //----------------------------------------------------------------------------------------------
+    static Vector3 TransformNormal( const Vector3& normal, const DualQuaternion& value );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      双対四元数によるスキニングをまとめて行います.
+    //!
+    //! @param [in]     pBones              ボーンの変換の配列.
+    //! @param [in]     pPositions          入力位置座標の配列.
+    //! @param [in]     pNormals            入力法線ベクトルの配列. 不要な場合は nullptr.
+    //! @param [in]     pIndices            頂点ごとに4つのボーン番号を並べた配列.
+    //! @param [in]     pWeights            頂点ごとに4つの重みを並べた配列.
+    //! @param [out]    pResultPositions    変換後の位置座標の格納先.
+    //! @param [out]    pResultNormals      変換後の法線ベクトルの格納先. pNormals が nullptr の場合は無視されます.
+    //! @param [in]     count               頂点数.
+    //! @note       頂点ごとに Blend() と Transform() / TransformNormal() を行うのと
+    //!             ビット単位で同じ結果になります.
+    //----------------------------------------------------------------------------------------------
+    static void Skin(
+        const DualQuaternion*   pBones,
+        const Vector3*          pPositions,
+        const Vector3*          pNormals,
+        const uint16_t*         pIndices,
+        const float*            pWeights,
+        Vector3*                pResultPositions,
+        Vector3*                pResultNormals,
+        size_t                  count );
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Random class (XorShift)
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -3437,6 +4371,7 @@ private:
     uint32_t     m_Y;            //!< 変数です.
     uint32_t     m_Z;            //!< 変数です.
     uint32_t     m_W;            //!< 変数です.
+    uint32_t     m_Lane[4][8];   //!< 多レーン生成用の状態です(x, y, z, wの順に8レーン分).
 
     //==============================================================================================
     // private methods
@@ -3556,6 +4491,36 @@ public:
     //----------------------------------------------------------------------------------------------
     double  GetAsF64( double a, double b );
 
+    //----------------------------------------------------------------------------------------------
+    //! @brief      8レーン並列に乱数を生成し，uint32_t型として配列に格納します.
+    //!
+    //! @param [out]    pValues     格納先の配列.
+    //! @param [in]     count       生成する個数.
+    //! @note       GetAsU32()とは独立した系列で，SetSeed()の種から決定的に導出されます.
+    //!             SIMD有効時と無効時で同一の結果を返却します.
+    //----------------------------------------------------------------------------------------------
+    void FillU32( uint32_t* pValues, size_t count );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      8レーン並列に乱数を生成し，指定された値範囲のfloat型として配列に格納します.
+    //!
+    //! @param [out]    pValues     格納先の配列.
+    //! @param [in]     count       生成する個数.
+    //! @param [in]     a           最小値.
+    //! @param [in]     b           最大値.
+    //! @note       上位24bitから[0, 1)の値を生成してaからbに写します(丸めによりbに一致する場合があります).
+    //----------------------------------------------------------------------------------------------
+    void FillF32( float* pValues, size_t count, float a, float b );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      8レーン並列に単位球面上に一様分布する単位ベクトルを生成し，配列に格納します.
+    //!
+    //! @param [out]    pValues     格納先の配列.
+    //! @param [in]     count       生成する個数.
+    //! @note       三角関数はSinCosFast()と同じ多項式で近似するため，長さの誤差は1e-6程度です.
+    //----------------------------------------------------------------------------------------------
+    void FillUnitVector3( Vector3* pValues, size_t count );
+
     //----------------------------------------------------------------------------------------------
     //! @brief      代入演算子です.
     //
@@ -3584,6 +4549,163 @@ public:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// RandomStream class (xoshiro128**)
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class RandomStream
+{
+    //==============================================================================================
+    // list of friend classes and methods.
+    //==============================================================================================
+    /* NOTHING */
+
+private:
+    //==============================================================================================
+    // private variables
+    //==============================================================================================
+    uint32_t     m_S[4];         //!< 内部状態です.
+
+    //==============================================================================================
+    // private methods
+    //==============================================================================================
+    /* NOTHING */
+
+protected:
+    //==============================================================================================
+    // protected variables
+    //==============================================================================================
+    /* NOTHING */
+
+    //==============================================================================================
+    // protected methods
+    //==============================================================================================
+    /* NOTHING */
+
+public:
+    //==============================================================================================
+    // public variables
+    //==============================================================================================
+    /* NOTHING */
+
+    //==============================================================================================
+    // public methods
+    //==============================================================================================
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //! @param [in]     seed        設定する種.
+    //----------------------------------------------------------------------------------------------
+    explicit RandomStream ( uint64_t seed );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      コピーコンストラクタです.
+    //! @param [in]     stream      複製元のインスタンス.
+    //----------------------------------------------------------------------------------------------
+    RandomStream ( const RandomStream& stream );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //----------------------------------------------------------------------------------------------
+    ~RandomStream();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      ランダム種を設定します.
+    //! @param [in]     seed        設定する種.
+    //----------------------------------------------------------------------------------------------
+    void SetSeed ( uint64_t seed );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      乱数をuint32_t型として取得します.
+    //! @return     乱数を返却します.
+    //----------------------------------------------------------------------------------------------
+    uint32_t  GetAsU32();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      乱数をfloat型として取得します.
+    //! @return     [0.0f, 1.0f)の範囲で乱数を返却します.
+    //----------------------------------------------------------------------------------------------
+    float  GetAsF32();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された値範囲で乱数をfloat型として取得します.
+    //! @param [in]     a       最小値.
+    //! @param [in]     b       最大値.
+    //! @return     aからbまでの範囲で乱数を返却します.
+    //----------------------------------------------------------------------------------------------
+    float  GetAsF32( float a, float b );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      系列を2^64個分進めます.
+    //----------------------------------------------------------------------------------------------
+    void Jump();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      系列を2^96個分進めます.
+    //----------------------------------------------------------------------------------------------
+    void LongJump();
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      ワーカースレッド用に独立した系列を生成します.
+    //!
+    //! @param [in]     streamIndex     系列番号.
+    //! @return     この系列を(streamIndex + 1) * 2^96個進めた系列を返却します.
+    //! @note       異なる系列番号同士，および元の系列の先頭2^96個とは重複しません.
+    //!             LongJump()を(streamIndex + 1)回適用するため計算量は O(streamIndex) です.
+    //!             スレッド数程度の番号を想定しています. 多数の系列が必要な場合は，
+    //!             LongJump()を繰り返して順に複製する方が効率的です.
+    //----------------------------------------------------------------------------------------------
+    RandomStream Split( uint32_t streamIndex ) const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      乱数をuint32_t型として配列に格納します.
+    //!
+    //! @param [out]    pValues     格納先の配列.
+    //! @param [in]     count       生成する個数.
+    //! @note       配列を固定長のブロックに分け，k番目のブロックをJump()をk回適用した系列で
+    //!             埋めます. OpenMP有効時はブロック単位で並列化しますが，結果はスレッド数に
+    //!             依存しません. 呼び出し後はブロック数分Jump()した状態になります.
+    //----------------------------------------------------------------------------------------------
+    void FillU32( uint32_t* pValues, size_t count );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      指定された値範囲の乱数をfloat型として配列に格納します.
+    //!
+    //! @param [out]    pValues     格納先の配列.
+    //! @param [in]     count       生成する個数.
+    //! @param [in]     a           最小値.
+    //! @param [in]     b           最大値.
+    //! @note       ブロックの分け方と系列の進め方はFillU32()と同じです.
+    //----------------------------------------------------------------------------------------------
+    void FillF32( float* pValues, size_t count, float a, float b );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      代入演算子です.
+    //!
+    //! @param [in]     stream      代入する値.
+    //! @return     代入結果を返却します.
+    //----------------------------------------------------------------------------------------------
+    RandomStream& operator =  ( const RandomStream& stream );
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      等価演算子です.
+    //!
+    //! @param [in]     stream      比較する値.
+    //! @retval true    内部状態が等価です.
+    //! @retval false   内部状態が非等価です.
+    //----------------------------------------------------------------------------------------------
+    bool    operator == ( const RandomStream& stream ) const;
+
+    //----------------------------------------------------------------------------------------------
+    //! @brief      非等価演算子です.
+    //!
+    //! @param [in]     stream      比較する値.
+    //! @retval true    内部状態が非等価です.
+    //! @retval false   内部状態が等価です.
+    //----------------------------------------------------------------------------------------------
+    bool    operator != ( const RandomStream& stream ) const;
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // OrthonormalBasis structure
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -3626,6 +4748,7 @@ public:
     //! @brief      U方向から基底を初期化します.
     //!
     //! @param [in]     nu      U方向です.
+    //! @note       分岐なしで構築し，u x v = w を満たします.
     //---------------------------------------------------------------------------------------------
     void InitFromU( const Vector3& nu );
 
@@ -3633,6 +4756,7 @@ public:
     //! @brief      V方向から基底を初期化します.
     //!
     //! @param [in]     nv      V方向です.
+    //! @note       分岐なしで構築し，u x v = w を満たします.
     //---------------------------------------------------------------------------------------------
     void InitFromV( const Vector3& nv );
 
@@ -3640,6 +4764,7 @@ public:
     //! @brief      W方向から基底を初期化します.
     //!
     //! @param [in]     nw      W方向です.
+    //! @note       Duff et al. (2017) の方法で分岐なしで構築し，u x v = w を満たします.
     //---------------------------------------------------------------------------------------------
     void InitFromW( const Vector3& );
 
@@ -3691,6 +4816,16 @@ public:
     //---------------------------------------------------------------------------------------------
     void InitFromWV( const Vector3& nw, const Vector3& nv );
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      W方向の配列から複数の基底をまとめて構築します.
+    //!
+    //! @param [in]     pValues     W方向の配列.
+    //! @param [out]    pResults    構築した基底の格納先.
+    //! @param [in]     count       要素数.
+    //! @note       結果は要素ごとに InitFromW() を呼び出した場合とビット単位で一致します.
+    //---------------------------------------------------------------------------------------------
+    static void CreateFromW( const Vector3* pValues, OrthonormalBasis* pResults, size_t count );
+
     //---------------------------------------------------------------------------------------------
     //! @brief      等価比較演算子です.
     //!
@@ -0,0 +1,259 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkSpatialHash.h
+// Desc : Spatial Hash Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkMath.h>
+#include <asvkGeometry.h>
+#include <asvkAllocator.h>
+#include <vector>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SpatialHash class
+// 一様格子のセルをハッシュ表で管理する, 動的なバウンディングスフィアの空間インデックスです.
+// 物体は中心を含むセルにだけ登録し(ルーズグリッド), 検索範囲をセルの半分だけ広げて取りこぼしを防ぎます.
+// 追加・移動・削除は O(1) で, セル内の物体は4個ずつ SoA で格納して SIMD でまとめて判定します.
+// 半径がセルの大きさの半分を超える物体はセルに入れず, 全ての検索で総当たりで判定します.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class SpatialHash
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables
+    //=============================================================================================
+    static constexpr uint32_t INVALID_HANDLE        = 0xffffffffu;  //!< 無効なハンドルです.
+    static constexpr uint32_t DEFAULT_BUCKET_COUNT  = 4096;         //!< 既定のハッシュ表の大きさです.
+
+    //=============================================================================================
+    // public methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    SpatialHash();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~SpatialHash();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      初期化します.
+    //!
+    //! @param [in]     cellSize        セルの一辺の長さ. 代表的な物体の直径程度を指定します.
+    //! @param [in]     bucketCount     ハッシュ表の大きさ. 2の累乗に切り上げます. 物体数程度が目安です.
+    //! @retval true    初期化に成功しました.
+    //! @retval false   初期化に失敗しました(セルの大きさが正でない).
+    //! @note       登録済みの物体は全て破棄します.
+    //---------------------------------------------------------------------------------------------
+    bool Init( float cellSize, uint32_t bucketCount = DEFAULT_BUCKET_COUNT );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定物体数分のメモリを予約します.
+    //!
+    //! @param [in]     count       予約する物体数.
+    //---------------------------------------------------------------------------------------------
+    void Reserve( size_t count );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全ての物体を破棄します.
+    //!
+    //! @note       セルの大きさとハッシュ表の大きさは保持します.
+    //---------------------------------------------------------------------------------------------
+    void Clear();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物体を追加します.
+    //!
+    //! @param [in]     sphere      物体のバウンディングスフィア.
+    //! @return     追加した物体のハンドルを返却します.
+    //! @note       Init() の後に呼び出す必要があります. 削除した物体のハンドルは再利用されます.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Insert( const BoundingSphere& sphere );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物体を移動します.
+    //!
+    //! @param [in]     handle      物体のハンドル.
+    //! @param [in]     sphere      移動後のバウンディングスフィア.
+    //! @note       同じセルに留まる場合は値を書き換えるだけです.
+    //---------------------------------------------------------------------------------------------
+    void Move( uint32_t handle, const BoundingSphere& sphere );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物体を削除します.
+    //!
+    //! @param [in]     handle      物体のハンドル.
+    //---------------------------------------------------------------------------------------------
+    void Remove( uint32_t handle );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物体のバウンディングスフィアを取得します.
+    //!
+    //! @param [in]     handle      物体のハンドル.
+    //! @return     登録されているバウンディングスフィアを返却します.
+    //---------------------------------------------------------------------------------------------
+    BoundingSphere GetSphere( uint32_t handle ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物体数を取得します.
+    //!
+    //! @return     登録されている物体数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      セルの一辺の長さを取得します.
+    //!
+    //! @return     セルの一辺の長さを返却します.
+    //---------------------------------------------------------------------------------------------
+    float GetCellSize() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バウンディングスフィアと重なる物体を検索します.
+    //!
+    //! @param [in]     sphere      検索範囲. 点から半径 r 以内の検索は半径 r の球を指定します.
+    //! @param [out]    pHandles    見つかった物体のハンドルの格納先(maxCount 個).
+    //! @param [in]     maxCount    格納できる最大数. 達した時点で検索を打ち切ります.
+    //! @return     格納したハンドルの数を返却します.
+    //! @note       中心間の距離が半径の和以下の物体を重なるものとします.
+    //---------------------------------------------------------------------------------------------
+    uint32_t QuerySphere( const BoundingSphere& sphere, uint32_t* pHandles, uint32_t maxCount ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      バウンディングボックスと重なる物体を検索します.
+    //!
+    //! @param [in]     box         検索範囲.
+    //! @param [out]    pHandles    見つかった物体のハンドルの格納先(maxCount 個).
+    //! @param [in]     maxCount    格納できる最大数. 達した時点で検索を打ち切ります.
+    //! @return     格納したハンドルの数を返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t QueryBox( const BoundingBox& box, uint32_t* pHandles, uint32_t maxCount ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      錐台と重なる物体を検索します.
+    //!
+    //! @param [in]     frustum     検索範囲.
+    //! @param [out]    pHandles    見つかった物体のハンドルの格納先(maxCount 個).
+    //! @param [in]     maxCount    格納できる最大数. 達した時点で検索を打ち切ります.
+    //! @return     格納したハンドルの数を返却します.
+    //! @note       Frustum::Contains( const BoundingSphere& ) と同じ判定結果になります.
+    //!             錐台の8頂点を囲むセルを走査し, セルごとに錐台の内側にある平面の判定を省きます.
+    //---------------------------------------------------------------------------------------------
+    uint32_t QueryFrustum( const Frustum& frustum, uint32_t* pHandles, uint32_t maxCount ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      点に近い順に物体を検索します.
+    //!
+    //! @param [in]     point       検索する点.
+    //! @param [in]     maxDistance 検索する最大距離.
+    //! @param [out]    pHandles    見つかった物体のハンドルの格納先(maxCount 個).
+    //! @param [out]    pDistances  点から物体の中心までの距離の格納先(maxCount 個).
+    //! @param [in]     maxCount    検索する最大数.
+    //! @return     格納したハンドルの数を返却します. 距離の昇順に並びます.
+    //! @note       点を含むセルから外側へ1層ずつ広げ, 残りの層に近いものがなくなった時点で打ち切ります.
+    //!             辿った層の物体密度から打ち切りまでのセル数を見積もり, 全ブロックの走査より高くつく場合は走査に切り替えます.
+    //---------------------------------------------------------------------------------------------
+    uint32_t QueryNearest(
+        const Vector3&  point,
+        float           maxDistance,
+        uint32_t*       pHandles,
+        float*          pDistances,
+        uint32_t        maxCount ) const;
+
+private:
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Block structure
+    // 同じバケットに登録された物体を4個ずつ SoA で格納します.
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct alignas(16) Block
+    {
+        float       x[4];           //!< 中心のX成分です.
+        float       y[4];           //!< 中心のY成分です.
+        float       z[4];           //!< 中心のZ成分です.
+        float       r[4];           //!< 半径です.
+        int32_t     cellX[4];       //!< 中心を含むセルのX座標です(同じバケットに入った別のセルと区別します. 大きな物体は INT32_MIN).
+        int32_t     cellY[4];       //!< 中心を含むセルのY座標です.
+        int32_t     cellZ[4];       //!< 中心を含むセルのZ座標です.
+        uint32_t    handle[4];      //!< 物体のハンドルです(空きレーンは INVALID_HANDLE).
+        uint32_t    next;           //!< 同じバケットの次のブロック, または空きブロックの連結です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Bucket structure
+    // 先頭のブロックだけが埋まりかけで, 後続のブロックは全て4個埋まっています.
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Bucket
+    {
+        uint32_t    head;           //!< 先頭のブロックの番号です.
+        uint32_t    count;          //!< 登録されている物体数です.
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    // Location structure
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    struct Location
+    {
+        uint32_t    bucket;         //!< バケットの番号です(未使用のハンドルは INVALID_HANDLE).
+        uint32_t    block;          //!< ブロックの番号です(未使用のハンドルは次の空きハンドル).
+        uint32_t    lane;           //!< ブロック内の位置です.
+    };
+
+    //=============================================================================================
+    // private variables
+    //=============================================================================================
+    AlignedVector<Block>    m_Blocks;           //!< ブロックです.
+    std::vector<Bucket>     m_Buckets;          //!< バケットです(末尾は大きな物体用).
+    std::vector<Location>   m_Locations;        //!< ハンドルから格納位置への対応表です.
+    uint32_t                m_FreeBlock;        //!< 空きブロックの先頭です.
+    uint32_t                m_FreeHandle;       //!< 空きハンドルの先頭です.
+    uint32_t                m_BucketShift;      //!< ハッシュ値からバケット番号を求めるシフト量です.
+    size_t                  m_Count;            //!< 物体数です.
+    float                   m_CellSize;         //!< セルの一辺の長さです.
+    float                   m_InvCellSize;      //!< セルの一辺の長さの逆数です.
+
+    //=============================================================================================
+    // private methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物体をバケットに登録します.
+    //---------------------------------------------------------------------------------------------
+    void Link( uint32_t handle, const BoundingSphere& sphere );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      物体をバケットから外します.
+    //---------------------------------------------------------------------------------------------
+    void Unlink( uint32_t handle );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      範囲と重なるセルの物体を判定します.
+    //!
+    //! @note       cellTest は bool( int32_t x, int32_t y, int32_t z, uint32_t& planeMask ) の形式で, false のセルを飛ばします.
+    //!             laneTest は uint32_t( const Block& block, uint32_t planeMask ) の形式で, 重なるレーンのマスクを返します.
+    //---------------------------------------------------------------------------------------------
+    template<typename CellTest, typename LaneTest>
+    uint32_t Query(
+        const BoundingBox&  bounds,
+        CellTest&&          cellTest,
+        LaneTest&&          laneTest,
+        uint32_t*           pHandles,
+        uint32_t            maxCount ) const;
+};
+
+} // namespace asvk
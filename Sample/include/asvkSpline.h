@@ -0,0 +1,160 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkSpline.h
+// Desc : Spline Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkMath.h>
+#include <vector>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Spline class
+// 制御点を通る一様 Catmull-Rom スプラインです.
+// 区間ごとに弧長の表を事前計算し，距離からの位置の検索を O(log n) で行います.
+// 弧長の表は曲がりが急な場所や速さが変わる場所で分割点を適応的に増やします.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class Spline
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables
+    //=============================================================================================
+    static constexpr uint32_t DEFAULT_SUBDIVISION = 16;     //!< 弧長の表を作成する際の区間ごとの既定の最小分割数です.
+
+    //=============================================================================================
+    // public methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    Spline();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~Spline();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      制御点を設定し，弧長の表を構築します.
+    //!
+    //! @param [in]     pPoints         制御点の配列.
+    //! @param [in]     count           制御点の数(2以上).
+    //! @param [in]     closed          始点と終点をつないで閉じた曲線にする場合は true.
+    //! @param [in]     subdivision     弧長の表を作成する際の区間ごとの最小分割数(1以上).
+    //! @retval true    構築に成功しました.
+    //! @retval false   構築に失敗しました(制御点が足りない).
+    //! @note       弦の長さと弧長の比が 0.999 を下回るか, 両端と中点の速さの比が 1.2 を超える分割は,
+    //!             最大で 1/16 の長さになるまで2分割されます.
+    //---------------------------------------------------------------------------------------------
+    bool Build( const Vector3* pPoints, size_t count, bool closed, uint32_t subdivision = DEFAULT_SUBDIVISION );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのデータを破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Clear();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パラメータを指定して位置を求めます.
+    //!
+    //! @param [in]     param       パラメータ. 整数部が区間番号, 小数部が区間内の位置で [0, GetSegmentCount()] にクランプされます.
+    //! @return     曲線上の位置を返却します.
+    //---------------------------------------------------------------------------------------------
+    Vector3 Evaluate( float param ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パラメータを指定して複数の位置をまとめて求めます.
+    //!
+    //! @param [in]     pParams     パラメータの配列.
+    //! @param [out]    pResults    曲線上の位置の格納先.
+    //! @param [in]     count       要素数.
+    //! @note       結果は Evaluate( float ) とビット単位で一致します.
+    //---------------------------------------------------------------------------------------------
+    void Evaluate( const float* pParams, Vector3* pResults, size_t count ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      パラメータを指定して接線ベクトルを求めます.
+    //!
+    //! @param [in]     param       パラメータ.
+    //! @return     パラメータに関する微分(正規化されていない)を返却します.
+    //---------------------------------------------------------------------------------------------
+    Vector3 EvaluateTangent( float param ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      始点からの距離をパラメータに変換します.
+    //!
+    //! @param [in]     distance    始点からの曲線に沿った距離. 閉じた曲線では全長で循環し，それ以外はクランプされます.
+    //! @return     パラメータを返却します.
+    //---------------------------------------------------------------------------------------------
+    float GetParam( float distance ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      始点からの距離を指定して位置を求めます.
+    //!
+    //! @param [in]     distance    始点からの曲線に沿った距離.
+    //! @return     曲線上の位置を返却します.
+    //---------------------------------------------------------------------------------------------
+    Vector3 EvaluateAtDistance( float distance ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      始点からの距離を指定して複数の位置をまとめて求めます.
+    //!
+    //! @param [in]     pDistances  始点からの距離の配列.
+    //! @param [out]    pResults    曲線上の位置の格納先.
+    //! @param [in]     count       要素数.
+    //---------------------------------------------------------------------------------------------
+    void EvaluateAtDistance( const float* pDistances, Vector3* pResults, size_t count ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      曲線の長さを取得します.
+    //!
+    //! @return     弧長の表から求めた全長を返却します.
+    //---------------------------------------------------------------------------------------------
+    float GetLength() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      区間数を取得します.
+    //!
+    //! @return     区間数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetSegmentCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      閉じた曲線かどうかを取得します.
+    //!
+    //! @retval true    閉じた曲線です.
+    //! @retval false   開いた曲線です.
+    //---------------------------------------------------------------------------------------------
+    bool IsClosed() const;
+
+private:
+    //=============================================================================================
+    // private variables
+    //=============================================================================================
+    std::vector<Vector3>    m_Points;           //!< 端点の外側を補った制御点です(区間iは m_Points[i]～m_Points[i+3] を使う).
+    std::vector<float>      m_Params;           //!< 分割点ごとのパラメータです.
+    std::vector<float>      m_Distances;        //!< 分割点ごとの始点からの累積距離です.
+    std::vector<float>      m_Speeds;           //!< 分割点ごとの速さ |dP/dt| です.
+    uint32_t                m_Subdivision;      //!< 区間ごとの最小分割数です.
+    bool                    m_Closed;           //!< 閉じた曲線かどうか.
+
+    //=============================================================================================
+    // private methods
+    //=============================================================================================
+    /* NOTHING */
+};
+
+} // namespace asvk
@@ -0,0 +1,231 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkTransformHierarchy.h
+// Desc : Transform Hierarchy Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTypedef.h>
+#include <asvkMath.h>
+#include <asvkAllocator.h>
+#include <vector>
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TransformHierarchy class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class TransformHierarchy
+{
+    //=============================================================================================
+    // list of friend classes and methods.
+    //=============================================================================================
+    /* NOTHING */
+
+public:
+    //=============================================================================================
+    // public variables
+    //=============================================================================================
+    static constexpr uint32_t INVALID_HANDLE = 0xffffffffu;    //!< 無効なハンドルです(親を持たないノードの指定に使います).
+
+    //=============================================================================================
+    // public methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    TransformHierarchy();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //---------------------------------------------------------------------------------------------
+    ~TransformHierarchy();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      指定ノード数分のメモリを予約します.
+    //!
+    //! @param [in]     count       予約するノード数.
+    //---------------------------------------------------------------------------------------------
+    void Reserve( size_t count );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      全てのノードを破棄します.
+    //---------------------------------------------------------------------------------------------
+    void Clear();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ノードを追加します.
+    //!
+    //! @param [in]     parent          親ノードのハンドル. ルートの場合はINVALID_HANDLEを指定します.
+    //! @param [in]     translation     ローカル平行移動量.
+    //! @param [in]     rotation        ローカル回転.
+    //! @param [in]     scale           ローカル拡大縮小率.
+    //! @return     追加したノードのハンドルを返却します.
+    //! @note       親は追加済みのノードである必要があります. ワールド行列は次のUpdate()で計算されます.
+    //---------------------------------------------------------------------------------------------
+    uint32_t Add(
+        uint32_t            parent,
+        const Vector3&      translation,
+        const Quaternion&   rotation,
+        const Vector3&      scale );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ローカル変換を設定し，ノードを更新対象にします.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @param [in]     translation     ローカル平行移動量.
+    //! @param [in]     rotation        ローカル回転.
+    //! @param [in]     scale           ローカル拡大縮小率.
+    //---------------------------------------------------------------------------------------------
+    void SetLocal(
+        uint32_t            handle,
+        const Vector3&      translation,
+        const Quaternion&   rotation,
+        const Vector3&      scale );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ローカル平行移動量を設定し，ノードを更新対象にします.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @param [in]     translation     ローカル平行移動量.
+    //---------------------------------------------------------------------------------------------
+    void SetTranslation( uint32_t handle, const Vector3& translation );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ローカル回転を設定し，ノードを更新対象にします.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @param [in]     rotation        ローカル回転.
+    //---------------------------------------------------------------------------------------------
+    void SetRotation( uint32_t handle, const Quaternion& rotation );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ローカル拡大縮小率を設定し，ノードを更新対象にします.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @param [in]     scale           ローカル拡大縮小率.
+    //---------------------------------------------------------------------------------------------
+    void SetScale( uint32_t handle, const Vector3& scale );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ローカル平行移動量を取得します.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @return     ローカル平行移動量を返却します.
+    //---------------------------------------------------------------------------------------------
+    const Vector3& GetTranslation( uint32_t handle ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ローカル回転を取得します.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @return     ローカル回転を返却します.
+    //---------------------------------------------------------------------------------------------
+    const Quaternion& GetRotation( uint32_t handle ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ローカル拡大縮小率を取得します.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @return     ローカル拡大縮小率を返却します.
+    //---------------------------------------------------------------------------------------------
+    const Vector3& GetScale( uint32_t handle ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      親ノードのハンドルを取得します.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @return     親ノードのハンドルを返却します. ルートの場合はINVALID_HANDLEを返却します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetParent( uint32_t handle ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ワールド行列を取得します.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @return     直近のUpdate()で計算したワールド行列を返却します.
+    //---------------------------------------------------------------------------------------------
+    const Matrix& GetWorld( uint32_t handle ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ノード数を取得します.
+    //!
+    //! @return     ノード数を返却します.
+    //---------------------------------------------------------------------------------------------
+    size_t GetCount() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ハンドルに対応する格納位置を取得します.
+    //!
+    //! @param [in]     handle          ノードのハンドル.
+    //! @return     GetWorldMatrices()の配列内の位置を返却します.
+    //! @note       格納位置はUpdate()で並べ替えが行われると変化します.
+    //---------------------------------------------------------------------------------------------
+    uint32_t GetSlot( uint32_t handle ) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ワールド行列の配列を取得します.
+    //!
+    //! @return     深さ順に並んだワールド行列の配列を返却します.
+    //---------------------------------------------------------------------------------------------
+    const Matrix* GetWorldMatrices() const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      更新対象のノードとその子孫のワールド行列を計算します.
+    //!
+    //! @note       ノードは深さ順に格納されており，同じ深さのノードは互いに独立なので
+    //!             OpenMP有効時は深さごとに並列に計算します.
+    //!             更新対象が少ない間は更新対象と子孫だけを深さごとの待ち行列で辿るため，
+    //!             計算量は変化したノード数に比例します. 待ち行列がその深さのノード数の
+    //!             1/8 を超えた深さからは全ノードを走査します(その深さ以降は O(n) です).
+    //---------------------------------------------------------------------------------------------
+    void Update();
+
+private:
+    //=============================================================================================
+    // private variables
+    //=============================================================================================
+    std::vector<Vector3>      m_Translation;      //!< ローカル平行移動量です(格納位置順).
+    AlignedVector<Quaternion> m_Rotation;         //!< ローカル回転です(格納位置順).
+    std::vector<Vector3>      m_Scale;            //!< ローカル拡大縮小率です(格納位置順).
+    AlignedVector<Matrix>     m_World;            //!< ワールド行列です(格納位置順).
+    std::vector<uint32_t>     m_Parent;           //!< 親の格納位置です(ルートはINVALID_HANDLE).
+    std::vector<uint32_t>     m_Depth;            //!< 深さです(ルートは0).
+    std::vector<uint8_t>      m_Dirty;            //!< ローカル変換が変更されたかどうか.
+    std::vector<uint8_t>      m_Changed;          //!< 全ノードを走査する更新でワールド行列が変化したかどうか.
+    std::vector<uint32_t>     m_SlotOfHandle;     //!< ハンドルから格納位置への対応表です.
+    std::vector<uint32_t>     m_HandleOfSlot;     //!< 格納位置からハンドルへの対応表です.
+    std::vector<uint32_t>     m_LevelOffset;      //!< 深さごとの先頭の格納位置です(末尾は総数).
+    std::vector<uint32_t>     m_DirtyHandle;      //!< 更新対象のノードのハンドルです.
+    std::vector<uint32_t>     m_ChildOffset;      //!< 格納位置ごとの子の先頭です(末尾は総数).
+    std::vector<uint32_t>     m_Child;            //!< 子の格納位置です(親の格納位置順).
+    std::vector<std::vector<uint32_t>> m_LevelQueue;  //!< 深さごとの更新待ちの格納位置です.
+    bool                      m_Sorted;           //!< 深さ順に並んでいるかどうか.
+    bool                      m_ChildValid;       //!< 子の対応表が最新かどうか.
+
+    //=============================================================================================
+    // private methods
+    //=============================================================================================
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ノードを更新対象にします.
+    //---------------------------------------------------------------------------------------------
+    void MarkDirty( uint32_t slot );
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      深さ順に並べ替えます.
+    //---------------------------------------------------------------------------------------------
+    void Sort();
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      子の対応表を構築します.
+    //---------------------------------------------------------------------------------------------
+    void BuildChildren();
+};
+
+} // namespace asvk
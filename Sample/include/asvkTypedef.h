@@ -125,10 +125,10 @@
 
 
 #ifndef ASVK_ALIGN
-    #if _MSC_VER
+    #if defined(_MSC_VER)
         #define ASVK_ALIGN( alignment )    __declspec( align(alignment) )
     #else
-        #define ASVK_ALIGN( alignment )    __attribute__( aligned(alignment) )
+        #define ASVK_ALIGN( alignment )    __attribute__( (aligned(alignment)) )
     #endif
 #endif//ASVK_ALIGN
 
@@ -143,8 +143,8 @@
 #endif//ASVK_WIDE
 
 
-#if defined(_M_IX86) || defined(_M_AMD64)
-  #if defined(_M_IX86_FP)
+#if defined(_M_IX86) || defined(_M_AMD64) || defined(__i386__) || defined(__x86_64__)
+  #if defined(_M_AMD64) || ( defined(_M_IX86_FP) && (_M_IX86_FP >= 2) ) || defined(__SSE2__)
     #define ASVK_IS_SSE2   (1)     // SSE2有効.
     #define ASVK_IS_NEON   (0)     // NEON無効.
   #else
@@ -172,9 +172,17 @@
     #define ASVK_IS_AVX2   (0)
 #endif
 
+// GCC/Clang では AVX2 は F16C を含まないので __F16C__ だけで判定する.
+// MSVC は __F16C__ を定義しないため /arch:AVX2 の場合に有効とする.
+#if defined(__F16C__) || ( defined(_MSC_VER) && defined(__AVX2__) )
+    #define ASVK_IS_F16C   (1)     // 半精度浮動小数変換命令(F16C)有効.
+#else
+    #define ASVK_IS_F16C   (0)     // 半精度浮動小数変換命令(F16C)無効.
+#endif
+
 
-#if defined(ASVK_USE_SIMD)
-    #define ASVK_IS_SIMD   (1)     // SIMD演算有効.
+#if defined(ASVK_USE_SIMD) && ASVK_IS_SSE2
+    #define ASVK_IS_SIMD   (1)     // SIMD演算有効 (SSE2が利用可能な場合のみ).
 #else
     #define ASVK_IS_SIMD   (0)     // SIMD演算無効.
 #endif// defined(ASVK_USE_SIMD)
@@ -187,6 +195,15 @@
 #endif//defined(_OPENMP)
 
 
+#if defined(ASVK_USE_ALIGNED_TYPES)
+    #define ASVK_IS_ALIGNED (1)     // Vector4, Quaternion, Matrix 等を16byte境界に配置.
+    #define ASVK_SIMD_ALIGN ASVK_ALIGN( 16 )
+#else
+    #define ASVK_IS_ALIGNED (0)     // 数学型のアライメントはfloatと同じ.
+    #define ASVK_SIMD_ALIGN
+#endif// defined(ASVK_USE_ALIGNED_TYPES)
+
+
 //--------------------------------------------------------------------------------------------------
 // Type Defenition
 //--------------------------------------------------------------------------------------------------
@@ -195,27 +212,19 @@
 //! @typedef    sptr
 //! @brief      符号付き整数ポインタです.
 //-------------------------------------------------------------------------------------------------
-#ifdef _WIN64
-using sptr = __int64;
-#else
-using sptr = _w64 int;
-#endif
+using sptr = intptr_t;
 
 //-------------------------------------------------------------------------------------------------
 //! @typedef    uptr
 //! @brief      符号なし整数ポインタです.
 //-------------------------------------------------------------------------------------------------
-#ifdef _WIN64 
-using uptr = unsigned __int64;
-#else
-using uptr = _w64 unsigned int;
-#endif
+using uptr = uintptr_t;
 
 //-------------------------------------------------------------------------------------------------
 //! @typedef    nullptr_type
 //! @brief      nullptr型です。
 //-------------------------------------------------------------------------------------------------
-using nullptr_type = decltype(__nullptr);
+using nullptr_type = decltype(nullptr);
 
 //-------------------------------------------------------------------------------------------------
 //! @typedef    half
@@ -228,7 +237,7 @@ using half = unsigned short;
 //! @brief      符号付き8bit整数型の最小値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef S8_MIN
-#define S8_MIN          (-127i8 - 1)
+#define S8_MIN          (-127 - 1)
 #endif//S8_MIN
 
 //--------------------------------------------------------------------------------------------------
@@ -236,7 +245,7 @@ using half = unsigned short;
 //! @brief      符号付き16bit整数型の最小値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef S16_MIN
-#define S16_MIN         (-32767i16 - 1)
+#define S16_MIN         (-32767 - 1)
 #endif//S16_MIN
 
 //--------------------------------------------------------------------------------------------------
@@ -244,7 +253,7 @@ using half = unsigned short;
 //! @brief      符号付き32bit整数型の最小値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef S32_MIN
-#define S32_MIN         (-2147483647i32 - 1)
+#define S32_MIN         (-2147483647 - 1)
 #endif//S32_MIN
 
 //--------------------------------------------------------------------------------------------------
@@ -252,7 +261,7 @@ using half = unsigned short;
 //! @brief      符号付き64bit整数型の最小値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef S64_MIN
-#define S64_MIN         (-9223372036854775807i64 - 1)
+#define S64_MIN         (-9223372036854775807LL - 1)
 #endif//S64_MIN
 
 //--------------------------------------------------------------------------------------------------
@@ -260,7 +269,7 @@ using half = unsigned short;
 //! @brief      符号付8bit整数型の最大値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef S8_MAX
-#define S8_MAX          127i8
+#define S8_MAX          127
 #endif//S8_MAX
 
 //--------------------------------------------------------------------------------------------------
@@ -268,7 +277,7 @@ using half = unsigned short;
 //! @brief      符号付き16bit整数型の最大値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef S16_MAX
-#define S16_MAX         32767i16
+#define S16_MAX         32767
 #endif//S16_MAX
 
 //--------------------------------------------------------------------------------------------------
@@ -276,7 +285,7 @@ using half = unsigned short;
 //! @brief      符号付き32bit整数型の最大値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef S32_MAX
-#define S32_MAX         2147483647i32
+#define S32_MAX         2147483647
 #endif//S32_MAX
 
 //--------------------------------------------------------------------------------------------------
@@ -284,7 +293,7 @@ using half = unsigned short;
 //! @brief      符号付き64bit整数型の最大値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef S64_MAX
-#define S64_MAX         9223372036854775807i64
+#define S64_MAX         9223372036854775807LL
 #endif//S64_MAX
 
 //--------------------------------------------------------------------------------------------------
@@ -292,7 +301,7 @@ using half = unsigned short;
 //! @brief      符号無し8bit整数型の最大値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef U8_MAX
-#define U8_MAX          0xffui8
+#define U8_MAX          0xffu
 #endif//U8_MAX
 
 //--------------------------------------------------------------------------------------------------
@@ -300,7 +309,7 @@ using half = unsigned short;
 //! @brief      符号無し16bit整数型の最大値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef U16_MAX
-#define U16_MAX         0xffffui16
+#define U16_MAX         0xffffu
 #endif//U16_MAX
 
 //--------------------------------------------------------------------------------------------------
@@ -308,7 +317,7 @@ using half = unsigned short;
 //! @brief      符号無し32bit整数型の最大値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef U32_MAX
-#define U32_MAX         0xffffffffui32
+#define U32_MAX         0xffffffffu
 #endif//U32_MAX
 
 //--------------------------------------------------------------------------------------------------
@@ -316,7 +325,7 @@ using half = unsigned short;
 //! @brief      符号無し64bit整数型の最大値です.
 //--------------------------------------------------------------------------------------------------
 #ifndef U64_MAX
-#define U64_MAX         0xffffffffffffffffui64
+#define U64_MAX         0xffffffffffffffffULL
 #endif//U64_MAX
 
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,503 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkBvh.inl
+// Desc : Bounding Volume Hierarchy Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+#pragma once
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Compile-time checks
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static_assert( sizeof(BvhNode) == 32, "BvhNode must be 32 bytes." );
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Bvh class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      プリミティブの判定関数を指定して，レイの最も近い交差を求めます.
+//-------------------------------------------------------------------------------------------------
+template<typename Intersector>
+inline bool Bvh::IntersectClosest
+(
+    const Ray&      ray,
+    float           maxDistance,
+    Intersector&&   intersector,
+    BvhHit&         hit
+) const
+{
+    return TraverseClosest( ray, maxDistance,
+        [this, &intersector]( uint32_t slot, float limit, float& distance )
+        { return intersector( m_Indices[slot], limit, distance ); },
+        hit );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      プリミティブの判定関数を指定して，レイが交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+template<typename Intersector>
+inline bool Bvh::IntersectAny
+(
+    const Ray&      ray,
+    float           maxDistance,
+    Intersector&&   intersector
+) const
+{
+    return TraverseAny( ray, maxDistance,
+        [this, &intersector]( uint32_t slot, float limit, float& distance )
+        { return intersector( m_Indices[slot], limit, distance ); } );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      プリミティブの判定関数を指定して，レイパケットの最も近い交差を求めます.
+//-------------------------------------------------------------------------------------------------
+template<typename Intersector>
+inline uint32_t Bvh::IntersectClosest
+(
+    const RayPacket4&   rays,
+    const float*        pMaxDistance,
+    Intersector&&       intersector,
+    BvhHit*             pHits
+) const
+{
+    return TraversePacketClosest( rays, pMaxDistance,
+        [this, &intersector]( uint32_t slot, const float* pLimit, float* pDistance )
+        { return intersector( m_Indices[slot], pLimit, pDistance ); },
+        pHits );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      プリミティブの判定関数を指定して，レイパケットが交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+template<typename Intersector>
+inline uint32_t Bvh::IntersectAny
+(
+    const RayPacket4&   rays,
+    const float*        pMaxDistance,
+    Intersector&&       intersector
+) const
+{
+    return TraversePacketAny( rays, pMaxDistance,
+        [this, &intersector]( uint32_t slot, const float* pLimit, float* pDistance )
+        { return intersector( m_Indices[slot], pLimit, pDistance ); } );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      プリミティブの判定関数を指定して，レイパケットの最も近い交差を求めます.
+//-------------------------------------------------------------------------------------------------
+template<typename Intersector>
+inline uint32_t Bvh::IntersectClosest
+(
+    const RayPacket8&   rays,
+    const float*        pMaxDistance,
+    Intersector&&       intersector,
+    BvhHit*             pHits
+) const
+{
+    return TraversePacketClosest( rays, pMaxDistance,
+        [this, &intersector]( uint32_t slot, const float* pLimit, float* pDistance )
+        { return intersector( m_Indices[slot], pLimit, pDistance ); },
+        pHits );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      プリミティブの判定関数を指定して，レイパケットが交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+template<typename Intersector>
+inline uint32_t Bvh::IntersectAny
+(
+    const RayPacket8&   rays,
+    const float*        pMaxDistance,
+    Intersector&&       intersector
+) const
+{
+    return TraversePacketAny( rays, pMaxDistance,
+        [this, &intersector]( uint32_t slot, const float* pLimit, float* pDistance )
+        { return intersector( m_Indices[slot], pLimit, pDistance ); } );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最も近い交差を求めて木を走査します.
+//      両方の子と交差する場合は近い方から辿り，遠い方は交差距離と一緒にスタックへ積みます.
+//      取り出した時点で最近傍より遠いノードは辿らずに捨てます.
+//-------------------------------------------------------------------------------------------------
+template<typename LeafIntersector>
+inline bool Bvh::TraverseClosest
+(
+    const Ray&          ray,
+    float               maxDistance,
+    LeafIntersector&&   intersector,
+    BvhHit&             hit
+) const
+{
+    float distance;
+    if ( m_Nodes.empty() || !m_Nodes[0].bounds.Intersects( ray, maxDistance, distance ) )
+    { return false; }
+
+    uint32_t stackNode    [MAX_DEPTH];
+    float    stackDistance[MAX_DEPTH];
+    uint32_t top   = 0;
+    uint32_t index = 0;
+    auto closest = maxDistance;
+    auto found   = false;
+
+    for( ;; )
+    {
+        const auto& node = m_Nodes[index];
+        if ( node.IsLeaf() )
+        {
+            for( auto i=0u; i<node.count; ++i )
+            {
+                auto slot = node.offset + i;
+                if ( intersector( slot, closest, distance ) && distance <= closest )
+                {
+                    closest      = distance;
+                    hit.index    = m_Indices[slot];
+                    hit.distance = distance;
+                    found        = true;
+                }
+            }
+        }
+        else
+        {
+            auto  nearIndex = index + 1;
+            auto  farIndex  = node.offset;
+            float nearDistance;
+            float farDistance;
+            auto  hitNear = m_Nodes[nearIndex].bounds.Intersects( ray, closest, nearDistance );
+            auto  hitFar  = m_Nodes[farIndex ].bounds.Intersects( ray, closest, farDistance );
+
+            if ( hitNear && hitFar )
+            {
+                if ( farDistance < nearDistance )
+                {
+                    std::swap( nearIndex,    farIndex );
+                    std::swap( nearDistance, farDistance );
+                }
+
+                assert( top < MAX_DEPTH );
+                stackNode    [top] = farIndex;
+                stackDistance[top] = farDistance;
+                top++;
+                index = nearIndex;
+                continue;
+            }
+            else if ( hitNear )
+            {
+                index = nearIndex;
+                continue;
+            }
+            else if ( hitFar )
+            {
+                index = farIndex;
+                continue;
+            }
+        }
+
+        // スタックから次のノードを取り出す.
+        auto popped = false;
+        while( top > 0 )
+        {
+            top--;
+            if ( stackDistance[top] <= closest )
+            {
+                index  = stackNode[top];
+                popped = true;
+                break;
+            }
+        }
+
+        if ( !popped )
+        { break; }
+    }
+
+    return found;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      いずれかと交差するか木を走査します. 最初に見つかった交差で打ち切ります.
+//-------------------------------------------------------------------------------------------------
+template<typename LeafIntersector>
+inline bool Bvh::TraverseAny
+(
+    const Ray&          ray,
+    float               maxDistance,
+    LeafIntersector&&   intersector
+) const
+{
+    float distance;
+    if ( m_Nodes.empty() || !m_Nodes[0].bounds.Intersects( ray, maxDistance, distance ) )
+    { return false; }
+
+    uint32_t stackNode[MAX_DEPTH];
+    uint32_t top   = 0;
+    uint32_t index = 0;
+
+    for( ;; )
+    {
+        const auto& node = m_Nodes[index];
+        if ( node.IsLeaf() )
+        {
+            for( auto i=0u; i<node.count; ++i )
+            {
+                if ( intersector( node.offset + i, maxDistance, distance ) && distance <= maxDistance )
+                { return true; }
+            }
+        }
+        else
+        {
+            auto hitLeft  = m_Nodes[index + 1  ].bounds.Intersects( ray, maxDistance, distance );
+            auto hitRight = m_Nodes[node.offset].bounds.Intersects( ray, maxDistance, distance );
+
+            if ( hitLeft && hitRight )
+            {
+                assert( top < MAX_DEPTH );
+                stackNode[top++] = node.offset;
+                index = index + 1;
+                continue;
+            }
+            else if ( hitLeft )
+            {
+                index = index + 1;
+                continue;
+            }
+            else if ( hitRight )
+            {
+                index = node.offset;
+                continue;
+            }
+        }
+
+        if ( top == 0 )
+        { break; }
+
+        index = stackNode[--top];
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットの最も近い交差を求めて木を走査します.
+//      いずれかのレーンが交差するノードをレーンのマスクと一緒に辿ります.
+//      両方の子と交差する場合は交差したレーンの最小距離が近い方から辿り，遠い方はその最小距離と一緒にスタックへ積みます.
+//      取り出した時点で対象レーンの最近傍の最大値より遠いノードは辿らずに捨てます.
+//-------------------------------------------------------------------------------------------------
+template<typename Packet, typename LeafIntersector>
+inline uint32_t Bvh::TraversePacketClosest
+(
+    const Packet&       rays,
+    const float*        pMaxDistance,
+    LeafIntersector&&   intersector,
+    BvhHit*             pHits
+) const
+{
+    static constexpr uint32_t WIDTH = Packet::WIDTH;
+
+    if ( m_Nodes.empty() )
+    { return 0; }
+
+    float closest [WIDTH];
+    float distance[WIDTH];
+    for( auto lane=0u; lane<WIDTH; ++lane )
+    { closest[lane] = pMaxDistance[lane]; }
+
+    auto mask = rays.Intersects( m_Nodes[0].bounds, closest, distance );
+    if ( mask == 0 )
+    { return 0; }
+
+    uint32_t stackNode    [MAX_DEPTH];
+    uint32_t stackMask    [MAX_DEPTH];
+    float    stackDistance[MAX_DEPTH];
+    uint32_t top   = 0;
+    uint32_t index = 0;
+    uint32_t found = 0;
+
+    for( ;; )
+    {
+        const auto& node = m_Nodes[index];
+        if ( node.IsLeaf() )
+        {
+            for( auto i=0u; i<node.count; ++i )
+            {
+                auto slot = node.offset + i;
+                auto hits = intersector( slot, closest, distance ) & mask;
+                for( auto lane=0u; hits != 0; ++lane, hits >>= 1 )
+                {
+                    if ( ( hits & 0x1 ) && distance[lane] <= closest[lane] )
+                    {
+                        closest[lane]        = distance[lane];
+                        pHits[lane].index    = m_Indices[slot];
+                        pHits[lane].distance = distance[lane];
+                        found |= 1u << lane;
+                    }
+                }
+            }
+        }
+        else
+        {
+            float nearDistance[WIDTH];
+            float farDistance [WIDTH];
+            auto  nearIndex = index + 1;
+            auto  farIndex  = node.offset;
+            auto  nearMask  = rays.Intersects( m_Nodes[nearIndex].bounds, closest, nearDistance ) & mask;
+            auto  farMask   = rays.Intersects( m_Nodes[farIndex ].bounds, closest, farDistance  ) & mask;
+
+            if ( nearMask != 0 && farMask != 0 )
+            {
+                auto nearMin = F32_MAX;
+                auto farMin  = F32_MAX;
+                for( auto lane=0u; lane<WIDTH; ++lane )
+                {
+                    if ( ( nearMask >> lane ) & 0x1 ) { nearMin = ( nearDistance[lane] < nearMin ) ? nearDistance[lane] : nearMin; }
+                    if ( ( farMask  >> lane ) & 0x1 ) { farMin  = ( farDistance [lane] < farMin  ) ? farDistance [lane] : farMin;  }
+                }
+
+                if ( farMin < nearMin )
+                {
+                    std::swap( nearIndex, farIndex );
+                    std::swap( nearMask,  farMask );
+                    std::swap( nearMin,   farMin );
+                }
+
+                assert( top < MAX_DEPTH );
+                stackNode    [top] = farIndex;
+                stackMask    [top] = farMask;
+                stackDistance[top] = farMin;
+                top++;
+                index = nearIndex;
+                mask  = nearMask;
+                continue;
+            }
+            else if ( nearMask != 0 )
+            {
+                index = nearIndex;
+                mask  = nearMask;
+                continue;
+            }
+            else if ( farMask != 0 )
+            {
+                index = farIndex;
+                mask  = farMask;
+                continue;
+            }
+        }
+
+        // スタックから次のノードを取り出す.
+        auto popped = false;
+        while( top > 0 )
+        {
+            top--;
+            auto limit = -F32_MAX;
+            for( auto lane=0u; lane<WIDTH; ++lane )
+            {
+                if ( ( stackMask[top] >> lane ) & 0x1 )
+                { limit = ( closest[lane] > limit ) ? closest[lane] : limit; }
+            }
+
+            if ( stackDistance[top] <= limit )
+            {
+                index  = stackNode[top];
+                mask   = stackMask[top];
+                popped = true;
+                break;
+            }
+        }
+
+        if ( !popped )
+        { break; }
+    }
+
+    return found;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットがいずれかと交差するか木を走査します. 全てのレーンが交差した時点で打ち切ります.
+//-------------------------------------------------------------------------------------------------
+template<typename Packet, typename LeafIntersector>
+inline uint32_t Bvh::TraversePacketAny
+(
+    const Packet&       rays,
+    const float*        pMaxDistance,
+    LeafIntersector&&   intersector
+) const
+{
+    static constexpr uint32_t WIDTH = Packet::WIDTH;
+
+    if ( m_Nodes.empty() )
+    { return 0; }
+
+    float distance[WIDTH];
+    auto active = rays.Intersects( m_Nodes[0].bounds, pMaxDistance, distance );
+    if ( active == 0 )
+    { return 0; }
+
+    uint32_t stackNode[MAX_DEPTH];
+    uint32_t stackMask[MAX_DEPTH];
+    uint32_t top   = 0;
+    uint32_t index = 0;
+    uint32_t mask  = active;
+    uint32_t found = 0;
+
+    for( ;; )
+    {
+        const auto& node = m_Nodes[index];
+        if ( node.IsLeaf() )
+        {
+            for( auto i=0u; i<node.count && mask != 0; ++i )
+            {
+                found |= intersector( node.offset + i, pMaxDistance, distance ) & mask;
+                if ( found == active )
+                { return found; }
+                mask &= ~found;
+            }
+        }
+        else
+        {
+            auto leftMask  = rays.Intersects( m_Nodes[index + 1  ].bounds, pMaxDistance, distance ) & mask;
+            auto rightMask = rays.Intersects( m_Nodes[node.offset].bounds, pMaxDistance, distance ) & mask;
+
+            if ( leftMask != 0 && rightMask != 0 )
+            {
+                assert( top < MAX_DEPTH );
+                stackNode[top] = node.offset;
+                stackMask[top] = rightMask;
+                top++;
+                index = index + 1;
+                mask  = leftMask;
+                continue;
+            }
+            else if ( leftMask != 0 )
+            {
+                index = index + 1;
+                mask  = leftMask;
+                continue;
+            }
+            else if ( rightMask != 0 )
+            {
+                index = node.offset;
+                mask  = rightMask;
+                continue;
+            }
+        }
+
+        // 交差が見つかったレーンを除いて, スタックから次のノードを取り出す.
+        mask = 0;
+        while( top > 0 && mask == 0 )
+        {
+            top--;
+            index = stackNode[top];
+            mask  = stackMask[top] & ~found;
+        }
+
+        if ( mask == 0 )
+        { break; }
+    }
+
+    return found;
+}
+
+} // namespace asvk
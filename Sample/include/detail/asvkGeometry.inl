@@ -1,11 +1,11 @@
 ﻿//-------------------------------------------------------------------------------------------------
-// File : asdxGeometry.inl
+// File : asvkGeometry.inl
 // Desc : Geometry Module.
 // Copyright(c) Project Asura. All right reserved.
 //-------------------------------------------------------------------------------------------------
 #pragma once
 
-namespace asdx {
+namespace asvk {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Ray structure
@@ -14,14 +14,14 @@ namespace asdx {
 //-------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 Ray::Ray( const Vector3& position, const Vector3& direction )
 { Update( position, direction ); }
 
 //-------------------------------------------------------------------------------------------------
 //      コピーコンストラクタです.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 Ray::Ray( const Ray& value )
 : pos   ( value.pos )
 , dir   ( value.dir )
@@ -32,7 +32,7 @@ Ray::Ray( const Ray& value )
 //-------------------------------------------------------------------------------------------------
 //      レイを更新します.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 void Ray::Update( const Vector3& position, const Vector3& direction )
 {
     pos = position;
@@ -40,9 +40,10 @@ void Ray::Update( const Vector3& position, const Vector3& direction )
     invDir.x = 1.0f / dir.x;
     invDir.y = 1.0f / dir.y;
     invDir.z = 1.0f / dir.z;
-    sign.x = ( dir.x > 0.0f ) ? 0 : 1;
-    sign.y = ( dir.y > 0.0f ) ? 0 : 1;
-    sign.z = ( dir.z > 0.0f ) ? 0 : 1;
+    // 方向が +0 の軸も正方向として扱うため, 逆数の符号で判定する.
+    sign.x = ( invDir.x < 0.0f ) ? 1 : 0;
+    sign.y = ( invDir.y < 0.0f ) ? 1 : 0;
+    sign.z = ( invDir.z < 0.0f ) ? 1 : 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -52,7 +53,7 @@ void Ray::Update( const Vector3& position, const Vector3& direction )
 //--------------------------------------------------------------------------------------------------
 //      コンストラクタです.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 BoundingBox::BoundingBox()
 : mini(  F32_MAX,  F32_MAX,  F32_MAX )
 , maxi( -F32_MAX, -F32_MAX, -F32_MAX )
@@ -61,8 +62,8 @@ BoundingBox::BoundingBox()
 //--------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
-BoundingBox::BoundingBox( const asdx::Vector3& _min, const asdx::Vector3& _max )
+ASVK_INLINE
+BoundingBox::BoundingBox( const Vector3& _min, const Vector3& _max )
 : mini( _min )
 , maxi( _max )
 { /* DO_NOTHING */ }
@@ -70,7 +71,7 @@ BoundingBox::BoundingBox( const asdx::Vector3& _min, const asdx::Vector3& _max )
 //--------------------------------------------------------------------------------------------------
 //      コピーコンストラクタです.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 BoundingBox::BoundingBox( const BoundingBox& value )
 : mini( value.mini )
 , maxi( value.maxi )
@@ -79,14 +80,14 @@ BoundingBox::BoundingBox( const BoundingBox& value )
 //--------------------------------------------------------------------------------------------------
 //      中心座標を取得します.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 Vector3 BoundingBox::GetCenter() const
 { return ( maxi + mini ) * 0.5f; }
 
 //--------------------------------------------------------------------------------------------------
 //      8角の頂点を取得します.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 std::array<Vector3, 8> BoundingBox::GetCorners() const
 {
     std::array<Vector3, 8> result;
@@ -108,7 +109,7 @@ std::array<Vector3, 8> BoundingBox::GetCorners() const
 //-------------------------------------------------------------------------------------------------
 //      点が含まれるかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool BoundingBox::Contains( const Vector3& point ) const
 {
     if ( mini.x > point.x || point.x > maxi.x
@@ -122,10 +123,10 @@ bool BoundingBox::Contains( const Vector3& point ) const
 //-------------------------------------------------------------------------------------------------
 //      点群が含まれるかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
-bool BoundingBox::Contains( const Vector3* pVertices, const u32 count ) const
+ASVK_INLINE
+bool BoundingBox::Contains( const Vector3* pVertices, const uint32_t count ) const
 {
-    for( u32 i=0; i<count; ++i )
+    for( uint32_t i=0; i<count; ++i )
     {
         if ( !Contains(pVertices[i]) )
         { return false; }
@@ -137,7 +138,7 @@ bool BoundingBox::Contains( const Vector3* pVertices, const u32 count ) const
 //-------------------------------------------------------------------------------------------------
 //      バウンディングスフィアが含まれるかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool BoundingBox::Contains( const BoundingSphere& sphere ) const
 {
     auto v = Vector3::Clamp( sphere.center, mini, maxi );
@@ -148,7 +149,7 @@ bool BoundingBox::Contains( const BoundingSphere& sphere ) const
 //-------------------------------------------------------------------------------------------------
 //      バウンディングボックスが含まれるかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool BoundingBox::Contains( const BoundingBox& box ) const
 {
     if ( maxi.x < box.mini.x || mini.x > box.maxi.x )
@@ -166,22 +167,50 @@ bool BoundingBox::Contains( const BoundingBox& box ) const
 //--------------------------------------------------------------------------------------------------
 //      マージします.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
-void BoundingBox::Merge( const asdx::Vector3& value )
+ASVK_INLINE
+void BoundingBox::Merge( const Vector3& value )
 {
-    maxi = asdx::Vector3::Max( maxi, value );
-    mini = asdx::Vector3::Min( mini, value );
+    maxi = Vector3::Max( maxi, value );
+    mini = Vector3::Min( mini, value );
+}
+
+//--------------------------------------------------------------------------------------------------
+//      レイと交差するか判定します.
+//      ※ Williams et al. "An Efficient and Robust Ray-Box Intersection Algorithm" を参照.
+//--------------------------------------------------------------------------------------------------
+ASVK_INLINE
+bool BoundingBox::Intersects( const Ray& ray, float maxDistance, float& distance ) const
+{
+    auto tx0 = ( ( ray.sign.x ? maxi.x : mini.x ) - ray.pos.x ) * ray.invDir.x;
+    auto tx1 = ( ( ray.sign.x ? mini.x : maxi.x ) - ray.pos.x ) * ray.invDir.x;
+    auto ty0 = ( ( ray.sign.y ? maxi.y : mini.y ) - ray.pos.y ) * ray.invDir.y;
+    auto ty1 = ( ( ray.sign.y ? mini.y : maxi.y ) - ray.pos.y ) * ray.invDir.y;
+    auto tz0 = ( ( ray.sign.z ? maxi.z : mini.z ) - ray.pos.z ) * ray.invDir.z;
+    auto tz1 = ( ( ray.sign.z ? mini.z : maxi.z ) - ray.pos.z ) * ray.invDir.z;
+
+    // 始点が面上にあり方向成分が0の軸は 0 * inf = NaN になるので, 比較で捨てて制約なしとして扱う.
+    auto tmin = 0.0f;
+    auto tmax = maxDistance;
+    tmin = ( tx0 > tmin ) ? tx0 : tmin;
+    tmin = ( ty0 > tmin ) ? ty0 : tmin;
+    tmin = ( tz0 > tmin ) ? tz0 : tmin;
+    tmax = ( tx1 < tmax ) ? tx1 : tmax;
+    tmax = ( ty1 < tmax ) ? ty1 : tmax;
+    tmax = ( tz1 < tmax ) ? tz1 : tmax;
+
+    distance = tmin;
+    return tmin <= tmax;
 }
 
 //--------------------------------------------------------------------------------------------------
 //      マージします.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 BoundingBox BoundingBox::Merge( const BoundingBox& a, const BoundingBox& b )
 {
     return BoundingBox(
-        asdx::Vector3::Min( a.mini, b.mini ),
-        asdx::Vector3::Max( a.maxi, b.maxi ) );
+        Vector3::Min( a.mini, b.mini ),
+        Vector3::Max( a.maxi, b.maxi ) );
 }
 
 
@@ -192,7 +221,7 @@ BoundingBox BoundingBox::Merge( const BoundingBox& a, const BoundingBox& b )
 //--------------------------------------------------------------------------------------------------
 //      コンストラクタです.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 BoundingSphere::BoundingSphere()
 : center( 0.0f, 0.0f, 0.0f )
 , radius( F32_MAX )
@@ -201,8 +230,8 @@ BoundingSphere::BoundingSphere()
 //--------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
-BoundingSphere::BoundingSphere( const asdx::Vector3& _center, const f32 _radius )
+ASVK_INLINE
+BoundingSphere::BoundingSphere( const Vector3& _center, const float _radius )
 : center( _center )
 , radius( _radius )
 { /* DO_NOTHING */ }
@@ -210,17 +239,17 @@ BoundingSphere::BoundingSphere( const asdx::Vector3& _center, const f32 _radius
 //--------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 BoundingSphere::BoundingSphere( const BoundingBox& value )
 {
     center = ( value.mini + value.maxi ) * 0.5f;
-    radius = asdx::Vector3::Distance( value.mini, value.maxi ) * 0.5f;
+    radius = Vector3::Distance( value.mini, value.maxi ) * 0.5f;
 }
 
 //--------------------------------------------------------------------------------------------------
 //      コピーコンストラクタです.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 BoundingSphere::BoundingSphere( const BoundingSphere& value )
 : center( value.center )
 , radius( value.radius )
@@ -229,7 +258,7 @@ BoundingSphere::BoundingSphere( const BoundingSphere& value )
 //-------------------------------------------------------------------------------------------------
 //      点を含むかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool BoundingSphere::Contains( const Vector3& point ) const
 {
     auto dist = Vector3::DistanceSq( point, center );
@@ -239,11 +268,11 @@ bool BoundingSphere::Contains( const Vector3& point ) const
 //-------------------------------------------------------------------------------------------------
 //      点群を含むかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
-bool BoundingSphere::Contains( const Vector3* pVertices, const u32 count ) const
+ASVK_INLINE
+bool BoundingSphere::Contains( const Vector3* pVertices, const uint32_t count ) const
 {
     auto r2 = radius * radius;
-    for( u32 i=0; i<count; ++i )
+    for( uint32_t i=0; i<count; ++i )
     {
         auto dist = Vector3::DistanceSq( pVertices[i], center );
         if ( dist > r2 )
@@ -256,12 +285,12 @@ bool BoundingSphere::Contains( const Vector3* pVertices, const u32 count ) const
 //-------------------------------------------------------------------------------------------------
 //      バウンディングボックスを含むかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool BoundingSphere::Contains( const BoundingBox& box ) const
 {
     auto corners = box.GetCorners();
     auto r2 = radius * radius;
-    for( u32 i=0; i<8; ++i )
+    for( uint32_t i=0; i<8; ++i )
     {
         auto dist = Vector3::DistanceSq( corners[i], center );
         if ( dist > r2 )
@@ -274,7 +303,7 @@ bool BoundingSphere::Contains( const BoundingBox& box ) const
 //-------------------------------------------------------------------------------------------------
 //      バウンディングスフィアを含むかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool BoundingSphere::Contains( const BoundingSphere& sphere ) const
 {
     auto dist = Vector3::Distance(center, sphere.center);
@@ -284,10 +313,10 @@ bool BoundingSphere::Contains( const BoundingSphere& sphere ) const
 //--------------------------------------------------------------------------------------------------
 //      マージします.
 //--------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 BoundingSphere BoundingSphere::Merge( const BoundingSphere& a, const BoundingSphere& b )
 {
-    asdx::Vector3 dif( 
+    Vector3 dif( 
         b.center.x - a.center.x,
         b.center.y - a.center.y,
         b.center.z - a.center.z );
@@ -305,12 +334,12 @@ BoundingSphere BoundingSphere::Merge( const BoundingSphere& a, const BoundingSph
 
     assert( len > 0.0f );
     auto v = dif * ( 1.0f / len );
-    auto fmin = asdx::Min<f32>( -a.radius, len - b.radius );
-    auto fmax = asdx::Max<f32>(  a.radius, len + b.radius );
+    auto fmin = Min<float>( -a.radius, len - b.radius );
+    auto fmax = Max<float>(  a.radius, len + b.radius );
     auto fmag = ( fmax - fmin ) * 0.5f;
 
     return BoundingSphere(
-        asdx::Vector3( a.center.x + v.x * ( fmag + fmin ),
+        Vector3( a.center.x + v.x * ( fmag + fmin ),
                        a.center.y + v.y * ( fmag + fmin ),
                        a.center.z + v.z * ( fmag + fmin )
         ),
@@ -318,6 +347,190 @@ BoundingSphere BoundingSphere::Merge( const BoundingSphere& a, const BoundingSph
     );
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Triangle structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Triangle::Triangle()
+: v0( 0.0f, 0.0f, 0.0f )
+, v1( 0.0f, 0.0f, 0.0f )
+, v2( 0.0f, 0.0f, 0.0f )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Triangle::Triangle( const Vector3& _v0, const Vector3& _v1, const Vector3& _v2 )
+: v0( _v0 )
+, v1( _v1 )
+, v2( _v2 )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      コピーコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Triangle::Triangle( const Triangle& value )
+: v0( value.v0 )
+, v1( value.v1 )
+, v2( value.v2 )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      レイと交差するか判定します.
+//      ※ Moller, Trumbore. "Fast, Minimum Storage Ray/Triangle Intersection" を参照.
+//      ※ RayPacket4/8 の判定と結果を一致させるため，演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+bool Triangle::Intersects( const Ray& ray, float maxDistance, float& distance ) const
+{
+    auto e1 = v1 - v0;
+    auto e2 = v2 - v0;
+    auto p  = Vector3::Cross( ray.dir, e2 );
+    auto invDet = 1.0f / Vector3::Dot( e1, p );
+
+    auto s = ray.pos - v0;
+    auto q = Vector3::Cross( s, e1 );
+    auto u = Vector3::Dot( s, p ) * invDet;
+    auto v = Vector3::Dot( ray.dir, q ) * invDet;
+    auto t = Vector3::Dot( e2, q ) * invDet;
+
+    // レイと平行な場合は inf や NaN になり, 以下の比較で棄却される.
+    distance = t;
+    return ( u >= 0.0f ) && ( v >= 0.0f ) && ( u + v <= 1.0f ) && ( t >= 0.0f ) && ( t <= maxDistance );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RayPacket4 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+RayPacket4::RayPacket4()
+: posX   {}
+, posY   {}
+, posZ   {}
+, dirX   {}
+, dirY   {}
+, dirZ   {}
+, invDirX{}
+, invDirY{}
+, invDirZ{}
+, signX  {}
+, signY  {}
+, signZ  {}
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      レイを設定します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void RayPacket4::Set( uint32_t lane, const Ray& ray )
+{
+    assert( lane < WIDTH );
+    posX   [lane] = ray.pos.x;
+    posY   [lane] = ray.pos.y;
+    posZ   [lane] = ray.pos.z;
+    dirX   [lane] = ray.dir.x;
+    dirY   [lane] = ray.dir.y;
+    dirZ   [lane] = ray.dir.z;
+    invDirX[lane] = ray.invDir.x;
+    invDirY[lane] = ray.invDir.y;
+    invDirZ[lane] = ray.invDir.z;
+    signX  [lane] = ray.sign.x ? ~0u : 0u;
+    signY  [lane] = ray.sign.y ? ~0u : 0u;
+    signZ  [lane] = ray.sign.z ? ~0u : 0u;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイを取得します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Ray RayPacket4::GetRay( uint32_t lane ) const
+{
+    assert( lane < WIDTH );
+    auto result = Ray(
+        Vector3( posX[lane], posY[lane], posZ[lane] ),
+        Vector3( dirX[lane], dirY[lane], dirZ[lane] ) );
+
+    // 設定済みの逆数と符号で上書きする(インライン展開されると逆数の除算は省かれる).
+    result.invDir = Vector3( invDirX[lane], invDirY[lane], invDirZ[lane] );
+    result.sign.x = signX[lane] ? 1 : 0;
+    result.sign.y = signY[lane] ? 1 : 0;
+    result.sign.z = signZ[lane] ? 1 : 0;
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RayPacket8 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+RayPacket8::RayPacket8()
+: posX   {}
+, posY   {}
+, posZ   {}
+, dirX   {}
+, dirY   {}
+, dirZ   {}
+, invDirX{}
+, invDirY{}
+, invDirZ{}
+, signX  {}
+, signY  {}
+, signZ  {}
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      レイを設定します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void RayPacket8::Set( uint32_t lane, const Ray& ray )
+{
+    assert( lane < WIDTH );
+    posX   [lane] = ray.pos.x;
+    posY   [lane] = ray.pos.y;
+    posZ   [lane] = ray.pos.z;
+    dirX   [lane] = ray.dir.x;
+    dirY   [lane] = ray.dir.y;
+    dirZ   [lane] = ray.dir.z;
+    invDirX[lane] = ray.invDir.x;
+    invDirY[lane] = ray.invDir.y;
+    invDirZ[lane] = ray.invDir.z;
+    signX  [lane] = ray.sign.x ? ~0u : 0u;
+    signY  [lane] = ray.sign.y ? ~0u : 0u;
+    signZ  [lane] = ray.sign.z ? ~0u : 0u;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイを取得します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Ray RayPacket8::GetRay( uint32_t lane ) const
+{
+    assert( lane < WIDTH );
+    auto result = Ray(
+        Vector3( posX[lane], posY[lane], posZ[lane] ),
+        Vector3( dirX[lane], dirY[lane], dirZ[lane] ) );
+
+    // 設定済みの逆数と符号で上書きする(インライン展開されると逆数の除算は省かれる).
+    result.invDir = Vector3( invDirX[lane], invDirY[lane], invDirZ[lane] );
+    result.sign.x = signX[lane] ? 1 : 0;
+    result.sign.y = signY[lane] ? 1 : 0;
+    result.sign.z = signZ[lane] ? 1 : 0;
+    return result;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // ViewFrustum class
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -325,7 +538,7 @@ BoundingSphere BoundingSphere::Merge( const BoundingSphere& a, const BoundingSph
 //-------------------------------------------------------------------------------------------------
 //      コンストラクタです.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 ViewFrustum::ViewFrustum()
 : m_Position( 0.0f, 0.0f, 0.0f )
 , m_Forward ( 0.0f, 0.0f, 1.0f )
@@ -333,6 +546,8 @@ ViewFrustum::ViewFrustum()
 , m_Upward  ( 0.0f, 1.0f, 0.0f )
 , m_FactorR ( 0.0f )
 , m_FactorU ( 0.0f )
+, m_SphereFactorR( 1.0f )
+, m_SphereFactorU( 1.0f )
 , m_NearClip( 0.0f )
 , m_FarClip ( 0.0f )
 { /* DO_NOTHING */ }
@@ -340,17 +555,22 @@ ViewFrustum::ViewFrustum()
 //-------------------------------------------------------------------------------------------------
 //      透視変換パラメータを設定します.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 void ViewFrustum::SetPerspective
 (
-    const f32 fieldOfView,
-    const f32 aspectRatio,
-    const f32 nearClip,
-    const f32 farClip
+    const float fieldOfView,
+    const float aspectRatio,
+    const float nearClip,
+    const float farClip
 )
 {
-    m_FactorR  = tanf( fieldOfView / 2.0f );
-    m_FactorU  = m_FactorR * aspectRatio;
+    // fieldOfView は Matrix::CreatePerspectiveFieldOfView() と同じく垂直方向の視野角.
+    m_FactorU  = tanf( fieldOfView / 2.0f );
+    m_FactorR  = m_FactorU * aspectRatio;
+
+    // 側面までの距離は r - factor * f を sqrt( 1 + factor^2 ) で割ったものになる.
+    m_SphereFactorR = sqrtf( 1.0f + m_FactorR * m_FactorR );
+    m_SphereFactorU = sqrtf( 1.0f + m_FactorU * m_FactorU );
     m_NearClip = nearClip;
     m_FarClip  = farClip;
 }
@@ -358,7 +578,7 @@ void ViewFrustum::SetPerspective
 //-------------------------------------------------------------------------------------------------
 //      ビュー変換パラメータを設定します.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 void ViewFrustum::SetView
 (
     const Vector3& position,
@@ -376,7 +596,7 @@ void ViewFrustum::SetView
 //-------------------------------------------------------------------------------------------------
 //      ビュー変換パラメータを設定します.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 void ViewFrustum::SetLookAt
 (
     const Vector3& position,
@@ -385,7 +605,7 @@ void ViewFrustum::SetLookAt
 )
 {
     m_Position = position;
-    m_Forward  = Vector3::Normalize(position - target);
+    m_Forward  = Vector3::Normalize(target - position);
     m_Right    = Vector3::Normalize(Vector3::Cross(upward, m_Forward));
     m_Upward   = Vector3::Normalize(Vector3::Cross(m_Forward, m_Right));
 }
@@ -393,7 +613,7 @@ void ViewFrustum::SetLookAt
 //-------------------------------------------------------------------------------------------------
 //      ビュー変換パラメータを設定します.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 void ViewFrustum::SetLookTo
 (
     const Vector3& position,
@@ -402,7 +622,7 @@ void ViewFrustum::SetLookTo
 )
 {
     m_Position = position;
-    m_Forward  = -direction;
+    m_Forward  = Vector3::Normalize(direction);
     m_Right    = Vector3::Normalize(Vector3::Cross(upward, m_Forward));
     m_Upward   = Vector3::Normalize(Vector3::Cross(m_Forward, m_Right));
 }
@@ -410,7 +630,7 @@ void ViewFrustum::SetLookTo
 //-------------------------------------------------------------------------------------------------
 //      点が含まれるかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool ViewFrustum::Contains( const Vector3& point ) const
 {
     auto op = point - m_Position;
@@ -434,8 +654,8 @@ bool ViewFrustum::Contains( const Vector3& point ) const
 //-------------------------------------------------------------------------------------------------
 //      点群が含まれるかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
-bool ViewFrustum::Contains( const Vector3* pVertices, const u32 count ) const
+ASVK_INLINE
+bool ViewFrustum::Contains( const Vector3* pVertices, const uint32_t count ) const
 {
     auto behindLeft   = 0;
     auto behindRight  = 0;
@@ -447,7 +667,7 @@ bool ViewFrustum::Contains( const Vector3* pVertices, const u32 count ) const
     auto inForward = false;
     auto inRight   = false;
     auto inUp      = false;
-    for( u32 i=0; i<count; ++i )
+    for( uint32_t i=0; i<count; ++i )
     {
         inForward = inRight = inUp = false;
 
@@ -461,7 +681,7 @@ bool ViewFrustum::Contains( const Vector3* pVertices, const u32 count ) const
 
         if ( f < m_NearClip )
         { ++behindNear; }
-        else if ( f < m_FarClip )
+        else if ( f > m_FarClip )
         { ++behindFar; }
         else
         { inForward = true; }
@@ -484,12 +704,13 @@ bool ViewFrustum::Contains( const Vector3* pVertices, const u32 count ) const
         { return true; }
     }
 
-    if ( behindLeft   == 8
-      || behindRight  == 8 
-      || behindFar    == 8 
-      || behindNear   == 8 
-      || behindTop    == 8
-      || behindBottom == 8 )
+    auto n = static_cast<int>( count );
+    if ( behindLeft   == n
+      || behindRight  == n
+      || behindFar    == n
+      || behindNear   == n
+      || behindTop    == n
+      || behindBottom == n )
     { return false; }
 
     return true;
@@ -498,7 +719,7 @@ bool ViewFrustum::Contains( const Vector3* pVertices, const u32 count ) const
 //-------------------------------------------------------------------------------------------------
 //      バウンディングスフィアが含まれるかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool ViewFrustum::Contains(const BoundingSphere& sphere) const
 {
     auto op = sphere.center - m_Position;
@@ -508,13 +729,13 @@ bool ViewFrustum::Contains(const BoundingSphere& sphere) const
 
     auto r = Vector3::Dot(op, m_Right);
     auto rLimit = m_FactorR * f;
-    auto rTop = rLimit + sphere.radius;
+    auto rTop = rLimit + sphere.radius * m_SphereFactorR;
     if ( r < -rTop || rTop < r )
     { return false; }
 
     auto u = Vector3::Dot(op, m_Upward);
     auto uLimit = m_FactorU * f;
-    auto uTop = uLimit + sphere.radius;
+    auto uTop = uLimit + sphere.radius * m_SphereFactorU;
     if ( u < -uTop || uTop < u )
     { return false; }
 
@@ -524,10 +745,9 @@ bool ViewFrustum::Contains(const BoundingSphere& sphere) const
 //-------------------------------------------------------------------------------------------------
 //      バウンディングボックスを含むかどうかチェックします.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 bool ViewFrustum::Contains( const BoundingBox& box ) const
 {
-    Vector3 p;
     auto outOfLeft   = 0;
     auto outOfRight  = 0;
     auto outOfFar    = 0;
@@ -546,24 +766,27 @@ bool ViewFrustum::Contains( const BoundingBox& box ) const
     for( auto i=0; i<8; ++i )
     {
         isInRightTest = isInUpTest = isInFrontTest = false;
-        p.x = corners[(i & 1)].x;
-        p.y = corners[(i >> 2) & 1].y;
-        p.z = corners[(i >> 1) & 1].z;
+        auto px = corners[(i & 1)].x      - m_Position.x;
+        auto py = corners[(i >> 2) & 1].y - m_Position.y;
+        auto pz = corners[(i >> 1) & 1].z - m_Position.z;
+
+        auto r = m_Right.x   * px + m_Right.y   * py + m_Right.z   * pz;
+        auto u = m_Upward.x  * px + m_Upward.y  * py + m_Upward.z  * pz;
+        auto f = m_Forward.x * px + m_Forward.y * py + m_Forward.z * pz;
 
-        auto r = m_Right.x   * p.x + m_Right.y   * p.y + m_Right.z   * p.z;
-        auto u = m_Upward.x  * p.x + m_Upward.y  * p.y + m_Upward.z  * p.z;
-        auto f = m_Forward.x * p.x + m_Forward.y * p.y + m_Forward.z * p.z;
+        auto rLimit = m_FactorR * f;
+        auto uLimit = m_FactorU * f;
 
-        if ( r < -m_FactorR * f )
+        if ( r < -rLimit )
         { outOfLeft++; }
-        else if ( r > m_FactorR * f )
+        else if ( r > rLimit )
         { outOfRight++; }
         else
         { isInRightTest = true; }
 
-        if ( u < -m_FactorU * f )
+        if ( u < -uLimit )
         { outOfBottom++; }
-        else if ( u > m_FactorU * f )
+        else if ( u > uLimit )
         { outOfTop++; }
         else
         { isInUpTest = true; }
@@ -593,7 +816,7 @@ bool ViewFrustum::Contains( const BoundingBox& box ) const
 //-------------------------------------------------------------------------------------------------
 //      8角の頂点を取得します.
 //-------------------------------------------------------------------------------------------------
-ASDX_INLINE
+ASVK_INLINE
 std::array<Vector3, 8> ViewFrustum::GetCorners() const
 {
     std::array<Vector3, 8> result;
@@ -620,5 +843,5 @@ std::array<Vector3, 8> ViewFrustum::GetCorners() const
     return result;
 }
 
-} // namespace asdx
+} // namespace asvk
 
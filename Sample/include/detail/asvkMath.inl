@@ -149,83 +149,72 @@ double Hypot( double x, double y, double z, double w )
 //      階乗計算します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-uint32_t Fact( uint32_t number )
-{
-    uint32_t result = 1;
-    for( uint32_t i=1; i<=number; ++i )
-    { result *= i; }
-    return result;
-}
+constexpr uint32_t Fact( uint32_t number )
+{ return ( number <= 1 ) ? 1 : number * Fact( number - 1 ); }
 
 //-------------------------------------------------------------------------------------------------
 //      2重階乗を計算します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-uint32_t DblFact( uint32_t number )
-{
-    uint32_t result = 1;
-    uint32_t start = ( ( number % 2 ) == 0 ) ? 2 : 1;
-    for( uint32_t i=start; i<=number; i+=2 )
-    { result *= i; }
-    return result;
-}
+constexpr uint32_t DblFact( uint32_t number )
+{ return ( number <= 1 ) ? 1 : number * DblFact( number - 2 ); }
 
 //-------------------------------------------------------------------------------------------------
 //      順列を計算します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-uint32_t Perm( uint32_t n, uint32_t r )
-{
-    assert( n >= r );
-    return Fact( n ) / Fact( n - r );
-}
+constexpr uint32_t Perm( uint32_t n, uint32_t r )
+{ return assert( n >= r ), Fact( n ) / Fact( n - r ); }
 
 //-------------------------------------------------------------------------------------------------
 //      組み合わせを計算します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-uint32_t Comb( uint32_t n, uint32_t r )
-{
-    assert( n >= r );
-    return Fact( n ) / ( Fact( n - r ) * Fact( r ) );
-}
+constexpr uint32_t Comb( uint32_t n, uint32_t r )
+{ return assert( n >= r ), Fact( n ) / ( Fact( n - r ) * Fact( r ) ); }
 
 //-------------------------------------------------------------------------------------------------
 //      32bit 浮動小数から 16bit 浮動小数に変換します.
+//      ※ 最近接偶数丸め. 範囲外は無限大，NaN は上位の仮数を残した quiet NaN になります.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE 
 half F32ToF16( float value )
 {
-    half result;
-
     // ビット列を崩さないままuint32_t型に変換.
-    uint32_t bit = *reinterpret_cast<uint32_t*>( &value );
+    uint32_t bit;
+    memcpy( &bit, &value, sizeof(bit) );
 
-    // float表現の符号bitを取り出し.
-    uint32_t sign   = ( bit & 0x80000000U) >> 16U;
+    // float表現の符号bitを取り出し，符号部を削ぎ落す.
+    uint32_t sign = ( bit & 0x80000000U ) >> 16U;
+    bit &= 0x7FFFFFFFU;
 
-    // 符号部を削ぎ落す.
-    bit     = bit & 0x7FFFFFFFU;
+    uint32_t result;
 
-    // halfとして表現する際に値がデカ過ぎる場合は，無限大にクランプ.
-    if ( bit > 0x47FFEFFFU)
-    { result = 0x7FFFU; }
+    // 丸めると65520以上になる値と無限大・NaN.
+    if ( bit >= 0x47800000U )
+    {
+        result = ( bit > 0x7F800000U )
+            ? 0x7E00U | ( ( bit >> 13U ) & 0x3FFU )     // NaN.
+            : 0x7C00U;                                  // 無限大.
+    }
+    // halfで非正規化数(またはゼロ)になる値.
+    else if ( bit < 0x38800000U )
+    {
+        // 2^-1 を加えて仮数の下位に揃えることで，丸めをFPUに任せる.
+        const uint32_t magic = 0x3F000000U;
+        float f, m;
+        memcpy( &f, &bit,   sizeof(f) );
+        memcpy( &m, &magic, sizeof(m) );
+        f += m;
+        memcpy( &result, &f, sizeof(result) );
+        result -= magic;
+    }
+    // halfで正規化数になる値.
     else
     {
-        // 正規化されたhalfとして表現するために小さすぎる値は正規化されていない値に変換.
-        if ( bit < 0x38800000U)
-        {
-            uint32_t shift = 113U - ( bit >> 23U);
-            bit    = (0x800000U | ( bit & 0x7FFFFFU)) >> shift;
-        }
-        else
-        {
-            // 正規化されたhalfとして表現するために指数部に再度バイアスをかける
-            bit += 0xC8000000U;
-        }
-
-        // half型表現にする.
-        result = (( bit + 0x0FFFU + (( bit >> 13U) & 1U)) >> 13U) & 0x7FFFU; 
+        // 指数部に再度バイアスをかけ，最近接偶数に丸める.
+        uint32_t odd = ( bit >> 13U ) & 1U;
+        result = ( bit + 0xC8000FFFU + odd ) >> 13U;
     }
 
     // 符号部を付け足して返却.
@@ -238,43 +227,29 @@ half F32ToF16( float value )
 ASVK_INLINE 
 float F16ToF32( half value )
 {
-    uint32_t exponent;
-    uint32_t result;
-
-    // 仮数
-    uint32_t mantissa = static_cast<uint32_t>( value & 0x03FF );
+    // 指数部と仮数部をfloatの位置に移し，2^112 倍して指数バイアスを補正する(非正規化数も正確に変換される).
+    uint32_t bit = static_cast<uint32_t>( value & 0x7FFF ) << 13U;
+    const uint32_t magic = 0x77800000U;
 
-    // 正規化済みの場合.
-    if ( ( value & 0x7C00 ) != 0 )
-    {
-        // 指数部を計算.
-        exponent = static_cast<uint32_t>( ( value >> 10 ) & 0x1F );
-    }
-    // 正規化されていない場合.
-    else if ( mantissa != 0 )
-    {
-        // 結果となるfloatで値を正規化する.
-        exponent = 1;
+    float f, m;
+    memcpy( &f, &bit,   sizeof(f) );
+    memcpy( &m, &magic, sizeof(m) );
+    f *= m;
 
-        do {
-            exponent--;
-            mantissa <<= 1;
-        } while ( ( mantissa & 0x0400 ) == 0);
+    uint32_t result;
+    memcpy( &result, &f, sizeof(result) );
 
-        mantissa &= 0x03FF;
-    }
-    // 値がゼロの場合.
-    else
-    {
-        // 指数部を計算.
-        exponent = (uint32_t)-112;
-    }
+    // 無限大・NaN は指数部を全て立てる(NaN は quiet NaN にする).
+    if ( ( value & 0x7FFF ) > 0x7BFF )
+    { result |= 0x7F800000U; }
+    if ( ( value & 0x7FFF ) > 0x7C00 )
+    { result |= 0x00400000U; }
 
-    result = ( ( value & 0x8000 ) << 16) | // 符号部.
-             ( ( exponent + 112 ) << 23) | // 指数部.
-             ( mantissa << 13 );           // 仮数部.
+    // 符号部.
+    result |= static_cast<uint32_t>( value & 0x8000 ) << 16U;
 
-    return *reinterpret_cast<float*>( &result );
+    memcpy( &f, &result, sizeof(f) );
+    return f;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -291,16 +266,474 @@ ASVK_INLINE
 constexpr double Lerp( double a, double b, double amount ) noexcept
 { return a + amount * ( b - a ); }
 
+//-------------------------------------------------------------------------------------------------
+//      正弦と余弦を同時に求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void SinCos( float radian, float& s, float& c )
+{
+    s = sinf( radian );
+    c = cosf( radian );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      正弦と余弦を多項式近似で同時に求めます.
+//      ※ DirectXMath の XMScalarSinCos と同じ 11次/10次 minimax 近似.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void SinCosFast( float radian, float& s, float& c )
+{
+    // [-π, π] に縮約. 2πを上位/下位に分割して(Cody-Waite)大きな角度での桁落ちを抑える.
+    auto q = static_cast<float>( static_cast<int32_t>( radian * ( 1.0f / F_2PI ) + ( ( radian >= 0.0f ) ? 0.5f : -0.5f ) ) );
+    auto y = ( radian - q * 6.28125f ) - q * 1.9353071795864769e-3f;
+
+    // [-π/2, π/2] に縮約. sin は不変で cos の符号が反転する.
+    auto sign = 1.0f;
+    if ( y > F_PIDIV2 )
+    {
+        y    = F_PI - y;
+        sign = -1.0f;
+    }
+    else if ( y < -F_PIDIV2 )
+    {
+        y    = -F_PI - y;
+        sign = -1.0f;
+    }
+
+    auto y2 = y * y;
+    s = ( ( ( ( ( -2.3889859e-08f * y2 + 2.7525562e-06f ) * y2 - 0.00019840874f ) * y2 + 0.0083333310f ) * y2 - 0.16666667f ) * y2 + 1.0f ) * y;
+
+    auto p = ( ( ( ( -2.6051615e-07f * y2 + 2.4760495e-05f ) * y2 - 0.0013888378f ) * y2 + 0.041666638f ) * y2 - 0.5f ) * y2 + 1.0f;
+    c = sign * p;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆平方根を近似計算します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+float RsqrtFast( float value )
+{
+#if ASVK_IS_SIMD
+    // 近似命令(相対誤差 1.5*2^-12) + ニュートン法1回.
+    auto y = _mm_cvtss_f32( _mm_rsqrt_ss( _mm_set_ss( value ) ) );
+    return y * ( 1.5f - 0.5f * value * y * y );
+#else
+    // 指数部の半減による初期値 + ニュートン法2回.
+    uint32_t i;
+    memcpy( &i, &value, sizeof(i) );
+    i = 0x5f375a86u - ( i >> 1 );
+
+    float y;
+    memcpy( &y, &i, sizeof(y) );
+    y = y * ( 1.5f - 0.5f * value * y * y );
+    y = y * ( 1.5f - 0.5f * value * y * y );
+    return y;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆正接を多項式近似で求めます.
+//      ※ Abramowitz and Stegun 4.4.49 の [0, 1] 上の15次近似.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+float Atan2Fast( float y, float x )
+{
+    auto ax = fabsf( x );
+    auto ay = fabsf( y );
+    auto mx = Max( ax, ay );
+    auto mn = Min( ax, ay );
+    if ( mx == 0.0f )
+    { return 0.0f; }
+
+    auto z  = mn / mx;
+    auto z2 = z * z;
+    auto r  = ( ( ( ( ( ( ( -0.0040540580f * z2 + 0.0218612288f ) * z2 - 0.0559098861f ) * z2 + 0.0964200441f ) * z2
+              - 0.1390853351f ) * z2 + 0.1994653599f ) * z2 - 0.3332985605f ) * z2 + 0.9999993329f ) * z;
+
+    if ( ay > ax )  { r = F_PIDIV2 - r; }
+    if ( x < 0.0f ) { r = F_PI - r; }
+
+    // atan2 と同様に y = -0 は負の側として扱います.
+    return copysignf( r, y );
+}
+
+#if ASVK_IS_SIMD
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-// Vector2 structure
+// SIMD Functions
 ///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace detail {
 
 //-------------------------------------------------------------------------------------------------
-//      コンストラクタです.
+//      数学型のメンバから4要素を読み込みます.
+//      ASVK_USE_ALIGNED_TYPES 有効時はアライメント済みのロードを使います.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Vector2::Vector2()
-{ /* DO_NOTHING */ }
+__m128 LoadFloat4( const float* pValues )
+{
+#if ASVK_IS_ALIGNED
+    return _mm_load_ps( pValues );
+#else
+    return _mm_loadu_ps( pValues );
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      数学型のメンバに4要素を書き込みます.
+//      ASVK_USE_ALIGNED_TYPES 有効時はアライメント済みのストアを使います.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void StoreFloat4( float* pValues, const __m128 value )
+{
+#if ASVK_IS_ALIGNED
+    _mm_store_ps( pValues, value );
+#else
+    _mm_storeu_ps( pValues, value );
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ベクトルを行列で変換します(SIMD版).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+__m128 TransformSimd( const __m128 value, const Matrix& matrix )
+{
+    // スカラー版と同じ加算順序 ((x*r0 + y*r1) + z*r2) + w*r3 で計算するので結果はビット単位で一致する.
+    auto result = _mm_mul_ps( _mm_shuffle_ps( value, value, _MM_SHUFFLE( 0, 0, 0, 0 ) ), detail::LoadFloat4( matrix.m[0] ) );
+    result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( value, value, _MM_SHUFFLE( 1, 1, 1, 1 ) ), detail::LoadFloat4( matrix.m[1] ) ) );
+    result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( value, value, _MM_SHUFFLE( 2, 2, 2, 2 ) ), detail::LoadFloat4( matrix.m[2] ) ) );
+    result = _mm_add_ps( result, _mm_mul_ps( _mm_shuffle_ps( value, value, _MM_SHUFFLE( 3, 3, 3, 3 ) ), detail::LoadFloat4( matrix.m[3] ) ) );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列同士を乗算します(SIMD版).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void MultiplySimd( const Matrix& a, const Matrix& b, Matrix& result )
+{
+    // b を先に全て読み込むので result が a または b と同じインスタンスでも問題ない.
+    auto b0 = detail::LoadFloat4( b.m[0] );
+    auto b1 = detail::LoadFloat4( b.m[1] );
+    auto b2 = detail::LoadFloat4( b.m[2] );
+    auto b3 = detail::LoadFloat4( b.m[3] );
+
+    for( auto i=0; i<4; ++i )
+    {
+        auto row = _mm_mul_ps( _mm_set1_ps( a.m[i][0] ), b0 );
+        row = _mm_add_ps( row, _mm_mul_ps( _mm_set1_ps( a.m[i][1] ), b1 ) );
+        row = _mm_add_ps( row, _mm_mul_ps( _mm_set1_ps( a.m[i][2] ), b2 ) );
+        row = _mm_add_ps( row, _mm_mul_ps( _mm_set1_ps( a.m[i][3] ), b3 ) );
+        detail::StoreFloat4( result.m[i], row );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列を転置します(SIMD版).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void TransposeSimd( const Matrix& value, Matrix& result )
+{
+    auto r0 = detail::LoadFloat4( value.m[0] );
+    auto r1 = detail::LoadFloat4( value.m[1] );
+    auto r2 = detail::LoadFloat4( value.m[2] );
+    auto r3 = detail::LoadFloat4( value.m[3] );
+
+    _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+    detail::StoreFloat4( result.m[0], r0 );
+    detail::StoreFloat4( result.m[1], r1 );
+    detail::StoreFloat4( result.m[2], r2 );
+    detail::StoreFloat4( result.m[3], r3 );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列同士を乗算し，乗算結果を転置します(SIMD版).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void MultiplyTransposeSimd( const Matrix& a, const Matrix& b, Matrix& result )
+{
+    auto b0 = detail::LoadFloat4( b.m[0] );
+    auto b1 = detail::LoadFloat4( b.m[1] );
+    auto b2 = detail::LoadFloat4( b.m[2] );
+    auto b3 = detail::LoadFloat4( b.m[3] );
+
+    __m128 rows[4];
+    for( auto i=0; i<4; ++i )
+    {
+        rows[i] = _mm_mul_ps( _mm_set1_ps( a.m[i][0] ), b0 );
+        rows[i] = _mm_add_ps( rows[i], _mm_mul_ps( _mm_set1_ps( a.m[i][1] ), b1 ) );
+        rows[i] = _mm_add_ps( rows[i], _mm_mul_ps( _mm_set1_ps( a.m[i][2] ), b2 ) );
+        rows[i] = _mm_add_ps( rows[i], _mm_mul_ps( _mm_set1_ps( a.m[i][3] ), b3 ) );
+    }
+
+    _MM_TRANSPOSE4_PS( rows[0], rows[1], rows[2], rows[3] );
+
+    detail::StoreFloat4( result.m[0], rows[0] );
+    detail::StoreFloat4( result.m[1], rows[1] );
+    detail::StoreFloat4( result.m[2], rows[2] );
+    detail::StoreFloat4( result.m[3], rows[3] );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆行列を求めます(SIMD版).
+//      ※ Intel AP-928 "Streaming SIMD Extensions - Inverse of 4x4 Matrix" を参照.
+//         余因子の加算順序がスカラー版と異なるため，結果はビット単位では一致しません.
+//         スカラー版との差は max|Δij| <= 4 * FLT_EPSILON * κ(M) * ||M^-1|| (無限大ノルム) に収まります(test/asvkMathTest.cpp).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void InvertSimd( const Matrix& value, Matrix& result )
+{
+    const float* src = &value._11;
+
+    // 転置しながら読み込み (row1, row3 は上位・下位64bitが入れ替わった状態).
+    auto tmp  = _mm_loadh_pi( _mm_loadl_pi( _mm_setzero_ps(), reinterpret_cast<const __m64*>( src + 0 ) ), reinterpret_cast<const __m64*>( src + 4 ) );
+    auto row1 = _mm_loadh_pi( _mm_loadl_pi( _mm_setzero_ps(), reinterpret_cast<const __m64*>( src + 8 ) ), reinterpret_cast<const __m64*>( src + 12 ) );
+    auto row0 = _mm_shuffle_ps( tmp, row1, 0x88 );
+    row1      = _mm_shuffle_ps( row1, tmp, 0xDD );
+    tmp       = _mm_loadh_pi( _mm_loadl_pi( _mm_setzero_ps(), reinterpret_cast<const __m64*>( src + 2 ) ), reinterpret_cast<const __m64*>( src + 6 ) );
+    auto row3 = _mm_loadh_pi( _mm_loadl_pi( _mm_setzero_ps(), reinterpret_cast<const __m64*>( src + 10 ) ), reinterpret_cast<const __m64*>( src + 14 ) );
+    auto row2 = _mm_shuffle_ps( tmp, row3, 0x88 );
+    row3      = _mm_shuffle_ps( row3, tmp, 0xDD );
+
+    tmp = _mm_mul_ps( row2, row3 );
+    tmp = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    auto minor0 = _mm_mul_ps( row1, tmp );
+    auto minor1 = _mm_mul_ps( row0, tmp );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor0 = _mm_sub_ps( _mm_mul_ps( row1, tmp ), minor0 );
+    minor1 = _mm_sub_ps( _mm_mul_ps( row0, tmp ), minor1 );
+    minor1 = _mm_shuffle_ps( minor1, minor1, 0x4E );
+
+    tmp = _mm_mul_ps( row1, row2 );
+    tmp = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor0 = _mm_add_ps( _mm_mul_ps( row3, tmp ), minor0 );
+    auto minor3 = _mm_mul_ps( row0, tmp );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor0 = _mm_sub_ps( minor0, _mm_mul_ps( row3, tmp ) );
+    minor3 = _mm_sub_ps( _mm_mul_ps( row0, tmp ), minor3 );
+    minor3 = _mm_shuffle_ps( minor3, minor3, 0x4E );
+
+    tmp  = _mm_mul_ps( _mm_shuffle_ps( row1, row1, 0x4E ), row3 );
+    tmp  = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    row2 = _mm_shuffle_ps( row2, row2, 0x4E );
+    minor0 = _mm_add_ps( _mm_mul_ps( row2, tmp ), minor0 );
+    auto minor2 = _mm_mul_ps( row0, tmp );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor0 = _mm_sub_ps( minor0, _mm_mul_ps( row2, tmp ) );
+    minor2 = _mm_sub_ps( _mm_mul_ps( row0, tmp ), minor2 );
+    minor2 = _mm_shuffle_ps( minor2, minor2, 0x4E );
+
+    tmp = _mm_mul_ps( row0, row1 );
+    tmp = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor2 = _mm_add_ps( _mm_mul_ps( row3, tmp ), minor2 );
+    minor3 = _mm_sub_ps( _mm_mul_ps( row2, tmp ), minor3 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor2 = _mm_sub_ps( _mm_mul_ps( row3, tmp ), minor2 );
+    minor3 = _mm_sub_ps( minor3, _mm_mul_ps( row2, tmp ) );
+
+    tmp = _mm_mul_ps( row0, row3 );
+    tmp = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor1 = _mm_sub_ps( minor1, _mm_mul_ps( row2, tmp ) );
+    minor2 = _mm_add_ps( _mm_mul_ps( row1, tmp ), minor2 );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor1 = _mm_add_ps( _mm_mul_ps( row2, tmp ), minor1 );
+    minor2 = _mm_sub_ps( minor2, _mm_mul_ps( row1, tmp ) );
+
+    tmp = _mm_mul_ps( row0, row2 );
+    tmp = _mm_shuffle_ps( tmp, tmp, 0xB1 );
+    minor1 = _mm_add_ps( _mm_mul_ps( row3, tmp ), minor1 );
+    minor3 = _mm_sub_ps( minor3, _mm_mul_ps( row1, tmp ) );
+    tmp    = _mm_shuffle_ps( tmp, tmp, 0x4E );
+    minor1 = _mm_sub_ps( minor1, _mm_mul_ps( row3, tmp ) );
+    minor3 = _mm_add_ps( _mm_mul_ps( row1, tmp ), minor3 );
+
+    // 行列式.
+    auto det = _mm_mul_ps( row0, minor0 );
+    det = _mm_add_ps( _mm_shuffle_ps( det, det, 0x4E ), det );
+    det = _mm_add_ss( _mm_shuffle_ps( det, det, 0xB1 ), det );
+    det = _mm_shuffle_ps( det, det, 0x00 );
+    assert( !IsZero( _mm_cvtss_f32( det ) ) );
+
+    // スカラー版と同様に除算で正規化する (逆数近似は使わない).
+    detail::StoreFloat4( result.m[0], _mm_div_ps( minor0, det ) );
+    detail::StoreFloat4( result.m[1], _mm_div_ps( minor1, det ) );
+    detail::StoreFloat4( result.m[2], _mm_div_ps( minor2, det ) );
+    detail::StoreFloat4( result.m[3], _mm_div_ps( minor3, det ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列の各要素をブロードキャストします.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void BroadcastMatrix( const Matrix& matrix, __m128* pResult )
+{
+    const float* src = &matrix._11;
+    for( auto i=0; i<16; ++i )
+    { pResult[i] = _mm_set1_ps( src[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4要素分のVector3配列(AoS)をSoA形式で読み込みます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void LoadVector3x4( const Vector3* pValues, __m128& x, __m128& y, __m128& z )
+{
+    const float* src = &pValues->x;
+    auto a = _mm_loadu_ps( src + 0 );   // x0 y0 z0 x1
+    auto b = _mm_loadu_ps( src + 4 );   // y1 z1 x2 y2
+    auto c = _mm_loadu_ps( src + 8 );   // z2 x3 y3 z3
+
+    x = _mm_shuffle_ps( a, _mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 3, 0 ) );
+    y = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) ), _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+    z = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) ), c, _MM_SHUFFLE( 3, 0, 2, 0 ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式の4要素分のベクトルをVector3配列(AoS)に書き出します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void StoreVector3x4( Vector3* pValues, const __m128 x, const __m128 y, const __m128 z )
+{
+    float* dst = &pValues->x;
+    auto a = _mm_shuffle_ps( _mm_shuffle_ps( x, y, _MM_SHUFFLE( 0, 0, 0, 0 ) ), _mm_shuffle_ps( z, x, _MM_SHUFFLE( 1, 1, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+    auto b = _mm_shuffle_ps( _mm_shuffle_ps( y, z, _MM_SHUFFLE( 1, 1, 1, 1 ) ), _mm_shuffle_ps( x, y, _MM_SHUFFLE( 2, 2, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+    auto c = _mm_shuffle_ps( _mm_shuffle_ps( z, x, _MM_SHUFFLE( 3, 3, 2, 2 ) ), _mm_shuffle_ps( y, z, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+    _mm_storeu_ps( dst + 0, a );
+    _mm_storeu_ps( dst + 4, b );
+    _mm_storeu_ps( dst + 8, c );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式のベクトルを変換します (m はBroadcastMatrix()の結果).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void TransformSoA( const __m128 x, const __m128 y, const __m128 z, const __m128* m, __m128& rx, __m128& ry, __m128& rz )
+{
+    // スカラー版と同じ加算順序なので結果はビット単位で一致する.
+    auto X = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[0] ), _mm_mul_ps( y, m[4] ) ), _mm_mul_ps( z, m[ 8] ) ), m[12] );
+    auto Y = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[1] ), _mm_mul_ps( y, m[5] ) ), _mm_mul_ps( z, m[ 9] ) ), m[13] );
+    auto Z = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[2] ), _mm_mul_ps( y, m[6] ) ), _mm_mul_ps( z, m[10] ) ), m[14] );
+    rx = X;
+    ry = Y;
+    rz = Z;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式の法線ベクトルを変換します (m はBroadcastMatrix()の結果).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void TransformNormalSoA( const __m128 x, const __m128 y, const __m128 z, const __m128* m, __m128& rx, __m128& ry, __m128& rz )
+{
+    auto X = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[0] ), _mm_mul_ps( y, m[4] ) ), _mm_mul_ps( z, m[ 8] ) );
+    auto Y = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[1] ), _mm_mul_ps( y, m[5] ) ), _mm_mul_ps( z, m[ 9] ) );
+    auto Z = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[2] ), _mm_mul_ps( y, m[6] ) ), _mm_mul_ps( z, m[10] ) );
+    rx = X;
+    ry = Y;
+    rz = Z;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式のベクトルを変換し，w=1に射影します (m はBroadcastMatrix()の結果).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void TransformCoordSoA( const __m128 x, const __m128 y, const __m128 z, const __m128* m, __m128& rx, __m128& ry, __m128& rz )
+{
+    auto X = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[0] ), _mm_mul_ps( y, m[4] ) ), _mm_mul_ps( z, m[ 8] ) ), m[12] );
+    auto Y = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[1] ), _mm_mul_ps( y, m[5] ) ), _mm_mul_ps( z, m[ 9] ) ), m[13] );
+    auto Z = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[2] ), _mm_mul_ps( y, m[6] ) ), _mm_mul_ps( z, m[10] ) ), m[14] );
+    auto W = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, m[3] ), _mm_mul_ps( y, m[7] ) ), _mm_mul_ps( z, m[11] ) ), m[15] );
+    rx = _mm_div_ps( X, W );
+    ry = _mm_div_ps( Y, W );
+    rz = _mm_div_ps( Z, W );
+}
+
+#if ASVK_IS_AVX
+//-------------------------------------------------------------------------------------------------
+//      行列の各要素をブロードキャストします(AVX版).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void BroadcastMatrix( const Matrix& matrix, __m256* pResult )
+{
+    const float* src = &matrix._11;
+    for( auto i=0; i<16; ++i )
+    { pResult[i] = _mm256_set1_ps( src[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8要素分のVector3配列(AoS)をSoA形式で読み込みます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void LoadVector3x8( const Vector3* pValues, __m256& x, __m256& y, __m256& z )
+{
+    __m128 x0, y0, z0, x1, y1, z1;
+    LoadVector3x4( pValues + 0, x0, y0, z0 );
+    LoadVector3x4( pValues + 4, x1, y1, z1 );
+    x = _mm256_insertf128_ps( _mm256_castps128_ps256( x0 ), x1, 1 );
+    y = _mm256_insertf128_ps( _mm256_castps128_ps256( y0 ), y1, 1 );
+    z = _mm256_insertf128_ps( _mm256_castps128_ps256( z0 ), z1, 1 );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式の8要素分のベクトルをVector3配列(AoS)に書き出します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void StoreVector3x8( Vector3* pValues, const __m256 x, const __m256 y, const __m256 z )
+{
+    StoreVector3x4( pValues + 0, _mm256_castps256_ps128( x ), _mm256_castps256_ps128( y ), _mm256_castps256_ps128( z ) );
+    StoreVector3x4( pValues + 4, _mm256_extractf128_ps( x, 1 ), _mm256_extractf128_ps( y, 1 ), _mm256_extractf128_ps( z, 1 ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式のベクトルを変換します(AVX版).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void TransformSoA( const __m256 x, const __m256 y, const __m256 z, const __m256* m, __m256& rx, __m256& ry, __m256& rz )
+{
+    auto X = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[0] ), _mm256_mul_ps( y, m[4] ) ), _mm256_mul_ps( z, m[ 8] ) ), m[12] );
+    auto Y = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[1] ), _mm256_mul_ps( y, m[5] ) ), _mm256_mul_ps( z, m[ 9] ) ), m[13] );
+    auto Z = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[2] ), _mm256_mul_ps( y, m[6] ) ), _mm256_mul_ps( z, m[10] ) ), m[14] );
+    rx = X;
+    ry = Y;
+    rz = Z;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式の法線ベクトルを変換します(AVX版).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void TransformNormalSoA( const __m256 x, const __m256 y, const __m256 z, const __m256* m, __m256& rx, __m256& ry, __m256& rz )
+{
+    auto X = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[0] ), _mm256_mul_ps( y, m[4] ) ), _mm256_mul_ps( z, m[ 8] ) );
+    auto Y = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[1] ), _mm256_mul_ps( y, m[5] ) ), _mm256_mul_ps( z, m[ 9] ) );
+    auto Z = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[2] ), _mm256_mul_ps( y, m[6] ) ), _mm256_mul_ps( z, m[10] ) );
+    rx = X;
+    ry = Y;
+    rz = Z;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式のベクトルを変換し，w=1に射影します(AVX版).
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void TransformCoordSoA( const __m256 x, const __m256 y, const __m256 z, const __m256* m, __m256& rx, __m256& ry, __m256& rz )
+{
+    auto X = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[0] ), _mm256_mul_ps( y, m[4] ) ), _mm256_mul_ps( z, m[ 8] ) ), m[12] );
+    auto Y = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[1] ), _mm256_mul_ps( y, m[5] ) ), _mm256_mul_ps( z, m[ 9] ) ), m[13] );
+    auto Z = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[2] ), _mm256_mul_ps( y, m[6] ) ), _mm256_mul_ps( z, m[10] ) ), m[14] );
+    auto W = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, m[3] ), _mm256_mul_ps( y, m[7] ) ), _mm256_mul_ps( z, m[11] ) ), m[15] );
+    rx = _mm256_div_ps( X, W );
+    ry = _mm256_div_ps( Y, W );
+    rz = _mm256_div_ps( Z, W );
+}
+#endif//ASVK_IS_AVX
+
+} // namespace detail
+#endif//ASVK_IS_SIMD
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Vector2 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
 
 //-------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタ.
@@ -317,7 +750,7 @@ Vector2::Vector2( const float* pf )
 //      引数付きコンストラクタ.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Vector2::Vector2( float nx, float ny )
+constexpr Vector2::Vector2( float nx, float ny )
 : x( nx )
 , y( ny )
 { /* DO_NOTHING */ }
@@ -1118,13 +1551,6 @@ void Vector2::TransformCoord( const Vector2 &coords, const Matrix &matrix, Vecto
 // Vector3 structure
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-//-------------------------------------------------------------------------------------------------
-//      コンストラクタです.
-//-------------------------------------------------------------------------------------------------
-ASVK_INLINE
-Vector3::Vector3()
-{ /* DO_NOTHING */ }
-
 //-------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
@@ -1141,7 +1567,7 @@ Vector3::Vector3( const float* pf )
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Vector3::Vector3( const Vector2& value, float nz )
+constexpr Vector3::Vector3( const Vector2& value, float nz )
 : x( value.x )
 , y( value.y )
 , z( nz )
@@ -1151,7 +1577,7 @@ Vector3::Vector3( const Vector2& value, float nz )
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Vector3::Vector3( float nx, float ny, float nz )
+constexpr Vector3::Vector3( float nx, float ny, float nz )
 : x( nx )
 , y( ny )
 , z( nz )
@@ -1355,6 +1781,21 @@ Vector3& Vector3::SafeNormalize( const Vector3& set )
     return (*this);
 }
 
+//-------------------------------------------------------------------------------------------------
+//      逆平方根の近似を用いて正規化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3& Vector3::NormalizeFast()
+{
+    auto magSq = LengthSq();
+    assert( magSq > 0.0f );
+    auto invMag = RsqrtFast( magSq );
+    x *= invMag;
+    y *= invMag;
+    z *= invMag;
+    return (*this);
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Vector3 methods
@@ -1576,6 +2017,35 @@ void Vector3::SafeNormalize( const Vector3& value, const Vector3& set, Vector3&
     }
 }
 
+//-------------------------------------------------------------------------------------------------
+//      逆平方根の近似を用いて正規化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 Vector3::NormalizeFast( const Vector3& value )
+{
+    auto magSq = value.LengthSq();
+    assert( magSq > 0.0f );
+    auto invMag = RsqrtFast( magSq );
+    return Vector3(
+        value.x * invMag,
+        value.y * invMag,
+        value.z * invMag );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆平方根の近似を用いて正規化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Vector3::NormalizeFast( const Vector3& value, Vector3& result )
+{
+    auto magSq = value.LengthSq();
+    assert( magSq > 0.0f );
+    auto invMag = RsqrtFast( magSq );
+    result.x = value.x * invMag;
+    result.y = value.y * invMag;
+    result.z = value.z * invMag;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      三角形の面法線を求めます.
 //-------------------------------------------------------------------------------------------------
@@ -2227,13 +2697,6 @@ void Vector3::InverseRotate( const Vector3& value, const Quaternion& rotation, V
 // Vector4 structure
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-//-------------------------------------------------------------------------------------------------
-//      コンストラクタです.
-//-------------------------------------------------------------------------------------------------
-ASVK_INLINE
-Vector4::Vector4()
-{ /* DO_NOTHING */ }
-
 //-------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
@@ -2251,7 +2714,7 @@ Vector4::Vector4( const float* pf )
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Vector4::Vector4( const Vector2& value, float nz, float nw )
+constexpr Vector4::Vector4( const Vector2& value, float nz, float nw )
 : x( value.x )
 , y( value.y )
 , z( nz )
@@ -2262,7 +2725,7 @@ Vector4::Vector4( const Vector2& value, float nz, float nw )
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Vector4::Vector4( const Vector3& value, float nw )
+constexpr Vector4::Vector4( const Vector3& value, float nw )
 : x( value.x )
 , y( value.y )
 , z( value.z )
@@ -2273,12 +2736,12 @@ Vector4::Vector4( const Vector3& value, float nw )
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Vector4::Vector4( float nx, float ny, float nz, float nw )
+constexpr Vector4::Vector4( float nx, float ny, float nz, float nw )
 : x( nx )
 , y( ny )
 , z( nz )
 , w( nw )
-{ /* DO_NTOHING */ }
+{ /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
 //      float* 型へのキャストです.
@@ -3032,11 +3495,17 @@ void Vector4::SmoothStep( const Vector4 &a, const Vector4 &b, float amount, Vect
 ASVK_INLINE
 Vector4 Vector4::Transform( const Vector4& position, const Matrix& matrix )
 {
+#if ASVK_IS_SIMD
+    Vector4 result;
+    detail::StoreFloat4( &result.x, detail::TransformSimd( detail::LoadFloat4( &position.x ), matrix ) );
+    return result;
+#else
     return Vector4(
         ( ( ((position.x * matrix._11) + (position.y * matrix._21)) + (position.z * matrix._31) ) + (position.w * matrix._41)),
         ( ( ((position.x * matrix._12) + (position.y * matrix._22)) + (position.z * matrix._32) ) + (position.w * matrix._42)),
         ( ( ((position.x * matrix._13) + (position.y * matrix._23)) + (position.z * matrix._33) ) + (position.w * matrix._43)),
         ( ( ((position.x * matrix._14) + (position.y * matrix._24)) + (position.z * matrix._34) ) + (position.w * matrix._44)) );
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3045,62 +3514,399 @@ Vector4 Vector4::Transform( const Vector4& position, const Matrix& matrix )
 ASVK_INLINE
 void Vector4::Transform( const Vector4 &position, const Matrix &matrix, Vector4 &result )
 {
+#if ASVK_IS_SIMD
+    detail::StoreFloat4( &result.x, detail::TransformSimd( detail::LoadFloat4( &position.x ), matrix ) );
+#else
     result.x = ( ( ((position.x * matrix._11) + (position.y * matrix._21)) + (position.z * matrix._31) ) + (position.w * matrix._41));
     result.y = ( ( ((position.x * matrix._12) + (position.y * matrix._22)) + (position.z * matrix._32) ) + (position.w * matrix._42));
     result.z = ( ( ((position.x * matrix._13) + (position.y * matrix._23)) + (position.z * matrix._33) ) + (position.w * matrix._43));
     result.w = ( ( ((position.x * matrix._14) + (position.y * matrix._24)) + (position.z * matrix._34) ) + (position.w * matrix._44));
+#endif//ASVK_IS_SIMD
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-// Matrix structure (row-major)
+// Vector3x4 structure
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 //-------------------------------------------------------------------------------------------------
-//      コンストラクタです.
+//      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Matrix::Matrix()
-{ /* DO_NOTHING */ }
+Vector3x4::Vector3x4( const Vector3* pValues )
+{ Load( pValues ); }
 
 //-------------------------------------------------------------------------------------------------
-//      引数付きコンストラクタです.
+//      Vector3配列(AoS)から読み込みます.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Matrix::Matrix( const float* pf )
+void Vector3x4::Load( const Vector3* pValues )
 {
-    assert( pf != nullptr );
-    memcpy( &_11, pf, sizeof(Matrix) );
+    assert( pValues != nullptr );
+#if ASVK_IS_SIMD
+    __m128 vx, vy, vz;
+    detail::LoadVector3x4( pValues, vx, vy, vz );
+    detail::StoreFloat4( x, vx );
+    detail::StoreFloat4( y, vy );
+    detail::StoreFloat4( z, vz );
+#else
+    for( auto i=0; i<4; ++i )
+    {
+        x[i] = pValues[i].x;
+        y[i] = pValues[i].y;
+        z[i] = pValues[i].z;
+    }
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
-//      引数付きコンストラクタです.
+//      Vector3配列(AoS)に書き出します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Matrix::Matrix
-(
-    float m11, float m12, float m13, float m14,
-    float m21, float m22, float m23, float m24,
-    float m31, float m32, float m33, float m34,
-    float m41, float m42, float m43, float m44 
-)
+void Vector3x4::Store( Vector3* pValues ) const
 {
-    _11 = m11; _12 = m12; _13 = m13; _14 = m14;
-    _21 = m21; _22 = m22; _23 = m23; _24 = m24;
-    _31 = m31; _32 = m32; _33 = m33; _34 = m34;
-    _41 = m41; _42 = m42; _43 = m43; _44 = m44;
+    assert( pValues != nullptr );
+#if ASVK_IS_SIMD
+    detail::StoreVector3x4( pValues, detail::LoadFloat4( x ), detail::LoadFloat4( y ), detail::LoadFloat4( z ) );
+#else
+    for( auto i=0; i<4; ++i )
+    {
+        pValues[i].x = x[i];
+        pValues[i].y = y[i];
+        pValues[i].z = z[i];
+    }
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
-//      引数付きコンストラクタです.
+//      指定された行列を用いて，ベクトルを変換します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Matrix::Matrix( const Vector4& v1, const Vector4& v2, const Vector4& v3, const Vector4& v4 )
+void Vector3x4::Transform( const Vector3x4& position, const Matrix& matrix, Vector3x4& result )
 {
-    _11 = v1.x; _12 = v1.y; _13 = v1.z; _14 = v1.z;
-    _21 = v2.x; _22 = v2.y; _23 = v2.z; _24 = v2.z;
-    _31 = v3.x; _32 = v3.y; _33 = v3.z; _34 = v3.z;
-    _41 = v4.x; _42 = v4.y; _43 = v4.z; _44 = v4.z;
-}
+#if ASVK_IS_SIMD
+    __m128 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    __m128 rx, ry, rz;
+    detail::TransformSoA( detail::LoadFloat4( position.x ), detail::LoadFloat4( position.y ), detail::LoadFloat4( position.z ), m, rx, ry, rz );
+    detail::StoreFloat4( result.x, rx );
+    detail::StoreFloat4( result.y, ry );
+    detail::StoreFloat4( result.z, rz );
+#else
+    for( auto i=0; i<4; ++i )
+    {
+        auto px = position.x[i];
+        auto py = position.y[i];
+        auto pz = position.z[i];
+        result.x[i] = ( ((px * matrix._11) + (py * matrix._21)) + (pz * matrix._31)) + matrix._41;
+        result.y[i] = ( ((px * matrix._12) + (py * matrix._22)) + (pz * matrix._32)) + matrix._42;
+        result.z[i] = ( ((px * matrix._13) + (py * matrix._23)) + (pz * matrix._33)) + matrix._43;
+    }
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，法線ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Vector3x4::TransformNormal( const Vector3x4& normal, const Matrix& matrix, Vector3x4& result )
+{
+#if ASVK_IS_SIMD
+    __m128 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    __m128 rx, ry, rz;
+    detail::TransformNormalSoA( detail::LoadFloat4( normal.x ), detail::LoadFloat4( normal.y ), detail::LoadFloat4( normal.z ), m, rx, ry, rz );
+    detail::StoreFloat4( result.x, rx );
+    detail::StoreFloat4( result.y, ry );
+    detail::StoreFloat4( result.z, rz );
+#else
+    for( auto i=0; i<4; ++i )
+    {
+        auto nx = normal.x[i];
+        auto ny = normal.y[i];
+        auto nz = normal.z[i];
+        result.x[i] = ((nx * matrix._11) + (ny * matrix._21)) + (nz * matrix._31);
+        result.y[i] = ((nx * matrix._12) + (ny * matrix._22)) + (nz * matrix._32);
+        result.z[i] = ((nx * matrix._13) + (ny * matrix._23)) + (nz * matrix._33);
+    }
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いてベクトルを変換し，変換結果をw=1に射影します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Vector3x4::TransformCoord( const Vector3x4& coord, const Matrix& matrix, Vector3x4& result )
+{
+#if ASVK_IS_SIMD
+    __m128 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    __m128 rx, ry, rz;
+    detail::TransformCoordSoA( detail::LoadFloat4( coord.x ), detail::LoadFloat4( coord.y ), detail::LoadFloat4( coord.z ), m, rx, ry, rz );
+    detail::StoreFloat4( result.x, rx );
+    detail::StoreFloat4( result.y, ry );
+    detail::StoreFloat4( result.z, rz );
+#else
+    for( auto i=0; i<4; ++i )
+    {
+        auto cx = coord.x[i];
+        auto cy = coord.y[i];
+        auto cz = coord.z[i];
+        auto X = ( ( ((cx * matrix._11) + (cy * matrix._21)) + (cz * matrix._31) ) + matrix._41);
+        auto Y = ( ( ((cx * matrix._12) + (cy * matrix._22)) + (cz * matrix._32) ) + matrix._42);
+        auto Z = ( ( ((cx * matrix._13) + (cy * matrix._23)) + (cz * matrix._33) ) + matrix._43);
+        auto W = ( ( ((cx * matrix._14) + (cy * matrix._24)) + (cz * matrix._34) ) + matrix._44);
+        result.x[i] = X / W;
+        result.y[i] = Y / W;
+        result.z[i] = Z / W;
+    }
+#endif//ASVK_IS_SIMD
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Vector3x8 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3x8::Vector3x8( const Vector3* pValues )
+{ Load( pValues ); }
+
+//-------------------------------------------------------------------------------------------------
+//      Vector3配列(AoS)から読み込みます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Vector3x8::Load( const Vector3* pValues )
+{
+    assert( pValues != nullptr );
+#if ASVK_IS_SIMD && ASVK_IS_AVX
+    __m256 vx, vy, vz;
+    detail::LoadVector3x8( pValues, vx, vy, vz );
+    _mm256_storeu_ps( x, vx );
+    _mm256_storeu_ps( y, vy );
+    _mm256_storeu_ps( z, vz );
+#elif ASVK_IS_SIMD
+    for( auto i=0; i<8; i+=4 )
+    {
+        __m128 vx, vy, vz;
+        detail::LoadVector3x4( pValues + i, vx, vy, vz );
+        detail::StoreFloat4( x + i, vx );
+        detail::StoreFloat4( y + i, vy );
+        detail::StoreFloat4( z + i, vz );
+    }
+#else
+    for( auto i=0; i<8; ++i )
+    {
+        x[i] = pValues[i].x;
+        y[i] = pValues[i].y;
+        z[i] = pValues[i].z;
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Vector3配列(AoS)に書き出します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Vector3x8::Store( Vector3* pValues ) const
+{
+    assert( pValues != nullptr );
+#if ASVK_IS_SIMD && ASVK_IS_AVX
+    detail::StoreVector3x8( pValues, _mm256_loadu_ps( x ), _mm256_loadu_ps( y ), _mm256_loadu_ps( z ) );
+#elif ASVK_IS_SIMD
+    for( auto i=0; i<8; i+=4 )
+    { detail::StoreVector3x4( pValues + i, detail::LoadFloat4( x + i ), detail::LoadFloat4( y + i ), detail::LoadFloat4( z + i ) ); }
+#else
+    for( auto i=0; i<8; ++i )
+    {
+        pValues[i].x = x[i];
+        pValues[i].y = y[i];
+        pValues[i].z = z[i];
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Vector3x8::Transform( const Vector3x8& position, const Matrix& matrix, Vector3x8& result )
+{
+#if ASVK_IS_SIMD && ASVK_IS_AVX
+    __m256 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    __m256 rx, ry, rz;
+    detail::TransformSoA( _mm256_loadu_ps( position.x ), _mm256_loadu_ps( position.y ), _mm256_loadu_ps( position.z ), m, rx, ry, rz );
+    _mm256_storeu_ps( result.x, rx );
+    _mm256_storeu_ps( result.y, ry );
+    _mm256_storeu_ps( result.z, rz );
+#elif ASVK_IS_SIMD
+    __m128 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    for( auto i=0; i<8; i+=4 )
+    {
+        __m128 rx, ry, rz;
+        detail::TransformSoA( detail::LoadFloat4( position.x + i ), detail::LoadFloat4( position.y + i ), detail::LoadFloat4( position.z + i ), m, rx, ry, rz );
+        detail::StoreFloat4( result.x + i, rx );
+        detail::StoreFloat4( result.y + i, ry );
+        detail::StoreFloat4( result.z + i, rz );
+    }
+#else
+    for( auto i=0; i<8; ++i )
+    {
+        auto px = position.x[i];
+        auto py = position.y[i];
+        auto pz = position.z[i];
+        result.x[i] = ( ((px * matrix._11) + (py * matrix._21)) + (pz * matrix._31)) + matrix._41;
+        result.y[i] = ( ((px * matrix._12) + (py * matrix._22)) + (pz * matrix._32)) + matrix._42;
+        result.z[i] = ( ((px * matrix._13) + (py * matrix._23)) + (pz * matrix._33)) + matrix._43;
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，法線ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Vector3x8::TransformNormal( const Vector3x8& normal, const Matrix& matrix, Vector3x8& result )
+{
+#if ASVK_IS_SIMD && ASVK_IS_AVX
+    __m256 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    __m256 rx, ry, rz;
+    detail::TransformNormalSoA( _mm256_loadu_ps( normal.x ), _mm256_loadu_ps( normal.y ), _mm256_loadu_ps( normal.z ), m, rx, ry, rz );
+    _mm256_storeu_ps( result.x, rx );
+    _mm256_storeu_ps( result.y, ry );
+    _mm256_storeu_ps( result.z, rz );
+#elif ASVK_IS_SIMD
+    __m128 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    for( auto i=0; i<8; i+=4 )
+    {
+        __m128 rx, ry, rz;
+        detail::TransformNormalSoA( detail::LoadFloat4( normal.x + i ), detail::LoadFloat4( normal.y + i ), detail::LoadFloat4( normal.z + i ), m, rx, ry, rz );
+        detail::StoreFloat4( result.x + i, rx );
+        detail::StoreFloat4( result.y + i, ry );
+        detail::StoreFloat4( result.z + i, rz );
+    }
+#else
+    for( auto i=0; i<8; ++i )
+    {
+        auto nx = normal.x[i];
+        auto ny = normal.y[i];
+        auto nz = normal.z[i];
+        result.x[i] = ((nx * matrix._11) + (ny * matrix._21)) + (nz * matrix._31);
+        result.y[i] = ((nx * matrix._12) + (ny * matrix._22)) + (nz * matrix._32);
+        result.z[i] = ((nx * matrix._13) + (ny * matrix._23)) + (nz * matrix._33);
+    }
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いてベクトルを変換し，変換結果をw=1に射影します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Vector3x8::TransformCoord( const Vector3x8& coord, const Matrix& matrix, Vector3x8& result )
+{
+#if ASVK_IS_SIMD && ASVK_IS_AVX
+    __m256 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    __m256 rx, ry, rz;
+    detail::TransformCoordSoA( _mm256_loadu_ps( coord.x ), _mm256_loadu_ps( coord.y ), _mm256_loadu_ps( coord.z ), m, rx, ry, rz );
+    _mm256_storeu_ps( result.x, rx );
+    _mm256_storeu_ps( result.y, ry );
+    _mm256_storeu_ps( result.z, rz );
+#elif ASVK_IS_SIMD
+    __m128 m[16];
+    detail::BroadcastMatrix( matrix, m );
+
+    for( auto i=0; i<8; i+=4 )
+    {
+        __m128 rx, ry, rz;
+        detail::TransformCoordSoA( detail::LoadFloat4( coord.x + i ), detail::LoadFloat4( coord.y + i ), detail::LoadFloat4( coord.z + i ), m, rx, ry, rz );
+        detail::StoreFloat4( result.x + i, rx );
+        detail::StoreFloat4( result.y + i, ry );
+        detail::StoreFloat4( result.z + i, rz );
+    }
+#else
+    for( auto i=0; i<8; ++i )
+    {
+        auto cx = coord.x[i];
+        auto cy = coord.y[i];
+        auto cz = coord.z[i];
+        auto X = ( ( ((cx * matrix._11) + (cy * matrix._21)) + (cz * matrix._31) ) + matrix._41);
+        auto Y = ( ( ((cx * matrix._12) + (cy * matrix._22)) + (cz * matrix._32) ) + matrix._42);
+        auto Z = ( ( ((cx * matrix._13) + (cy * matrix._23)) + (cz * matrix._33) ) + matrix._43);
+        auto W = ( ( ((cx * matrix._14) + (cy * matrix._24)) + (cz * matrix._34) ) + matrix._44);
+        result.x[i] = X / W;
+        result.y[i] = Y / W;
+        result.z[i] = Z / W;
+    }
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Matrix structure (row-major)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix::Matrix( const float* pf )
+{
+    assert( pf != nullptr );
+    memcpy( &_11, pf, sizeof(Matrix) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+constexpr Matrix::Matrix
+(
+    float m11, float m12, float m13, float m14,
+    float m21, float m22, float m23, float m24,
+    float m31, float m32, float m33, float m34,
+    float m41, float m42, float m43, float m44 
+)
+: _11( m11 ), _12( m12 ), _13( m13 ), _14( m14 )
+, _21( m21 ), _22( m22 ), _23( m23 ), _24( m24 )
+, _31( m31 ), _32( m32 ), _33( m33 ), _34( m34 )
+, _41( m41 ), _42( m42 ), _43( m43 ), _44( m44 )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+constexpr Matrix::Matrix( const Vector4& v1, const Vector4& v2, const Vector4& v3, const Vector4& v4 )
+: _11( v1.x ), _12( v1.y ), _13( v1.z ), _14( v1.w )
+, _21( v2.x ), _22( v2.y ), _23( v2.z ), _24( v2.w )
+, _31( v3.x ), _32( v3.y ), _33( v3.z ), _34( v3.w )
+, _41( v4.x ), _42( v4.y ), _43( v4.z ), _44( v4.w )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      アフィン変換行列から変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+constexpr Matrix::Matrix( const Matrix3x4& value )
+: _11( value._11 ), _12( value._21 ), _13( value._31 ), _14( 0.0f )
+, _21( value._12 ), _22( value._22 ), _23( value._32 ), _24( 0.0f )
+, _31( value._13 ), _32( value._23 ), _33( value._33 ), _34( 0.0f )
+, _41( value._14 ), _42( value._24 ), _43( value._34 ), _44( 1.0f )
+{ /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
 //      インデクサです.
@@ -3136,6 +3942,10 @@ Matrix::operator const float* () const
 ASVK_INLINE 
 Matrix& Matrix::operator *= ( const Matrix &value )
 {
+#if ASVK_IS_SIMD
+    detail::MultiplySimd( *this, value, *this );
+    return (*this);
+#else
     auto m11 = ( _11 * value._11 ) + ( _12 * value._21 ) + ( _13 * value._31 ) + ( _14 * value._41 );
     auto m12 = ( _11 * value._12 ) + ( _12 * value._22 ) + ( _13 * value._32 ) + ( _14 * value._42 );
     auto m13 = ( _11 * value._13 ) + ( _12 * value._23 ) + ( _13 * value._33 ) + ( _14 * value._43 );
@@ -3162,6 +3972,7 @@ Matrix& Matrix::operator *= ( const Matrix &value )
     _41 = m41;  _42 = m42;  _43 = m43;  _44 = m44;
 
     return (*this);
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3253,6 +4064,11 @@ Matrix Matrix::operator - () const
 ASVK_INLINE 
 Matrix Matrix::operator * ( const Matrix& value ) const
 {
+#if ASVK_IS_SIMD
+    Matrix result;
+    detail::MultiplySimd( *this, value, result );
+    return result;
+#else
     return Matrix(
         ( _11 * value._11 ) + ( _12 * value._21 ) + ( _13 * value._31 ) + ( _14 * value._41 ),
         ( _11 * value._12 ) + ( _12 * value._22 ) + ( _13 * value._32 ) + ( _14 * value._42 ),
@@ -3274,6 +4090,7 @@ Matrix Matrix::operator * ( const Matrix& value ) const
         ( _41 * value._13 ) + ( _42 * value._23 ) + ( _43 * value._33 ) + ( _44 * value._43 ),
         ( _41 * value._14 ) + ( _42 * value._24 ) + ( _43 * value._34 ) + ( _44 * value._44 )
     );
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3400,7 +4217,7 @@ Matrix& Matrix::Identity()
 //      単位行列を生成します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Matrix Matrix::CreateIdentity()
+constexpr Matrix Matrix::CreateIdentity()
 {
     return Matrix(
         1.0f, 0.0f, 0.0f, 0.0f,
@@ -3428,11 +4245,17 @@ bool Matrix::IsIdentity( const Matrix &value )
 ASVK_INLINE
 Matrix Matrix::Transpose( const Matrix& value )
 {
+#if ASVK_IS_SIMD
+    Matrix result;
+    detail::TransposeSimd( value, result );
+    return result;
+#else
     return Matrix(
         value._11, value._21, value._31, value._41,
         value._12, value._22, value._32, value._42,
         value._13, value._23, value._33, value._43,
         value._14, value._24, value._34, value._44 );
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3441,6 +4264,9 @@ Matrix Matrix::Transpose( const Matrix& value )
 ASVK_INLINE
 void Matrix::Transpose( const Matrix &value, Matrix &result )
 {
+#if ASVK_IS_SIMD
+    detail::TransposeSimd( value, result );
+#else
     result._11 = value._11;
     result._12 = value._21;
     result._13 = value._31;
@@ -3454,12 +4280,13 @@ void Matrix::Transpose( const Matrix &value, Matrix &result )
     result._31 = value._13;
     result._32 = value._23;
     result._33 = value._33;
-    result._34 = value._34;
+    result._34 = value._43;
 
     result._41 = value._14;
     result._42 = value._24;
     result._43 = value._34;
     result._44 = value._44;
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3468,6 +4295,11 @@ void Matrix::Transpose( const Matrix &value, Matrix &result )
 ASVK_INLINE
 Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
 {
+#if ASVK_IS_SIMD
+    Matrix result;
+    detail::MultiplySimd( a, b, result );
+    return result;
+#else
     return Matrix(
         ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 ),
         ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 ),
@@ -3489,6 +4321,7 @@ Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
         ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 ),
         ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 )
     );
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3497,6 +4330,9 @@ Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
 ASVK_INLINE
 void Matrix::Multiply( const Matrix &a, const Matrix &b, Matrix &result )
 {
+#if ASVK_IS_SIMD
+    detail::MultiplySimd( a, b, result );
+#else
     result._11 = ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 );
     result._12 = ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 );
     result._13 = ( a._11 * b._13 ) + ( a._12 * b._23 ) + ( a._13 * b._33 ) + ( a._14 * b._43 );
@@ -3516,6 +4352,7 @@ void Matrix::Multiply( const Matrix &a, const Matrix &b, Matrix &result )
     result._42 = ( a._41 * b._12 ) + ( a._42 * b._22 ) + ( a._43 * b._32 ) + ( a._44 * b._42 );
     result._43 = ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 );
     result._44 = ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 );
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3564,27 +4401,9 @@ void Matrix::Multiply( const Matrix &value, float scaleFactor, Matrix &result )
 ASVK_INLINE
 Matrix Matrix::MultiplyTranspose( const Matrix& a, const Matrix& b )
 {
-    return Matrix(
-        ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 ),
-        ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 ),
-        ( a._11 * b._13 ) + ( a._12 * b._23 ) + ( a._13 * b._33 ) + ( a._14 * b._43 ),
-        ( a._11 * b._14 ) + ( a._12 * b._24 ) + ( a._13 * b._34 ) + ( a._14 * b._44 ),
-
-        ( a._21 * b._11 ) + ( a._22 * b._21 ) + ( a._23 * b._31 ) + ( a._24 * b._41 ),
-        ( a._21 * b._12 ) + ( a._22 * b._22 ) + ( a._23 * b._32 ) + ( a._24 * b._42 ),
-        ( a._21 * b._13 ) + ( a._22 * b._23 ) + ( a._23 * b._33 ) + ( a._24 * b._43 ),
-        ( a._21 * b._14 ) + ( a._22 * b._24 ) + ( a._23 * b._34 ) + ( a._24 * b._44 ),
-
-        ( a._31 * b._11 ) + ( a._32 * b._21 ) + ( a._33 * b._31 ) + ( a._34 * b._41 ),
-        ( a._31 * b._12 ) + ( a._32 * b._22 ) + ( a._33 * b._32 ) + ( a._34 * b._42 ),
-        ( a._31 * b._13 ) + ( a._32 * b._23 ) + ( a._33 * b._33 ) + ( a._34 * b._43 ),
-        ( a._31 * b._14 ) + ( a._32 * b._24 ) + ( a._33 * b._34 ) + ( a._34 * b._44 ),
-
-        ( a._41 * b._11 ) + ( a._42 * b._21 ) + ( a._43 * b._31 ) + ( a._44 * b._41 ),
-        ( a._41 * b._12 ) + ( a._42 * b._22 ) + ( a._43 * b._32 ) + ( a._44 * b._42 ),
-        ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 ),
-        ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 )
-    );
+    Matrix result;
+    MultiplyTranspose( a, b, result );
+    return result;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3593,6 +4412,9 @@ Matrix Matrix::MultiplyTranspose( const Matrix& a, const Matrix& b )
 ASVK_INLINE
 void Matrix::MultiplyTranspose( const Matrix &a, const Matrix &b, Matrix &result )
 {
+#if ASVK_IS_SIMD
+    detail::MultiplyTransposeSimd( a, b, result );
+#else
     result._11 = ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 );
     result._21 = ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 );
     result._31 = ( a._11 * b._13 ) + ( a._12 * b._23 ) + ( a._13 * b._33 ) + ( a._14 * b._43 );
@@ -3612,6 +4434,7 @@ void Matrix::MultiplyTranspose( const Matrix &a, const Matrix &b, Matrix &result
     result._24 = ( a._41 * b._12 ) + ( a._42 * b._22 ) + ( a._43 * b._32 ) + ( a._44 * b._42 );
     result._34 = ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 );
     result._44 = ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 );
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3620,6 +4443,11 @@ void Matrix::MultiplyTranspose( const Matrix &a, const Matrix &b, Matrix &result
 ASVK_INLINE 
 Matrix Matrix::Invert( const Matrix& value )
 {
+#if ASVK_IS_SIMD
+    Matrix result;
+    detail::InvertSimd( value, result );
+    return result;
+#else
     auto det = value.Determinant();
     assert( !IsZero( det ) );
 
@@ -3648,6 +4476,7 @@ Matrix Matrix::Invert( const Matrix& value )
         m21 / det, m22 / det, m23 / det, m24 / det,
         m31 / det, m32 / det, m33 / det, m34 / det,
         m41 / det, m42 / det, m43 / det, m44 / det );
+#endif//ASVK_IS_SIMD
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3656,6 +4485,9 @@ Matrix Matrix::Invert( const Matrix& value )
 ASVK_INLINE
 void Matrix::Invert( const Matrix &value, Matrix &result )
 { 
+#if ASVK_IS_SIMD
+    detail::InvertSimd( value, result );
+#else
     auto det = value.Determinant();
     assert( det != 0.0f );
 
@@ -3698,13 +4530,151 @@ void Matrix::Invert( const Matrix &value, Matrix &result )
     result._42 /= det;
     result._43 /= det;
     result._44 /= det;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      剛体変換行列の逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix Matrix::InvertRigid( const Matrix& value )
+{
+    Matrix result;
+    InvertRigid( value, result );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      剛体変換行列の逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Matrix::InvertRigid( const Matrix& value, Matrix& result )
+{
+    // [R 0; t 1]^-1 = [R^T 0; -t*R^T 1]
+    auto tx = value._41;
+    auto ty = value._42;
+    auto tz = value._43;
+
+    auto m41 = -( tx * value._11 + ty * value._12 + tz * value._13 );
+    auto m42 = -( tx * value._21 + ty * value._22 + tz * value._23 );
+    auto m43 = -( tx * value._31 + ty * value._32 + tz * value._33 );
+
+    auto m12 = value._21;
+    auto m13 = value._31;
+    auto m23 = value._32;
+    auto m21 = value._12;
+    auto m31 = value._13;
+    auto m32 = value._23;
+
+    result._11 = value._11; result._12 = m12;       result._13 = m13;       result._14 = 0.0f;
+    result._21 = m21;       result._22 = value._22; result._23 = m23;       result._24 = 0.0f;
+    result._31 = m31;       result._32 = m32;       result._33 = value._33; result._34 = 0.0f;
+    result._41 = m41;       result._42 = m42;       result._43 = m43;       result._44 = 1.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アフィン変換行列の逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix Matrix::InvertAffine( const Matrix& value )
+{
+    Matrix result;
+    InvertAffine( value, result );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アフィン変換行列の逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Matrix::InvertAffine( const Matrix& value, Matrix& result )
+{
+    // [L 0; t 1]^-1 = [L^-1 0; -t*L^-1 1]
+    auto c11 = value._22 * value._33 - value._23 * value._32;
+    auto c21 = value._23 * value._31 - value._21 * value._33;
+    auto c31 = value._21 * value._32 - value._22 * value._31;
+
+    auto det = value._11 * c11 + value._12 * c21 + value._13 * c31;
+    assert( det != 0.0f );
+    auto invDet = 1.0f / det;
+
+    auto m11 = c11 * invDet;
+    auto m12 = ( value._13 * value._32 - value._12 * value._33 ) * invDet;
+    auto m13 = ( value._12 * value._23 - value._13 * value._22 ) * invDet;
+
+    auto m21 = c21 * invDet;
+    auto m22 = ( value._11 * value._33 - value._13 * value._31 ) * invDet;
+    auto m23 = ( value._13 * value._21 - value._11 * value._23 ) * invDet;
+
+    auto m31 = c31 * invDet;
+    auto m32 = ( value._12 * value._31 - value._11 * value._32 ) * invDet;
+    auto m33 = ( value._11 * value._22 - value._12 * value._21 ) * invDet;
+
+    auto tx = value._41;
+    auto ty = value._42;
+    auto tz = value._43;
+
+    result._11 = m11; result._12 = m12; result._13 = m13; result._14 = 0.0f;
+    result._21 = m21; result._22 = m22; result._23 = m23; result._24 = 0.0f;
+    result._31 = m31; result._32 = m32; result._33 = m33; result._34 = 0.0f;
+    result._41 = -( tx * m11 + ty * m21 + tz * m31 );
+    result._42 = -( tx * m12 + ty * m22 + tz * m32 );
+    result._43 = -( tx * m13 + ty * m23 + tz * m33 );
+    result._44 = 1.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列の種類を判定し，最も軽い方法で逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+bool Matrix::SafeInvert( const Matrix& value, Matrix& result )
+{
+    auto isAffine = ( value._14 == 0.0f ) && ( value._24 == 0.0f ) && ( value._34 == 0.0f ) && ( value._44 == 1.0f );
+    if ( !isAffine )
+    {
+        auto det = value.Determinant();
+        if ( !( fabs( det ) >= FLT_MIN ) )
+        { return false; }
+
+        Invert( value, result );
+        return true;
+    }
+
+    // 左上3x3の行同士の内積から正規直交かどうかを調べる.
+    auto d11 = value._11 * value._11 + value._12 * value._12 + value._13 * value._13;
+    auto d22 = value._21 * value._21 + value._22 * value._22 + value._23 * value._23;
+    auto d33 = value._31 * value._31 + value._32 * value._32 + value._33 * value._33;
+    auto d12 = value._11 * value._21 + value._12 * value._22 + value._13 * value._23;
+    auto d13 = value._11 * value._31 + value._12 * value._32 + value._13 * value._33;
+    auto d23 = value._21 * value._31 + value._22 * value._32 + value._23 * value._33;
+
+    auto isRigid = ( fabs( d11 - 1.0f ) <= RIGID_EPSILON )
+                && ( fabs( d22 - 1.0f ) <= RIGID_EPSILON )
+                && ( fabs( d33 - 1.0f ) <= RIGID_EPSILON )
+                && ( fabs( d12 ) <= RIGID_EPSILON )
+                && ( fabs( d13 ) <= RIGID_EPSILON )
+                && ( fabs( d23 ) <= RIGID_EPSILON );
+    if ( isRigid )
+    {
+        InvertRigid( value, result );
+        return true;
+    }
+
+    auto det = value._11 * ( value._22 * value._33 - value._23 * value._32 )
+             + value._12 * ( value._23 * value._31 - value._21 * value._33 )
+             + value._13 * ( value._21 * value._32 - value._22 * value._31 );
+    if ( !( fabs( det ) >= FLT_MIN ) )
+    { return false; }
+
+    InvertAffine( value, result );
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
 //      拡大・縮小行列を生成します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Matrix Matrix::CreateScale( float scale )
+constexpr Matrix Matrix::CreateScale( float scale )
 {
     return Matrix(
         scale, 0.0f, 0.0f, 0.0f,
@@ -3728,8 +4698,8 @@ void Matrix::CreateScale( float scale, Matrix &result )
 //-------------------------------------------------------------------------------------------------
 //      拡大・縮小行列を生成します.
 //-------------------------------------------------------------------------------------------------
-ASVK_INLINE 
-Matrix Matrix::CreateScale( float xScale, float yScale, float zScale )
+ASVK_INLINE
+constexpr Matrix Matrix::CreateScale( float xScale, float yScale, float zScale )
 {
     return Matrix(
         xScale, 0.0f,   0.0f,   0.0f,
@@ -3754,7 +4724,7 @@ void Matrix::CreateScale( float xScale, float yScale, float zScale, Matrix &resu
 //      拡大・縮小行列を生成します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Matrix Matrix::CreateScale( const Vector3& scales )
+constexpr Matrix Matrix::CreateScale( const Vector3& scales )
 {
     return Matrix(
         scales.x,   0.0f,       0.0f,       0.0f,
@@ -3778,8 +4748,8 @@ void Matrix::CreateScale( const Vector3 &scales, Matrix &result )
 //-------------------------------------------------------------------------------------------------
 //      平行移動行列を生成します.
 //-------------------------------------------------------------------------------------------------
-ASVK_INLINE 
-Matrix Matrix::CreateTranslation( float xPos, float yPos, float zPos )
+ASVK_INLINE
+constexpr Matrix Matrix::CreateTranslation( float xPos, float yPos, float zPos )
 {
     return Matrix(
         1.0f, 0.0f, 0.0f, 0.0f,
@@ -3804,7 +4774,7 @@ void Matrix::CreateTranslation( float xPos, float yPos, float zPos, Matrix &resu
 //      平行移動行列を生成します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Matrix Matrix::CreateTranslation( const Vector3& pos )
+constexpr Matrix Matrix::CreateTranslation( const Vector3& pos )
 {
     return Matrix(
         1.0f, 0.0f, 0.0f, 0.0f,
@@ -3831,8 +4801,8 @@ void Matrix::CreateTranslation( const Vector3 &pos, Matrix &result )
 ASVK_INLINE 
 Matrix Matrix::CreateRotationX( const float radian )
 {
-    auto cosRad = cosf(radian);
-    auto sinRad = sinf(radian);
+    float sinRad, cosRad;
+    SinCos( radian, sinRad, cosRad );
     return Matrix(
         1.0f,   0.0f,   0.0f,   0.0f,
         0.0f,   cosRad, sinRad, 0.0f,
@@ -3846,8 +4816,8 @@ Matrix Matrix::CreateRotationX( const float radian )
 ASVK_INLINE 
 void Matrix::CreateRotationX( const float radian, Matrix &result )
 {
-    auto cosRad = cosf( radian );
-    auto sinRad = sinf( radian );
+    float sinRad, cosRad;
+    SinCos( radian, sinRad, cosRad );
 
     result._11 = 1.0f;      result._12 = 0.0f;      result._13 = 0.0f;      result._14 = 0.0f;
     result._21 = 0.0f;      result._22 = cosRad;    result._23 = sinRad;    result._24 = 0.0f;
@@ -3861,8 +4831,8 @@ void Matrix::CreateRotationX( const float radian, Matrix &result )
 ASVK_INLINE 
 Matrix Matrix::CreateRotationY( const float radian )
 {
-    auto cosRad = cosf( radian );
-    auto sinRad = sinf( radian );
+    float sinRad, cosRad;
+    SinCos( radian, sinRad, cosRad );
 
     return Matrix(
         cosRad, 0.0f,  -sinRad, 0.0f,
@@ -3877,8 +4847,8 @@ Matrix Matrix::CreateRotationY( const float radian )
 ASVK_INLINE
 void Matrix::CreateRotationY( const float radian, Matrix &result )
 {
-    auto cosRad = cosf( radian );
-    auto sinRad = sinf( radian );
+    float sinRad, cosRad;
+    SinCos( radian, sinRad, cosRad );
 
     result._11 = cosRad;    result._12 = 0.0f;  result._13 = -sinRad;   result._14 = 0.0f;
     result._21 = 0.0f;      result._22 = 1.0f;  result._23 = 0.0f;      result._24 = 0.0f;
@@ -3892,8 +4862,8 @@ void Matrix::CreateRotationY( const float radian, Matrix &result )
 ASVK_INLINE
 Matrix Matrix::CreateRotationZ( const float radian )
 {
-    auto cosRad = cosf( radian );
-    auto sinRad = sinf( radian );
+    float sinRad, cosRad;
+    SinCos( radian, sinRad, cosRad );
 
     return Matrix( 
         cosRad, sinRad, 0.0f, 0.0f,
@@ -3908,8 +4878,8 @@ Matrix Matrix::CreateRotationZ( const float radian )
 ASVK_INLINE
 void Matrix::CreateRotationZ( const float radian, Matrix &result )
 {
-    auto cosRad = cosf( radian );
-    auto sinRad = sinf( radian );
+    float sinRad, cosRad;
+    SinCos( radian, sinRad, cosRad );
 
     result._11 = cosRad;    result._12 = sinRad;    result._13 = 0.0f;    result._14 = 0.0f;
     result._21 = -sinRad;   result._22 = cosRad;    result._23 = 0.0f;    result._24 = 0.0f;
@@ -4089,6 +5059,26 @@ void Matrix::CreateRotationFromYawPitchRoll( float yaw, float pitch, float roll,
     Matrix::CreateFromQuaternion( value, result );
 }
 
+//-------------------------------------------------------------------------------------------------
+//      SinCosFast()を用いてヨー・ピッチ・ロール角から回転行列を生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix Matrix::CreateRotationFromYawPitchRollFast( float yaw, float pitch, float roll )
+{
+    auto value = Quaternion::CreateFromYawPitchRollFast( yaw, pitch, roll );
+    return Matrix::CreateFromQuaternion( value );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SinCosFast()を用いてヨー・ピッチ・ロール角から回転行列を生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Matrix::CreateRotationFromYawPitchRollFast( float yaw, float pitch, float roll, Matrix& result )
+{
+    auto value = Quaternion::CreateFromYawPitchRollFast( yaw, pitch, roll );
+    Matrix::CreateFromQuaternion( value, result );
+}
+
 //-------------------------------------------------------------------------------------------------
 //      注視点を基にビュー行列を生成します.
 //-------------------------------------------------------------------------------------------------
@@ -4574,8 +5564,8 @@ Matrix Matrix::CreateOrthographicOffCenter
 )
 {
     auto width  = right - left;
-    auto height = bottom - top;
-    auto depth  = farClip - nearClip;
+    auto height = top - bottom;
+    auto depth  = nearClip - farClip;
     assert( !IsZero( width ) );
     assert( !IsZero( height ) );
     assert( !IsZero( depth ) );
@@ -4596,8 +5586,8 @@ Matrix Matrix::CreateOrthographicOffCenter
         1.0f / depth,
         0.0f,
 
-        (left + right) / width,
-        (top + bottom) / height,
+        -(left + right) / width,
+        -(top + bottom) / height,
         nearClip / depth,
         1.0f
     );
@@ -4619,7 +5609,7 @@ void Matrix::CreateOrthographicOffCenter
 )
 {
     auto width  = right - left;
-    auto height = bottom - top;
+    auto height = top - bottom;
     auto depth  = nearClip - farClip;
     assert( !IsZero( width ) );
     assert( !IsZero( height ) );
@@ -4640,8 +5630,8 @@ void Matrix::CreateOrthographicOffCenter
     result._33 = 1.0f / depth;
     result._34 = 0.0f;
 
-    result._41 = (left + right) / width;
-    result._42 = (top + bottom) / height;
+    result._41 = -(left + right) / width;
+    result._42 = -(top + bottom) / height;
     result._43 = nearClip / depth;
     result._44 = 1.0f;
 }
@@ -4754,56 +5744,311 @@ void Matrix::CreateBillboardAxisY( const Matrix& value, Matrix& result )
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-// Quaternion
+// Matrix3x4 structure (row-major)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-//-------------------------------------------------------------------------------------------------
-//      コンストラクタです.
-//-------------------------------------------------------------------------------------------------
-ASVK_INLINE
-Quaternion::Quaternion()
-{ /* DO_NOTHING */ }
-
 //-------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Quaternion::Quaternion( const float* pf )
+Matrix3x4::Matrix3x4( const float* pf )
 {
     assert( pf != nullptr );
-    x = pf[ 0 ];
-    y = pf[ 1 ];
-    z = pf[ 2 ];
-    w = pf[ 3 ];
+    memcpy( &_11, pf, sizeof(Matrix3x4) );
 }
 
 //-------------------------------------------------------------------------------------------------
 //      引数付きコンストラクタです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Quaternion::Quaternion( float nx, float ny, float nz, float nw )
-: x( nx )
-, y( ny )
-, z( nz )
-, w( nw )
+constexpr Matrix3x4::Matrix3x4
+(
+    float m11, float m12, float m13, float m14,
+    float m21, float m22, float m23, float m24,
+    float m31, float m32, float m33, float m34
+)
+: _11( m11 ), _12( m12 ), _13( m13 ), _14( m14 )
+, _21( m21 ), _22( m22 ), _23( m23 ), _24( m24 )
+, _31( m31 ), _32( m32 ), _33( m33 ), _34( m34 )
 { /* DO_NOTHING */ }
 
 //-------------------------------------------------------------------------------------------------
-//      float* 型へのキャストです.
+//      4x4行列から変換します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Quaternion::operator float* ()
-{ return static_cast<float*>( &x ); }
+Matrix3x4::Matrix3x4( const Matrix& value )
+{
+    _11 = value._11; _12 = value._21; _13 = value._31; _14 = value._41;
+    _21 = value._12; _22 = value._22; _23 = value._32; _24 = value._42;
+    _31 = value._13; _32 = value._23; _33 = value._33; _34 = value._43;
+}
 
 //-------------------------------------------------------------------------------------------------
-//      const float* 型へのキャストです.
+//      float* 型へのキャストです.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Quaternion::operator const float* () const
-{ return static_cast<const float*>( &x ); }
+Matrix3x4::operator float* ()
+{ return static_cast<float*>( &_11 ); }
 
 //-------------------------------------------------------------------------------------------------
-//      加算代入演算子です.
+//      const float* 型へのキャストです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix3x4::operator const float* () const
+{ return static_cast<const float*>( &_11 ); }
+
+//-------------------------------------------------------------------------------------------------
+//      乗算代入演算子です.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix3x4& Matrix3x4::operator *= ( const Matrix3x4& value )
+{
+    Multiply( *this, value, *this );
+    return (*this);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乗算演算子です.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix3x4 Matrix3x4::operator * ( const Matrix3x4& value ) const
+{
+    Matrix3x4 result;
+    Multiply( *this, value, result );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      等価比較演算子です.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+bool Matrix3x4::operator == ( const Matrix3x4& value ) const
+{ return ( 0 == memcmp( this, &value, sizeof( Matrix3x4 ) ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      非等価比較演算子です.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+bool Matrix3x4::operator != ( const Matrix3x4& value ) const
+{ return ( 0 != memcmp( this, &value, sizeof( Matrix3x4 ) ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      単位行列化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix3x4& Matrix3x4::Identity()
+{
+    _11 = _22 = _33 = 1.0f;
+    _12 = _13 = _14 =
+    _21 = _23 = _24 =
+    _31 = _32 = _34 = 0.0f;
+    return (*this);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      単位行列を生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+constexpr Matrix3x4 Matrix3x4::CreateIdentity()
+{
+    return Matrix3x4(
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列を合成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix3x4 Matrix3x4::Multiply( const Matrix3x4& a, const Matrix3x4& b )
+{
+    Matrix3x4 result;
+    Multiply( a, b, result );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列を合成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Matrix3x4::Multiply( const Matrix3x4& a, const Matrix3x4& b, Matrix3x4& result )
+{
+    // 転置形式なので b * a を計算する. 暗黙の4行目は (0, 0, 0, 1).
+#if ASVK_IS_SIMD
+    auto a0 = detail::LoadFloat4( a.m[0] );
+    auto a1 = detail::LoadFloat4( a.m[1] );
+    auto a2 = detail::LoadFloat4( a.m[2] );
+
+    __m128 r[3];
+    for( auto i=0; i<3; ++i )
+    {
+        auto t = _mm_add_ps( _mm_mul_ps( a0, _mm_set1_ps( b.m[i][0] ) ), _mm_mul_ps( a1, _mm_set1_ps( b.m[i][1] ) ) );
+        t = _mm_add_ps( t, _mm_mul_ps( a2, _mm_set1_ps( b.m[i][2] ) ) );
+
+        // 平行移動は4列目だけに加える(0を加えると -0 が +0 になりスカラー版と一致しない).
+        auto h = _mm_unpackhi_ps( t, _mm_add_ps( t, _mm_set1_ps( b.m[i][3] ) ) );   // (t2, -, t3, t3 + b14)
+        r[i] = _mm_shuffle_ps( t, h, _MM_SHUFFLE( 3, 0, 1, 0 ) );
+    }
+
+    detail::StoreFloat4( result.m[0], r[0] );
+    detail::StoreFloat4( result.m[1], r[1] );
+    detail::StoreFloat4( result.m[2], r[2] );
+#else
+    auto m11 = ( ( a._11 * b._11 ) + ( a._21 * b._12 ) ) + ( a._31 * b._13 );
+    auto m12 = ( ( a._12 * b._11 ) + ( a._22 * b._12 ) ) + ( a._32 * b._13 );
+    auto m13 = ( ( a._13 * b._11 ) + ( a._23 * b._12 ) ) + ( a._33 * b._13 );
+    auto m14 = ( ( ( a._14 * b._11 ) + ( a._24 * b._12 ) ) + ( a._34 * b._13 ) ) + b._14;
+
+    auto m21 = ( ( a._11 * b._21 ) + ( a._21 * b._22 ) ) + ( a._31 * b._23 );
+    auto m22 = ( ( a._12 * b._21 ) + ( a._22 * b._22 ) ) + ( a._32 * b._23 );
+    auto m23 = ( ( a._13 * b._21 ) + ( a._23 * b._22 ) ) + ( a._33 * b._23 );
+    auto m24 = ( ( ( a._14 * b._21 ) + ( a._24 * b._22 ) ) + ( a._34 * b._23 ) ) + b._24;
+
+    auto m31 = ( ( a._11 * b._31 ) + ( a._21 * b._32 ) ) + ( a._31 * b._33 );
+    auto m32 = ( ( a._12 * b._31 ) + ( a._22 * b._32 ) ) + ( a._32 * b._33 );
+    auto m33 = ( ( a._13 * b._31 ) + ( a._23 * b._32 ) ) + ( a._33 * b._33 );
+    auto m34 = ( ( ( a._14 * b._31 ) + ( a._24 * b._32 ) ) + ( a._34 * b._33 ) ) + b._34;
+
+    result._11 = m11; result._12 = m12; result._13 = m13; result._14 = m14;
+    result._21 = m21; result._22 = m22; result._23 = m23; result._24 = m24;
+    result._31 = m31; result._32 = m32; result._33 = m33; result._34 = m34;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Matrix3x4 Matrix3x4::InvertAffine( const Matrix3x4& value )
+{
+    Matrix3x4 result;
+    InvertAffine( value, result );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆行列を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Matrix3x4::InvertAffine( const Matrix3x4& value, Matrix3x4& result )
+{
+    // 3x3部分の余因子.
+    auto c11 = value._22 * value._33 - value._23 * value._32;
+    auto c12 = value._23 * value._31 - value._21 * value._33;
+    auto c13 = value._21 * value._32 - value._22 * value._31;
+
+    auto det = value._11 * c11 + value._12 * c12 + value._13 * c13;
+    assert( det != 0.0f );
+    auto invDet = 1.0f / det;
+
+    auto m11 = c11 * invDet;
+    auto m12 = ( value._13 * value._32 - value._12 * value._33 ) * invDet;
+    auto m13 = ( value._12 * value._23 - value._13 * value._22 ) * invDet;
+
+    auto m21 = c12 * invDet;
+    auto m22 = ( value._11 * value._33 - value._13 * value._31 ) * invDet;
+    auto m23 = ( value._13 * value._21 - value._11 * value._23 ) * invDet;
+
+    auto m31 = c13 * invDet;
+    auto m32 = ( value._12 * value._31 - value._11 * value._32 ) * invDet;
+    auto m33 = ( value._11 * value._22 - value._12 * value._21 ) * invDet;
+
+    // 平行移動成分は -(L^-1 * t).
+    auto tx = value._14;
+    auto ty = value._24;
+    auto tz = value._34;
+
+    result._11 = m11; result._12 = m12; result._13 = m13; result._14 = -( m11 * tx + m12 * ty + m13 * tz );
+    result._21 = m21; result._22 = m22; result._23 = m23; result._24 = -( m21 * tx + m22 * ty + m23 * tz );
+    result._31 = m31; result._32 = m32; result._33 = m33; result._34 = -( m31 * tx + m32 * ty + m33 * tz );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      位置ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 Matrix3x4::TransformCoord( const Vector3& coord, const Matrix3x4& matrix )
+{
+    return Vector3(
+        ( ((coord.x * matrix._11) + (coord.y * matrix._12)) + (coord.z * matrix._13)) + matrix._14,
+        ( ((coord.x * matrix._21) + (coord.y * matrix._22)) + (coord.z * matrix._23)) + matrix._24,
+        ( ((coord.x * matrix._31) + (coord.y * matrix._32)) + (coord.z * matrix._33)) + matrix._34 );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      位置ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Matrix3x4::TransformCoord( const Vector3& coord, const Matrix3x4& matrix, Vector3& result )
+{ result = TransformCoord( coord, matrix ); }
+
+//-------------------------------------------------------------------------------------------------
+//      法線ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 Matrix3x4::TransformNormal( const Vector3& normal, const Matrix3x4& matrix )
+{
+    return Vector3(
+        ((normal.x * matrix._11) + (normal.y * matrix._12)) + (normal.z * matrix._13),
+        ((normal.x * matrix._21) + (normal.y * matrix._22)) + (normal.z * matrix._23),
+        ((normal.x * matrix._31) + (normal.y * matrix._32)) + (normal.z * matrix._33) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      法線ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Matrix3x4::TransformNormal( const Vector3& normal, const Matrix3x4& matrix, Vector3& result )
+{ result = TransformNormal( normal, matrix ); }
+
+static_assert( sizeof(Matrix3x4) == sizeof(float) * 12, "Matrix3x4 must be tightly packed." );
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Quaternion
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Quaternion::Quaternion( const float* pf )
+{
+    assert( pf != nullptr );
+    x = pf[ 0 ];
+    y = pf[ 1 ];
+    z = pf[ 2 ];
+    w = pf[ 3 ];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+constexpr Quaternion::Quaternion( float nx, float ny, float nz, float nw )
+: x( nx )
+, y( ny )
+, z( nz )
+, w( nw )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      float* 型へのキャストです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Quaternion::operator float* ()
+{ return static_cast<float*>( &x ); }
+
+//-------------------------------------------------------------------------------------------------
+//      const float* 型へのキャストです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Quaternion::operator const float* () const
+{ return static_cast<const float*>( &x ); }
+
+//-------------------------------------------------------------------------------------------------
+//      加算代入演算子です.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE 
 Quaternion& Quaternion::operator += ( const Quaternion& q )
@@ -4837,7 +6082,7 @@ Quaternion& Quaternion::operator *= ( const Quaternion& q )
     auto X = ( q.x * w ) + ( x * q.w ) + ( q.y * z ) - ( q.z * y );
     auto Y = ( q.y * w ) + ( y * q.w ) + ( q.z * x ) - ( q.x * z );
     auto Z = ( q.z * w ) + ( z * q.w ) + ( q.x * y ) - ( q.y * x );
-    auto W = ( q.w * w ) - ( q.x * x ) - ( q.y * y ) + ( q.z * z );
+    auto W = ( q.w * w ) - ( q.x * x ) - ( q.y * y ) - ( q.z * z );
     x = X;
     y = Y;
     z = Z;
@@ -4891,14 +6136,14 @@ Quaternion Quaternion::operator - () const
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE 
 Quaternion Quaternion::operator + ( const Quaternion& q ) const
-{ return Quaternion( x + q.x, y + q.y, z + q.z, w + q.z ); }
+{ return Quaternion( x + q.x, y + q.y, z + q.z, w + q.w ); }
 
 //-------------------------------------------------------------------------------------------------
 //      減算演算子です.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE 
 Quaternion Quaternion::operator - ( const Quaternion& q ) const
-{ return Quaternion( x - q.x, y - q.y, z - q.z, w - q.z ); }
+{ return Quaternion( x - q.x, y - q.y, z - q.z, w - q.w ); }
 
 //-------------------------------------------------------------------------------------------------
 //      乗算演算子です.
@@ -4910,7 +6155,7 @@ Quaternion Quaternion::operator * ( const Quaternion& q ) const
         ( q.x * w ) + ( x * q.w ) + ( q.y * z ) - ( q.z * y ),
         ( q.y * w ) + ( y * q.w ) + ( q.z * x ) - ( q.x * z ),
         ( q.z * w ) + ( z * q.w ) + ( q.x * y ) - ( q.y * x ),
-        ( q.w * w ) - ( q.x * x ) - ( q.y * y ) + ( q.z * z )
+        ( q.w * w ) - ( q.x * x ) - ( q.y * y ) - ( q.z * z )
    );
 }
 
@@ -5015,6 +6260,22 @@ Quaternion& Quaternion::SafeNormalize( const Quaternion& set )
     return (*this);
 }
 
+//-------------------------------------------------------------------------------------------------
+//      逆平方根の近似を用いて正規化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Quaternion& Quaternion::NormalizeFast()
+{
+    auto magSq = LengthSq();
+    assert( magSq > 0.0f );
+    auto invMag = RsqrtFast( magSq );
+    x *= invMag;
+    y *= invMag;
+    z *= invMag;
+    w *= invMag;
+    return (*this);
+}
+
 //-------------------------------------------------------------------------------------------------
 //      単位四元数化します.
 //-------------------------------------------------------------------------------------------------
@@ -5036,7 +6297,7 @@ Quaternion& Quaternion::Identity()
 //      単位四元数を生成します.
 //-------------------------------------------------------------------------------------------------
 ASVK_INLINE
-Quaternion Quaternion::CreateIdentity()
+constexpr Quaternion Quaternion::CreateIdentity()
 { return Quaternion( 0.0f, 0.0f, 0.0f, 1.0f ); }
 
 //-------------------------------------------------------------------------------------------------
@@ -5070,7 +6331,7 @@ Quaternion Quaternion::Multiply( const Quaternion& a, const Quaternion& b )
         ( b.x * a.w ) + ( a.x * b.w ) + ( b.y * a.z ) - ( b.z * a.y ),
         ( b.y * a.w ) + ( a.y * b.w ) + ( b.z * a.x ) - ( b.x * a.z ),
         ( b.z * a.w ) + ( a.z * b.w ) + ( b.x * a.y ) - ( b.y * a.x ),
-        ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) + ( b.z * a.z )
+        ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) - ( b.z * a.z )
    );
 }
 
@@ -5083,7 +6344,7 @@ void Quaternion::Multiply( const Quaternion& a, const Quaternion& b, Quaternion&
     result.x = ( b.x * a.w ) + ( a.x * b.w ) + ( b.y * a.z ) - ( b.z * a.y );
     result.y = ( b.y * a.w ) + ( a.y * b.w ) + ( b.z * a.x ) - ( b.x * a.z );
     result.z = ( b.z * a.w ) + ( a.z * b.w ) + ( b.x * a.y ) - ( b.y * a.x );
-    result.w = ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) + ( b.z * a.z );
+    result.w = ( b.w * a.w ) - ( b.x * a.x ) - ( b.y * a.y ) - ( b.z * a.z );
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -5143,10 +6404,10 @@ void Quaternion::Normalize( const Quaternion& value, Quaternion &result )
 {
     auto mag = value.Length();
     assert( mag > 0.0f );
-    result.x /= mag;
-    result.y /= mag;
-    result.z /= mag;
-    result.w /= mag;
+    result.x = value.x / mag;
+    result.y = value.y / mag;
+    result.z = value.z / mag;
+    result.w = value.w / mag;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -5192,6 +6453,37 @@ void Quaternion::SafeNormalize( const Quaternion& value, const Quaternion& set,
     }
 }
 
+//-------------------------------------------------------------------------------------------------
+//      逆平方根の近似を用いて正規化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Quaternion Quaternion::NormalizeFast( const Quaternion& value )
+{
+    auto magSq = value.LengthSq();
+    assert( magSq > 0.0f );
+    auto invMag = RsqrtFast( magSq );
+    return Quaternion(
+        value.x * invMag,
+        value.y * invMag,
+        value.z * invMag,
+        value.w * invMag );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆平方根の近似を用いて正規化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Quaternion::NormalizeFast( const Quaternion& value, Quaternion& result )
+{
+    auto magSq = value.LengthSq();
+    assert( magSq > 0.0f );
+    auto invMag = RsqrtFast( magSq );
+    result.x = value.x * invMag;
+    result.y = value.y * invMag;
+    result.z = value.z * invMag;
+    result.w = value.w * invMag;
+}
+
 //-------------------------------------------------------------------------------------------------
 //      ヨー・ピッチ・ロール角から四元数を生成します.
 //-------------------------------------------------------------------------------------------------
@@ -5201,12 +6493,10 @@ Quaternion Quaternion::CreateFromYawPitchRoll( float yaw, float pitch, float rol
     auto r = roll  * 0.5f;
     auto p = pitch * 0.5f;
     auto y = yaw   * 0.5f;
-    auto sr = sinf( r );
-    auto cr = cosf( r );
-    auto sp = sinf( p );
-    auto cp = cosf( p );
-    auto sy = sinf( y );
-    auto cy = cosf( y );
+    float sr, cr, sp, cp, sy, cy;
+    SinCos( r, sr, cr );
+    SinCos( p, sp, cp );
+    SinCos( y, sy, cy );
 
     return Quaternion(
         cy * sp * cr + sy * cp * sr,
@@ -5225,12 +6515,41 @@ void Quaternion::CreateFromYawPitchRoll( float yaw, float pitch, float roll, Qua
     auto r = roll  * 0.5f;
     auto p = pitch * 0.5f;
     auto y = yaw   * 0.5f;
-    auto sr = sinf(r);
-    auto cr = cosf(r);
-    auto sp = sinf(p);
-    auto cp = cosf(p);
-    auto sy = sinf(y);
-    auto cy = cosf(y);
+    float sr, cr, sp, cp, sy, cy;
+    SinCos( r, sr, cr );
+    SinCos( p, sp, cp );
+    SinCos( y, sy, cy );
+
+    result.x = cy * sp * cr + sy * cp * sr;
+    result.y = sy * cp * cr - cy * sp * sr;
+    result.z = cy * cp * sr - sy * sp * cr;
+    result.w = cy * cp * cr + sy * sp * sr;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SinCosFast()を用いてヨー・ピッチ・ロール角から四元数を生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Quaternion Quaternion::CreateFromYawPitchRollFast( float yaw, float pitch, float roll )
+{
+    Quaternion result;
+    CreateFromYawPitchRollFast( yaw, pitch, roll, result );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SinCosFast()を用いてヨー・ピッチ・ロール角から四元数を生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void Quaternion::CreateFromYawPitchRollFast( float yaw, float pitch, float roll, Quaternion& result )
+{
+    auto r = roll  * 0.5f;
+    auto p = pitch * 0.5f;
+    auto y = yaw   * 0.5f;
+    float sr, cr, sp, cp, sy, cy;
+    SinCosFast( r, sr, cr );
+    SinCosFast( p, sp, cp );
+    SinCosFast( y, sy, cy );
 
     result.x = cy * sp * cr + sy * cp * sr;
     result.y = sy * cp * cr - cy * sp * sr;
@@ -5595,6 +6914,172 @@ void Quaternion::Squad
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DualQuaternion structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+constexpr DualQuaternion::DualQuaternion( const Quaternion& nreal, const Quaternion& ndual )
+: real( nreal )
+, dual( ndual )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      正規化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+DualQuaternion& DualQuaternion::Normalize()
+{
+    // Skin() のSIMD版と同じ演算順序.
+    auto lenSq = real.LengthSq();
+    assert( lenSq > 0.0f );
+    auto inv = 1.0f / sqrtf( lenSq );
+    real *= inv;
+    dual *= inv;
+    return (*this);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      平行移動量を取得します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 DualQuaternion::GetTranslation() const
+{
+    // t = 2 * dual * conj(real) のベクトル部.
+    return Vector3(
+        2.0f * ( ( real.w * dual.x - dual.w * real.x ) + ( real.y * dual.z - real.z * dual.y ) ),
+        2.0f * ( ( real.w * dual.y - dual.w * real.y ) + ( real.z * dual.x - real.x * dual.z ) ),
+        2.0f * ( ( real.w * dual.z - dual.w * real.z ) + ( real.x * dual.y - real.y * dual.x ) ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      恒等変換を生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+constexpr DualQuaternion DualQuaternion::CreateIdentity()
+{
+    return DualQuaternion(
+        Quaternion( 0.0f, 0.0f, 0.0f, 1.0f ),
+        Quaternion( 0.0f, 0.0f, 0.0f, 0.0f ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      回転と平行移動から双対四元数を生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+DualQuaternion DualQuaternion::CreateFromRotationTranslation( const Quaternion& rotation, const Vector3& translation )
+{
+    auto t = Quaternion( translation.x, translation.y, translation.z, 0.0f );
+    return DualQuaternion( rotation, Quaternion::Multiply( rotation, t ) * 0.5f );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      剛体変換行列から双対四元数を生成します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+DualQuaternion DualQuaternion::CreateFromMatrix( const Matrix& value )
+{
+    return CreateFromRotationTranslation(
+        Quaternion::CreateFromRotationMatrix( value ),
+        Vector3( value._41, value._42, value._43 ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      双対四元数同士の乗算を行います.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+DualQuaternion DualQuaternion::Multiply( const DualQuaternion& a, const DualQuaternion& b )
+{
+    return DualQuaternion(
+        Quaternion::Multiply( a.real, b.real ),
+        Quaternion::Multiply( a.dual, b.real ) + Quaternion::Multiply( a.real, b.dual ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      共役な双対四元数を求めます.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+DualQuaternion DualQuaternion::Conjugate( const DualQuaternion& value )
+{ return DualQuaternion( Quaternion::Conjugate( value.real ), Quaternion::Conjugate( value.dual ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      正規化を行います.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+DualQuaternion DualQuaternion::Normalize( const DualQuaternion& value )
+{
+    auto result = value;
+    return result.Normalize();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      重み付きで線形補間し，正規化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+DualQuaternion DualQuaternion::Blend( const DualQuaternion* pValues, const float* pWeights, size_t count )
+{
+    assert( pValues != nullptr && pWeights != nullptr && count > 0 );
+
+    const auto& pivot = pValues[0].real;
+    auto result = DualQuaternion( pivot * pWeights[0], pValues[0].dual * pWeights[0] );
+    for( size_t i=1; i<count; ++i )
+    {
+        // q と -q は同じ回転なので，短い方の経路でブレンドする.
+        auto w = pWeights[i];
+        if ( Quaternion::Dot( pValues[i].real, pivot ) < 0.0f )
+        { w = -w; }
+
+        result.real += pValues[i].real * w;
+        result.dual += pValues[i].dual * w;
+    }
+
+    return result.Normalize();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      位置座標を変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 DualQuaternion::Transform( const Vector3& position, const DualQuaternion& value )
+{
+    const auto& q = value.real;
+    const auto& p = position;
+
+    // p' = p + 2 * q.xyz x ( q.xyz x p + q.w * p ).
+    auto tx = ( q.y * p.z - q.z * p.y ) + q.w * p.x;
+    auto ty = ( q.z * p.x - q.x * p.z ) + q.w * p.y;
+    auto tz = ( q.x * p.y - q.y * p.x ) + q.w * p.z;
+    auto t  = value.GetTranslation();
+
+    return Vector3(
+        ( p.x + 2.0f * ( q.y * tz - q.z * ty ) ) + t.x,
+        ( p.y + 2.0f * ( q.z * tx - q.x * tz ) ) + t.y,
+        ( p.z + 2.0f * ( q.x * ty - q.y * tx ) ) + t.z );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      法線ベクトルを変換します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 DualQuaternion::TransformNormal( const Vector3& normal, const DualQuaternion& value )
+{
+    const auto& q = value.real;
+    const auto& n = normal;
+
+    auto tx = ( q.y * n.z - q.z * n.y ) + q.w * n.x;
+    auto ty = ( q.z * n.x - q.x * n.z ) + q.w * n.y;
+    auto tz = ( q.x * n.y - q.y * n.x ) + q.w * n.z;
+
+    return Vector3(
+        n.x + 2.0f * ( q.y * tz - q.z * ty ),
+        n.y + 2.0f * ( q.z * tx - q.x * tz ),
+        n.z + 2.0f * ( q.x * ty - q.y * tx ) );
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////
 // OrthonormalBasis structure
 ////////////////////////////////////////////////////////////////////////////////////
@@ -5636,14 +7121,12 @@ OrthonormalBasis::OrthonormalBasis( const OrthonormalBasis& value )
 ASVK_INLINE
 void OrthonormalBasis::InitFromU( const Vector3& value )
 {
-    Vector3 n( 1.0f, 0.0f, 0.0f );
-    Vector3 m( 0.0f, 1.0f, 0.0f );
-    
-    u = Vector3::Normalize( value );
-    v = Vector3::Cross( u, n );
-    if ( v.Length() < ONB_EPSILON )
-    { v = Vector3::Cross( u, m ); }
-    w = Vector3::Cross( v, u );
+    // W方向として構築した基底を回して u x v = w を保つ.
+    OrthonormalBasis basis;
+    basis.InitFromW( value );
+    u = basis.w;
+    v = basis.u;
+    w = basis.v;
 }
 
 //----------------------------------------------------------------------------------
@@ -5652,14 +7135,11 @@ void OrthonormalBasis::InitFromU( const Vector3& value )
 ASVK_INLINE
 void OrthonormalBasis::InitFromV( const Vector3& value )
 {
-    Vector3 n ( 1.0f, 0.0f, 0.0f );
-    Vector3 m ( 0.0f, 1.0f, 0.0f );
-
-    v = Vector3::Normalize( value );
-    u = Vector3::Cross( v, n );
-    if ( u.LengthSq() < ONB_EPSILON )
-    { u = Vector3::Cross( v, m ); }
-    w = Vector3::Cross( v, u );
+    OrthonormalBasis basis;
+    basis.InitFromW( value );
+    u = basis.v;
+    v = basis.w;
+    w = basis.u;
 }
 
 //----------------------------------------------------------------------------------
@@ -5668,17 +7148,16 @@ void OrthonormalBasis::InitFromV( const Vector3& value )
 ASVK_INLINE
 void OrthonormalBasis::InitFromW( const Vector3& value )
 {
-    Vector3 n ( 1.0f, 0.0f, 0.0f );
-    Vector3 m ( 0.0f, 1.0f, 0.0f );
-
     w = Vector3::Normalize( value );
-    u = Vector3::Cross( w, n );
-    if ( u.Length() < ONB_EPSILON )
-    { u = Vector3::Cross( w, m ); }
-    u.Normalize();
 
-    v = Vector3::Cross( u, w );
-    v.Normalize();
+    // Duff et al. "Building an Orthonormal Basis, Revisited" (JCGT 2017) による分岐なしの構築.
+    // ※ CreateFromW() のSIMD版と結果を一致させるため，演算順序を変えないこと.
+    auto sign = copysignf( 1.0f, w.z );
+    auto a    = -1.0f / ( sign + w.z );
+    auto b    = w.x * w.y * a;
+
+    u = Vector3( 1.0f + sign * w.x * w.x * a, sign * b, -sign * w.x );
+    v = Vector3( b, sign + w.y * w.y * a, -w.y );
 }
 
 //----------------------------------------------------------------------------------
@@ -5689,7 +7168,7 @@ void OrthonormalBasis::InitFromUV( const Vector3& _u, const Vector3& _v )
 {
     u = Vector3::Normalize( _u );
     w = Vector3::Normalize( Vector3::Cross( _u, _v ) );
-    v = Vector3::Cross( w, v );
+    v = Vector3::Cross( w, u );
 }
 
 //----------------------------------------------------------------------------------
@@ -5770,5 +7249,260 @@ bool OrthonormalBasis::operator != ( const OrthonormalBasis& value ) const
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Packing Functions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+static constexpr float OCT16_SCALE    = 32767.0f;                  //!< 16bit SNORM の量子化幅です.
+static constexpr float OCT8_SCALE     = 127.0f;                    //!< 8bit SNORM の量子化幅です.
+static constexpr float QTANGENT_SCALE = 255.0f;                    //!< QTangent の各成分(9bit)の量子化幅です.
+static constexpr float QTANGENT_SQRT2 = 1.4142135623730950488f;    //!< √2です.
+
+//-------------------------------------------------------------------------------------------------
+//      [-1, 1] の値を [0, 2 * scale] の整数に量子化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+int32_t QuantizeSnorm( float value, float scale )
+{ return static_cast<int32_t>( value * scale + scale + 0.5f ); }
+
+//-------------------------------------------------------------------------------------------------
+//      単位ベクトルを八面体に写像します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void OctahedralWrap( const Vector3& value, float& x, float& y )
+{
+    auto inv = 1.0f / ( fabsf( value.x ) + fabsf( value.y ) + fabsf( value.z ) );
+    x = value.x * inv;
+    y = value.y * inv;
+
+    // 下半球は対角線で折り返す.
+    if ( value.z < 0.0f )
+    {
+        auto ox = x;
+        x = ( 1.0f - fabsf( y  ) ) * ( ( ox >= 0.0f ) ? 1.0f : -1.0f );
+        y = ( 1.0f - fabsf( ox ) ) * ( ( y  >= 0.0f ) ? 1.0f : -1.0f );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      八面体上の点から単位ベクトルを復元します.
+//      ※ バッチ版と結果を一致させるため，比較の向きや演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 OctahedralUnwrap( float x, float y )
+{
+    auto z  = 1.0f - fabsf( x ) - fabsf( y );
+    auto nz = -z;
+    auto t  = ( nz > 0.0f ) ? nz : 0.0f;
+    x += ( x >= 0.0f ) ? -t : t;
+    y += ( y >= 0.0f ) ? -t : t;
+
+    auto inv = 1.0f / sqrtf( x * x + y * y + z * z );
+    return Vector3( x * inv, y * inv, z * inv );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      量子化した SNORM 値を [-1, 1] に戻します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+float DequantizeSnorm( int32_t value, float scale )
+{
+    auto v = static_cast<float>( value ) * ( 1.0f / scale );
+    return ( v > -1.0f ) ? v : -1.0f;
+}
+
+} // namespace detail
+
+//-------------------------------------------------------------------------------------------------
+//      単位ベクトルを八面体写像で2x16bitに符号化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+uint32_t EncodeOctahedral16( const Vector3& value )
+{
+    float x, y;
+    detail::OctahedralWrap( value, x, y );
+
+    auto qx = detail::QuantizeSnorm( x, detail::OCT16_SCALE ) - 32767;
+    auto qy = detail::QuantizeSnorm( y, detail::OCT16_SCALE ) - 32767;
+    return ( static_cast<uint32_t>( qx ) & 0xFFFF ) | ( static_cast<uint32_t>( qy ) << 16 );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2x16bit の八面体写像から単位ベクトルを復号します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 DecodeOctahedral16( uint32_t value )
+{
+    auto x = detail::DequantizeSnorm( static_cast<int16_t>( value & 0xFFFF ), detail::OCT16_SCALE );
+    auto y = detail::DequantizeSnorm( static_cast<int16_t>( value >> 16 ),    detail::OCT16_SCALE );
+    return detail::OctahedralUnwrap( x, y );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      単位ベクトルを八面体写像で2x8bitに符号化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+uint16_t EncodeOctahedral8( const Vector3& value )
+{
+    float x, y;
+    detail::OctahedralWrap( value, x, y );
+
+    auto qx = detail::QuantizeSnorm( x, detail::OCT8_SCALE ) - 127;
+    auto qy = detail::QuantizeSnorm( y, detail::OCT8_SCALE ) - 127;
+    return static_cast<uint16_t>( ( static_cast<uint32_t>( qx ) & 0xFF ) | ( ( static_cast<uint32_t>( qy ) & 0xFF ) << 8 ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2x8bit の八面体写像から単位ベクトルを復号します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+Vector3 DecodeOctahedral8( uint16_t value )
+{
+    auto x = detail::DequantizeSnorm( static_cast<int8_t>( value & 0xFF ), detail::OCT8_SCALE );
+    auto y = detail::DequantizeSnorm( static_cast<int8_t>( value >> 8 ),   detail::OCT8_SCALE );
+    return detail::OctahedralUnwrap( x, y );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      接線空間を表す回転を32bitに符号化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+uint32_t EncodeQTangent( const Quaternion& rotation, float handedness )
+{
+    float c[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+    // 絶対値最大の成分を省略する(同値の場合は後ろの成分を優先).
+    auto ax = fabsf( c[0] );
+    auto ay = fabsf( c[1] );
+    auto az = fabsf( c[2] );
+    auto aw = fabsf( c[3] );
+    auto mx = Max( Max( ax, ay ), Max( az, aw ) );
+    uint32_t index = ( aw == mx ) ? 3 : ( az == mx ) ? 2 : ( ay == mx ) ? 1 : 0;
+
+    // q と -q は同じ回転なので，省略する成分が正になるよう揃える.
+    auto sign = ( c[index] < 0.0f ) ? -1.0f : 1.0f;
+
+    // 残りの成分は [-1/√2, 1/√2] に収まるので √2 倍して量子化する.
+    uint32_t result = 0;
+    uint32_t shift  = 0;
+    for( uint32_t i = 0; i < 4; ++i )
+    {
+        if ( i == index )
+        { continue; }
+
+        auto v = ( c[i] * sign ) * detail::QTANGENT_SQRT2;
+        v = ( v < 1.0f )  ? v : 1.0f;
+        v = ( v > -1.0f ) ? v : -1.0f;
+        result |= static_cast<uint32_t>( detail::QuantizeSnorm( v, detail::QTANGENT_SCALE ) ) << shift;
+        shift  += 9;
+    }
+
+    result |= index << 27;
+    result |= ( handedness < 0.0f ) ? ( 1u << 29 ) : 0u;
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      法線と接線を32bitに符号化します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+uint32_t EncodeQTangent( const Vector3& normal, const Vector4& tangent )
+{
+    // 接線を法線に直交化し，(接線, 従接線, 法線) を行とする回転行列を作る.
+    auto t = Vector3( tangent.x, tangent.y, tangent.z );
+    t = Vector3::Normalize( t - normal * Vector3::Dot( normal, t ) );
+    auto b = Vector3::Cross( normal, t );
+
+    auto m = Matrix(
+        t.x,      t.y,      t.z,      0.0f,
+        b.x,      b.y,      b.z,      0.0f,
+        normal.x, normal.y, normal.z, 0.0f,
+        0.0f,     0.0f,     0.0f,     1.0f );
+
+    return EncodeQTangent( Quaternion::CreateFromRotationMatrix( m ), tangent.w );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      QTangent から接線空間の回転を復号します.
+//      ※ バッチ版と結果を一致させるため，演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void DecodeQTangent( uint32_t value, Quaternion& rotation, float& handedness )
+{
+    const auto scale = ( 1.0f / detail::QTANGENT_SCALE ) * ( 1.0f / detail::QTANGENT_SQRT2 );
+
+    auto a = static_cast<float>( static_cast<int32_t>( ( value >>  0 ) & 0x1FF ) - 255 ) * scale;
+    auto b = static_cast<float>( static_cast<int32_t>( ( value >>  9 ) & 0x1FF ) - 255 ) * scale;
+    auto c = static_cast<float>( static_cast<int32_t>( ( value >> 18 ) & 0x1FF ) - 255 ) * scale;
+    auto r = 1.0f - a * a - b * b - c * c;
+    auto d = sqrtf( ( r > 0.0f ) ? r : 0.0f );
+
+    switch( ( value >> 27 ) & 0x3 )
+    {
+    case 0:  rotation = Quaternion( d, a, b, c ); break;
+    case 1:  rotation = Quaternion( a, d, b, c ); break;
+    case 2:  rotation = Quaternion( a, b, d, c ); break;
+    default: rotation = Quaternion( a, b, c, d ); break;
+    }
+
+    handedness = ( value & ( 1u << 29 ) ) ? -1.0f : 1.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      QTangent から法線と接線を復号します.
+//-------------------------------------------------------------------------------------------------
+ASVK_INLINE
+void DecodeQTangent( uint32_t value, Vector3& normal, Vector4& tangent )
+{
+    Quaternion rotation;
+    float      handedness;
+    DecodeQTangent( value, rotation, handedness );
+
+    auto t = Vector3::Rotate( Vector3( 1.0f, 0.0f, 0.0f ), rotation );
+    normal  = Vector3::Rotate( Vector3( 0.0f, 0.0f, 1.0f ), rotation );
+    tangent = Vector4( t.x, t.y, t.z, handedness );
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Compile-time checks
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static_assert( Fact( 5 ) == 120 && DblFact( 7 ) == 105 && DblFact( 8 ) == 384, "Fact() must be constexpr." );
+static_assert( Perm( 5, 2 ) == 20 && Comb( 5, 2 ) == 10, "Perm()/Comb() must be constexpr." );
+static_assert( ToDegree( F_PI ) == 180.0f, "ToDegree() must be constexpr." );
+
+static_assert( Vector2( 1.0f, 2.0f ).y == 2.0f, "Vector2 must be constexpr constructible." );
+static_assert( Vector3( Vector2( 1.0f, 2.0f ), 3.0f ).z == 3.0f, "Vector3 must be constexpr constructible." );
+static_assert( Vector4( Vector3( 1.0f, 2.0f, 3.0f ), 4.0f ).w == 4.0f, "Vector4 must be constexpr constructible." );
+static_assert( Quaternion::CreateIdentity().w == 1.0f, "Quaternion::CreateIdentity() must be constexpr." );
+
+static_assert( Matrix::CreateIdentity()._44 == 1.0f && Matrix::CreateIdentity()._41 == 0.0f, "Matrix::CreateIdentity() must be constexpr." );
+static_assert( Matrix::CreateScale( 2.0f, 3.0f, 4.0f )._33 == 4.0f, "Matrix::CreateScale() must be constexpr." );
+static_assert( Matrix::CreateTranslation( Vector3( 1.0f, 2.0f, 3.0f ) )._42 == 2.0f, "Matrix::CreateTranslation() must be constexpr." );
+static_assert( Matrix( Vector4( 1.0f, 2.0f, 3.0f, 4.0f ), Vector4( 0.0f, 0.0f, 0.0f, 0.0f ), Vector4( 0.0f, 0.0f, 0.0f, 0.0f ), Vector4( 0.0f, 0.0f, 0.0f, 1.0f ) )._14 == 4.0f, "Matrix must be constexpr constructible." );
+static_assert( Matrix( Matrix3x4::CreateIdentity() )._44 == 1.0f, "Matrix3x4 must be constexpr convertible." );
+
+static_assert( std::is_trivially_default_constructible<Vector3>::value, "Vector3 must be trivially default constructible." );
+static_assert( std::is_trivially_default_constructible<Matrix>::value,  "Matrix must be trivially default constructible." );
+
+// ASVK_USE_ALIGNED_TYPES の有無でサイズが変わらないこと(配列の要素間隔は常に同じ).
+static_assert( sizeof(Vector4)        == sizeof(float) * 4,  "Vector4 must be tightly packed." );
+static_assert( sizeof(Vector3x4)      == sizeof(float) * 12, "Vector3x4 must be tightly packed." );
+static_assert( sizeof(Vector3x8)      == sizeof(float) * 24, "Vector3x8 must be tightly packed." );
+static_assert( sizeof(Matrix)         == sizeof(float) * 16, "Matrix must be tightly packed." );
+static_assert( sizeof(Quaternion)     == sizeof(float) * 4,  "Quaternion must be tightly packed." );
+static_assert( sizeof(DualQuaternion) == sizeof(float) * 8,  "DualQuaternion must be tightly packed." );
+
+static_assert( alignof(Vector4)        == ( ASVK_IS_ALIGNED ? 16 : alignof(float) ), "Vector4 alignment mismatch." );
+static_assert( alignof(Vector3x4)      == ( ASVK_IS_ALIGNED ? 16 : alignof(float) ), "Vector3x4 alignment mismatch." );
+static_assert( alignof(Vector3x8)      == ( ASVK_IS_ALIGNED ? 16 : alignof(float) ), "Vector3x8 alignment mismatch." );
+static_assert( alignof(Matrix)         == ( ASVK_IS_ALIGNED ? 16 : alignof(float) ), "Matrix alignment mismatch." );
+static_assert( alignof(Matrix3x4)      == ( ASVK_IS_ALIGNED ? 16 : alignof(float) ), "Matrix3x4 alignment mismatch." );
+static_assert( alignof(Quaternion)     == ( ASVK_IS_ALIGNED ? 16 : alignof(float) ), "Quaternion alignment mismatch." );
+static_assert( alignof(DualQuaternion) == ( ASVK_IS_ALIGNED ? 16 : alignof(float) ), "DualQuaternion alignment mismatch." );
+
+
 } // namespace asvk
 
@@ -0,0 +1,547 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkAnimation.cpp
+// Desc : Keyframe Animation Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkAnimation.h>
+#include <algorithm>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr float   ROTATION_SCALE      = 16383.0f;                                            //!< 回転の各成分(15bit)の量子化幅です.
+static constexpr float   ROTATION_SQRT2      = 1.4142135623730950488f;                              //!< √2です.
+static constexpr float   ROTATION_DEQUANTIZE = ( 1.0f / ROTATION_SCALE ) * ( 1.0f / ROTATION_SQRT2 ); //!< 量子化した回転の成分を元に戻す係数です.
+static constexpr float   RANGE_SCALE         = 65535.0f;                                            //!< 平行移動量・拡大縮小率(16bit)の量子化幅です.
+static constexpr float   ROTATION_SLERP_DOT  = 0.93969262f;                                         //!< 球面線形補間に切り替えるキー間の内積です(cos 20°. キー間の回転角40°でnlerpの誤差は0.08°).
+
+
+//-------------------------------------------------------------------------------------------------
+//      単位四元数を smallest-three 形式の48bitに量子化します.
+//-------------------------------------------------------------------------------------------------
+inline void EncodeRotation( const asvk::Quaternion& value, uint16_t* pResult )
+{
+    auto q = asvk::Quaternion::Normalize( value );
+    float c[4] = { q.x, q.y, q.z, q.w };
+
+    // 絶対値が最大の成分は残りの3成分から復元できるので捨てる.
+    uint32_t index = 0;
+    for( uint32_t i=1; i<4; ++i )
+    {
+        if ( fabsf( c[i] ) > fabsf( c[index] ) )
+        { index = i; }
+    }
+
+    // q と -q は同じ回転なので，捨てる成分が正になるように符号を揃える.
+    auto sign = ( c[index] < 0.0f ) ? -1.0f : 1.0f;
+
+    uint32_t n = 0;
+    for( uint32_t i=0; i<4; ++i )
+    {
+        if ( i == index )
+        { continue; }
+
+        // 残りの成分は [-1/√2, 1/√2] に収まる.
+        auto v = ( c[i] * sign ) * ROTATION_SQRT2;
+        v = ( v < 1.0f )  ? v : 1.0f;
+        v = ( v > -1.0f ) ? v : -1.0f;
+        pResult[n++] = static_cast<uint16_t>( asvk::detail::QuantizeSnorm( v, ROTATION_SCALE ) );
+    }
+
+    // 捨てた成分の番号は先頭2要素の最上位ビットに格納する.
+    pResult[0] |= static_cast<uint16_t>( ( index & 0x1 ) << 15 );
+    pResult[1] |= static_cast<uint16_t>( ( index & 0x2 ) << 14 );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      smallest-three 形式の48bitから単位四元数を復元します.
+//-------------------------------------------------------------------------------------------------
+inline asvk::Quaternion DecodeRotation( const uint16_t* pValue )
+{
+    auto a = static_cast<float>( static_cast<int32_t>( pValue[0] & 0x7FFF ) - 16383 ) * ROTATION_DEQUANTIZE;
+    auto b = static_cast<float>( static_cast<int32_t>( pValue[1] & 0x7FFF ) - 16383 ) * ROTATION_DEQUANTIZE;
+    auto c = static_cast<float>( static_cast<int32_t>( pValue[2] & 0x7FFF ) - 16383 ) * ROTATION_DEQUANTIZE;
+    auto r = ( ( 1.0f - a * a ) - b * b ) - c * c;
+    auto d = sqrtf( ( r > 0.0f ) ? r : 0.0f );
+
+    switch( ( pValue[0] >> 15 ) | ( ( pValue[1] >> 15 ) << 1 ) )
+    {
+    case 0:  return asvk::Quaternion( d, a, b, c );
+    case 1:  return asvk::Quaternion( a, d, b, c );
+    case 2:  return asvk::Quaternion( a, b, d, c );
+    default: return asvk::Quaternion( a, b, c, d );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      トラックの範囲で16bitに量子化します.
+//-------------------------------------------------------------------------------------------------
+inline uint16_t QuantizeRange( float value, float minValue, float step )
+{
+    if ( step <= 0.0f )
+    { return 0; }
+
+    auto v = ( value - minValue ) / step + 0.5f;
+    v = ( v > 0.0f ) ? v : 0.0f;
+    v = ( v < RANGE_SCALE ) ? v : RANGE_SCALE;
+    return static_cast<uint16_t>( v );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      16bitに量子化したベクトルを復元します.
+//-------------------------------------------------------------------------------------------------
+inline asvk::Vector3 DequantizeRange( const uint16_t* pValue, const asvk::Vector3& minValue, const asvk::Vector3& step )
+{
+    return asvk::Vector3(
+        minValue.x + static_cast<float>( pValue[0] ) * step.x,
+        minValue.y + static_cast<float>( pValue[1] ) * step.y,
+        minValue.z + static_cast<float>( pValue[2] ) * step.z );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      最短経路で正規化線形補間を行います.
+//      キー間の回転角が大きくnlerpの誤差が無視できない場合は球面線形補間を行います.
+//      ※ SIMD版と結果を一致させるため，演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+inline asvk::Quaternion Nlerp( const asvk::Quaternion& a, const asvk::Quaternion& b, float amount )
+{
+    auto dot = ( ( a.x * b.x + a.y * b.y ) + a.z * b.z ) + a.w * b.w;
+    if ( fabsf( dot ) < ROTATION_SLERP_DOT )
+    { return asvk::Quaternion::Slerp( a, b, amount ); }
+
+    auto s   = 1.0f - amount;
+    auto t   = ( dot < 0.0f ) ? -amount : amount;
+
+    auto x = a.x * s + b.x * t;
+    auto y = a.y * s + b.y * t;
+    auto z = a.z * s + b.z * t;
+    auto w = a.w * s + b.w * t;
+
+    auto inv = 1.0f / sqrtf( ( ( x * x + y * y ) + z * z ) + w * w );
+    return asvk::Quaternion( x * inv, y * inv, z * inv, w * inv );
+}
+
+#if ASVK_IS_SIMD
+//-------------------------------------------------------------------------------------------------
+//      マスクに従って値を選択します.
+//-------------------------------------------------------------------------------------------------
+inline __m128 Select( __m128 mask, __m128 a, __m128 b )
+{ return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      4キー分の回転を復元します(DecodeRotation() と同じ結果).
+//-------------------------------------------------------------------------------------------------
+inline void DecodeRotation4( const uint16_t* const* ppValues, __m128& x, __m128& y, __m128& z, __m128& w )
+{
+    auto v0 = _mm_setr_epi32( ppValues[0][0], ppValues[1][0], ppValues[2][0], ppValues[3][0] );
+    auto v1 = _mm_setr_epi32( ppValues[0][1], ppValues[1][1], ppValues[2][1], ppValues[3][1] );
+    auto v2 = _mm_setr_epi32( ppValues[0][2], ppValues[1][2], ppValues[2][2], ppValues[3][2] );
+
+    auto mask = _mm_set1_epi32( 0x7FFF );
+    auto bias = _mm_set1_epi32( 16383 );
+    auto k    = _mm_set1_ps( ROTATION_DEQUANTIZE );
+    auto a = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( _mm_and_si128( v0, mask ), bias ) ), k );
+    auto b = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( _mm_and_si128( v1, mask ), bias ) ), k );
+    auto c = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( _mm_and_si128( v2, mask ), bias ) ), k );
+
+    auto r = _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), _mm_mul_ps( a, a ) ), _mm_mul_ps( b, b ) ), _mm_mul_ps( c, c ) );
+    auto d = _mm_sqrt_ps( _mm_max_ps( r, _mm_setzero_ps() ) );
+
+    auto index = _mm_or_si128( _mm_srli_epi32( v0, 15 ), _mm_slli_epi32( _mm_srli_epi32( v1, 15 ), 1 ) );
+    auto is0   = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_setzero_si128() ) );
+    auto is1   = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 1 ) ) );
+    auto is2   = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 2 ) ) );
+    auto is3   = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 3 ) ) );
+
+    x = Select( is0, d, a );
+    y = Select( is0, a, Select( is1, d, b ) );
+    z = Select( is3, c, Select( is2, d, b ) );
+    w = Select( is3, d, c );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4キー分の量子化したベクトルを復元します(DequantizeRange() と同じ結果).
+//-------------------------------------------------------------------------------------------------
+inline void DequantizeRange4
+(
+    const uint16_t* const*  ppValues,
+    const asvk::Vector3*    pMin,
+    const asvk::Vector3*    pStep,
+    __m128&                 x,
+    __m128&                 y,
+    __m128&                 z
+)
+{
+    __m128 mx, my, mz;
+    __m128 sx, sy, sz;
+    asvk::detail::LoadVector3x4( pMin,  mx, my, mz );
+    asvk::detail::LoadVector3x4( pStep, sx, sy, sz );
+
+    auto vx = _mm_cvtepi32_ps( _mm_setr_epi32( ppValues[0][0], ppValues[1][0], ppValues[2][0], ppValues[3][0] ) );
+    auto vy = _mm_cvtepi32_ps( _mm_setr_epi32( ppValues[0][1], ppValues[1][1], ppValues[2][1], ppValues[3][1] ) );
+    auto vz = _mm_cvtepi32_ps( _mm_setr_epi32( ppValues[0][2], ppValues[1][2], ppValues[2][2], ppValues[3][2] ) );
+
+    x = _mm_add_ps( mx, _mm_mul_ps( vx, sx ) );
+    y = _mm_add_ps( my, _mm_mul_ps( vy, sy ) );
+    z = _mm_add_ps( mz, _mm_mul_ps( vz, sz ) );
+}
+#endif//ASVK_IS_SIMD
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AnimationCursor class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+AnimationCursor::AnimationCursor()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+AnimationCursor::~AnimationCursor()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      先頭のキーに戻します.
+//-------------------------------------------------------------------------------------------------
+void AnimationCursor::Reset()
+{ std::fill( m_Keys.begin(), m_Keys.end(), 0u ); }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AnimationClip class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+AnimationClip::AnimationClip()
+: m_KeyOffset   ( 1, 0 )
+, m_Duration    ( 0.0f )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+AnimationClip::~AnimationClip()
+{ Clear(); }
+
+//-------------------------------------------------------------------------------------------------
+//      キーフレームを量子化してクリップを構築します.
+//-------------------------------------------------------------------------------------------------
+bool AnimationClip::Build( const AnimationTrack* pTracks, size_t count )
+{
+    assert( count == 0 || pTracks != nullptr );
+    Clear();
+
+    // 入力をチェック.
+    size_t keyCount = 0;
+    for( size_t i=0; i<count; ++i )
+    {
+        const auto& track = pTracks[i];
+        if ( track.KeyCount == 0 )
+        { return false; }
+
+        assert( track.Times != nullptr && track.Translations != nullptr && track.Rotations != nullptr && track.Scales != nullptr );
+        for( uint32_t k=1; k<track.KeyCount; ++k )
+        {
+            if ( !( track.Times[k - 1] < track.Times[k] ) )
+            { return false; }
+        }
+
+        keyCount += track.KeyCount;
+    }
+
+    m_KeyOffset      .resize( count + 1 );
+    m_Times          .resize( keyCount );
+    m_Rotations      .resize( keyCount * 3 );
+    m_Translations   .resize( keyCount * 3 );
+    m_Scales         .resize( keyCount * 3 );
+    m_TranslationMin .resize( count );
+    m_TranslationStep.resize( count );
+    m_ScaleMin       .resize( count );
+    m_ScaleStep      .resize( count );
+
+    uint32_t offset = 0;
+    for( size_t i=0; i<count; ++i )
+    {
+        const auto& track = pTracks[i];
+        m_KeyOffset[i] = offset;
+
+        auto tmin = track.Translations[0];
+        auto tmax = track.Translations[0];
+        auto smin = track.Scales[0];
+        auto smax = track.Scales[0];
+        for( uint32_t k=1; k<track.KeyCount; ++k )
+        {
+            tmin = Vector3::Min( tmin, track.Translations[k] );
+            tmax = Vector3::Max( tmax, track.Translations[k] );
+            smin = Vector3::Min( smin, track.Scales[k] );
+            smax = Vector3::Max( smax, track.Scales[k] );
+        }
+
+        auto tstep = ( tmax - tmin ) / RANGE_SCALE;
+        auto sstep = ( smax - smin ) / RANGE_SCALE;
+        m_TranslationMin [i] = tmin;
+        m_TranslationStep[i] = tstep;
+        m_ScaleMin       [i] = smin;
+        m_ScaleStep      [i] = sstep;
+
+        for( uint32_t k=0; k<track.KeyCount; ++k )
+        {
+            auto idx = offset + k;
+            const auto& t = track.Translations[k];
+            const auto& s = track.Scales[k];
+
+            m_Times[idx] = track.Times[k];
+            EncodeRotation( track.Rotations[k], &m_Rotations[idx * 3] );
+
+            m_Translations[idx * 3 + 0] = QuantizeRange( t.x, tmin.x, tstep.x );
+            m_Translations[idx * 3 + 1] = QuantizeRange( t.y, tmin.y, tstep.y );
+            m_Translations[idx * 3 + 2] = QuantizeRange( t.z, tmin.z, tstep.z );
+
+            m_Scales[idx * 3 + 0] = QuantizeRange( s.x, smin.x, sstep.x );
+            m_Scales[idx * 3 + 1] = QuantizeRange( s.y, smin.y, sstep.y );
+            m_Scales[idx * 3 + 2] = QuantizeRange( s.z, smin.z, sstep.z );
+        }
+
+        m_Duration = Max( m_Duration, track.Times[track.KeyCount - 1] );
+        offset += track.KeyCount;
+    }
+    m_KeyOffset[count] = offset;
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全てのデータを破棄します.
+//-------------------------------------------------------------------------------------------------
+void AnimationClip::Clear()
+{
+    m_KeyOffset      .assign( 1, 0 );
+    m_Times          .clear();
+    m_Rotations      .clear();
+    m_Translations   .clear();
+    m_Scales         .clear();
+    m_TranslationMin .clear();
+    m_TranslationStep.clear();
+    m_ScaleMin       .clear();
+    m_ScaleStep      .clear();
+    m_Duration = 0.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      カーソルをこのクリップ用に初期化します.
+//-------------------------------------------------------------------------------------------------
+void AnimationClip::ResetCursor( AnimationCursor& cursor ) const
+{ cursor.m_Keys.assign( GetTrackCount(), 0u ); }
+
+//-------------------------------------------------------------------------------------------------
+//      指定時刻を挟むキーを探します.
+//-------------------------------------------------------------------------------------------------
+float AnimationClip::Seek( size_t track, float time, uint32_t& key ) const
+{
+    auto count = m_KeyOffset[track + 1] - m_KeyOffset[track];
+    if ( count == 1 )
+    {
+        key = 0;
+        return 0.0f;
+    }
+
+    const float* times = &m_Times[m_KeyOffset[track]];
+    auto k = ( key < count - 1 ) ? key : count - 2;
+
+    if ( time < times[k] || ( k + 2 < count && time >= times[k + 2] ) )
+    {
+        // 大きく移動した場合だけ二分探索する.
+        auto pos = static_cast<uint32_t>( std::upper_bound( times, times + count, time ) - times );
+        k = ( pos > 1 ) ? pos - 1 : 0;
+        k = ( k < count - 1 ) ? k : count - 2;
+    }
+    else if ( time >= times[k + 1] && k + 2 < count )
+    {
+        // 前方向への連続サンプリングでは高々1キー進めるだけで済む.
+        k++;
+    }
+
+    key = k;
+    auto amount = ( time - times[k] ) / ( times[k + 1] - times[k] );
+    return Saturate( amount );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全トラックを指定時刻でサンプリングします.
+//-------------------------------------------------------------------------------------------------
+void AnimationClip::Sample
+(
+    float               time,
+    AnimationCursor&    cursor,
+    Vector3*            pTranslations,
+    Quaternion*         pRotations,
+    Vector3*            pScales
+) const
+{
+    auto count = GetTrackCount();
+    assert( cursor.m_Keys.size() == count );
+    assert( count == 0 || ( pTranslations != nullptr && pRotations != nullptr && pScales != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    // キーの探索はトラックごとに行い，復元と補間を4トラックずつまとめて行う.
+    for( ; i + 4 <= count; i += 4 )
+    {
+        const uint16_t* ra[4];
+        const uint16_t* rb[4];
+        const uint16_t* ta[4];
+        const uint16_t* tb[4];
+        const uint16_t* sa[4];
+        const uint16_t* sb[4];
+        float amount[4];
+
+        for( size_t j=0; j<4; ++j )
+        {
+            auto& key = cursor.m_Keys[i + j];
+            amount[j] = Seek( i + j, time, key );
+
+            auto a = m_KeyOffset[i + j] + key;
+            auto b = ( a + 1 < m_KeyOffset[i + j + 1] ) ? a + 1 : a;
+            ra[j] = &m_Rotations   [a * 3]; rb[j] = &m_Rotations   [b * 3];
+            ta[j] = &m_Translations[a * 3]; tb[j] = &m_Translations[b * 3];
+            sa[j] = &m_Scales      [a * 3]; sb[j] = &m_Scales      [b * 3];
+        }
+
+        auto t = _mm_loadu_ps( amount );
+        auto s = _mm_sub_ps( _mm_set1_ps( 1.0f ), t );
+
+        // 回転.
+        {
+            __m128 ax, ay, az, aw;
+            __m128 bx, by, bz, bw;
+            DecodeRotation4( ra, ax, ay, az, aw );
+            DecodeRotation4( rb, bx, by, bz, bw );
+
+            auto dot = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ), _mm_mul_ps( az, bz ) ), _mm_mul_ps( aw, bw ) );
+            auto tt  = _mm_xor_ps( t, _mm_and_ps( _mm_cmplt_ps( dot, _mm_setzero_ps() ), _mm_set1_ps( -0.0f ) ) );
+
+            auto x = _mm_add_ps( _mm_mul_ps( ax, s ), _mm_mul_ps( bx, tt ) );
+            auto y = _mm_add_ps( _mm_mul_ps( ay, s ), _mm_mul_ps( by, tt ) );
+            auto z = _mm_add_ps( _mm_mul_ps( az, s ), _mm_mul_ps( bz, tt ) );
+            auto w = _mm_add_ps( _mm_mul_ps( aw, s ), _mm_mul_ps( bw, tt ) );
+
+            auto lenSq = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) ), _mm_mul_ps( w, w ) );
+            auto inv   = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( lenSq ) );
+            x = _mm_mul_ps( x, inv );
+            y = _mm_mul_ps( y, inv );
+            z = _mm_mul_ps( z, inv );
+            w = _mm_mul_ps( w, inv );
+
+            _MM_TRANSPOSE4_PS( x, y, z, w );
+            detail::StoreFloat4( &pRotations[i + 0].x, x );
+            detail::StoreFloat4( &pRotations[i + 1].x, y );
+            detail::StoreFloat4( &pRotations[i + 2].x, z );
+            detail::StoreFloat4( &pRotations[i + 3].x, w );
+
+            // キー間の回転角が大きいトラックはスカラー版と同じ球面線形補間で上書きする.
+            auto wide = _mm_movemask_ps( _mm_cmplt_ps( _mm_andnot_ps( _mm_set1_ps( -0.0f ), dot ), _mm_set1_ps( ROTATION_SLERP_DOT ) ) );
+            for( size_t j=0; wide != 0; ++j, wide >>= 1 )
+            {
+                if ( wide & 0x1 )
+                { pRotations[i + j] = Quaternion::Slerp( DecodeRotation( ra[j] ), DecodeRotation( rb[j] ), amount[j] ); }
+            }
+        }
+
+        // 平行移動量と拡大縮小率 (Vector3::Lerp() と同じ式).
+        {
+            __m128 ax, ay, az;
+            __m128 bx, by, bz;
+            DequantizeRange4( ta, &m_TranslationMin[i], &m_TranslationStep[i], ax, ay, az );
+            DequantizeRange4( tb, &m_TranslationMin[i], &m_TranslationStep[i], bx, by, bz );
+            detail::StoreVector3x4( pTranslations + i,
+                _mm_add_ps( ax, _mm_mul_ps( t, _mm_sub_ps( bx, ax ) ) ),
+                _mm_add_ps( ay, _mm_mul_ps( t, _mm_sub_ps( by, ay ) ) ),
+                _mm_add_ps( az, _mm_mul_ps( t, _mm_sub_ps( bz, az ) ) ) );
+
+            DequantizeRange4( sa, &m_ScaleMin[i], &m_ScaleStep[i], ax, ay, az );
+            DequantizeRange4( sb, &m_ScaleMin[i], &m_ScaleStep[i], bx, by, bz );
+            detail::StoreVector3x4( pScales + i,
+                _mm_add_ps( ax, _mm_mul_ps( t, _mm_sub_ps( bx, ax ) ) ),
+                _mm_add_ps( ay, _mm_mul_ps( t, _mm_sub_ps( by, ay ) ) ),
+                _mm_add_ps( az, _mm_mul_ps( t, _mm_sub_ps( bz, az ) ) ) );
+        }
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    {
+        auto& key    = cursor.m_Keys[i];
+        auto  amount = Seek( i, time, key );
+
+        auto a = m_KeyOffset[i] + key;
+        auto b = ( a + 1 < m_KeyOffset[i + 1] ) ? a + 1 : a;
+
+        pRotations[i] = Nlerp(
+            DecodeRotation( &m_Rotations[a * 3] ),
+            DecodeRotation( &m_Rotations[b * 3] ),
+            amount );
+
+        pTranslations[i] = Vector3::Lerp(
+            DequantizeRange( &m_Translations[a * 3], m_TranslationMin[i], m_TranslationStep[i] ),
+            DequantizeRange( &m_Translations[b * 3], m_TranslationMin[i], m_TranslationStep[i] ),
+            amount );
+
+        pScales[i] = Vector3::Lerp(
+            DequantizeRange( &m_Scales[a * 3], m_ScaleMin[i], m_ScaleStep[i] ),
+            DequantizeRange( &m_Scales[b * 3], m_ScaleMin[i], m_ScaleStep[i] ),
+            amount );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      トラック数を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t AnimationClip::GetTrackCount() const
+{ return m_KeyOffset.size() - 1; }
+
+//-------------------------------------------------------------------------------------------------
+//      総キー数を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t AnimationClip::GetKeyCount() const
+{ return m_Times.size(); }
+
+//-------------------------------------------------------------------------------------------------
+//      再生時間を取得します.
+//-------------------------------------------------------------------------------------------------
+float AnimationClip::GetDuration() const
+{ return m_Duration; }
+
+//-------------------------------------------------------------------------------------------------
+//      クリップが使用しているメモリ量を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t AnimationClip::GetMemorySize() const
+{
+    return m_KeyOffset      .size() * sizeof( uint32_t )
+         + m_Times          .size() * sizeof( float )
+         + m_Rotations      .size() * sizeof( uint16_t )
+         + m_Translations   .size() * sizeof( uint16_t )
+         + m_Scales         .size() * sizeof( uint16_t )
+         + m_TranslationMin .size() * sizeof( Vector3 )
+         + m_TranslationStep.size() * sizeof( Vector3 )
+         + m_ScaleMin       .size() * sizeof( Vector3 )
+         + m_ScaleStep      .size() * sizeof( Vector3 );
+}
+
+} // namespace asvk
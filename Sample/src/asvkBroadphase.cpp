@@ -0,0 +1,459 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkBroadphase.cpp
+// Desc : Broadphase Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkBroadphase.h>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr size_t   BROADPHASE_PARALLEL_THRESHOLD = 4096;     //!< 並列化する物体数の閾値です.
+static constexpr int64_t  BROADPHASE_CHUNK_COUNT        = 64;       //!< 並列化する際の分割数です(結果は分割数にもスレッド数にも依存しません).
+static constexpr uint32_t LANE_COUNT                    = 8;        //!< 1度に判定する最大の物体数です(配列の末尾に埋める数).
+static constexpr uint64_t INSERTION_SORT_BUDGET         = 8;        //!< 挿入ソートを諦めて並べ直す, 物体あたりの移動回数です.
+static constexpr float    SPHERE_MARGIN                 = 1.0f / 65536.0f;  //!< 丸め誤差に備えて球の区間に足す, 座標と半径に対する割合です.
+static constexpr float    SPHERE_MIN_MARGIN             = 1e-18f;   //!< 球の区間に足す最小の幅です(2乗がアンダーフローする距離を含めます).
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// AxisStats structure
+// 分割ごとに集計する中心の統計です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct AxisStats
+{
+    double      sum[3];     //!< 中心の和です.
+    double      sumSq[3];   //!< 中心の2乗の和です.
+    uint32_t    count;      //!< 区間が空でない物体数です.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      分割の先頭の位置を求めます.
+//-------------------------------------------------------------------------------------------------
+inline size_t ChunkBegin( size_t count, int64_t chunk, int64_t chunkCount )
+{ return static_cast<size_t>( ( uint64_t( count ) * uint64_t( chunk ) ) / uint64_t( chunkCount ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      浮動小数の大小関係を保つ符号なし整数に変換します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t OrderBits( float value )
+{
+    uint32_t bits;
+    memcpy( &bits, &value, sizeof(bits) );
+    return ( bits & 0x80000000u ) ? ~bits : ( bits | 0x80000000u );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      並べ替えのキーを求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint64_t MakeKey( float mini, uint32_t index )
+{ return ( uint64_t( OrderBits( mini ) ) << 32 ) | index; }
+
+//-------------------------------------------------------------------------------------------------
+//      区間が重なる組を判定して追加します.
+//      並べた軸の始点は昇順なので, 始点が終点を超えた時点で打ち切ります.
+//-------------------------------------------------------------------------------------------------
+template<typename NarrowTest>
+void SweepRange
+(
+    const float* const*             pMini,
+    const float* const*             pMaxi,
+    const uint32_t*                 pIndex,
+    size_t                          begin,
+    size_t                          end,
+    NarrowTest&                     narrowTest,
+    std::vector<asvk::OverlapPair>& pairs
+)
+{
+    auto emit = [&]( uint32_t a, uint32_t b )
+    {
+        if ( !narrowTest( a, b ) )
+        { return; }
+
+        asvk::OverlapPair pair;
+        pair.a = ( a < b ) ? a : b;
+        pair.b = ( a < b ) ? b : a;
+        pairs.push_back( pair );
+    };
+
+    for( auto i=begin; i<end; ++i )
+    {
+    #if ASVK_IS_SIMD && ASVK_IS_AVX
+        auto maxi0 = _mm256_set1_ps( pMaxi[0][i] );
+        auto mini1 = _mm256_set1_ps( pMini[1][i] );
+        auto maxi1 = _mm256_set1_ps( pMaxi[1][i] );
+        auto mini2 = _mm256_set1_ps( pMini[2][i] );
+        auto maxi2 = _mm256_set1_ps( pMaxi[2][i] );
+
+        // 32バイト境界から読むため, 先頭の i 以前のレーンは結果から除きます.
+        // 末尾は NaN で埋めてあるので, 範囲外のレーンは比較が偽になります.
+        auto skip = static_cast<int>( ( i + 1 ) & 7 );
+        for( auto j=( i + 1 ) & ~size_t( 7 ); ; j+=8, skip=0 )
+        {
+            auto inRange = _mm256_movemask_ps( _mm256_cmp_ps( _mm256_load_ps( pMini[0] + j ), maxi0, _CMP_LE_OQ ) );
+            if ( inRange == 0 )
+            { break; }
+
+            auto overlap = _mm256_and_ps(
+                _mm256_and_ps( _mm256_cmp_ps( _mm256_load_ps( pMini[1] + j ), maxi1, _CMP_LE_OQ ), _mm256_cmp_ps( _mm256_load_ps( pMaxi[1] + j ), mini1, _CMP_GE_OQ ) ),
+                _mm256_and_ps( _mm256_cmp_ps( _mm256_load_ps( pMini[2] + j ), maxi2, _CMP_LE_OQ ), _mm256_cmp_ps( _mm256_load_ps( pMaxi[2] + j ), mini2, _CMP_GE_OQ ) ) );
+            auto mask = ( inRange & _mm256_movemask_ps( overlap ) ) >> skip << skip;
+            for( auto k=0u; k<8 && mask != 0; ++k )
+            {
+                if ( mask & ( 1 << k ) )
+                { emit( pIndex[i], pIndex[j + k] ); }
+            }
+
+            if ( inRange != 0xff )
+            { break; }
+        }
+    #elif ASVK_IS_SIMD
+        auto maxi0 = _mm_set1_ps( pMaxi[0][i] );
+        auto mini1 = _mm_set1_ps( pMini[1][i] );
+        auto maxi1 = _mm_set1_ps( pMaxi[1][i] );
+        auto mini2 = _mm_set1_ps( pMini[2][i] );
+        auto maxi2 = _mm_set1_ps( pMaxi[2][i] );
+
+        // 末尾は NaN で埋めてあるので, 範囲外のレーンは比較が偽になります.
+        for( auto j=i+1; ; j+=4 )
+        {
+            auto inRange = _mm_movemask_ps( _mm_cmple_ps( _mm_loadu_ps( pMini[0] + j ), maxi0 ) );
+            if ( inRange == 0 )
+            { break; }
+
+            auto overlap = _mm_and_ps(
+                _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( pMini[1] + j ), maxi1 ), _mm_cmpge_ps( _mm_loadu_ps( pMaxi[1] + j ), mini1 ) ),
+                _mm_and_ps( _mm_cmple_ps( _mm_loadu_ps( pMini[2] + j ), maxi2 ), _mm_cmpge_ps( _mm_loadu_ps( pMaxi[2] + j ), mini2 ) ) );
+            auto mask = inRange & _mm_movemask_ps( overlap );
+            for( auto k=0u; k<4 && mask != 0; ++k )
+            {
+                if ( mask & ( 1 << k ) )
+                { emit( pIndex[i], pIndex[j + k] ); }
+            }
+
+            if ( inRange != 0xf )
+            { break; }
+        }
+    #else
+        auto maxi0 = pMaxi[0][i];
+        auto mini1 = pMini[1][i];
+        auto maxi1 = pMaxi[1][i];
+        auto mini2 = pMini[2][i];
+        auto maxi2 = pMaxi[2][i];
+        for( auto j=i+1; pMini[0][j] <= maxi0; ++j )
+        {
+            // 分岐を減らすため全ての比較をまとめて評価します.
+            auto overlap = ( pMini[1][j] <= maxi1 ) & ( pMaxi[1][j] >= mini1 )
+                         & ( pMini[2][j] <= maxi2 ) & ( pMaxi[2][j] >= mini2 );
+            if ( overlap )
+            { emit( pIndex[i], pIndex[j] ); }
+        }
+    #endif//ASVK_IS_SIMD
+    }
+}
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Broadphase class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+Broadphase::Broadphase()
+: m_Count   ( 0 )
+, m_Axis    ( 0 )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+Broadphase::~Broadphase()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      重なるバウンディングスフィアの組を求めます.
+//-------------------------------------------------------------------------------------------------
+size_t Broadphase::FindPairs( const BoundingSphere* pSpheres, size_t count, std::vector<OverlapPair>& pairs )
+{
+    if ( pSpheres == nullptr )
+    { count = 0; }
+
+    auto getBounds = [pSpheres]( size_t index, float* pMini, float* pMaxi )
+    {
+        const auto& sphere = pSpheres[index];
+        const float center[3] = { sphere.center.x, sphere.center.y, sphere.center.z };
+        auto valid = ( sphere.radius >= 0.0f );
+        for( auto k=0; k<3; ++k )
+        {
+            auto margin = ( fabsf( center[k] ) + sphere.radius ) * SPHERE_MARGIN + SPHERE_MIN_MARGIN;
+            pMini[k] = center[k] - sphere.radius - margin;
+            pMaxi[k] = center[k] + sphere.radius + margin;
+            valid &= ( pMini[k] <= pMaxi[k] );
+        }
+        return valid;
+    };
+    auto narrowTest = [pSpheres]( uint32_t a, uint32_t b )
+    { return pSpheres[a].Contains( pSpheres[b] ); };
+
+    return Sweep( count, getBounds, narrowTest, pairs );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      重なるバウンディングボックスの組を求めます.
+//-------------------------------------------------------------------------------------------------
+size_t Broadphase::FindPairs( const BoundingBox* pBoxes, size_t count, std::vector<OverlapPair>& pairs )
+{
+    if ( pBoxes == nullptr )
+    { count = 0; }
+
+    auto getBounds = [pBoxes]( size_t index, float* pMini, float* pMaxi )
+    {
+        const auto& box = pBoxes[index];
+        pMini[0] = box.mini.x; pMini[1] = box.mini.y; pMini[2] = box.mini.z;
+        pMaxi[0] = box.maxi.x; pMaxi[1] = box.maxi.y; pMaxi[2] = box.maxi.z;
+        return ( pMini[0] <= pMaxi[0] ) && ( pMini[1] <= pMaxi[1] ) && ( pMini[2] <= pMaxi[2] );
+    };
+
+    // 区間の判定が BoundingBox::Contains() と同じなので, 形状の判定は不要です.
+    auto narrowTest = []( uint32_t, uint32_t )
+    { return true; };
+
+    return Sweep( count, getBounds, narrowTest, pairs );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      保持している並び順を破棄します.
+//-------------------------------------------------------------------------------------------------
+void Broadphase::Reset()
+{
+    m_Keys.clear();
+    m_Count = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      直前の FindPairs() で区間を並べた軸を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t Broadphase::GetAxis() const
+{ return m_Axis; }
+
+//-------------------------------------------------------------------------------------------------
+//      区間を並べ, 重なる組を求めます.
+//-------------------------------------------------------------------------------------------------
+template<typename GetBounds, typename NarrowTest>
+size_t Broadphase::Sweep
+(
+    size_t                      count,
+    GetBounds&&                 getBounds,
+    NarrowTest&&                narrowTest,
+    std::vector<OverlapPair>&   pairs
+)
+{
+    pairs.clear();
+    if ( count > size_t( UINT32_MAX ) )
+    { count = 0; }
+
+    auto chunkCount = ( count >= BROADPHASE_PARALLEL_THRESHOLD ) ? BROADPHASE_CHUNK_COUNT : int64_t( 1 );
+
+    // 中心の分散が最も大きい軸を選びます. 分割の順に足し合わせるので結果はスレッド数に依存しません.
+    AxisStats stats[BROADPHASE_CHUNK_COUNT] = {};
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( chunkCount > 1 )
+#endif
+    for( int64_t c=0; c<chunkCount; ++c )
+    {
+        auto& s = stats[c];
+        for( auto i=ChunkBegin( count, c, chunkCount ); i<ChunkBegin( count, c + 1, chunkCount ); ++i )
+        {
+            float mini[3], maxi[3];
+            if ( !getBounds( i, mini, maxi ) )
+            { continue; }
+
+            for( auto k=0; k<3; ++k )
+            {
+                auto center = 0.5 * ( double( mini[k] ) + double( maxi[k] ) );
+                s.sum  [k] += center;
+                s.sumSq[k] += center * center;
+            }
+            s.count++;
+        }
+    }
+
+    AxisStats merged = {};
+    for( int64_t c=0; c<chunkCount; ++c )
+    {
+        for( auto k=0; k<3; ++k )
+        {
+            merged.sum  [k] += stats[c].sum  [k];
+            merged.sumSq[k] += stats[c].sumSq[k];
+        }
+        merged.count += stats[c].count;
+    }
+
+    uint32_t axis     = 0;
+    double   variance = -1.0;
+    for( auto k=0u; k<3; ++k )
+    {
+        auto mean = merged.sum[k] / double( std::max( merged.count, 1u ) );
+        auto v    = merged.sumSq[k] / double( std::max( merged.count, 1u ) ) - mean * mean;
+        if ( v > variance )
+        {
+            variance = v;
+            axis     = k;
+        }
+    }
+
+    // 区間の始点で並べます. 物体と軸が前回と同じなら前回の並びを更新して挿入ソートします.
+    auto valid      = size_t( merged.count );
+    auto coherent   = ( count == m_Count && axis == m_Axis && valid == m_Keys.size() );
+    auto refreshed  = true;
+    if ( coherent )
+    {
+        bool stale[BROADPHASE_CHUNK_COUNT] = {};
+
+    #if ASVK_IS_OPENMP
+        #pragma omp parallel for if( chunkCount > 1 )
+    #endif
+        for( int64_t c=0; c<chunkCount; ++c )
+        {
+            for( auto i=ChunkBegin( valid, c, chunkCount ); i<ChunkBegin( valid, c + 1, chunkCount ); ++i )
+            {
+                auto index = static_cast<uint32_t>( m_Keys[i] );
+                float mini[3], maxi[3];
+                stale[c] |= !getBounds( index, mini, maxi );
+                m_Keys[i] = MakeKey( mini[axis], index );
+            }
+        }
+
+        for( int64_t c=0; c<chunkCount; ++c )
+        { refreshed &= !stale[c]; }
+
+        // 移動回数が予算を超えたら並べ直しに切り替えます.
+        auto budget = uint64_t( valid ) * INSERTION_SORT_BUDGET;
+        for( size_t i=1; i<valid && refreshed && budget > 0; ++i )
+        {
+            auto key = m_Keys[i];
+            auto pos = i;
+            for( ; pos > 0 && m_Keys[pos - 1] > key && budget > 0; --pos, --budget )
+            { m_Keys[pos] = m_Keys[pos - 1]; }
+            m_Keys[pos] = key;
+        }
+        coherent = refreshed && budget > 0;
+    }
+
+    if ( !coherent )
+    {
+        // 区間が空でない物体を番号順に詰めます. 分割ごとの個数から書き込み先を決めます.
+        size_t offset[BROADPHASE_CHUNK_COUNT];
+        size_t position = 0;
+        for( int64_t c=0; c<chunkCount; ++c )
+        {
+            offset[c]  = position;
+            position  += stats[c].count;
+        }
+
+        m_Keys.resize( valid );
+
+    #if ASVK_IS_OPENMP
+        #pragma omp parallel for if( chunkCount > 1 )
+    #endif
+        for( int64_t c=0; c<chunkCount; ++c )
+        {
+            auto dst = offset[c];
+            for( auto i=ChunkBegin( count, c, chunkCount ); i<ChunkBegin( count, c + 1, chunkCount ); ++i )
+            {
+                float mini[3], maxi[3];
+                if ( getBounds( i, mini, maxi ) )
+                { m_Keys[dst++] = MakeKey( mini[axis], static_cast<uint32_t>( i ) ); }
+            }
+        }
+
+        std::sort( m_Keys.begin(), m_Keys.end() );
+    }
+
+    m_Count = count;
+    m_Axis  = axis;
+
+    // 並べた順に区間を詰めます. 並べた軸を [0] にし, 末尾は判定が偽になるよう NaN で埋めます.
+    uint32_t axes[3] = { axis, ( axis + 1 ) % 3, ( axis + 2 ) % 3 };
+    for( auto k=0; k<3; ++k )
+    {
+        m_Mini[k].resize( valid + LANE_COUNT );
+        m_Maxi[k].resize( valid + LANE_COUNT );
+        std::fill( m_Mini[k].begin() + valid, m_Mini[k].end(), std::numeric_limits<float>::quiet_NaN() );
+        std::fill( m_Maxi[k].begin() + valid, m_Maxi[k].end(), std::numeric_limits<float>::quiet_NaN() );
+    }
+    m_Index.resize( valid );
+
+    auto sweepChunks = ( valid >= BROADPHASE_PARALLEL_THRESHOLD ) ? BROADPHASE_CHUNK_COUNT : int64_t( 1 );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( sweepChunks > 1 )
+#endif
+    for( int64_t c=0; c<sweepChunks; ++c )
+    {
+        for( auto i=ChunkBegin( valid, c, sweepChunks ); i<ChunkBegin( valid, c + 1, sweepChunks ); ++i )
+        {
+            auto index = static_cast<uint32_t>( m_Keys[i] );
+            float mini[3], maxi[3];
+            getBounds( index, mini, maxi );
+            for( auto k=0; k<3; ++k )
+            {
+                m_Mini[k][i] = mini[axes[k]];
+                m_Maxi[k][i] = maxi[axes[k]];
+            }
+            m_Index[i] = index;
+        }
+    }
+
+    // 分割ごとに組を求めます. 始点の密度に偏りがあるので動的に割り当てます.
+    const float* pMini[3] = { m_Mini[0].data(), m_Mini[1].data(), m_Mini[2].data() };
+    const float* pMaxi[3] = { m_Maxi[0].data(), m_Maxi[1].data(), m_Maxi[2].data() };
+    m_Chunks.resize( size_t( sweepChunks ) );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for schedule( dynamic ) if( sweepChunks > 1 )
+#endif
+    for( int64_t c=0; c<sweepChunks; ++c )
+    {
+        auto& chunk = m_Chunks[c];
+        chunk.clear();
+        SweepRange( pMini, pMaxi, m_Index.data(), ChunkBegin( valid, c, sweepChunks ), ChunkBegin( valid, c + 1, sweepChunks ), narrowTest, chunk );
+    }
+
+    // 分割の順に連結します.
+    size_t offset[BROADPHASE_CHUNK_COUNT];
+    size_t total  = 0;
+    for( int64_t c=0; c<sweepChunks; ++c )
+    {
+        offset[c] = total;
+        total    += m_Chunks[c].size();
+    }
+    pairs.resize( total );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( sweepChunks > 1 )
+#endif
+    for( int64_t c=0; c<sweepChunks; ++c )
+    { std::copy( m_Chunks[c].begin(), m_Chunks[c].end(), pairs.begin() + offset[c] ); }
+
+    return total;
+}
+
+} // namespace asvk
@@ -0,0 +1,840 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkBvh.cpp
+// Desc : Bounding Volume Hierarchy Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkBvh.h>
+#include <algorithm>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr uint32_t BIN_COUNT               = 16;         //!< SAH評価に使う軸ごとの最大ビン数です.
+static constexpr uint32_t MIN_BIN_COUNT           = 4;          //!< SAH評価に使う軸ごとの最小ビン数です.
+static constexpr float    TRAVERSAL_COST          = 1.0f;       //!< プリミティブ1個の判定に対するノード走査の相対コストです.
+static constexpr uint32_t BVH_PARALLEL_THRESHOLD  = 16384;      //!< ノード内の処理を並列化するプリミティブ数の閾値です.
+static constexpr int64_t  BVH_CHUNK_COUNT         = 64;         //!< 並列化する際の分割数です(結果は分割数だけで決まりスレッド数に依存しません).
+static constexpr uint32_t RADIX_BITS              = 8;          //!< 基数ソートの1パスで処理するビット数です.
+static constexpr uint32_t RADIX_SIZE              = 1u << RADIX_BITS;   //!< 基数ソートのバケット数です.
+static constexpr uint32_t LBVH_TASK_SIZE          = 2048;       //!< LBVHの部分木を並列に構築する単位のプリミティブ数です.
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PrimitiveRef structure
+// 構築中に並べ替えるプリミティブの参照です. 連続して読めるよう範囲と中心を一緒に持ちます.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct PrimitiveRef
+{
+    asvk::BoundingBox   box;        //!< バウンディングボックスです.
+    asvk::Vector3       center;     //!< バウンディングボックスの中心です.
+    uint32_t            index;      //!< Build() に渡された配列の添え字です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// NodeBounds structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct NodeBounds
+{
+    asvk::BoundingBox   box;        //!< プリミティブのバウンディングボックスを合わせたものです.
+    asvk::BoundingBox   center;     //!< プリミティブの中心を囲むバウンディングボックスです.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Bin structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct Bin
+{
+    asvk::BoundingBox   box;        //!< ビンに入ったプリミティブのバウンディングボックスです.
+    uint32_t            count;      //!< ビンに入ったプリミティブ数です.
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// BinSet structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct BinSet
+{
+    Bin bins[3][BIN_COUNT];         //!< 軸ごとのビンです.
+};
+
+
+//-------------------------------------------------------------------------------------------------
+//      表面積の半分を求めます.
+//-------------------------------------------------------------------------------------------------
+inline float HalfArea( const asvk::BoundingBox& box )
+{
+    auto d = box.maxi - box.mini;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスを広げます.
+//-------------------------------------------------------------------------------------------------
+inline void Grow( asvk::BoundingBox& result, const asvk::BoundingBox& value )
+{
+    result.mini = asvk::Vector3::Min( result.mini, value.mini );
+    result.maxi = asvk::Vector3::Max( result.maxi, value.maxi );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードのプリミティブ数から使用するビン数を求めます.
+//      小さいノードではビンの初期化と評価の固定費が支配的になるため, ビンを減らします.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t GetBinCount( uint32_t count )
+{
+    auto binCount = count / 2;
+    binCount = ( binCount > MIN_BIN_COUNT ) ? binCount : MIN_BIN_COUNT;
+    return ( binCount < BIN_COUNT ) ? binCount : BIN_COUNT;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      中心座標からビン番号を求めます.
+//      ※ 分割時の振り分けと一致させるため, ビン詰めと分割で必ずこの関数を使うこと.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t GetBinIndex( float value, float mini, float scale, uint32_t binCount )
+{
+    auto index = static_cast<int32_t>( ( value - mini ) * scale );
+    index = ( index > 0 ) ? index : 0;
+    return ( static_cast<uint32_t>( index ) < binCount - 1 ) ? static_cast<uint32_t>( index ) : binCount - 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間 [begin, end) を集計します. 要素数が多い場合は固定数に分割して並列に集計し，先頭から順にまとめます.
+//-------------------------------------------------------------------------------------------------
+template<typename T, typename Accumulate, typename Combine>
+void Reduce( uint32_t begin, uint32_t end, T& result, Accumulate accumulate, Combine combine )
+{
+    if ( end - begin < BVH_PARALLEL_THRESHOLD )
+    {
+        accumulate( result, begin, end );
+        return;
+    }
+
+    // result は単位元として初期化されている前提.
+    std::vector<T> partials( static_cast<size_t>( BVH_CHUNK_COUNT ), result );
+    auto count = end - begin;
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for
+#endif
+    for( int64_t i=0; i<BVH_CHUNK_COUNT; ++i )
+    {
+        auto chunkBegin = begin + static_cast<uint32_t>( ( uint64_t( count ) * uint64_t( i     ) ) / BVH_CHUNK_COUNT );
+        auto chunkEnd   = begin + static_cast<uint32_t>( ( uint64_t( count ) * uint64_t( i + 1 ) ) / BVH_CHUNK_COUNT );
+        accumulate( partials[i], chunkBegin, chunkEnd );
+    }
+
+    for( const auto& partial : partials )
+    { combine( result, partial ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを再帰的に構築します.
+//      左の子は直後に, 右の子は左の部分木の後ろに並びます.
+//-------------------------------------------------------------------------------------------------
+uint32_t BuildNode
+(
+    std::vector<asvk::BvhNode>& nodes,
+    PrimitiveRef*               pRefs,
+    uint32_t                    begin,
+    uint32_t                    end,
+    uint32_t                    maxLeafSize,
+    uint32_t                    depth
+)
+{
+    using asvk::BoundingBox;
+
+    auto nodeIndex = static_cast<uint32_t>( nodes.size() );
+    nodes.emplace_back();
+
+    auto count = end - begin;
+
+    // ノードと中心のバウンディングボックス.
+    NodeBounds bounds;
+    Reduce( begin, end, bounds,
+        [pRefs]( NodeBounds& result, uint32_t first, uint32_t last )
+        {
+            for( auto i=first; i<last; ++i )
+            {
+                Grow( result.box, pRefs[i].box );
+                result.center.Merge( pRefs[i].center );
+            }
+        },
+        []( NodeBounds& result, const NodeBounds& partial )
+        {
+            Grow( result.box,    partial.box );
+            Grow( result.center, partial.center );
+        } );
+
+    auto makeLeaf = [&]()
+    {
+        auto& node  = nodes[nodeIndex];
+        node.bounds = bounds.box;
+        node.offset = begin;
+        node.count  = count;
+        return nodeIndex;
+    };
+
+    // 走査用のスタックが溢れないよう, 深さの上限では強制的に葉にする.
+    if ( count == 1 || depth + 1 >= asvk::Bvh::MAX_DEPTH )
+    { return makeLeaf(); }
+
+    auto extent = bounds.center.maxi - bounds.center.mini;
+    auto mid    = begin;
+
+    if ( extent.x <= 0.0f && extent.y <= 0.0f && extent.z <= 0.0f )
+    {
+        // 中心が全て一致していてSAHでは分けられない.
+        if ( count <= maxLeafSize )
+        { return makeLeaf(); }
+
+        mid = begin + count / 2;
+    }
+    else
+    {
+        auto  binCount = GetBinCount( count );
+        float scale[3];
+        for( auto axis=0; axis<3; ++axis )
+        { scale[axis] = ( extent[axis] > 0.0f ) ? float( binCount ) / extent[axis] : 0.0f; }
+
+        // ビン詰め.
+        BinSet binSet;
+        for( auto axis=0; axis<3; ++axis )
+        {
+            for( auto i=0u; i<binCount; ++i )
+            {
+                binSet.bins[axis][i].box   = BoundingBox();
+                binSet.bins[axis][i].count = 0;
+            }
+        }
+
+        auto centerMin = bounds.center.mini;
+        Reduce( begin, end, binSet,
+            [pRefs, &scale, &centerMin, binCount]( BinSet& result, uint32_t first, uint32_t last )
+            {
+                for( auto i=first; i<last; ++i )
+                {
+                    const auto& ref = pRefs[i];
+                    for( auto axis=0; axis<3; ++axis )
+                    {
+                        auto& bin = result.bins[axis][GetBinIndex( ref.center[axis], centerMin[axis], scale[axis], binCount )];
+                        Grow( bin.box, ref.box );
+                        bin.count++;
+                    }
+                }
+            },
+            [binCount]( BinSet& result, const BinSet& partial )
+            {
+                for( auto axis=0; axis<3; ++axis )
+                {
+                    for( auto i=0u; i<binCount; ++i )
+                    {
+                        Grow( result.bins[axis][i].box, partial.bins[axis][i].box );
+                        result.bins[axis][i].count += partial.bins[axis][i].count;
+                    }
+                }
+            } );
+
+        // 各ビン境界で分割した場合のコストを評価する.
+        auto bestCost  = F32_MAX;
+        auto bestAxis  = -1;
+        auto bestSplit = 0u;
+        for( auto axis=0; axis<3; ++axis )
+        {
+            if ( scale[axis] <= 0.0f )
+            { continue; }
+
+            const auto& bins = binSet.bins[axis];
+            float       leftCost[BIN_COUNT - 1];
+            BoundingBox box;
+            uint32_t    leftCount = 0;
+            for( auto i=0u; i<binCount - 1; ++i )
+            {
+                Grow( box, bins[i].box );
+                leftCount  += bins[i].count;
+                leftCost[i] = ( leftCount > 0 ) ? HalfArea( box ) * float( leftCount ) : 0.0f;
+            }
+
+            box = BoundingBox();
+            uint32_t rightCount = 0;
+            for( auto i=binCount - 1; i>0; --i )
+            {
+                Grow( box, bins[i].box );
+                rightCount += bins[i].count;
+                if ( rightCount == 0 || rightCount == count )
+                { continue; }
+
+                auto cost = leftCost[i - 1] + HalfArea( box ) * float( rightCount );
+                if ( cost < bestCost )
+                {
+                    bestCost  = cost;
+                    bestAxis  = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        assert( bestAxis >= 0 );
+        auto area      = HalfArea( bounds.box );
+        auto leafCost  = float( count );
+        auto splitCost = TRAVERSAL_COST + ( ( area > 0.0f ) ? bestCost / area : 0.0f );
+        if ( count <= maxLeafSize && leafCost <= splitCost )
+        { return makeLeaf(); }
+
+        // bestSplit 番目のビン以降を右の子に振り分ける.
+        auto axisMin   = centerMin[bestAxis];
+        auto axisScale = scale[bestAxis];
+        auto it = std::partition( pRefs + begin, pRefs + end,
+            [bestAxis, bestSplit, axisMin, axisScale, binCount]( const PrimitiveRef& ref )
+            { return GetBinIndex( ref.center[bestAxis], axisMin, axisScale, binCount ) < bestSplit; } );
+        mid = static_cast<uint32_t>( it - pRefs );
+        assert( begin < mid && mid < end );
+    }
+
+    BuildNode( nodes, pRefs, begin, mid, maxLeafSize, depth + 1 );
+    auto right = BuildNode( nodes, pRefs, mid, end, maxLeafSize, depth + 1 );
+
+    auto& node  = nodes[nodeIndex];
+    node.bounds = bounds.box;
+    node.offset = right;
+    node.count  = 0;
+    return nodeIndex;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      10ビットの値を3ビット間隔に広げます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t ExpandBits( uint32_t value )
+{
+    value &= 0x3ff;
+    value = ( value | ( value << 16 ) ) & 0x030000ff;
+    value = ( value | ( value <<  8 ) ) & 0x0300f00f;
+    value = ( value | ( value <<  4 ) ) & 0x030c30c3;
+    value = ( value | ( value <<  2 ) ) & 0x09249249;
+    return value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      21ビットの値を3ビット間隔に広げます.
+//-------------------------------------------------------------------------------------------------
+inline uint64_t ExpandBits( uint64_t value )
+{
+    value &= 0x1fffff;
+    value = ( value | ( value << 32 ) ) & 0x001f00000000ffffull;
+    value = ( value | ( value << 16 ) ) & 0x001f0000ff0000ffull;
+    value = ( value | ( value <<  8 ) ) & 0x100f00f00f00f00full;
+    value = ( value | ( value <<  4 ) ) & 0x10c30c30c30c30c3ull;
+    value = ( value | ( value <<  2 ) ) & 0x1249249249249249ull;
+    return value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      [0, 1] に正規化した座標からモートン符号を求めます.
+//-------------------------------------------------------------------------------------------------
+template<typename Key>
+inline Key EncodeMorton( float x, float y, float z )
+{
+    // Key が32ビットなら軸あたり10ビット, 64ビットなら21ビット.
+    constexpr uint32_t bits  = ( sizeof(Key) * 8 ) / 3;
+    constexpr float    scale = float( ( 1u << bits ) - 1 );
+    auto ix = static_cast<Key>( asvk::Saturate( x ) * scale );
+    auto iy = static_cast<Key>( asvk::Saturate( y ) * scale );
+    auto iz = static_cast<Key>( asvk::Saturate( z ) * scale );
+    return ( ExpandBits( ix ) << 2 ) | ( ExpandBits( iy ) << 1 ) | ExpandBits( iz );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      キーと値の組を基数ソート(LSD)します. 同じキーの順序は保たれます.
+//      要素数が多い場合は固定数に分割して並列にヒストグラムを作り，分割順に書き込み先を割り当てます.
+//-------------------------------------------------------------------------------------------------
+template<typename Key>
+void RadixSort
+(
+    std::vector<Key>&       keys,
+    std::vector<uint32_t>&  values,
+    std::vector<Key>&       tempKeys,
+    std::vector<uint32_t>&  tempValues,
+    uint32_t                keyBits
+)
+{
+    auto count      = static_cast<uint32_t>( keys.size() );
+    auto chunkCount = ( count >= BVH_PARALLEL_THRESHOLD ) ? BVH_CHUNK_COUNT : int64_t( 1 );
+    std::vector<uint32_t> histogram( static_cast<size_t>( chunkCount ) * RADIX_SIZE );
+
+    tempKeys  .resize( count );
+    tempValues.resize( count );
+
+    for( auto shift=0u; shift<keyBits; shift+=RADIX_BITS )
+    {
+        std::fill( histogram.begin(), histogram.end(), 0u );
+
+    #if ASVK_IS_OPENMP
+        #pragma omp parallel for if( chunkCount > 1 )
+    #endif
+        for( int64_t c=0; c<chunkCount; ++c )
+        {
+            auto begin  = static_cast<uint32_t>( ( uint64_t( count ) * uint64_t( c     ) ) / uint64_t( chunkCount ) );
+            auto end    = static_cast<uint32_t>( ( uint64_t( count ) * uint64_t( c + 1 ) ) / uint64_t( chunkCount ) );
+            auto pCount = histogram.data() + c * RADIX_SIZE;
+            for( auto i=begin; i<end; ++i )
+            { pCount[ ( keys[i] >> shift ) & ( RADIX_SIZE - 1 ) ]++; }
+        }
+
+        // 全て同じ桁ならこのパスは並びが変わらない.
+        auto skip = false;
+        for( auto d=0u; d<RADIX_SIZE && !skip; ++d )
+        {
+            uint32_t total = 0;
+            for( int64_t c=0; c<chunkCount; ++c )
+            { total += histogram[c * RADIX_SIZE + d]; }
+            skip = ( total == count );
+        }
+        if ( skip )
+        { continue; }
+
+        // 桁の小さい順, 同じ桁は分割の順に書き込み先を割り当てる.
+        uint32_t offset = 0;
+        for( auto d=0u; d<RADIX_SIZE; ++d )
+        {
+            for( int64_t c=0; c<chunkCount; ++c )
+            {
+                auto& value = histogram[c * RADIX_SIZE + d];
+                auto  n     = value;
+                value   = offset;
+                offset += n;
+            }
+        }
+
+    #if ASVK_IS_OPENMP
+        #pragma omp parallel for if( chunkCount > 1 )
+    #endif
+        for( int64_t c=0; c<chunkCount; ++c )
+        {
+            auto begin    = static_cast<uint32_t>( ( uint64_t( count ) * uint64_t( c     ) ) / uint64_t( chunkCount ) );
+            auto end      = static_cast<uint32_t>( ( uint64_t( count ) * uint64_t( c + 1 ) ) / uint64_t( chunkCount ) );
+            auto pOffset  = histogram.data() + c * RADIX_SIZE;
+            for( auto i=begin; i<end; ++i )
+            {
+                auto dst = pOffset[ ( keys[i] >> shift ) & ( RADIX_SIZE - 1 ) ]++;
+                tempKeys  [dst] = keys  [i];
+                tempValues[dst] = values[i];
+            }
+        }
+
+        keys  .swap( tempKeys );
+        values.swap( tempValues );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間を2分する位置を求めます.
+//      モートン符号が異なる最上位ビットで分け, 全て同じ場合や深さの上限に近い場合は中央で分けます.
+//-------------------------------------------------------------------------------------------------
+template<typename Key>
+inline uint32_t FindSplit( const Key* pCodes, uint32_t begin, uint32_t end, uint32_t depth )
+{
+    auto count = end - begin;
+
+    // 残りを中央で分け続けても葉が MAX_DEPTH - 1 を超えないようにする (count は32ビットなので高々32段).
+    auto balance = false;
+    if ( depth + 32 >= asvk::Bvh::MAX_DEPTH - 1 )
+    {
+        uint32_t levels = 0;
+        while( ( uint64_t( 1 ) << levels ) < count )
+        { levels++; }
+        balance = ( depth + levels >= asvk::Bvh::MAX_DEPTH - 1 );
+    }
+
+    auto diff = pCodes[begin] ^ pCodes[end - 1];
+    if ( diff == 0 || balance )
+    { return begin + count / 2; }
+
+    // 最上位ビットだけを残す.
+    for( auto shift=1u; shift<sizeof(Key) * 8; shift<<=1 )
+    { diff |= diff >> shift; }
+    auto top = diff ^ ( diff >> 1 );
+
+    auto it = std::partition_point( pCodes + begin, pCodes + end, [top]( Key code ) { return ( code & top ) == 0; } );
+    return static_cast<uint32_t>( it - pCodes );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// LinearTask structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct LinearTask
+{
+    uint32_t    node;       //!< 部分木の根のノード番号です.
+    uint32_t    begin;      //!< 区間の先頭です.
+    uint32_t    end;        //!< 区間の終端です.
+    uint32_t    depth;      //!< 部分木の根の深さです.
+};
+
+//-------------------------------------------------------------------------------------------------
+//      LBVHのノードを再帰的に構築します.
+//      葉を1プリミティブとすると [begin, end) の部分木のノード数は 2 * ( end - begin ) - 1 で決まるため,
+//      右の子の番号は左の区間の大きさから求まります.
+//      pTasks を指定した場合は LBVH_TASK_SIZE 以下の区間を構築せずにタスクとして積み, 辿った上位ノードを pTop に積みます.
+//-------------------------------------------------------------------------------------------------
+template<typename Key>
+void BuildLinearNode
+(
+    asvk::BvhNode*              pNodes,
+    const Key*                  pCodes,
+    const asvk::BoundingBox*    pBoxes,
+    uint32_t                    node,
+    uint32_t                    begin,
+    uint32_t                    end,
+    uint32_t                    depth,
+    std::vector<LinearTask>*    pTasks,
+    std::vector<uint32_t>*      pTop
+)
+{
+    auto& result = pNodes[node];
+    if ( end - begin == 1 )
+    {
+        result.bounds = pBoxes[begin];
+        result.offset = begin;
+        result.count  = 1;
+        return;
+    }
+
+    if ( pTasks != nullptr )
+    {
+        if ( end - begin <= LBVH_TASK_SIZE )
+        {
+            pTasks->push_back( LinearTask{ node, begin, end, depth } );
+            return;
+        }
+        pTop->push_back( node );
+    }
+
+    auto mid   = FindSplit( pCodes, begin, end, depth );
+    auto right = node + 2 * ( mid - begin );
+    BuildLinearNode( pNodes, pCodes, pBoxes, node + 1, begin, mid, depth + 1, pTasks, pTop );
+    BuildLinearNode( pNodes, pCodes, pBoxes, right,    mid,   end, depth + 1, pTasks, pTop );
+
+    result.offset = right;
+    result.count  = 0;
+    if ( pTasks == nullptr )
+    { result.bounds = asvk::BoundingBox::Merge( pNodes[node + 1].bounds, pNodes[right].bounds ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      モートン符号を求めてソートし，LBVHを構築します.
+//-------------------------------------------------------------------------------------------------
+template<typename Key>
+void BuildLinearTree
+(
+    const asvk::BoundingBox*    pBoxes,
+    uint32_t                    count,
+    std::vector<asvk::BvhNode>& nodes,
+    std::vector<uint32_t>&      indices,
+    std::vector<asvk::BoundingBox>& sortedBoxes
+)
+{
+    using asvk::BoundingBox;
+    using asvk::Vector3;
+
+    auto n = static_cast<int64_t>( count );
+
+    // 中心を囲むバウンディングボックス.
+    BoundingBox centerBounds;
+    Reduce( 0, count, centerBounds,
+        [pBoxes]( BoundingBox& result, uint32_t first, uint32_t last )
+        {
+            for( auto i=first; i<last; ++i )
+            { result.Merge( ( pBoxes[i].mini + pBoxes[i].maxi ) * 0.5f ); }
+        },
+        []( BoundingBox& result, const BoundingBox& partial )
+        { Grow( result, partial ); } );
+
+    auto extent = centerBounds.maxi - centerBounds.mini;
+    auto scale  = Vector3(
+        ( extent.x > 0.0f ) ? 1.0f / extent.x : 0.0f,
+        ( extent.y > 0.0f ) ? 1.0f / extent.y : 0.0f,
+        ( extent.z > 0.0f ) ? 1.0f / extent.z : 0.0f );
+
+    std::vector<Key> codes( count );
+    indices.resize( count );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( n >= int64_t( BVH_PARALLEL_THRESHOLD ) )
+#endif
+    for( int64_t i=0; i<n; ++i )
+    {
+        auto center = ( ( pBoxes[i].mini + pBoxes[i].maxi ) * 0.5f - centerBounds.mini );
+        codes  [i] = EncodeMorton<Key>( center.x * scale.x, center.y * scale.y, center.z * scale.z );
+        indices[i] = static_cast<uint32_t>( i );
+    }
+
+    std::vector<Key>      tempKeys;
+    std::vector<uint32_t> tempValues;
+    RadixSort( codes, indices, tempKeys, tempValues, ( sizeof(Key) * 8 / 3 ) * 3 );
+
+    sortedBoxes.resize( count );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( n >= int64_t( BVH_PARALLEL_THRESHOLD ) )
+#endif
+    for( int64_t i=0; i<n; ++i )
+    { sortedBoxes[i] = pBoxes[ indices[i] ]; }
+
+    // 上位ノードを辿って部分木のタスクに分け, 部分木を並列に構築してから上位ノードの範囲を下から求める.
+    nodes.resize( size_t( count ) * 2 - 1 );
+    std::vector<LinearTask> tasks;
+    std::vector<uint32_t>   top;
+    BuildLinearNode( nodes.data(), codes.data(), sortedBoxes.data(), 0, 0, count, 0, &tasks, &top );
+
+    auto taskCount = static_cast<int64_t>( tasks.size() );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for schedule(dynamic) if( taskCount > 1 )
+#endif
+    for( int64_t i=0; i<taskCount; ++i )
+    {
+        const auto& task = tasks[i];
+        BuildLinearNode<Key>( nodes.data(), codes.data(), sortedBoxes.data(), task.node, task.begin, task.end, task.depth, nullptr, nullptr );
+    }
+
+    // 前順に積んであるので, 逆順に処理すれば子が先に確定している.
+    for( auto it = top.rbegin(); it != top.rend(); ++it )
+    {
+        auto& node  = nodes[*it];
+        node.bounds = BoundingBox::Merge( nodes[*it + 1].bounds, nodes[node.offset].bounds );
+    }
+}
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Bvh class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t Bvh::DEFAULT_LEAF_SIZE;
+constexpr uint32_t Bvh::MAX_DEPTH;
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+Bvh::Bvh()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+Bvh::~Bvh()
+{ Clear(); }
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスの配列から木を構築します.
+//-------------------------------------------------------------------------------------------------
+bool Bvh::Build( const BoundingBox* pBoxes, size_t count, uint32_t maxLeafSize )
+{
+    Clear();
+
+    if ( pBoxes == nullptr || count == 0 || count > size_t( UINT32_MAX / 2 ) )
+    { return false; }
+
+    maxLeafSize = ( maxLeafSize > 0 ) ? maxLeafSize : 1;
+
+    auto n = static_cast<int64_t>( count );
+    std::vector<PrimitiveRef> refs( count );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( n >= int64_t( BVH_PARALLEL_THRESHOLD ) )
+#endif
+    for( int64_t i=0; i<n; ++i )
+    {
+        refs[i].box    = pBoxes[i];
+        refs[i].center = ( pBoxes[i].mini + pBoxes[i].maxi ) * 0.5f;
+        refs[i].index  = static_cast<uint32_t>( i );
+    }
+
+    // 葉ノード1つにつき内部ノードは高々1つ.
+    m_Nodes.reserve( count * 2 - 1 );
+    BuildNode( m_Nodes, refs.data(), 0, static_cast<uint32_t>( count ), maxLeafSize, 0 );
+
+    // 走査時に連続して読めるよう, 葉ノードの並び順でバウンディングボックスも保持しておく.
+    m_Indices.resize( count );
+    m_Boxes  .resize( count );
+    for( size_t i=0; i<count; ++i )
+    {
+        m_Indices[i] = refs[i].index;
+        m_Boxes  [i] = refs[i].box;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスの配列からモートン符号順の木(LBVH)を構築します.
+//-------------------------------------------------------------------------------------------------
+bool Bvh::BuildLinear( const BoundingBox* pBoxes, size_t count, MortonPrecision precision )
+{
+    if ( pBoxes == nullptr || count == 0 || count > size_t( UINT32_MAX / 2 ) )
+    {
+        Clear();
+        return false;
+    }
+
+    // 毎フレーム作り直す場合に備えて, 配列は破棄せずに大きさだけ合わせて上書きする.
+
+    if ( precision == MortonPrecision::Bits63 )
+    { BuildLinearTree<uint64_t>( pBoxes, static_cast<uint32_t>( count ), m_Nodes, m_Indices, m_Boxes ); }
+    else
+    { BuildLinearTree<uint32_t>( pBoxes, static_cast<uint32_t>( count ), m_Nodes, m_Indices, m_Boxes ); }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全てのデータを破棄します.
+//-------------------------------------------------------------------------------------------------
+void Bvh::Clear()
+{
+    m_Nodes  .clear();
+    m_Indices.clear();
+    m_Boxes  .clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//      プリミティブのバウンディングボックスとレイの最も近い交差を求めます.
+//-------------------------------------------------------------------------------------------------
+bool Bvh::IntersectClosest( const Ray& ray, float maxDistance, BvhHit& hit ) const
+{
+    return TraverseClosest( ray, maxDistance,
+        [this, &ray]( uint32_t slot, float limit, float& distance )
+        { return m_Boxes[slot].Intersects( ray, limit, distance ); },
+        hit );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      プリミティブのバウンディングボックスとレイが交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+bool Bvh::IntersectAny( const Ray& ray, float maxDistance ) const
+{
+    return TraverseAny( ray, maxDistance,
+        [this, &ray]( uint32_t slot, float limit, float& distance )
+        { return m_Boxes[slot].Intersects( ray, limit, distance ); } );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットとプリミティブのバウンディングボックスの最も近い交差を求めます.
+//-------------------------------------------------------------------------------------------------
+uint32_t Bvh::IntersectClosest( const RayPacket4& rays, const float* pMaxDistance, BvhHit* pHits ) const
+{
+#if ASVK_IS_SIMD
+    return TraversePacketClosest( rays, pMaxDistance,
+        [this, &rays]( uint32_t slot, const float* pLimit, float* pDistance )
+        { return rays.Intersects( m_Boxes[slot], pLimit, pDistance ); },
+        pHits );
+#else
+    // SIMD 無効時はレーンをまとめて判定しても速くならないため, 1本ずつ走査する.
+    uint32_t mask = 0;
+    for( auto lane=0u; lane<RayPacket4::WIDTH; ++lane )
+    {
+        if ( IntersectClosest( rays.GetRay( lane ), pMaxDistance[lane], pHits[lane] ) )
+        { mask |= 1u << lane; }
+    }
+    return mask;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットとプリミティブのバウンディングボックスが交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+uint32_t Bvh::IntersectAny( const RayPacket4& rays, const float* pMaxDistance ) const
+{
+#if ASVK_IS_SIMD
+    return TraversePacketAny( rays, pMaxDistance,
+        [this, &rays]( uint32_t slot, const float* pLimit, float* pDistance )
+        { return rays.Intersects( m_Boxes[slot], pLimit, pDistance ); } );
+#else
+    // SIMD 無効時はレーンをまとめて判定しても速くならないため, 1本ずつ走査する.
+    uint32_t mask = 0;
+    for( auto lane=0u; lane<RayPacket4::WIDTH; ++lane )
+    {
+        if ( IntersectAny( rays.GetRay( lane ), pMaxDistance[lane] ) )
+        { mask |= 1u << lane; }
+    }
+    return mask;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットとプリミティブのバウンディングボックスの最も近い交差を求めます.
+//-------------------------------------------------------------------------------------------------
+uint32_t Bvh::IntersectClosest( const RayPacket8& rays, const float* pMaxDistance, BvhHit* pHits ) const
+{
+#if ASVK_IS_SIMD
+    return TraversePacketClosest( rays, pMaxDistance,
+        [this, &rays]( uint32_t slot, const float* pLimit, float* pDistance )
+        { return rays.Intersects( m_Boxes[slot], pLimit, pDistance ); },
+        pHits );
+#else
+    // SIMD 無効時はレーンをまとめて判定しても速くならないため, 1本ずつ走査する.
+    uint32_t mask = 0;
+    for( auto lane=0u; lane<RayPacket8::WIDTH; ++lane )
+    {
+        if ( IntersectClosest( rays.GetRay( lane ), pMaxDistance[lane], pHits[lane] ) )
+        { mask |= 1u << lane; }
+    }
+    return mask;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットとプリミティブのバウンディングボックスが交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+uint32_t Bvh::IntersectAny( const RayPacket8& rays, const float* pMaxDistance ) const
+{
+#if ASVK_IS_SIMD
+    return TraversePacketAny( rays, pMaxDistance,
+        [this, &rays]( uint32_t slot, const float* pLimit, float* pDistance )
+        { return rays.Intersects( m_Boxes[slot], pLimit, pDistance ); } );
+#else
+    // SIMD 無効時はレーンをまとめて判定しても速くならないため, 1本ずつ走査する.
+    uint32_t mask = 0;
+    for( auto lane=0u; lane<RayPacket8::WIDTH; ++lane )
+    {
+        if ( IntersectAny( rays.GetRay( lane ), pMaxDistance[lane] ) )
+        { mask |= 1u << lane; }
+    }
+    return mask;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードの配列を取得します.
+//-------------------------------------------------------------------------------------------------
+const BvhNode* Bvh::GetNodes() const
+{ return m_Nodes.data(); }
+
+//-------------------------------------------------------------------------------------------------
+//      ノード数を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t Bvh::GetNodeCount() const
+{ return m_Nodes.size(); }
+
+//-------------------------------------------------------------------------------------------------
+//      葉ノードの並び順のプリミティブ番号の配列を取得します.
+//-------------------------------------------------------------------------------------------------
+const uint32_t* Bvh::GetIndices() const
+{ return m_Indices.data(); }
+
+//-------------------------------------------------------------------------------------------------
+//      全体のバウンディングボックスを取得します.
+//-------------------------------------------------------------------------------------------------
+BoundingBox Bvh::GetBounds() const
+{ return m_Nodes.empty() ? BoundingBox() : m_Nodes[0].bounds; }
+
+} // namespace asvk
@@ -0,0 +1,1014 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkGeometry.cpp
+// Desc : Geometry Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkGeometry.h>
+#include <cassert>
+#include <cmath>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr int64_t FRUSTUM_PARALLEL_THRESHOLD = 256;  //!< 錐台カリングを並列化するマスク要素数(32要素単位)の閾値です.
+static constexpr size_t  MASK_BITS                  = 32;   //!< マスク1要素あたりのビット数です.
+
+
+#if ASVK_IS_SIMD
+//-------------------------------------------------------------------------------------------------
+//      符号を反転します (スカラー版の単項マイナスと同じ結果になります).
+//-------------------------------------------------------------------------------------------------
+inline __m128 Negate( const __m128 value )
+{ return _mm_xor_ps( value, _mm_set1_ps( -0.0f ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      3要素の内積を求めます (Vector3::Dot() と同じ演算順序).
+//-------------------------------------------------------------------------------------------------
+inline __m128 Dot3
+(
+    const __m128 ax, const __m128 ay, const __m128 az,
+    const __m128 bx, const __m128 by, const __m128 bz
+)
+{
+    return _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ), _mm_mul_ps( az, bz ) );
+}
+
+  #if ASVK_IS_AVX
+inline __m256 Negate( const __m256 value )
+{ return _mm256_xor_ps( value, _mm256_set1_ps( -0.0f ) ); }
+
+inline __m256 Dot3
+(
+    const __m256 ax, const __m256 ay, const __m256 az,
+    const __m256 bx, const __m256 by, const __m256 bz
+)
+{
+    return _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( ax, bx ), _mm256_mul_ps( ay, by ) ), _mm256_mul_ps( az, bz ) );
+}
+  #endif//ASVK_IS_AVX
+#endif//ASVK_IS_SIMD
+
+//-------------------------------------------------------------------------------------------------
+//      平面ごとの判定結果のビットから包含関係を求めます.
+//-------------------------------------------------------------------------------------------------
+inline asvk::Containment ResolveContainment( uint32_t outBits, uint32_t inBits, uint32_t validMask, uint32_t& planeMask )
+{
+    planeMask &= validMask;
+    if ( ( outBits & planeMask ) != 0 )
+    { return asvk::Containment::Outside; }
+
+    planeMask &= ~inBits;
+    return ( planeMask == 0 ) ? asvk::Containment::Inside : asvk::Containment::Intersect;
+}
+
+#if ASVK_IS_SIMD
+//-------------------------------------------------------------------------------------------------
+//      マスクで選択します (mask のビットが立っている要素は a, それ以外は b).
+//-------------------------------------------------------------------------------------------------
+inline __m128 Select( const __m128 mask, const __m128 a, const __m128 b )
+{ return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットの lane 番目から4本とバウンディングボックスの交差を判定します.
+//      ※ BoundingBox::Intersects() と結果を一致させるため，演算順序を変えないこと.
+//      _mm_max_ps( a, b ) は ( a > b ) ? a : b と同じく, NaN の場合は b を返します.
+//-------------------------------------------------------------------------------------------------
+template<typename Packet>
+inline uint32_t IntersectBox4
+(
+    const Packet&               rays,
+    uint32_t                    lane,
+    const asvk::BoundingBox&    box,
+    const float*                pMaxDistance,
+    float*                      pDistance
+)
+{
+    auto signX = _mm_castsi128_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( rays.signX + lane ) ) );
+    auto signY = _mm_castsi128_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( rays.signY + lane ) ) );
+    auto signZ = _mm_castsi128_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( rays.signZ + lane ) ) );
+    auto minX = _mm_set1_ps( box.mini.x );
+    auto minY = _mm_set1_ps( box.mini.y );
+    auto minZ = _mm_set1_ps( box.mini.z );
+    auto maxX = _mm_set1_ps( box.maxi.x );
+    auto maxY = _mm_set1_ps( box.maxi.y );
+    auto maxZ = _mm_set1_ps( box.maxi.z );
+    auto posX = _mm_loadu_ps( rays.posX + lane );
+    auto posY = _mm_loadu_ps( rays.posY + lane );
+    auto posZ = _mm_loadu_ps( rays.posZ + lane );
+    auto invX = _mm_loadu_ps( rays.invDirX + lane );
+    auto invY = _mm_loadu_ps( rays.invDirY + lane );
+    auto invZ = _mm_loadu_ps( rays.invDirZ + lane );
+
+    auto tx0 = _mm_mul_ps( _mm_sub_ps( Select( signX, maxX, minX ), posX ), invX );
+    auto tx1 = _mm_mul_ps( _mm_sub_ps( Select( signX, minX, maxX ), posX ), invX );
+    auto ty0 = _mm_mul_ps( _mm_sub_ps( Select( signY, maxY, minY ), posY ), invY );
+    auto ty1 = _mm_mul_ps( _mm_sub_ps( Select( signY, minY, maxY ), posY ), invY );
+    auto tz0 = _mm_mul_ps( _mm_sub_ps( Select( signZ, maxZ, minZ ), posZ ), invZ );
+    auto tz1 = _mm_mul_ps( _mm_sub_ps( Select( signZ, minZ, maxZ ), posZ ), invZ );
+
+    auto tmin = _mm_setzero_ps();
+    auto tmax = _mm_loadu_ps( pMaxDistance + lane );
+    tmin = _mm_max_ps( tx0, tmin );
+    tmin = _mm_max_ps( ty0, tmin );
+    tmin = _mm_max_ps( tz0, tmin );
+    tmax = _mm_min_ps( tx1, tmax );
+    tmax = _mm_min_ps( ty1, tmax );
+    tmax = _mm_min_ps( tz1, tmax );
+
+    _mm_storeu_ps( pDistance + lane, tmin );
+    return static_cast<uint32_t>( _mm_movemask_ps( _mm_cmple_ps( tmin, tmax ) ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットの lane 番目から4本と三角形の交差を判定します.
+//      ※ Triangle::Intersects() と結果を一致させるため，演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+template<typename Packet>
+inline uint32_t IntersectTriangle4
+(
+    const Packet&               rays,
+    uint32_t                    lane,
+    const asvk::Triangle&       triangle,
+    const float*                pMaxDistance,
+    float*                      pDistance
+)
+{
+    auto e1 = triangle.v1 - triangle.v0;
+    auto e2 = triangle.v2 - triangle.v0;
+    auto e1x = _mm_set1_ps( e1.x );
+    auto e1y = _mm_set1_ps( e1.y );
+    auto e1z = _mm_set1_ps( e1.z );
+    auto e2x = _mm_set1_ps( e2.x );
+    auto e2y = _mm_set1_ps( e2.y );
+    auto e2z = _mm_set1_ps( e2.z );
+    auto dx = _mm_loadu_ps( rays.dirX + lane );
+    auto dy = _mm_loadu_ps( rays.dirY + lane );
+    auto dz = _mm_loadu_ps( rays.dirZ + lane );
+
+    auto px = _mm_sub_ps( _mm_mul_ps( dy, e2z ), _mm_mul_ps( dz, e2y ) );
+    auto py = _mm_sub_ps( _mm_mul_ps( dz, e2x ), _mm_mul_ps( dx, e2z ) );
+    auto pz = _mm_sub_ps( _mm_mul_ps( dx, e2y ), _mm_mul_ps( dy, e2x ) );
+    auto invDet = _mm_div_ps( _mm_set1_ps( 1.0f ), Dot3( e1x, e1y, e1z, px, py, pz ) );
+
+    auto sx = _mm_sub_ps( _mm_loadu_ps( rays.posX + lane ), _mm_set1_ps( triangle.v0.x ) );
+    auto sy = _mm_sub_ps( _mm_loadu_ps( rays.posY + lane ), _mm_set1_ps( triangle.v0.y ) );
+    auto sz = _mm_sub_ps( _mm_loadu_ps( rays.posZ + lane ), _mm_set1_ps( triangle.v0.z ) );
+    auto qx = _mm_sub_ps( _mm_mul_ps( sy, e1z ), _mm_mul_ps( sz, e1y ) );
+    auto qy = _mm_sub_ps( _mm_mul_ps( sz, e1x ), _mm_mul_ps( sx, e1z ) );
+    auto qz = _mm_sub_ps( _mm_mul_ps( sx, e1y ), _mm_mul_ps( sy, e1x ) );
+    auto u = _mm_mul_ps( Dot3( sx, sy, sz, px, py, pz ), invDet );
+    auto v = _mm_mul_ps( Dot3( dx, dy, dz, qx, qy, qz ), invDet );
+    auto t = _mm_mul_ps( Dot3( e2x, e2y, e2z, qx, qy, qz ), invDet );
+
+    auto zero = _mm_setzero_ps();
+    auto hit  = _mm_and_ps( _mm_cmpge_ps( u, zero ), _mm_cmpge_ps( v, zero ) );
+    hit = _mm_and_ps( hit, _mm_cmple_ps( _mm_add_ps( u, v ), _mm_set1_ps( 1.0f ) ) );
+    hit = _mm_and_ps( hit, _mm_cmpge_ps( t, zero ) );
+    hit = _mm_and_ps( hit, _mm_cmple_ps( t, _mm_loadu_ps( pMaxDistance + lane ) ) );
+
+    _mm_storeu_ps( pDistance + lane, t );
+    return static_cast<uint32_t>( _mm_movemask_ps( hit ) );
+}
+
+  #if ASVK_IS_AVX
+inline __m256 Select( const __m256 mask, const __m256 a, const __m256 b )
+{ return _mm256_or_ps( _mm256_and_ps( mask, a ), _mm256_andnot_ps( mask, b ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      8本のレイとバウンディングボックスの交差を判定します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t IntersectBox8
+(
+    const asvk::RayPacket8&     rays,
+    const asvk::BoundingBox&    box,
+    const float*                pMaxDistance,
+    float*                      pDistance
+)
+{
+    auto signX = _mm256_castsi256_ps( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( rays.signX ) ) );
+    auto signY = _mm256_castsi256_ps( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( rays.signY ) ) );
+    auto signZ = _mm256_castsi256_ps( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( rays.signZ ) ) );
+    auto minX = _mm256_set1_ps( box.mini.x );
+    auto minY = _mm256_set1_ps( box.mini.y );
+    auto minZ = _mm256_set1_ps( box.mini.z );
+    auto maxX = _mm256_set1_ps( box.maxi.x );
+    auto maxY = _mm256_set1_ps( box.maxi.y );
+    auto maxZ = _mm256_set1_ps( box.maxi.z );
+    auto posX = _mm256_loadu_ps( rays.posX );
+    auto posY = _mm256_loadu_ps( rays.posY );
+    auto posZ = _mm256_loadu_ps( rays.posZ );
+    auto invX = _mm256_loadu_ps( rays.invDirX );
+    auto invY = _mm256_loadu_ps( rays.invDirY );
+    auto invZ = _mm256_loadu_ps( rays.invDirZ );
+
+    auto tx0 = _mm256_mul_ps( _mm256_sub_ps( Select( signX, maxX, minX ), posX ), invX );
+    auto tx1 = _mm256_mul_ps( _mm256_sub_ps( Select( signX, minX, maxX ), posX ), invX );
+    auto ty0 = _mm256_mul_ps( _mm256_sub_ps( Select( signY, maxY, minY ), posY ), invY );
+    auto ty1 = _mm256_mul_ps( _mm256_sub_ps( Select( signY, minY, maxY ), posY ), invY );
+    auto tz0 = _mm256_mul_ps( _mm256_sub_ps( Select( signZ, maxZ, minZ ), posZ ), invZ );
+    auto tz1 = _mm256_mul_ps( _mm256_sub_ps( Select( signZ, minZ, maxZ ), posZ ), invZ );
+
+    auto tmin = _mm256_setzero_ps();
+    auto tmax = _mm256_loadu_ps( pMaxDistance );
+    tmin = _mm256_max_ps( tx0, tmin );
+    tmin = _mm256_max_ps( ty0, tmin );
+    tmin = _mm256_max_ps( tz0, tmin );
+    tmax = _mm256_min_ps( tx1, tmax );
+    tmax = _mm256_min_ps( ty1, tmax );
+    tmax = _mm256_min_ps( tz1, tmax );
+
+    _mm256_storeu_ps( pDistance, tmin );
+    return static_cast<uint32_t>( _mm256_movemask_ps( _mm256_cmp_ps( tmin, tmax, _CMP_LE_OQ ) ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8本のレイと三角形の交差を判定します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t IntersectTriangle8
+(
+    const asvk::RayPacket8&     rays,
+    const asvk::Triangle&       triangle,
+    const float*                pMaxDistance,
+    float*                      pDistance
+)
+{
+    auto e1 = triangle.v1 - triangle.v0;
+    auto e2 = triangle.v2 - triangle.v0;
+    auto e1x = _mm256_set1_ps( e1.x );
+    auto e1y = _mm256_set1_ps( e1.y );
+    auto e1z = _mm256_set1_ps( e1.z );
+    auto e2x = _mm256_set1_ps( e2.x );
+    auto e2y = _mm256_set1_ps( e2.y );
+    auto e2z = _mm256_set1_ps( e2.z );
+    auto dx = _mm256_loadu_ps( rays.dirX );
+    auto dy = _mm256_loadu_ps( rays.dirY );
+    auto dz = _mm256_loadu_ps( rays.dirZ );
+
+    auto px = _mm256_sub_ps( _mm256_mul_ps( dy, e2z ), _mm256_mul_ps( dz, e2y ) );
+    auto py = _mm256_sub_ps( _mm256_mul_ps( dz, e2x ), _mm256_mul_ps( dx, e2z ) );
+    auto pz = _mm256_sub_ps( _mm256_mul_ps( dx, e2y ), _mm256_mul_ps( dy, e2x ) );
+    auto invDet = _mm256_div_ps( _mm256_set1_ps( 1.0f ), Dot3( e1x, e1y, e1z, px, py, pz ) );
+
+    auto sx = _mm256_sub_ps( _mm256_loadu_ps( rays.posX ), _mm256_set1_ps( triangle.v0.x ) );
+    auto sy = _mm256_sub_ps( _mm256_loadu_ps( rays.posY ), _mm256_set1_ps( triangle.v0.y ) );
+    auto sz = _mm256_sub_ps( _mm256_loadu_ps( rays.posZ ), _mm256_set1_ps( triangle.v0.z ) );
+    auto qx = _mm256_sub_ps( _mm256_mul_ps( sy, e1z ), _mm256_mul_ps( sz, e1y ) );
+    auto qy = _mm256_sub_ps( _mm256_mul_ps( sz, e1x ), _mm256_mul_ps( sx, e1z ) );
+    auto qz = _mm256_sub_ps( _mm256_mul_ps( sx, e1y ), _mm256_mul_ps( sy, e1x ) );
+    auto u = _mm256_mul_ps( Dot3( sx, sy, sz, px, py, pz ), invDet );
+    auto v = _mm256_mul_ps( Dot3( dx, dy, dz, qx, qy, qz ), invDet );
+    auto t = _mm256_mul_ps( Dot3( e2x, e2y, e2z, qx, qy, qz ), invDet );
+
+    auto zero = _mm256_setzero_ps();
+    auto hit  = _mm256_and_ps( _mm256_cmp_ps( u, zero, _CMP_GE_OQ ), _mm256_cmp_ps( v, zero, _CMP_GE_OQ ) );
+    hit = _mm256_and_ps( hit, _mm256_cmp_ps( _mm256_add_ps( u, v ), _mm256_set1_ps( 1.0f ), _CMP_LE_OQ ) );
+    hit = _mm256_and_ps( hit, _mm256_cmp_ps( t, zero, _CMP_GE_OQ ) );
+    hit = _mm256_and_ps( hit, _mm256_cmp_ps( t, _mm256_loadu_ps( pMaxDistance ), _CMP_LE_OQ ) );
+
+    _mm256_storeu_ps( pDistance, t );
+    return static_cast<uint32_t>( _mm256_movemask_ps( hit ) );
+}
+  #endif//ASVK_IS_AVX
+#else
+//-------------------------------------------------------------------------------------------------
+//      1本ずつバウンディングボックスとの交差を判定します.
+//      ※ BoundingBox::Intersects() と結果を一致させるため，演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+template<typename Packet>
+inline uint32_t IntersectBoxSingle
+(
+    const Packet&               rays,
+    const asvk::BoundingBox&    box,
+    const float*                pMaxDistance,
+    float*                      pDistance
+)
+{
+    uint32_t mask = 0;
+    for( auto lane=0u; lane<Packet::WIDTH; ++lane )
+    {
+        auto tx0 = ( ( rays.signX[lane] ? box.maxi.x : box.mini.x ) - rays.posX[lane] ) * rays.invDirX[lane];
+        auto tx1 = ( ( rays.signX[lane] ? box.mini.x : box.maxi.x ) - rays.posX[lane] ) * rays.invDirX[lane];
+        auto ty0 = ( ( rays.signY[lane] ? box.maxi.y : box.mini.y ) - rays.posY[lane] ) * rays.invDirY[lane];
+        auto ty1 = ( ( rays.signY[lane] ? box.mini.y : box.maxi.y ) - rays.posY[lane] ) * rays.invDirY[lane];
+        auto tz0 = ( ( rays.signZ[lane] ? box.maxi.z : box.mini.z ) - rays.posZ[lane] ) * rays.invDirZ[lane];
+        auto tz1 = ( ( rays.signZ[lane] ? box.mini.z : box.maxi.z ) - rays.posZ[lane] ) * rays.invDirZ[lane];
+
+        auto tmin = 0.0f;
+        auto tmax = pMaxDistance[lane];
+        tmin = ( tx0 > tmin ) ? tx0 : tmin;
+        tmin = ( ty0 > tmin ) ? ty0 : tmin;
+        tmin = ( tz0 > tmin ) ? tz0 : tmin;
+        tmax = ( tx1 < tmax ) ? tx1 : tmax;
+        tmax = ( ty1 < tmax ) ? ty1 : tmax;
+        tmax = ( tz1 < tmax ) ? tz1 : tmax;
+
+        pDistance[lane] = tmin;
+        mask |= ( tmin <= tmax ) ? ( 1u << lane ) : 0u;
+    }
+    return mask;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      1本ずつ三角形との交差を判定します.
+//-------------------------------------------------------------------------------------------------
+template<typename Packet>
+inline uint32_t IntersectTriangleSingle
+(
+    const Packet&               rays,
+    const asvk::Triangle&       triangle,
+    const float*                pMaxDistance,
+    float*                      pDistance
+)
+{
+    uint32_t mask = 0;
+    for( auto lane=0u; lane<Packet::WIDTH; ++lane )
+    {
+        // 方向ベクトルの逆数は使わないため, レイを作り直さずに判定する.
+        asvk::Vector3 pos( rays.posX[lane], rays.posY[lane], rays.posZ[lane] );
+        asvk::Vector3 dir( rays.dirX[lane], rays.dirY[lane], rays.dirZ[lane] );
+
+        auto e1 = triangle.v1 - triangle.v0;
+        auto e2 = triangle.v2 - triangle.v0;
+        auto p  = asvk::Vector3::Cross( dir, e2 );
+        auto invDet = 1.0f / asvk::Vector3::Dot( e1, p );
+
+        auto s = pos - triangle.v0;
+        auto q = asvk::Vector3::Cross( s, e1 );
+        auto u = asvk::Vector3::Dot( s, p ) * invDet;
+        auto v = asvk::Vector3::Dot( dir, q ) * invDet;
+        auto t = asvk::Vector3::Dot( e2, q ) * invDet;
+
+        pDistance[lane] = t;
+        if ( ( u >= 0.0f ) && ( v >= 0.0f ) && ( u + v <= 1.0f ) && ( t >= 0.0f ) && ( t <= pMaxDistance[lane] ) )
+        { mask |= 1u << lane; }
+    }
+    return mask;
+}
+#endif//ASVK_IS_SIMD
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ViewFrustum class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      複数のバウンディングスフィアをまとめて判定します.
+//      ※ Contains( const BoundingSphere& ) と結果を一致させるため，比較の向きや演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+void ViewFrustum::CullSpheres
+(
+    const float*    pCenterX,
+    const float*    pCenterY,
+    const float*    pCenterZ,
+    const float*    pRadius,
+    size_t          count,
+    uint32_t*       pVisibleMask
+) const
+{
+    assert( count == 0 || ( pCenterX != nullptr && pCenterY != nullptr && pCenterZ != nullptr && pRadius != nullptr && pVisibleMask != nullptr ) );
+    auto n = static_cast<int64_t>( ( count + MASK_BITS - 1 ) / MASK_BITS );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( n >= FRUSTUM_PARALLEL_THRESHOLD )
+#endif
+    for( int64_t w=0; w<n; ++w )
+    {
+        auto start = static_cast<size_t>( w ) * MASK_BITS;
+        auto end   = ( start + MASK_BITS < count ) ? start + MASK_BITS : count;
+        auto i     = start;
+        uint32_t bits = 0;
+
+    #if ASVK_IS_SIMD
+      #if ASVK_IS_AVX
+        {
+            auto px = _mm256_set1_ps( m_Position.x );
+            auto py = _mm256_set1_ps( m_Position.y );
+            auto pz = _mm256_set1_ps( m_Position.z );
+            auto fx = _mm256_set1_ps( m_Forward.x );
+            auto fy = _mm256_set1_ps( m_Forward.y );
+            auto fz = _mm256_set1_ps( m_Forward.z );
+            auto rx = _mm256_set1_ps( m_Right.x );
+            auto ry = _mm256_set1_ps( m_Right.y );
+            auto rz = _mm256_set1_ps( m_Right.z );
+            auto ux = _mm256_set1_ps( m_Upward.x );
+            auto uy = _mm256_set1_ps( m_Upward.y );
+            auto uz = _mm256_set1_ps( m_Upward.z );
+            auto factorR = _mm256_set1_ps( m_FactorR );
+            auto factorU = _mm256_set1_ps( m_FactorU );
+            auto sphereR = _mm256_set1_ps( m_SphereFactorR );
+            auto sphereU = _mm256_set1_ps( m_SphereFactorU );
+            auto nearClip = _mm256_set1_ps( m_NearClip );
+            auto farClip  = _mm256_set1_ps( m_FarClip );
+
+            for( ; i + 8 <= end; i += 8 )
+            {
+                auto radius = _mm256_loadu_ps( pRadius + i );
+                auto ox = _mm256_sub_ps( _mm256_loadu_ps( pCenterX + i ), px );
+                auto oy = _mm256_sub_ps( _mm256_loadu_ps( pCenterY + i ), py );
+                auto oz = _mm256_sub_ps( _mm256_loadu_ps( pCenterZ + i ), pz );
+
+                auto f = Dot3( ox, oy, oz, fx, fy, fz );
+                auto out = _mm256_or_ps(
+                    _mm256_cmp_ps( f, _mm256_sub_ps( nearClip, radius ), _CMP_LT_OQ ),
+                    _mm256_cmp_ps( _mm256_add_ps( farClip, radius ), f, _CMP_LT_OQ ) );
+
+                auto r    = Dot3( ox, oy, oz, rx, ry, rz );
+                auto rTop = _mm256_add_ps( _mm256_mul_ps( factorR, f ), _mm256_mul_ps( radius, sphereR ) );
+                out = _mm256_or_ps( out, _mm256_cmp_ps( r, Negate( rTop ), _CMP_LT_OQ ) );
+                out = _mm256_or_ps( out, _mm256_cmp_ps( rTop, r, _CMP_LT_OQ ) );
+
+                auto u    = Dot3( ox, oy, oz, ux, uy, uz );
+                auto uTop = _mm256_add_ps( _mm256_mul_ps( factorU, f ), _mm256_mul_ps( radius, sphereU ) );
+                out = _mm256_or_ps( out, _mm256_cmp_ps( u, Negate( uTop ), _CMP_LT_OQ ) );
+                out = _mm256_or_ps( out, _mm256_cmp_ps( uTop, u, _CMP_LT_OQ ) );
+
+                auto visible = static_cast<uint32_t>( ~_mm256_movemask_ps( out ) ) & 0xffu;
+                bits |= visible << ( i - start );
+            }
+        }
+      #endif//ASVK_IS_AVX
+        {
+            auto px = _mm_set1_ps( m_Position.x );
+            auto py = _mm_set1_ps( m_Position.y );
+            auto pz = _mm_set1_ps( m_Position.z );
+            auto fx = _mm_set1_ps( m_Forward.x );
+            auto fy = _mm_set1_ps( m_Forward.y );
+            auto fz = _mm_set1_ps( m_Forward.z );
+            auto rx = _mm_set1_ps( m_Right.x );
+            auto ry = _mm_set1_ps( m_Right.y );
+            auto rz = _mm_set1_ps( m_Right.z );
+            auto ux = _mm_set1_ps( m_Upward.x );
+            auto uy = _mm_set1_ps( m_Upward.y );
+            auto uz = _mm_set1_ps( m_Upward.z );
+            auto factorR = _mm_set1_ps( m_FactorR );
+            auto factorU = _mm_set1_ps( m_FactorU );
+            auto sphereR = _mm_set1_ps( m_SphereFactorR );
+            auto sphereU = _mm_set1_ps( m_SphereFactorU );
+            auto nearClip = _mm_set1_ps( m_NearClip );
+            auto farClip  = _mm_set1_ps( m_FarClip );
+
+            for( ; i + 4 <= end; i += 4 )
+            {
+                auto radius = _mm_loadu_ps( pRadius + i );
+                auto ox = _mm_sub_ps( _mm_loadu_ps( pCenterX + i ), px );
+                auto oy = _mm_sub_ps( _mm_loadu_ps( pCenterY + i ), py );
+                auto oz = _mm_sub_ps( _mm_loadu_ps( pCenterZ + i ), pz );
+
+                auto f = Dot3( ox, oy, oz, fx, fy, fz );
+                auto out = _mm_or_ps(
+                    _mm_cmplt_ps( f, _mm_sub_ps( nearClip, radius ) ),
+                    _mm_cmplt_ps( _mm_add_ps( farClip, radius ), f ) );
+
+                auto r    = Dot3( ox, oy, oz, rx, ry, rz );
+                auto rTop = _mm_add_ps( _mm_mul_ps( factorR, f ), _mm_mul_ps( radius, sphereR ) );
+                out = _mm_or_ps( out, _mm_cmplt_ps( r, Negate( rTop ) ) );
+                out = _mm_or_ps( out, _mm_cmplt_ps( rTop, r ) );
+
+                auto u    = Dot3( ox, oy, oz, ux, uy, uz );
+                auto uTop = _mm_add_ps( _mm_mul_ps( factorU, f ), _mm_mul_ps( radius, sphereU ) );
+                out = _mm_or_ps( out, _mm_cmplt_ps( u, Negate( uTop ) ) );
+                out = _mm_or_ps( out, _mm_cmplt_ps( uTop, u ) );
+
+                auto visible = static_cast<uint32_t>( ~_mm_movemask_ps( out ) ) & 0xfu;
+                bits |= visible << ( i - start );
+            }
+        }
+    #endif//ASVK_IS_SIMD
+
+        for( ; i < end; ++i )
+        {
+            BoundingSphere sphere( Vector3( pCenterX[i], pCenterY[i], pCenterZ[i] ), pRadius[i] );
+            if ( Contains( sphere ) )
+            { bits |= 1u << ( i - start ); }
+        }
+
+        pVisibleMask[w] = bits;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      複数のバウンディングボックスをまとめて判定します.
+//      8頂点それぞれについて各平面の外側にあるかを求め，全頂点が同じ平面の外側にあるものを除外します.
+//      ※ Contains( const BoundingBox& ) の else if による排他判定もそのまま再現すること.
+//-------------------------------------------------------------------------------------------------
+void ViewFrustum::CullBoxes
+(
+    const float*    pMinX,
+    const float*    pMinY,
+    const float*    pMinZ,
+    const float*    pMaxX,
+    const float*    pMaxY,
+    const float*    pMaxZ,
+    size_t          count,
+    uint32_t*       pVisibleMask
+) const
+{
+    assert( count == 0 || ( pMinX != nullptr && pMinY != nullptr && pMinZ != nullptr && pVisibleMask != nullptr ) );
+    assert( count == 0 || ( pMaxX != nullptr && pMaxY != nullptr && pMaxZ != nullptr ) );
+    auto n = static_cast<int64_t>( ( count + MASK_BITS - 1 ) / MASK_BITS );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( n >= FRUSTUM_PARALLEL_THRESHOLD )
+#endif
+    for( int64_t w=0; w<n; ++w )
+    {
+        auto start = static_cast<size_t>( w ) * MASK_BITS;
+        auto end   = ( start + MASK_BITS < count ) ? start + MASK_BITS : count;
+        auto i     = start;
+        uint32_t bits = 0;
+
+    #if ASVK_IS_SIMD
+      #if ASVK_IS_AVX
+        {
+            auto px = _mm256_set1_ps( m_Position.x );
+            auto py = _mm256_set1_ps( m_Position.y );
+            auto pz = _mm256_set1_ps( m_Position.z );
+            auto fx = _mm256_set1_ps( m_Forward.x );
+            auto fy = _mm256_set1_ps( m_Forward.y );
+            auto fz = _mm256_set1_ps( m_Forward.z );
+            auto rx = _mm256_set1_ps( m_Right.x );
+            auto ry = _mm256_set1_ps( m_Right.y );
+            auto rz = _mm256_set1_ps( m_Right.z );
+            auto ux = _mm256_set1_ps( m_Upward.x );
+            auto uy = _mm256_set1_ps( m_Upward.y );
+            auto uz = _mm256_set1_ps( m_Upward.z );
+            auto factorR = _mm256_set1_ps( m_FactorR );
+            auto factorU = _mm256_set1_ps( m_FactorU );
+            auto nearClip = _mm256_set1_ps( m_NearClip );
+            auto farClip  = _mm256_set1_ps( m_FarClip );
+
+            for( ; i + 8 <= end; i += 8 )
+            {
+                // 頂点の各成分は最小値か最大値のどちらかなので，積は軸ごとに2通りだけ求めておく.
+                __m256 dx[2], dy[2], dz[2];
+                dx[0] = _mm256_sub_ps( _mm256_loadu_ps( pMinX + i ), px );
+                dx[1] = _mm256_sub_ps( _mm256_loadu_ps( pMaxX + i ), px );
+                dy[0] = _mm256_sub_ps( _mm256_loadu_ps( pMinY + i ), py );
+                dy[1] = _mm256_sub_ps( _mm256_loadu_ps( pMaxY + i ), py );
+                dz[0] = _mm256_sub_ps( _mm256_loadu_ps( pMinZ + i ), pz );
+                dz[1] = _mm256_sub_ps( _mm256_loadu_ps( pMaxZ + i ), pz );
+
+                __m256 rX[2], rY[2], rZ[2], uX[2], uY[2], uZ[2], fX[2], fY[2], fZ[2];
+                for( auto j=0; j<2; ++j )
+                {
+                    rX[j] = _mm256_mul_ps( rx, dx[j] ); rY[j] = _mm256_mul_ps( ry, dy[j] ); rZ[j] = _mm256_mul_ps( rz, dz[j] );
+                    uX[j] = _mm256_mul_ps( ux, dx[j] ); uY[j] = _mm256_mul_ps( uy, dy[j] ); uZ[j] = _mm256_mul_ps( uz, dz[j] );
+                    fX[j] = _mm256_mul_ps( fx, dx[j] ); fY[j] = _mm256_mul_ps( fy, dy[j] ); fZ[j] = _mm256_mul_ps( fz, dz[j] );
+                }
+
+                // 全頂点が外側にある平面を求める.
+                auto allOnes = _mm256_castsi256_ps( _mm256_set1_epi32( -1 ) );
+                auto outL = allOnes, outR = allOnes;
+                auto outB = allOnes, outT = allOnes;
+                auto outN = allOnes, outF = allOnes;
+
+                for( auto j=0; j<8; ++j )
+                {
+                    auto ix = ( j & 1 );
+                    auto iy = ( j >> 2 ) & 1;
+                    auto iz = ( j >> 1 ) & 1;
+
+                    auto r = _mm256_add_ps( _mm256_add_ps( rX[ix], rY[iy] ), rZ[iz] );
+                    auto u = _mm256_add_ps( _mm256_add_ps( uX[ix], uY[iy] ), uZ[iz] );
+                    auto f = _mm256_add_ps( _mm256_add_ps( fX[ix], fY[iy] ), fZ[iz] );
+
+                    auto rLimit = _mm256_mul_ps( factorR, f );
+                    auto uLimit = _mm256_mul_ps( factorU, f );
+
+                    auto left   = _mm256_cmp_ps( r, Negate( rLimit ), _CMP_LT_OQ );
+                    auto bottom = _mm256_cmp_ps( u, Negate( uLimit ), _CMP_LT_OQ );
+                    auto front  = _mm256_cmp_ps( f, nearClip, _CMP_LT_OQ );
+
+                    outL = _mm256_and_ps( outL, left );
+                    outR = _mm256_and_ps( outR, _mm256_andnot_ps( left, _mm256_cmp_ps( rLimit, r, _CMP_LT_OQ ) ) );
+                    outB = _mm256_and_ps( outB, bottom );
+                    outT = _mm256_and_ps( outT, _mm256_andnot_ps( bottom, _mm256_cmp_ps( uLimit, u, _CMP_LT_OQ ) ) );
+                    outN = _mm256_and_ps( outN, front );
+                    outF = _mm256_and_ps( outF, _mm256_andnot_ps( front, _mm256_cmp_ps( farClip, f, _CMP_LT_OQ ) ) );
+                }
+
+                auto out = _mm256_or_ps(
+                    _mm256_or_ps( _mm256_or_ps( outL, outR ), _mm256_or_ps( outB, outT ) ),
+                    _mm256_or_ps( outN, outF ) );
+
+                auto visible = static_cast<uint32_t>( ~_mm256_movemask_ps( out ) ) & 0xffu;
+                bits |= visible << ( i - start );
+            }
+        }
+      #endif//ASVK_IS_AVX
+        {
+            auto px = _mm_set1_ps( m_Position.x );
+            auto py = _mm_set1_ps( m_Position.y );
+            auto pz = _mm_set1_ps( m_Position.z );
+            auto fx = _mm_set1_ps( m_Forward.x );
+            auto fy = _mm_set1_ps( m_Forward.y );
+            auto fz = _mm_set1_ps( m_Forward.z );
+            auto rx = _mm_set1_ps( m_Right.x );
+            auto ry = _mm_set1_ps( m_Right.y );
+            auto rz = _mm_set1_ps( m_Right.z );
+            auto ux = _mm_set1_ps( m_Upward.x );
+            auto uy = _mm_set1_ps( m_Upward.y );
+            auto uz = _mm_set1_ps( m_Upward.z );
+            auto factorR = _mm_set1_ps( m_FactorR );
+            auto factorU = _mm_set1_ps( m_FactorU );
+            auto nearClip = _mm_set1_ps( m_NearClip );
+            auto farClip  = _mm_set1_ps( m_FarClip );
+
+            for( ; i + 4 <= end; i += 4 )
+            {
+                __m128 dx[2], dy[2], dz[2];
+                dx[0] = _mm_sub_ps( _mm_loadu_ps( pMinX + i ), px );
+                dx[1] = _mm_sub_ps( _mm_loadu_ps( pMaxX + i ), px );
+                dy[0] = _mm_sub_ps( _mm_loadu_ps( pMinY + i ), py );
+                dy[1] = _mm_sub_ps( _mm_loadu_ps( pMaxY + i ), py );
+                dz[0] = _mm_sub_ps( _mm_loadu_ps( pMinZ + i ), pz );
+                dz[1] = _mm_sub_ps( _mm_loadu_ps( pMaxZ + i ), pz );
+
+                __m128 rX[2], rY[2], rZ[2], uX[2], uY[2], uZ[2], fX[2], fY[2], fZ[2];
+                for( auto j=0; j<2; ++j )
+                {
+                    rX[j] = _mm_mul_ps( rx, dx[j] ); rY[j] = _mm_mul_ps( ry, dy[j] ); rZ[j] = _mm_mul_ps( rz, dz[j] );
+                    uX[j] = _mm_mul_ps( ux, dx[j] ); uY[j] = _mm_mul_ps( uy, dy[j] ); uZ[j] = _mm_mul_ps( uz, dz[j] );
+                    fX[j] = _mm_mul_ps( fx, dx[j] ); fY[j] = _mm_mul_ps( fy, dy[j] ); fZ[j] = _mm_mul_ps( fz, dz[j] );
+                }
+
+                auto allOnes = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+                auto outL = allOnes, outR = allOnes;
+                auto outB = allOnes, outT = allOnes;
+                auto outN = allOnes, outF = allOnes;
+
+                for( auto j=0; j<8; ++j )
+                {
+                    auto ix = ( j & 1 );
+                    auto iy = ( j >> 2 ) & 1;
+                    auto iz = ( j >> 1 ) & 1;
+
+                    auto r = _mm_add_ps( _mm_add_ps( rX[ix], rY[iy] ), rZ[iz] );
+                    auto u = _mm_add_ps( _mm_add_ps( uX[ix], uY[iy] ), uZ[iz] );
+                    auto f = _mm_add_ps( _mm_add_ps( fX[ix], fY[iy] ), fZ[iz] );
+
+                    auto rLimit = _mm_mul_ps( factorR, f );
+                    auto uLimit = _mm_mul_ps( factorU, f );
+
+                    auto left   = _mm_cmplt_ps( r, Negate( rLimit ) );
+                    auto bottom = _mm_cmplt_ps( u, Negate( uLimit ) );
+                    auto front  = _mm_cmplt_ps( f, nearClip );
+
+                    outL = _mm_and_ps( outL, left );
+                    outR = _mm_and_ps( outR, _mm_andnot_ps( left, _mm_cmplt_ps( rLimit, r ) ) );
+                    outB = _mm_and_ps( outB, bottom );
+                    outT = _mm_and_ps( outT, _mm_andnot_ps( bottom, _mm_cmplt_ps( uLimit, u ) ) );
+                    outN = _mm_and_ps( outN, front );
+                    outF = _mm_and_ps( outF, _mm_andnot_ps( front, _mm_cmplt_ps( farClip, f ) ) );
+                }
+
+                auto out = _mm_or_ps(
+                    _mm_or_ps( _mm_or_ps( outL, outR ), _mm_or_ps( outB, outT ) ),
+                    _mm_or_ps( outN, outF ) );
+
+                auto visible = static_cast<uint32_t>( ~_mm_movemask_ps( out ) ) & 0xfu;
+                bits |= visible << ( i - start );
+            }
+        }
+    #endif//ASVK_IS_SIMD
+
+        for( ; i < end; ++i )
+        {
+            BoundingBox box(
+                Vector3( pMinX[i], pMinY[i], pMinZ[i] ),
+                Vector3( pMaxX[i], pMaxY[i], pMaxZ[i] ) );
+            if ( Contains( box ) )
+            { bits |= 1u << ( i - start ); }
+        }
+
+        pVisibleMask[w] = bits;
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Frustum class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t Frustum::PLANE_LEFT;
+constexpr uint32_t Frustum::PLANE_RIGHT;
+constexpr uint32_t Frustum::PLANE_BOTTOM;
+constexpr uint32_t Frustum::PLANE_TOP;
+constexpr uint32_t Frustum::PLANE_NEAR;
+constexpr uint32_t Frustum::PLANE_FAR;
+constexpr uint32_t Frustum::PLANE_COUNT;
+constexpr uint32_t Frustum::ALL_PLANES;
+constexpr uint32_t Frustum::PADDED_COUNT;
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+Frustum::Frustum()
+: m_PlaneMask( ALL_PLANES )
+{
+    for( auto i=0u; i<PADDED_COUNT; ++i )
+    {
+        m_NormalX [i] = 0.0f;
+        m_NormalY [i] = 0.0f;
+        m_NormalZ [i] = 0.0f;
+        m_Distance[i] = 0.0f;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      引数付きコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+Frustum::Frustum( const Matrix& viewProjection )
+{ SetMatrix( viewProjection ); }
+
+//-------------------------------------------------------------------------------------------------
+//      行列から6平面を抽出します.
+//-------------------------------------------------------------------------------------------------
+void Frustum::SetMatrix( const Matrix& m )
+{
+    // 行ベクトル規約 (clip = v * M) なので，クリップ座標の各成分は行列の列との内積になる.
+    // -w <= x <= w, -w <= y <= w, 0 <= z <= w の各不等式が1つの平面に対応する.
+    const float planes[PLANE_COUNT][4] = {
+        { m._14 + m._11, m._24 + m._21, m._34 + m._31, m._44 + m._41 },     // 左.
+        { m._14 - m._11, m._24 - m._21, m._34 - m._31, m._44 - m._41 },     // 右.
+        { m._14 + m._12, m._24 + m._22, m._34 + m._32, m._44 + m._42 },     // 下.
+        { m._14 - m._12, m._24 - m._22, m._34 - m._32, m._44 - m._42 },     // 上.
+        { m._13,         m._23,         m._33,         m._43         },     // 近.
+        { m._14 - m._13, m._24 - m._23, m._34 - m._33, m._44 - m._43 },     // 遠.
+    };
+
+    m_PlaneMask = ALL_PLANES;
+
+    for( auto i=0u; i<PADDED_COUNT; ++i )
+    {
+        // 余りのレーンは先頭の平面を複製して判定結果に影響しないようにする.
+        auto& plane = planes[ ( i < PLANE_COUNT ) ? i : i - PLANE_COUNT ];
+
+        // 遠平面が無限遠の射影行列などでは法線が0になるので，その平面は判定から外す.
+        auto length    = sqrtf( plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2] );
+        auto invLength = 0.0f;
+        if ( length > 0.0f )
+        { invLength = 1.0f / length; }
+        else if ( i < PLANE_COUNT )
+        { m_PlaneMask &= ~( 1u << i ); }
+
+        m_NormalX [i] = plane[0] * invLength;
+        m_NormalY [i] = plane[1] * invLength;
+        m_NormalZ [i] = plane[2] * invLength;
+        m_Distance[i] = plane[3] * invLength;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      平面を取得します.
+//-------------------------------------------------------------------------------------------------
+Vector4 Frustum::GetPlane( uint32_t index ) const
+{
+    assert( index < PLANE_COUNT );
+    return Vector4( m_NormalX[index], m_NormalY[index], m_NormalZ[index], m_Distance[index] );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングスフィアとの包含関係を判定します.
+//-------------------------------------------------------------------------------------------------
+Containment Frustum::Classify( const BoundingSphere& sphere ) const
+{
+    uint32_t planeMask = ALL_PLANES;
+    return Classify( sphere, planeMask );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      判定する平面を限定して，バウンディングスフィアとの包含関係を判定します.
+//-------------------------------------------------------------------------------------------------
+Containment Frustum::Classify( const BoundingSphere& sphere, uint32_t& planeMask ) const
+{
+    uint32_t outBits = 0;
+    uint32_t inBits  = 0;
+
+#if ASVK_IS_SIMD
+  #if ASVK_IS_AVX
+    {
+        auto cx = _mm256_set1_ps( sphere.center.x );
+        auto cy = _mm256_set1_ps( sphere.center.y );
+        auto cz = _mm256_set1_ps( sphere.center.z );
+        auto r  = _mm256_set1_ps( sphere.radius );
+
+        auto d = _mm256_add_ps( Dot3(
+            _mm256_loadu_ps( m_NormalX ), _mm256_loadu_ps( m_NormalY ), _mm256_loadu_ps( m_NormalZ ), cx, cy, cz ),
+            _mm256_loadu_ps( m_Distance ) );
+
+        outBits = static_cast<uint32_t>( _mm256_movemask_ps( _mm256_cmp_ps( d, Negate( r ), _CMP_LT_OQ ) ) );
+        inBits  = static_cast<uint32_t>( _mm256_movemask_ps( _mm256_cmp_ps( d, r, _CMP_GE_OQ ) ) );
+    }
+  #else
+    {
+        auto cx = _mm_set1_ps( sphere.center.x );
+        auto cy = _mm_set1_ps( sphere.center.y );
+        auto cz = _mm_set1_ps( sphere.center.z );
+        auto r  = _mm_set1_ps( sphere.radius );
+
+        for( auto i=0u; i<PADDED_COUNT; i += 4 )
+        {
+            auto d = _mm_add_ps( Dot3(
+                _mm_loadu_ps( m_NormalX + i ), _mm_loadu_ps( m_NormalY + i ), _mm_loadu_ps( m_NormalZ + i ), cx, cy, cz ),
+                _mm_loadu_ps( m_Distance + i ) );
+
+            outBits |= static_cast<uint32_t>( _mm_movemask_ps( _mm_cmplt_ps( d, Negate( r ) ) ) ) << i;
+            inBits  |= static_cast<uint32_t>( _mm_movemask_ps( _mm_cmpge_ps( d, r ) ) ) << i;
+        }
+    }
+  #endif//ASVK_IS_AVX
+#else
+    for( auto i=0u; i<PLANE_COUNT; ++i )
+    {
+        auto d = m_NormalX[i] * sphere.center.x
+               + m_NormalY[i] * sphere.center.y
+               + m_NormalZ[i] * sphere.center.z
+               + m_Distance[i];
+
+        if ( d < -sphere.radius )
+        { outBits |= 1u << i; }
+        if ( d >= sphere.radius )
+        { inBits |= 1u << i; }
+    }
+#endif//ASVK_IS_SIMD
+
+    return ResolveContainment( outBits, inBits, m_PlaneMask, planeMask );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスとの包含関係を判定します.
+//-------------------------------------------------------------------------------------------------
+Containment Frustum::Classify( const BoundingBox& box ) const
+{
+    uint32_t planeMask = ALL_PLANES;
+    return Classify( box, planeMask );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      判定する平面を限定して，バウンディングボックスとの包含関係を判定します.
+//      中心の符号付き距離と，法線方向に射影した半径 (|n|・extent) を比べます.
+//-------------------------------------------------------------------------------------------------
+Containment Frustum::Classify( const BoundingBox& box, uint32_t& planeMask ) const
+{
+    uint32_t outBits = 0;
+    uint32_t inBits  = 0;
+
+    auto center = ( box.maxi + box.mini ) * 0.5f;
+    auto extent = ( box.maxi - box.mini ) * 0.5f;
+
+#if ASVK_IS_SIMD
+  #if ASVK_IS_AVX
+    {
+        auto absMask = _mm256_set1_ps( -0.0f );
+        auto nx = _mm256_loadu_ps( m_NormalX );
+        auto ny = _mm256_loadu_ps( m_NormalY );
+        auto nz = _mm256_loadu_ps( m_NormalZ );
+
+        auto d = _mm256_add_ps( Dot3( nx, ny, nz,
+            _mm256_set1_ps( center.x ), _mm256_set1_ps( center.y ), _mm256_set1_ps( center.z ) ),
+            _mm256_loadu_ps( m_Distance ) );
+        auto s = Dot3(
+            _mm256_andnot_ps( absMask, nx ), _mm256_andnot_ps( absMask, ny ), _mm256_andnot_ps( absMask, nz ),
+            _mm256_set1_ps( extent.x ), _mm256_set1_ps( extent.y ), _mm256_set1_ps( extent.z ) );
+
+        outBits = static_cast<uint32_t>( _mm256_movemask_ps( _mm256_cmp_ps( _mm256_add_ps( d, s ), _mm256_setzero_ps(), _CMP_LT_OQ ) ) );
+        inBits  = static_cast<uint32_t>( _mm256_movemask_ps( _mm256_cmp_ps( _mm256_sub_ps( d, s ), _mm256_setzero_ps(), _CMP_GE_OQ ) ) );
+    }
+  #else
+    {
+        auto absMask = _mm_set1_ps( -0.0f );
+        auto cx = _mm_set1_ps( center.x );
+        auto cy = _mm_set1_ps( center.y );
+        auto cz = _mm_set1_ps( center.z );
+        auto ex = _mm_set1_ps( extent.x );
+        auto ey = _mm_set1_ps( extent.y );
+        auto ez = _mm_set1_ps( extent.z );
+
+        for( auto i=0u; i<PADDED_COUNT; i += 4 )
+        {
+            auto nx = _mm_loadu_ps( m_NormalX + i );
+            auto ny = _mm_loadu_ps( m_NormalY + i );
+            auto nz = _mm_loadu_ps( m_NormalZ + i );
+
+            auto d = _mm_add_ps( Dot3( nx, ny, nz, cx, cy, cz ), _mm_loadu_ps( m_Distance + i ) );
+            auto s = Dot3( _mm_andnot_ps( absMask, nx ), _mm_andnot_ps( absMask, ny ), _mm_andnot_ps( absMask, nz ), ex, ey, ez );
+
+            outBits |= static_cast<uint32_t>( _mm_movemask_ps( _mm_cmplt_ps( _mm_add_ps( d, s ), _mm_setzero_ps() ) ) ) << i;
+            inBits  |= static_cast<uint32_t>( _mm_movemask_ps( _mm_cmpge_ps( _mm_sub_ps( d, s ), _mm_setzero_ps() ) ) ) << i;
+        }
+    }
+  #endif//ASVK_IS_AVX
+#else
+    for( auto i=0u; i<PLANE_COUNT; ++i )
+    {
+        auto d = m_NormalX[i] * center.x
+               + m_NormalY[i] * center.y
+               + m_NormalZ[i] * center.z
+               + m_Distance[i];
+        auto s = fabsf( m_NormalX[i] ) * extent.x
+               + fabsf( m_NormalY[i] ) * extent.y
+               + fabsf( m_NormalZ[i] ) * extent.z;
+
+        if ( d + s < 0.0f )
+        { outBits |= 1u << i; }
+        if ( d - s >= 0.0f )
+        { inBits |= 1u << i; }
+    }
+#endif//ASVK_IS_SIMD
+
+    return ResolveContainment( outBits, inBits, m_PlaneMask, planeMask );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングスフィアの一部でも含むか判定します.
+//-------------------------------------------------------------------------------------------------
+bool Frustum::Contains( const BoundingSphere& sphere ) const
+{ return Classify( sphere ) != Containment::Outside; }
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスの一部でも含むか判定します.
+//-------------------------------------------------------------------------------------------------
+bool Frustum::Contains( const BoundingBox& box ) const
+{ return Classify( box ) != Containment::Outside; }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RayPacket4 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t RayPacket4::WIDTH;
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスと交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+uint32_t RayPacket4::Intersects( const BoundingBox& box, const float* pMaxDistance, float* pDistance ) const
+{
+#if ASVK_IS_SIMD
+    return IntersectBox4( *this, 0, box, pMaxDistance, pDistance );
+#else
+    return IntersectBoxSingle( *this, box, pMaxDistance, pDistance );
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      三角形と交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+uint32_t RayPacket4::Intersects( const Triangle& triangle, const float* pMaxDistance, float* pDistance ) const
+{
+#if ASVK_IS_SIMD
+    return IntersectTriangle4( *this, 0, triangle, pMaxDistance, pDistance );
+#else
+    return IntersectTriangleSingle( *this, triangle, pMaxDistance, pDistance );
+#endif
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RayPacket8 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t RayPacket8::WIDTH;
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスと交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+uint32_t RayPacket8::Intersects( const BoundingBox& box, const float* pMaxDistance, float* pDistance ) const
+{
+#if ASVK_IS_SIMD && ASVK_IS_AVX
+    return IntersectBox8( *this, box, pMaxDistance, pDistance );
+#elif ASVK_IS_SIMD
+    return IntersectBox4( *this, 0, box, pMaxDistance, pDistance )
+         | ( IntersectBox4( *this, 4, box, pMaxDistance, pDistance ) << 4 );
+#else
+    return IntersectBoxSingle( *this, box, pMaxDistance, pDistance );
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+//      三角形と交差するか判定します.
+//-------------------------------------------------------------------------------------------------
+uint32_t RayPacket8::Intersects( const Triangle& triangle, const float* pMaxDistance, float* pDistance ) const
+{
+#if ASVK_IS_SIMD && ASVK_IS_AVX
+    return IntersectTriangle8( *this, triangle, pMaxDistance, pDistance );
+#elif ASVK_IS_SIMD
+    return IntersectTriangle4( *this, 0, triangle, pMaxDistance, pDistance )
+         | ( IntersectTriangle4( *this, 4, triangle, pMaxDistance, pDistance ) << 4 );
+#else
+    return IntersectTriangleSingle( *this, triangle, pMaxDistance, pDistance );
+#endif
+}
+
+} // namespace asvk
@@ -0,0 +1,920 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkMath.cpp
+// Desc : Math Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkMath.h>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr int64_t MULTIPLY_PARALLEL_THRESHOLD = 2048;     //!< 行列乗算を並列化する要素数の閾値です.
+
+
+#if ASVK_IS_SIMD && !ASVK_IS_F16C
+//-------------------------------------------------------------------------------------------------
+//      4つのfloatをhalfに変換します(F32ToF16() と同じ丸め・特殊値の扱い).
+//-------------------------------------------------------------------------------------------------
+inline __m128i F32ToF16x4( __m128 value )
+{
+    auto sign   = _mm_and_ps( value, _mm_castsi128_ps( _mm_set1_epi32( 0x80000000 ) ) );
+    auto absf   = _mm_xor_ps( value, sign );
+    auto bits   = _mm_castps_si128( absf );
+
+    // 無限大・NaN.
+    auto isNaN     = _mm_castps_si128( _mm_cmpunord_ps( absf, absf ) );
+    auto payload   = _mm_or_si128( _mm_set1_epi32( 0x200 ), _mm_and_si128( _mm_srli_epi32( bits, 13 ), _mm_set1_epi32( 0x3FF ) ) );
+    auto special   = _mm_or_si128( _mm_set1_epi32( 0x7C00 ), _mm_and_si128( isNaN, payload ) );
+    auto isRegular = _mm_cmpgt_epi32( _mm_set1_epi32( 0x47800000 ), bits );
+
+    // 非正規化数.
+    auto magic     = _mm_set1_epi32( 0x3F000000 );
+    auto subnormal = _mm_sub_epi32( _mm_castps_si128( _mm_add_ps( absf, _mm_castsi128_ps( magic ) ) ), magic );
+    auto isSub     = _mm_cmpgt_epi32( _mm_set1_epi32( 0x38800000 ), bits );
+
+    // 正規化数 (仮数の最下位bitが奇数なら切り上げ側に寄せる).
+    auto odd    = _mm_and_si128( _mm_srli_epi32( bits, 13 ), _mm_set1_epi32( 1 ) );
+    auto normal = _mm_srli_epi32( _mm_add_epi32( _mm_add_epi32( bits, _mm_set1_epi32( int( 0xC8000FFF ) ) ), odd ), 13 );
+
+    auto result = _mm_or_si128( _mm_and_si128( isSub, subnormal ), _mm_andnot_si128( isSub, normal ) );
+    result = _mm_or_si128( _mm_and_si128( isRegular, result ), _mm_andnot_si128( isRegular, special ) );
+
+    // 符号は算術シフトで符号拡張しておき，packs_epi32 の飽和に掛からないようにする.
+    return _mm_or_si128( result, _mm_srai_epi32( _mm_castps_si128( sign ), 16 ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4つのhalfをfloatに変換します(F16ToF32() と同じ結果).
+//-------------------------------------------------------------------------------------------------
+inline __m128 F16ToF32x4( __m128i value )
+{
+    auto expmant = _mm_and_si128( value, _mm_set1_epi32( 0x7FFF ) );
+    auto scaled  = _mm_mul_ps( _mm_castsi128_ps( _mm_slli_epi32( expmant, 13 ) ), _mm_castsi128_ps( _mm_set1_epi32( 0x77800000 ) ) );
+    auto infnan  = _mm_and_si128( _mm_cmpgt_epi32( expmant, _mm_set1_epi32( 0x7BFF ) ), _mm_set1_epi32( 0x7F800000 ) );
+    auto quiet   = _mm_and_si128( _mm_cmpgt_epi32( expmant, _mm_set1_epi32( 0x7C00 ) ), _mm_set1_epi32( 0x00400000 ) );
+    auto sign    = _mm_slli_epi32( _mm_xor_si128( value, expmant ), 16 );
+    return _mm_or_ps( scaled, _mm_castsi128_ps( _mm_or_si128( sign, _mm_or_si128( infnan, quiet ) ) ) );
+}
+#endif//ASVK_IS_SIMD && !ASVK_IS_F16C
+
+#if ASVK_IS_SIMD
+//-------------------------------------------------------------------------------------------------
+//      マスクに従って値を選択します.
+//-------------------------------------------------------------------------------------------------
+inline __m128 Select( __m128 mask, __m128 a, __m128 b )
+{ return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) ); }
+
+inline __m128i Select( __m128i mask, __m128i a, __m128i b )
+{ return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      絶対値を求めます.
+//-------------------------------------------------------------------------------------------------
+inline __m128 Abs( __m128 value )
+{ return _mm_andnot_ps( _mm_set1_ps( -0.0f ), value ); }
+
+//-------------------------------------------------------------------------------------------------
+//      [-1, 1] の値を [0, 2 * scale] の整数に量子化します(detail::QuantizeSnorm() と同じ結果).
+//-------------------------------------------------------------------------------------------------
+inline __m128i QuantizeSnorm( __m128 value, float scale )
+{
+    auto k = _mm_set1_ps( scale );
+    return _mm_cvttps_epi32( _mm_add_ps( _mm_add_ps( _mm_mul_ps( value, k ), k ), _mm_set1_ps( 0.5f ) ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      量子化した SNORM 値を [-1, 1] に戻します(detail::DequantizeSnorm() と同じ結果).
+//-------------------------------------------------------------------------------------------------
+inline __m128 DequantizeSnorm( __m128i value, float scale )
+{ return _mm_max_ps( _mm_mul_ps( _mm_cvtepi32_ps( value ), _mm_set1_ps( 1.0f / scale ) ), _mm_set1_ps( -1.0f ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      4つの単位ベクトルを八面体に写像します(detail::OctahedralWrap() と同じ結果).
+//-------------------------------------------------------------------------------------------------
+inline void OctahedralWrap( __m128 vx, __m128 vy, __m128 vz, __m128& x, __m128& y )
+{
+    auto zero = _mm_setzero_ps();
+    auto one  = _mm_set1_ps( 1.0f );
+    auto inv  = _mm_div_ps( one, _mm_add_ps( _mm_add_ps( Abs( vx ), Abs( vy ) ), Abs( vz ) ) );
+    auto px   = _mm_mul_ps( vx, inv );
+    auto py   = _mm_mul_ps( vy, inv );
+
+    auto sx = Select( _mm_cmpge_ps( px, zero ), one, _mm_set1_ps( -1.0f ) );
+    auto sy = Select( _mm_cmpge_ps( py, zero ), one, _mm_set1_ps( -1.0f ) );
+    auto fx = _mm_mul_ps( _mm_sub_ps( one, Abs( py ) ), sx );
+    auto fy = _mm_mul_ps( _mm_sub_ps( one, Abs( px ) ), sy );
+
+    auto lower = _mm_cmplt_ps( vz, zero );
+    x = Select( lower, fx, px );
+    y = Select( lower, fy, py );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      八面体上の4点から単位ベクトルを復元します(detail::OctahedralUnwrap() と同じ結果).
+//-------------------------------------------------------------------------------------------------
+inline void OctahedralUnwrap( __m128 x, __m128 y, __m128& rx, __m128& ry, __m128& rz )
+{
+    auto zero = _mm_setzero_ps();
+    auto one  = _mm_set1_ps( 1.0f );
+    auto sign = _mm_set1_ps( -0.0f );
+
+    auto z  = _mm_sub_ps( _mm_sub_ps( one, Abs( x ) ), Abs( y ) );
+    auto t  = _mm_max_ps( _mm_xor_ps( z, sign ), zero );
+    auto nt = _mm_xor_ps( t, sign );
+    x = _mm_add_ps( x, Select( _mm_cmpge_ps( x, zero ), nt, t ) );
+    y = _mm_add_ps( y, Select( _mm_cmpge_ps( y, zero ), nt, t ) );
+
+    auto len = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+    auto inv = _mm_div_ps( one, _mm_sqrt_ps( len ) );
+    rx = _mm_mul_ps( x, inv );
+    ry = _mm_mul_ps( y, inv );
+    rz = _mm_mul_ps( z, inv );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      4頂点分のk番目の影響ボーンをSoA形式で読み込みます(r[0..3]が実部xyzw, r[4..7]が双対部xyzw).
+//-------------------------------------------------------------------------------------------------
+inline void GatherDualQuaternion4( const asvk::DualQuaternion* pBones, const uint16_t* pIndices, size_t k, __m128* r )
+{
+    const auto& b0 = pBones[ pIndices[ 0 + k] ];
+    const auto& b1 = pBones[ pIndices[ 4 + k] ];
+    const auto& b2 = pBones[ pIndices[ 8 + k] ];
+    const auto& b3 = pBones[ pIndices[12 + k] ];
+
+    r[0] = asvk::detail::LoadFloat4( &b0.real.x );
+    r[1] = asvk::detail::LoadFloat4( &b1.real.x );
+    r[2] = asvk::detail::LoadFloat4( &b2.real.x );
+    r[3] = asvk::detail::LoadFloat4( &b3.real.x );
+    _MM_TRANSPOSE4_PS( r[0], r[1], r[2], r[3] );
+
+    r[4] = asvk::detail::LoadFloat4( &b0.dual.x );
+    r[5] = asvk::detail::LoadFloat4( &b1.dual.x );
+    r[6] = asvk::detail::LoadFloat4( &b2.dual.x );
+    r[7] = asvk::detail::LoadFloat4( &b3.dual.x );
+    _MM_TRANSPOSE4_PS( r[4], r[5], r[6], r[7] );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SoA形式のベクトルを回転します(DualQuaternion::TransformNormal() と同じ結果).
+//-------------------------------------------------------------------------------------------------
+inline void RotateSoA( const __m128* q, __m128& x, __m128& y, __m128& z )
+{
+    auto two = _mm_set1_ps( 2.0f );
+    auto tx  = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( q[1], z ), _mm_mul_ps( q[2], y ) ), _mm_mul_ps( q[3], x ) );
+    auto ty  = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( q[2], x ), _mm_mul_ps( q[0], z ) ), _mm_mul_ps( q[3], y ) );
+    auto tz  = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( q[0], y ), _mm_mul_ps( q[1], x ) ), _mm_mul_ps( q[3], z ) );
+
+    x = _mm_add_ps( x, _mm_mul_ps( two, _mm_sub_ps( _mm_mul_ps( q[1], tz ), _mm_mul_ps( q[2], ty ) ) ) );
+    y = _mm_add_ps( y, _mm_mul_ps( two, _mm_sub_ps( _mm_mul_ps( q[2], tx ), _mm_mul_ps( q[0], tz ) ) ) );
+    z = _mm_add_ps( z, _mm_mul_ps( two, _mm_sub_ps( _mm_mul_ps( q[0], ty ), _mm_mul_ps( q[1], tx ) ) ) );
+}
+#endif//ASVK_IS_SIMD
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+//-------------------------------------------------------------------------------------------------
+//      float型の配列をまとめてhalf型に変換します.
+//-------------------------------------------------------------------------------------------------
+void F32ToF16( const float* pValues, half* pResults, size_t count )
+{
+    assert( count == 0 || ( pValues != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+  #if ASVK_IS_F16C
+    for( ; i + 8 <= count; i += 8 )
+    {
+        auto v = _mm256_loadu_ps( pValues + i );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pResults + i ), _mm256_cvtps_ph( v, _MM_FROUND_TO_NEAREST_INT ) );
+    }
+  #else
+    for( ; i + 8 <= count; i += 8 )
+    {
+        auto lo = F32ToF16x4( _mm_loadu_ps( pValues + i + 0 ) );
+        auto hi = F32ToF16x4( _mm_loadu_ps( pValues + i + 4 ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pResults + i ), _mm_packs_epi32( lo, hi ) );
+    }
+  #endif//ASVK_IS_F16C
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = F32ToF16( pValues[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      half型の配列をまとめてfloat型に変換します.
+//-------------------------------------------------------------------------------------------------
+void F16ToF32( const half* pValues, float* pResults, size_t count )
+{
+    assert( count == 0 || ( pValues != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+  #if ASVK_IS_F16C
+    for( ; i + 8 <= count; i += 8 )
+    {
+        auto v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pValues + i ) );
+        _mm256_storeu_ps( pResults + i, _mm256_cvtph_ps( v ) );
+    }
+  #else
+    for( ; i + 8 <= count; i += 8 )
+    {
+        auto v    = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pValues + i ) );
+        auto zero = _mm_setzero_si128();
+        _mm_storeu_ps( pResults + i + 0, F16ToF32x4( _mm_unpacklo_epi16( v, zero ) ) );
+        _mm_storeu_ps( pResults + i + 4, F16ToF32x4( _mm_unpackhi_epi16( v, zero ) ) );
+    }
+  #endif//ASVK_IS_F16C
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = F16ToF32( pValues[i] ); }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+//      単位ベクトルの配列をまとめて2x16bitの八面体写像に符号化します.
+//-------------------------------------------------------------------------------------------------
+void EncodeOctahedral16( const Vector3* pValues, uint32_t* pResults, size_t count )
+{
+    assert( count == 0 || ( pValues != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    for( ; i + 4 <= count; i += 4 )
+    {
+        __m128 vx, vy, vz, x, y;
+        detail::LoadVector3x4( pValues + i, vx, vy, vz );
+        OctahedralWrap( vx, vy, vz, x, y );
+
+        auto qx = _mm_sub_epi32( QuantizeSnorm( x, detail::OCT16_SCALE ), _mm_set1_epi32( 32767 ) );
+        auto qy = _mm_sub_epi32( QuantizeSnorm( y, detail::OCT16_SCALE ), _mm_set1_epi32( 32767 ) );
+        auto r  = _mm_or_si128( _mm_and_si128( qx, _mm_set1_epi32( 0xFFFF ) ), _mm_slli_epi32( qy, 16 ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pResults + i ), r );
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = EncodeOctahedral16( pValues[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2x16bitの八面体写像の配列をまとめて単位ベクトルに復号します.
+//-------------------------------------------------------------------------------------------------
+void DecodeOctahedral16( const uint32_t* pValues, Vector3* pResults, size_t count )
+{
+    assert( count == 0 || ( pValues != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    for( ; i + 4 <= count; i += 4 )
+    {
+        auto v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pValues + i ) );
+        auto x = DequantizeSnorm( _mm_srai_epi32( _mm_slli_epi32( v, 16 ), 16 ), detail::OCT16_SCALE );
+        auto y = DequantizeSnorm( _mm_srai_epi32( v, 16 ), detail::OCT16_SCALE );
+
+        __m128 rx, ry, rz;
+        OctahedralUnwrap( x, y, rx, ry, rz );
+        detail::StoreVector3x4( pResults + i, rx, ry, rz );
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = DecodeOctahedral16( pValues[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      単位ベクトルの配列をまとめて2x8bitの八面体写像に符号化します.
+//-------------------------------------------------------------------------------------------------
+void EncodeOctahedral8( const Vector3* pValues, uint16_t* pResults, size_t count )
+{
+    assert( count == 0 || ( pValues != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    for( ; i + 4 <= count; i += 4 )
+    {
+        __m128 vx, vy, vz, x, y;
+        detail::LoadVector3x4( pValues + i, vx, vy, vz );
+        OctahedralWrap( vx, vy, vz, x, y );
+
+        auto qx = _mm_sub_epi32( QuantizeSnorm( x, detail::OCT8_SCALE ), _mm_set1_epi32( 127 ) );
+        auto qy = _mm_sub_epi32( QuantizeSnorm( y, detail::OCT8_SCALE ), _mm_set1_epi32( 127 ) );
+
+        // Y を符号付きのまま上位に置き，packs_epi32 の飽和に掛からないようにする.
+        auto r = _mm_or_si128( _mm_and_si128( qx, _mm_set1_epi32( 0xFF ) ), _mm_slli_epi32( qy, 8 ) );
+        _mm_storel_epi64( reinterpret_cast<__m128i*>( pResults + i ), _mm_packs_epi32( r, r ) );
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = EncodeOctahedral8( pValues[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2x8bitの八面体写像の配列をまとめて単位ベクトルに復号します.
+//-------------------------------------------------------------------------------------------------
+void DecodeOctahedral8( const uint16_t* pValues, Vector3* pResults, size_t count )
+{
+    assert( count == 0 || ( pValues != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    for( ; i + 4 <= count; i += 4 )
+    {
+        auto v = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( pValues + i ) );
+        v = _mm_unpacklo_epi16( v, _mm_setzero_si128() );
+        auto x = DequantizeSnorm( _mm_srai_epi32( _mm_slli_epi32( v, 24 ), 24 ), detail::OCT8_SCALE );
+        auto y = DequantizeSnorm( _mm_srai_epi32( _mm_slli_epi32( v, 16 ), 24 ), detail::OCT8_SCALE );
+
+        __m128 rx, ry, rz;
+        OctahedralUnwrap( x, y, rx, ry, rz );
+        detail::StoreVector3x4( pResults + i, rx, ry, rz );
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = DecodeOctahedral8( pValues[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      接線空間の回転の配列をまとめてQTangentに符号化します.
+//-------------------------------------------------------------------------------------------------
+void EncodeQTangent( const Quaternion* pRotations, const float* pHandedness, uint32_t* pResults, size_t count )
+{
+    assert( count == 0 || ( pRotations != nullptr && pHandedness != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    for( ; i + 4 <= count; i += 4 )
+    {
+        auto x = detail::LoadFloat4( &pRotations[i + 0].x );
+        auto y = detail::LoadFloat4( &pRotations[i + 1].x );
+        auto z = detail::LoadFloat4( &pRotations[i + 2].x );
+        auto w = detail::LoadFloat4( &pRotations[i + 3].x );
+        _MM_TRANSPOSE4_PS( x, y, z, w );
+
+        // 絶対値最大の成分(同値の場合は後ろの成分を優先).
+        auto mx  = _mm_max_ps( _mm_max_ps( Abs( x ), Abs( y ) ), _mm_max_ps( Abs( z ), Abs( w ) ) );
+        auto isW = _mm_cmpeq_ps( Abs( w ), mx );
+        auto isZ = _mm_andnot_ps( isW, _mm_cmpeq_ps( Abs( z ), mx ) );
+        auto isY = _mm_andnot_ps( _mm_or_ps( isW, isZ ), _mm_cmpeq_ps( Abs( y ), mx ) );
+        auto isX = _mm_andnot_ps( _mm_or_ps( _mm_or_ps( isW, isZ ), isY ), _mm_castsi128_ps( _mm_set1_epi32( -1 ) ) );
+
+        auto drop = Select( isW, w, Select( isZ, z, Select( isY, y, x ) ) );
+        auto sign = Select( _mm_cmplt_ps( drop, _mm_setzero_ps() ), _mm_set1_ps( -1.0f ), _mm_set1_ps( 1.0f ) );
+
+        __m128i q[4];
+        __m128  c[4] = { x, y, z, w };
+        for( auto j = 0; j < 4; ++j )
+        {
+            auto v = _mm_mul_ps( _mm_mul_ps( c[j], sign ), _mm_set1_ps( detail::QTANGENT_SQRT2 ) );
+            v = _mm_max_ps( _mm_min_ps( v, _mm_set1_ps( 1.0f ) ), _mm_set1_ps( -1.0f ) );
+            q[j] = QuantizeSnorm( v, detail::QTANGENT_SCALE );
+        }
+
+        auto a = Select( _mm_castps_si128( isX ), q[1], q[0] );
+        auto b = Select( _mm_castps_si128( _mm_or_ps( isX, isY ) ), q[2], q[1] );
+        auto d = Select( _mm_castps_si128( isW ), q[2], q[3] );
+
+        auto index = _mm_or_si128(
+            _mm_and_si128( _mm_castps_si128( isW ), _mm_set1_epi32( 3 ) ),
+            _mm_or_si128(
+                _mm_and_si128( _mm_castps_si128( isZ ), _mm_set1_epi32( 2 ) ),
+                _mm_and_si128( _mm_castps_si128( isY ), _mm_set1_epi32( 1 ) ) ) );
+        auto flip = _mm_and_si128(
+            _mm_castps_si128( _mm_cmplt_ps( _mm_loadu_ps( pHandedness + i ), _mm_setzero_ps() ) ),
+            _mm_set1_epi32( 1 << 29 ) );
+
+        auto r = _mm_or_si128( a, _mm_slli_epi32( b, 9 ) );
+        r = _mm_or_si128( r, _mm_slli_epi32( d, 18 ) );
+        r = _mm_or_si128( r, _mm_slli_epi32( index, 27 ) );
+        r = _mm_or_si128( r, flip );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pResults + i ), r );
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = EncodeQTangent( pRotations[i], pHandedness[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      QTangentの配列をまとめて接線空間の回転に復号します.
+//-------------------------------------------------------------------------------------------------
+void DecodeQTangent( const uint32_t* pValues, Quaternion* pRotations, float* pHandedness, size_t count )
+{
+    assert( count == 0 || ( pValues != nullptr && pRotations != nullptr && pHandedness != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    const auto scale = ( 1.0f / detail::QTANGENT_SCALE ) * ( 1.0f / detail::QTANGENT_SQRT2 );
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        auto v    = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pValues + i ) );
+        auto mask = _mm_set1_epi32( 0x1FF );
+        auto bias = _mm_set1_epi32( 255 );
+        auto k    = _mm_set1_ps( scale );
+
+        auto a = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( _mm_and_si128( v, mask ), bias ) ), k );
+        auto b = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( _mm_and_si128( _mm_srli_epi32( v,  9 ), mask ), bias ) ), k );
+        auto c = _mm_mul_ps( _mm_cvtepi32_ps( _mm_sub_epi32( _mm_and_si128( _mm_srli_epi32( v, 18 ), mask ), bias ) ), k );
+
+        auto r = _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), _mm_mul_ps( a, a ) ), _mm_mul_ps( b, b ) ), _mm_mul_ps( c, c ) );
+        auto d = _mm_sqrt_ps( _mm_max_ps( r, _mm_setzero_ps() ) );
+
+        auto index = _mm_and_si128( _mm_srli_epi32( v, 27 ), _mm_set1_epi32( 0x3 ) );
+        auto is0   = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_setzero_si128() ) );
+        auto is1   = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 1 ) ) );
+        auto is2   = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 2 ) ) );
+        auto is3   = _mm_castsi128_ps( _mm_cmpeq_epi32( index, _mm_set1_epi32( 3 ) ) );
+
+        auto x = Select( is0, d, a );
+        auto y = Select( is0, a, Select( is1, d, b ) );
+        auto z = Select( is3, c, Select( is2, d, b ) );
+        auto w = Select( is3, d, c );
+        _MM_TRANSPOSE4_PS( x, y, z, w );
+        detail::StoreFloat4( &pRotations[i + 0].x, x );
+        detail::StoreFloat4( &pRotations[i + 1].x, y );
+        detail::StoreFloat4( &pRotations[i + 2].x, z );
+        detail::StoreFloat4( &pRotations[i + 3].x, w );
+
+        auto flip = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( v, _mm_set1_epi32( 1 << 29 ) ), _mm_setzero_si128() ) );
+        _mm_storeu_ps( pHandedness + i, Select( flip, _mm_set1_ps( 1.0f ), _mm_set1_ps( -1.0f ) ) );
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { DecodeQTangent( pValues[i], pRotations[i], pHandedness[i] ); }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Vector3 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，複数のベクトルをまとめて変換します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::Transform( const Vector3* pPositions, const Matrix& matrix, Vector3* pResults, size_t count )
+{
+    assert( count == 0 || ( pPositions != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+  #if ASVK_IS_AVX
+    {
+        __m256 m[16];
+        detail::BroadcastMatrix( matrix, m );
+
+        for( ; i + 8 <= count; i += 8 )
+        {
+            __m256 x, y, z;
+            detail::LoadVector3x8( pPositions + i, x, y, z );
+            detail::TransformSoA( x, y, z, m, x, y, z );
+            detail::StoreVector3x8( pResults + i, x, y, z );
+        }
+    }
+  #endif//ASVK_IS_AVX
+    {
+        __m128 m[16];
+        detail::BroadcastMatrix( matrix, m );
+
+        for( ; i + 4 <= count; i += 4 )
+        {
+            __m128 x, y, z;
+            detail::LoadVector3x4( pPositions + i, x, y, z );
+            detail::TransformSoA( x, y, z, m, x, y, z );
+            detail::StoreVector3x4( pResults + i, x, y, z );
+        }
+    }
+#endif//ASVK_IS_SIMD
+
+    // 端数 (pResults == pPositions でも安全なように戻り値版を使う).
+    for( ; i < count; ++i )
+    { pResults[i] = Vector3::Transform( pPositions[i], matrix ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて，複数の法線ベクトルをまとめて変換します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::TransformNormal( const Vector3* pNormals, const Matrix& matrix, Vector3* pResults, size_t count )
+{
+    assert( count == 0 || ( pNormals != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+  #if ASVK_IS_AVX
+    {
+        __m256 m[16];
+        detail::BroadcastMatrix( matrix, m );
+
+        for( ; i + 8 <= count; i += 8 )
+        {
+            __m256 x, y, z;
+            detail::LoadVector3x8( pNormals + i, x, y, z );
+            detail::TransformNormalSoA( x, y, z, m, x, y, z );
+            detail::StoreVector3x8( pResults + i, x, y, z );
+        }
+    }
+  #endif//ASVK_IS_AVX
+    {
+        __m128 m[16];
+        detail::BroadcastMatrix( matrix, m );
+
+        for( ; i + 4 <= count; i += 4 )
+        {
+            __m128 x, y, z;
+            detail::LoadVector3x4( pNormals + i, x, y, z );
+            detail::TransformNormalSoA( x, y, z, m, x, y, z );
+            detail::StoreVector3x4( pResults + i, x, y, z );
+        }
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = Vector3::TransformNormal( pNormals[i], matrix ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定された行列を用いて複数のベクトルをまとめて変換し，変換結果をw=1に射影します.
+//-------------------------------------------------------------------------------------------------
+void Vector3::TransformCoord( const Vector3* pCoords, const Matrix& matrix, Vector3* pResults, size_t count )
+{
+    assert( count == 0 || ( pCoords != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+  #if ASVK_IS_AVX
+    {
+        __m256 m[16];
+        detail::BroadcastMatrix( matrix, m );
+
+        for( ; i + 8 <= count; i += 8 )
+        {
+            __m256 x, y, z;
+            detail::LoadVector3x8( pCoords + i, x, y, z );
+            detail::TransformCoordSoA( x, y, z, m, x, y, z );
+            detail::StoreVector3x8( pResults + i, x, y, z );
+        }
+    }
+  #endif//ASVK_IS_AVX
+    {
+        __m128 m[16];
+        detail::BroadcastMatrix( matrix, m );
+
+        for( ; i + 4 <= count; i += 4 )
+        {
+            __m128 x, y, z;
+            detail::LoadVector3x4( pCoords + i, x, y, z );
+            detail::TransformCoordSoA( x, y, z, m, x, y, z );
+            detail::StoreVector3x4( pResults + i, x, y, z );
+        }
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = Vector3::TransformCoord( pCoords[i], matrix ); }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Matrix structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      複数の行列の乗算をまとめて行います.
+//-------------------------------------------------------------------------------------------------
+void Matrix::MultiplyBatch( const Matrix* pA, const Matrix* pB, Matrix* pResults, size_t count )
+{
+    assert( count == 0 || ( pA != nullptr && pB != nullptr && pResults != nullptr ) );
+    auto n = static_cast<int64_t>( count );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel for if( n >= MULTIPLY_PARALLEL_THRESHOLD )
+#endif
+    for( int64_t i=0; i<n; ++i )
+    { pResults[i] = Matrix::Multiply( pA[i], pB[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      平坦化された階層構造の行列を親から順に乗算します.
+//-------------------------------------------------------------------------------------------------
+void Matrix::MultiplyHierarchy( const Matrix* pLocals, const int32_t* pParents, Matrix* pResults, size_t count )
+{
+    assert( count == 0 || ( pLocals != nullptr && pParents != nullptr && pResults != nullptr ) );
+    auto n = static_cast<int64_t>( count );
+
+    int64_t start = 0;
+    while( start < n )
+    {
+        // 親が区間より前にある要素が続く限り区間を伸ばす. 区間内は互いに独立に計算できる.
+        auto end = start + 1;
+        while( end < n && pParents[end] < start )
+        { end++; }
+
+    #if ASVK_IS_OPENMP
+        #pragma omp parallel for if( end - start >= MULTIPLY_PARALLEL_THRESHOLD )
+    #endif
+        for( int64_t i=start; i<end; ++i )
+        {
+            auto parent = pParents[i];
+            assert( parent < i );
+
+            if ( parent < 0 )
+            { pResults[i] = pLocals[i]; }
+            else
+            { Matrix::Multiply( pLocals[i], pResults[parent], pResults[i] ); }
+        }
+
+        start = end;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列パレットによる線形ブレンドスキニングをまとめて行います.
+//-------------------------------------------------------------------------------------------------
+void Matrix::Skin
+(
+    const Matrix*       pBones,
+    const Vector3*      pPositions,
+    const Vector3*      pNormals,
+    const uint16_t*     pIndices,
+    const float*        pWeights,
+    Vector3*            pResultPositions,
+    Vector3*            pResultNormals,
+    size_t              count
+)
+{
+    assert( count == 0 || ( pBones != nullptr && pPositions != nullptr && pIndices != nullptr && pWeights != nullptr && pResultPositions != nullptr ) );
+    assert( pNormals == nullptr || pResultNormals != nullptr );
+
+    for( size_t i=0; i<count; ++i )
+    {
+        auto indices = pIndices + i * 4;
+        auto weights = pWeights + i * 4;
+        const auto& p = pPositions[i];
+
+        float pos[4];
+        float nrm[4];
+
+    #if ASVK_IS_SIMD
+        // 1頂点分の行列を行単位でブレンドする.
+        __m128 r[4];
+        {
+            const auto& m = pBones[ indices[0] ];
+            auto w = _mm_set1_ps( weights[0] );
+            for( auto j=0; j<4; ++j )
+            { r[j] = _mm_mul_ps( detail::LoadFloat4( m.m[j] ), w ); }
+        }
+        for( auto k=1; k<4; ++k )
+        {
+            const auto& m = pBones[ indices[k] ];
+            auto w = _mm_set1_ps( weights[k] );
+            for( auto j=0; j<4; ++j )
+            { r[j] = _mm_add_ps( r[j], _mm_mul_ps( detail::LoadFloat4( m.m[j] ), w ) ); }
+        }
+
+        _mm_storeu_ps( pos, _mm_add_ps( _mm_add_ps( _mm_add_ps(
+            _mm_mul_ps( _mm_set1_ps( p.x ), r[0] ),
+            _mm_mul_ps( _mm_set1_ps( p.y ), r[1] ) ),
+            _mm_mul_ps( _mm_set1_ps( p.z ), r[2] ) ),
+            r[3] ) );
+
+        if ( pNormals != nullptr )
+        {
+            const auto& n = pNormals[i];
+            _mm_storeu_ps( nrm, _mm_add_ps( _mm_add_ps(
+                _mm_mul_ps( _mm_set1_ps( n.x ), r[0] ),
+                _mm_mul_ps( _mm_set1_ps( n.y ), r[1] ) ),
+                _mm_mul_ps( _mm_set1_ps( n.z ), r[2] ) ) );
+        }
+    #else
+        float r[4][3];
+        {
+            const auto& m = pBones[ indices[0] ];
+            for( auto j=0; j<4; ++j )
+            for( auto c=0; c<3; ++c )
+            { r[j][c] = m.m[j][c] * weights[0]; }
+        }
+        for( auto k=1; k<4; ++k )
+        {
+            const auto& m = pBones[ indices[k] ];
+            for( auto j=0; j<4; ++j )
+            for( auto c=0; c<3; ++c )
+            { r[j][c] = r[j][c] + m.m[j][c] * weights[k]; }
+        }
+
+        for( auto c=0; c<3; ++c )
+        { pos[c] = ( ( p.x * r[0][c] + p.y * r[1][c] ) + p.z * r[2][c] ) + r[3][c]; }
+
+        if ( pNormals != nullptr )
+        {
+            const auto& n = pNormals[i];
+            for( auto c=0; c<3; ++c )
+            { nrm[c] = ( n.x * r[0][c] + n.y * r[1][c] ) + n.z * r[2][c]; }
+        }
+    #endif//ASVK_IS_SIMD
+
+        pResultPositions[i] = Vector3( pos[0], pos[1], pos[2] );
+
+        if ( pNormals != nullptr )
+        {
+            // 重み付き平均で長さが変わるので正規化し直す.
+            auto lenSq = nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2];
+            auto inv   = ( lenSq > 0.0f ) ? 1.0f / sqrtf( lenSq ) : 0.0f;
+            pResultNormals[i] = Vector3( nrm[0] * inv, nrm[1] * inv, nrm[2] * inv );
+        }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DualQuaternion structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      双対四元数によるスキニングをまとめて行います.
+//-------------------------------------------------------------------------------------------------
+void DualQuaternion::Skin
+(
+    const DualQuaternion*   pBones,
+    const Vector3*          pPositions,
+    const Vector3*          pNormals,
+    const uint16_t*         pIndices,
+    const float*            pWeights,
+    Vector3*                pResultPositions,
+    Vector3*                pResultNormals,
+    size_t                  count
+)
+{
+    assert( count == 0 || ( pBones != nullptr && pPositions != nullptr && pIndices != nullptr && pWeights != nullptr && pResultPositions != nullptr ) );
+    assert( pNormals == nullptr || pResultNormals != nullptr );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    // 4頂点ずつSoA形式でブレンドする. 演算順序は Blend(), Transform() と同じ.
+    for( ; i + 4 <= count; i += 4 )
+    {
+        auto indices = pIndices + i * 4;
+        auto weights = pWeights + i * 4;
+
+        __m128 w[4];
+        w[0] = _mm_loadu_ps( weights +  0 );
+        w[1] = _mm_loadu_ps( weights +  4 );
+        w[2] = _mm_loadu_ps( weights +  8 );
+        w[3] = _mm_loadu_ps( weights + 12 );
+        _MM_TRANSPOSE4_PS( w[0], w[1], w[2], w[3] );
+
+        __m128 b[8];
+        __m128 q[8];
+        __m128 pivot[4];
+        GatherDualQuaternion4( pBones, indices, 0, b );
+        for( auto j=0; j<8; ++j )
+        { q[j] = _mm_mul_ps( b[j], w[0] ); }
+        for( auto j=0; j<4; ++j )
+        { pivot[j] = b[j]; }
+
+        for( size_t k=1; k<4; ++k )
+        {
+            GatherDualQuaternion4( pBones, indices, k, b );
+
+            auto dot  = _mm_add_ps( _mm_add_ps( _mm_add_ps(
+                            _mm_mul_ps( b[0], pivot[0] ), _mm_mul_ps( b[1], pivot[1] ) ),
+                            _mm_mul_ps( b[2], pivot[2] ) ),
+                            _mm_mul_ps( b[3], pivot[3] ) );
+            auto flip = _mm_and_ps( _mm_cmplt_ps( dot, _mm_setzero_ps() ), _mm_set1_ps( -0.0f ) );
+            auto wk   = _mm_xor_ps( w[k], flip );
+
+            for( auto j=0; j<8; ++j )
+            { q[j] = _mm_add_ps( q[j], _mm_mul_ps( b[j], wk ) ); }
+        }
+
+        auto lenSq = _mm_add_ps( _mm_add_ps( _mm_add_ps(
+                        _mm_mul_ps( q[0], q[0] ), _mm_mul_ps( q[1], q[1] ) ),
+                        _mm_mul_ps( q[2], q[2] ) ),
+                        _mm_mul_ps( q[3], q[3] ) );
+        auto inv = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( lenSq ) );
+        for( auto j=0; j<8; ++j )
+        { q[j] = _mm_mul_ps( q[j], inv ); }
+
+        // 平行移動量 t = 2 * ( q.w * d.xyz - d.w * q.xyz + q.xyz x d.xyz ).
+        auto two = _mm_set1_ps( 2.0f );
+        auto ux  = _mm_mul_ps( two, _mm_add_ps(
+                        _mm_sub_ps( _mm_mul_ps( q[3], q[4] ), _mm_mul_ps( q[7], q[0] ) ),
+                        _mm_sub_ps( _mm_mul_ps( q[1], q[6] ), _mm_mul_ps( q[2], q[5] ) ) ) );
+        auto uy  = _mm_mul_ps( two, _mm_add_ps(
+                        _mm_sub_ps( _mm_mul_ps( q[3], q[5] ), _mm_mul_ps( q[7], q[1] ) ),
+                        _mm_sub_ps( _mm_mul_ps( q[2], q[4] ), _mm_mul_ps( q[0], q[6] ) ) ) );
+        auto uz  = _mm_mul_ps( two, _mm_add_ps(
+                        _mm_sub_ps( _mm_mul_ps( q[3], q[6] ), _mm_mul_ps( q[7], q[2] ) ),
+                        _mm_sub_ps( _mm_mul_ps( q[0], q[5] ), _mm_mul_ps( q[1], q[4] ) ) ) );
+
+        __m128 x, y, z;
+        detail::LoadVector3x4( pPositions + i, x, y, z );
+        RotateSoA( q, x, y, z );
+        detail::StoreVector3x4( pResultPositions + i, _mm_add_ps( x, ux ), _mm_add_ps( y, uy ), _mm_add_ps( z, uz ) );
+
+        if ( pNormals != nullptr )
+        {
+            detail::LoadVector3x4( pNormals + i, x, y, z );
+            RotateSoA( q, x, y, z );
+            detail::StoreVector3x4( pResultNormals + i, x, y, z );
+        }
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    {
+        auto indices = pIndices + i * 4;
+        DualQuaternion bones[4] = {
+            pBones[ indices[0] ],
+            pBones[ indices[1] ],
+            pBones[ indices[2] ],
+            pBones[ indices[3] ],
+        };
+        auto blended = Blend( bones, pWeights + i * 4, 4 );
+
+        pResultPositions[i] = Transform( pPositions[i], blended );
+        if ( pNormals != nullptr )
+        { pResultNormals[i] = TransformNormal( pNormals[i], blended ); }
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// OrthonormalBasis structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      W方向の配列から複数の基底をまとめて構築します.
+//-------------------------------------------------------------------------------------------------
+void OrthonormalBasis::CreateFromW( const Vector3* pValues, OrthonormalBasis* pResults, size_t count )
+{
+    static_assert( sizeof( OrthonormalBasis ) == sizeof( float ) * 9, "OrthonormalBasis must be tightly packed." );
+    assert( count == 0 || ( pValues != nullptr && pResults != nullptr ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    const auto one  = _mm_set1_ps( 1.0f );
+    const auto sgn  = _mm_set1_ps( -0.0f );
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        // InitFromW() と同じ演算順序.
+        __m128 x, y, z;
+        detail::LoadVector3x4( pValues + i, x, y, z );
+        auto mag = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) ) );
+        x = _mm_div_ps( x, mag );
+        y = _mm_div_ps( y, mag );
+        z = _mm_div_ps( z, mag );
+
+        auto sign = _mm_or_ps( _mm_and_ps( z, sgn ), one );
+        auto a    = _mm_div_ps( _mm_set1_ps( -1.0f ), _mm_add_ps( sign, z ) );
+        auto b    = _mm_mul_ps( _mm_mul_ps( x, y ), a );
+
+        __m128 r[9];
+        r[0] = _mm_add_ps( one, _mm_mul_ps( _mm_mul_ps( _mm_mul_ps( sign, x ), x ), a ) );
+        r[1] = _mm_mul_ps( sign, b );
+        r[2] = _mm_mul_ps( _mm_xor_ps( sign, sgn ), x );
+        r[3] = b;
+        r[4] = _mm_add_ps( sign, _mm_mul_ps( _mm_mul_ps( y, y ), a ) );
+        r[5] = _mm_xor_ps( y, sgn );
+        r[6] = x;
+        r[7] = y;
+        r[8] = z;
+
+        // SoA(9成分x4) を AoS(4基底x9成分) に並べ替えて書き出す.
+        _MM_TRANSPOSE4_PS( r[0], r[1], r[2], r[3] );
+        _MM_TRANSPOSE4_PS( r[4], r[5], r[6], r[7] );
+
+        float* dst = &pResults[i].u.x;
+        for( auto j=0; j<4; ++j )
+        {
+            _mm_storeu_ps( dst + j * 9 + 0, r[j + 0] );
+            _mm_storeu_ps( dst + j * 9 + 4, r[j + 4] );
+        }
+        float last[4];
+        _mm_storeu_ps( last, r[8] );
+        dst[ 8] = last[0];
+        dst[17] = last[1];
+        dst[26] = last[2];
+        dst[35] = last[3];
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i].InitFromW( pValues[i] ); }
+}
+
+} // namespace asvk
@@ -10,6 +10,260 @@
 #include <asvkMath.h>
 
 
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr uint32_t LANE_COUNT = 8;                   //!< 多レーン生成のレーン数です.
+static constexpr float    F32_UNIT   = 1.0f / 16777216.0f;  //!< 24bit整数を[0, 1)に写す係数(2^-24)です.
+
+static constexpr size_t   STREAM_FILL_BLOCK = 16384;        //!< RandomStreamの一括生成で1系列が受け持つ個数です.
+static constexpr size_t   STREAM_FILL_ROUND = 64;           //!< RandomStreamの一括生成で1度に並列化するブロック数です.
+
+// xoshiro128** のジャンプ多項式 (2^64 および 2^96 ステップ).
+static constexpr uint32_t STREAM_JUMP[4]      = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+static constexpr uint32_t STREAM_LONG_JUMP[4] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+
+// SinCosFast() と同じ [-π/2, π/2] 上の近似多項式の係数.
+static constexpr float SIN_C0 = -2.3889859e-08f;
+static constexpr float SIN_C1 =  2.7525562e-06f;
+static constexpr float SIN_C2 = -0.00019840874f;
+static constexpr float SIN_C3 =  0.0083333310f;
+static constexpr float SIN_C4 = -0.16666667f;
+static constexpr float COS_C0 = -2.6051615e-07f;
+static constexpr float COS_C1 =  2.4760495e-05f;
+static constexpr float COS_C2 = -0.0013888378f;
+static constexpr float COS_C3 =  0.041666638f;
+static constexpr float COS_C4 = -0.5f;
+
+
+//-------------------------------------------------------------------------------------------------
+//      32bit値を攪拌します(MurmurHash3 の fmix32).
+//-------------------------------------------------------------------------------------------------
+inline uint32_t Mix32( uint32_t value )
+{
+    value ^= value >> 16;
+    value *= 0x85ebca6bu;
+    value ^= value >> 13;
+    value *= 0xc2b2ae35u;
+    value ^= value >> 16;
+    return value;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全レーンを1ステップ進め，8個の乱数を返却します.
+//-------------------------------------------------------------------------------------------------
+inline void NextLanes( uint32_t (&state)[4][LANE_COUNT], uint32_t (&result)[LANE_COUNT] )
+{
+    for( auto k = 0u; k < LANE_COUNT; ++k )
+    {
+        auto t = state[0][k] ^ ( state[0][k] << 11 );
+        state[0][k] = state[1][k];
+        state[1][k] = state[2][k];
+        state[2][k] = state[3][k];
+        state[3][k] = ( state[3][k] ^ ( state[3][k] >> 19 ) ) ^ ( t ^ ( t >> 8 ) );
+        result[k] = state[3][k];
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数の上位24bitを[0, 1)のfloat型に変換します.
+//-------------------------------------------------------------------------------------------------
+inline float ToUnitF32( uint32_t value )
+{ return static_cast<float>( static_cast<int32_t>( value >> 8 ) ) * F32_UNIT; }
+
+//-------------------------------------------------------------------------------------------------
+//      2つの乱数から単位ベクトルを生成します.
+//      ※ SIMD版の UnitVector3() と演算順序を一致させること.
+//-------------------------------------------------------------------------------------------------
+inline asvk::Vector3 UnitVector3( uint32_t u, uint32_t v )
+{
+    // z を [-1, 1) で一様に選ぶと球面上で一様になる(アルキメデスの定理).
+    auto z = ToUnitF32( u ) * 2.0f - 1.0f;
+    auto r = sqrtf( 1.0f - z * z );
+
+    // [-π/2, π/2) の角度と最下位bitによる反転で全周を覆う(範囲縮約が不要になる).
+    auto t  = ToUnitF32( v ) * asvk::F_PI - asvk::F_PIDIV2;
+    auto t2 = t * t;
+    auto s  = ( ( ( ( ( SIN_C0 * t2 + SIN_C1 ) * t2 + SIN_C2 ) * t2 + SIN_C3 ) * t2 + SIN_C4 ) * t2 + 1.0f ) * t;
+    auto c  = ( ( ( ( COS_C0 * t2 + COS_C1 ) * t2 + COS_C2 ) * t2 + COS_C3 ) * t2 + COS_C4 ) * t2 + 1.0f;
+    auto f  = ( v & 0x1 ) ? -1.0f : 1.0f;
+
+    return asvk::Vector3( ( r * c ) * f, ( r * s ) * f, z );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      左ローテートします.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t Rotl( uint32_t value, int shift )
+{ return ( value << shift ) | ( value >> ( 32 - shift ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      xoshiro128** の状態を1ステップ進め，乱数を返却します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t NextStream( uint32_t (&state)[4] )
+{
+    auto result = Rotl( state[1] * 5, 7 ) * 9;
+    auto t      = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3]  = Rotl( state[3], 11 );
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ジャンプ多項式を適用して xoshiro128** の状態を進めます.
+//-------------------------------------------------------------------------------------------------
+inline void JumpStream( uint32_t (&state)[4], const uint32_t (&table)[4] )
+{
+    uint32_t s[4] = { 0, 0, 0, 0 };
+    for( auto i = 0; i < 4; ++i )
+    {
+        for( auto b = 0; b < 32; ++b )
+        {
+            if ( table[i] & ( 1u << b ) )
+            {
+                s[0] ^= state[0];
+                s[1] ^= state[1];
+                s[2] ^= state[2];
+                s[3] ^= state[3];
+            }
+            NextStream( state );
+        }
+    }
+
+    memcpy( state, s, sizeof(s) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      配列をブロックに分け，各ブロックをJumpで分離した系列で埋めます.
+//      ※ ブロックの割り当てはスレッド数に依存しないので，結果は常に同一になります.
+//-------------------------------------------------------------------------------------------------
+template<typename FillFunc>
+void FillStreamBlocks( uint32_t (&state)[4], size_t count, FillFunc func )
+{
+    uint32_t blocks[STREAM_FILL_ROUND][4];
+
+    for( size_t head = 0; head < count; head += STREAM_FILL_BLOCK * STREAM_FILL_ROUND )
+    {
+        // 各ブロックの開始状態を逐次ジャンプで確定させる.
+        int64_t n = 0;
+        for( ; n < int64_t(STREAM_FILL_ROUND) && head + n * STREAM_FILL_BLOCK < count; ++n )
+        {
+            memcpy( blocks[n], state, sizeof(state) );
+            JumpStream( state, STREAM_JUMP );
+        }
+
+    #if ASVK_IS_OPENMP
+        #pragma omp parallel for if( n > 1 )
+    #endif
+        for( int64_t k=0; k<n; ++k )
+        {
+            auto begin = head + size_t(k) * STREAM_FILL_BLOCK;
+            auto end   = ( count - begin < STREAM_FILL_BLOCK ) ? count : begin + STREAM_FILL_BLOCK;
+            func( blocks[k], begin, end );
+        }
+    }
+}
+
+#if ASVK_IS_SIMD
+//-------------------------------------------------------------------------------------------------
+//      SSE2 レジスタ上に保持した全レーンの状態です.
+//-------------------------------------------------------------------------------------------------
+struct LaneState
+{
+    __m128i x[2];
+    __m128i y[2];
+    __m128i z[2];
+    __m128i w[2];
+
+    void Load( const uint32_t (&state)[4][LANE_COUNT] )
+    {
+        for( auto h = 0; h < 2; ++h )
+        {
+            x[h] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &state[0][h * 4] ) );
+            y[h] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &state[1][h * 4] ) );
+            z[h] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &state[2][h * 4] ) );
+            w[h] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( &state[3][h * 4] ) );
+        }
+    }
+
+    void Store( uint32_t (&state)[4][LANE_COUNT] ) const
+    {
+        for( auto h = 0; h < 2; ++h )
+        {
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( &state[0][h * 4] ), x[h] );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( &state[1][h * 4] ), y[h] );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( &state[2][h * 4] ), z[h] );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( &state[3][h * 4] ), w[h] );
+        }
+    }
+
+    // 全レーンを1ステップ進める. lo にレーン0-3，hi にレーン4-7 の乱数を返す.
+    void Next( __m128i& lo, __m128i& hi )
+    {
+        for( auto h = 0; h < 2; ++h )
+        {
+            auto t = _mm_xor_si128( x[h], _mm_slli_epi32( x[h], 11 ) );
+            x[h] = y[h];
+            y[h] = z[h];
+            z[h] = w[h];
+            w[h] = _mm_xor_si128(
+                _mm_xor_si128( w[h], _mm_srli_epi32( w[h], 19 ) ),
+                _mm_xor_si128( t,    _mm_srli_epi32( t,     8 ) ) );
+        }
+        lo = w[0];
+        hi = w[1];
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+//      乱数の上位24bitを[0, 1)のfloat型に変換します.
+//-------------------------------------------------------------------------------------------------
+inline __m128 ToUnitF32( __m128i value )
+{ return _mm_mul_ps( _mm_cvtepi32_ps( _mm_srli_epi32( value, 8 ) ), _mm_set1_ps( F32_UNIT ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      2つの乱数から4つの単位ベクトルを SoA 形式で生成します.
+//-------------------------------------------------------------------------------------------------
+inline void UnitVector3( __m128i u, __m128i v, __m128& x, __m128& y, __m128& z )
+{
+    auto one = _mm_set1_ps( 1.0f );
+    z = _mm_sub_ps( _mm_mul_ps( ToUnitF32( u ), _mm_set1_ps( 2.0f ) ), one );
+    auto r = _mm_sqrt_ps( _mm_sub_ps( one, _mm_mul_ps( z, z ) ) );
+
+    auto t  = _mm_sub_ps( _mm_mul_ps( ToUnitF32( v ), _mm_set1_ps( asvk::F_PI ) ), _mm_set1_ps( asvk::F_PIDIV2 ) );
+    auto t2 = _mm_mul_ps( t, t );
+
+    auto s = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( SIN_C0 ), t2 ), _mm_set1_ps( SIN_C1 ) );
+    s = _mm_add_ps( _mm_mul_ps( s, t2 ), _mm_set1_ps( SIN_C2 ) );
+    s = _mm_add_ps( _mm_mul_ps( s, t2 ), _mm_set1_ps( SIN_C3 ) );
+    s = _mm_add_ps( _mm_mul_ps( s, t2 ), _mm_set1_ps( SIN_C4 ) );
+    s = _mm_add_ps( _mm_mul_ps( s, t2 ), one );
+    s = _mm_mul_ps( s, t );
+
+    auto c = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( COS_C0 ), t2 ), _mm_set1_ps( COS_C1 ) );
+    c = _mm_add_ps( _mm_mul_ps( c, t2 ), _mm_set1_ps( COS_C2 ) );
+    c = _mm_add_ps( _mm_mul_ps( c, t2 ), _mm_set1_ps( COS_C3 ) );
+    c = _mm_add_ps( _mm_mul_ps( c, t2 ), _mm_set1_ps( COS_C4 ) );
+    c = _mm_add_ps( _mm_mul_ps( c, t2 ), one );
+
+    // 最下位bitを符号bitへ移して反転する(-1倍と同じ結果).
+    auto f = _mm_castsi128_ps( _mm_slli_epi32( v, 31 ) );
+    x = _mm_xor_ps( _mm_mul_ps( r, c ), f );
+    y = _mm_xor_ps( _mm_mul_ps( r, s ), f );
+}
+#endif//ASVK_IS_SIMD
+
+} // namespace /* anonymous */
+
+
 namespace asvk {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -33,6 +287,7 @@ Random::Random( const Random& random )
     m_Y = random.m_Y;
     m_Z = random.m_Z;
     m_W = random.m_W;
+    memcpy( m_Lane, random.m_Lane, sizeof(m_Lane) );
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -52,6 +307,32 @@ void Random::SetSeed( int seed )
     m_Y = 362436069;
     m_Z = 521288629;
     m_W = ( seed <= 0 ) ? 88675123 : seed;
+
+    // 多レーン用の状態を導出する. GetAsU32() の系列を変えないよう複製した状態を進め，
+    // 各レーンが同じ系列のずれにならないよう攪拌してから設定する.
+    uint32_t x = m_X;
+    uint32_t y = m_Y;
+    uint32_t z = m_Z;
+    uint32_t w = m_W;
+    for( auto j = 0u; j < 4; ++j )
+    {
+        for( auto k = 0u; k < LANE_COUNT; ++k )
+        {
+            uint32_t t = x ^ ( x << 11 );
+            x = y;
+            y = z;
+            z = w;
+            w = ( w ^ ( w >> 19 ) ) ^ ( t ^ ( t >> 8 ) );
+            m_Lane[j][k] = Mix32( w + k );
+        }
+    }
+
+    // xorshift は全ゼロが不動点になるので回避する.
+    for( auto k = 0u; k < LANE_COUNT; ++k )
+    {
+        if ( ( m_Lane[0][k] | m_Lane[1][k] | m_Lane[2][k] | m_Lane[3][k] ) == 0 )
+        { m_Lane[3][k] = 88675123; }
+    }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -156,6 +437,115 @@ double Random::GetAsF64( double a, double b )
     return x;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      8レーン並列に乱数を生成し，uint32_t型として配列に格納します.
+//-------------------------------------------------------------------------------------------------
+void Random::FillU32( uint32_t* pValues, size_t count )
+{
+    assert( count == 0 || pValues != nullptr );
+    uint32_t block[LANE_COUNT];
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    LaneState state;
+    state.Load( m_Lane );
+
+    for( ; i + LANE_COUNT <= count; i += LANE_COUNT )
+    {
+        __m128i lo, hi;
+        state.Next( lo, hi );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pValues + i + 0 ), lo );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pValues + i + 4 ), hi );
+    }
+
+    state.Store( m_Lane );
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; i += LANE_COUNT )
+    {
+        NextLanes( m_Lane, block );
+        auto n = ( count - i < LANE_COUNT ) ? count - i : LANE_COUNT;
+        memcpy( pValues + i, block, sizeof(uint32_t) * n );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8レーン並列に乱数を生成し，指定された値範囲のfloat型として配列に格納します.
+//-------------------------------------------------------------------------------------------------
+void Random::FillF32( float* pValues, size_t count, float a, float b )
+{
+    assert( count == 0 || pValues != nullptr );
+    uint32_t block[LANE_COUNT];
+    auto scale = b - a;
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    LaneState state;
+    state.Load( m_Lane );
+
+    auto vs = _mm_set1_ps( scale );
+    auto va = _mm_set1_ps( a );
+    for( ; i + LANE_COUNT <= count; i += LANE_COUNT )
+    {
+        __m128i lo, hi;
+        state.Next( lo, hi );
+        _mm_storeu_ps( pValues + i + 0, _mm_add_ps( _mm_mul_ps( ToUnitF32( lo ), vs ), va ) );
+        _mm_storeu_ps( pValues + i + 4, _mm_add_ps( _mm_mul_ps( ToUnitF32( hi ), vs ), va ) );
+    }
+
+    state.Store( m_Lane );
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; i += LANE_COUNT )
+    {
+        NextLanes( m_Lane, block );
+        auto n = ( count - i < LANE_COUNT ) ? count - i : LANE_COUNT;
+        for( size_t k = 0; k < n; ++k )
+        { pValues[i + k] = ToUnitF32( block[k] ) * scale + a; }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      8レーン並列に単位球面上に一様分布する単位ベクトルを生成し，配列に格納します.
+//-------------------------------------------------------------------------------------------------
+void Random::FillUnitVector3( Vector3* pValues, size_t count )
+{
+    assert( count == 0 || pValues != nullptr );
+    uint32_t u[LANE_COUNT];
+    uint32_t v[LANE_COUNT];
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    LaneState state;
+    state.Load( m_Lane );
+
+    for( ; i + LANE_COUNT <= count; i += LANE_COUNT )
+    {
+        __m128i u0, u1, v0, v1;
+        state.Next( u0, u1 );
+        state.Next( v0, v1 );
+
+        __m128 x, y, z;
+        UnitVector3( u0, v0, x, y, z );
+        detail::StoreVector3x4( pValues + i + 0, x, y, z );
+        UnitVector3( u1, v1, x, y, z );
+        detail::StoreVector3x4( pValues + i + 4, x, y, z );
+    }
+
+    state.Store( m_Lane );
+#endif//ASVK_IS_SIMD
+
+    // 1ブロック8個あたり2ステップ消費する(SIMD版と同じ順序).
+    for( ; i < count; i += LANE_COUNT )
+    {
+        NextLanes( m_Lane, u );
+        NextLanes( m_Lane, v );
+        auto n = ( count - i < LANE_COUNT ) ? count - i : LANE_COUNT;
+        for( size_t k = 0; k < n; ++k )
+        { pValues[i + k] = UnitVector3( u[k], v[k] ); }
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 //      代入演算子です.
 //-------------------------------------------------------------------------------------------------
@@ -165,6 +555,7 @@ Random& Random::operator = ( const Random& random )
     m_Y = random.m_Y;
     m_Z = random.m_Z;
     m_W = random.m_W;
+    memcpy( m_Lane, random.m_Lane, sizeof(m_Lane) );
     return (*this);
 }
 
@@ -184,4 +575,150 @@ bool Random::operator != ( const Random& random ) const
     return  ( this != &random );
 }
 
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// RandomStream class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+RandomStream::RandomStream( uint64_t seed )
+{
+    SetSeed( seed );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      コピーコンストラクタです.
+//-------------------------------------------------------------------------------------------------
+RandomStream::RandomStream( const RandomStream& stream )
+{
+    memcpy( m_S, stream.m_S, sizeof(m_S) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+RandomStream::~RandomStream()
+{
+    /* DO_NOTHING */
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ランダム種を設定します.
+//-------------------------------------------------------------------------------------------------
+void RandomStream::SetSeed( uint64_t seed )
+{
+    // 近い種同士でも状態が離れるよう SplitMix64 で展開する.
+    for( auto i = 0; i < 2; ++i )
+    {
+        seed += 0x9e3779b97f4a7c15ull;
+        auto z = seed;
+        z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+        z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebull;
+        z = z ^ ( z >> 31 );
+
+        m_S[i * 2 + 0] = static_cast<uint32_t>( z );
+        m_S[i * 2 + 1] = static_cast<uint32_t>( z >> 32 );
+    }
+
+    // 全ゼロは不動点なので回避する.
+    if ( ( m_S[0] | m_S[1] | m_S[2] | m_S[3] ) == 0 )
+    { m_S[0] = 1; }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数をuint32_t型として取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t RandomStream::GetAsU32()
+{ return NextStream( m_S ); }
+
+//-------------------------------------------------------------------------------------------------
+//      乱数をfloat型として取得します.
+//-------------------------------------------------------------------------------------------------
+float RandomStream::GetAsF32()
+{ return ToUnitF32( NextStream( m_S ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      指定された値範囲で乱数をfloat型として取得します.
+//-------------------------------------------------------------------------------------------------
+float RandomStream::GetAsF32( float a, float b )
+{ return ToUnitF32( NextStream( m_S ) ) * ( b - a ) + a; }
+
+//-------------------------------------------------------------------------------------------------
+//      系列を2^64個分進めます.
+//-------------------------------------------------------------------------------------------------
+void RandomStream::Jump()
+{ JumpStream( m_S, STREAM_JUMP ); }
+
+//-------------------------------------------------------------------------------------------------
+//      系列を2^96個分進めます.
+//-------------------------------------------------------------------------------------------------
+void RandomStream::LongJump()
+{ JumpStream( m_S, STREAM_LONG_JUMP ); }
+
+//-------------------------------------------------------------------------------------------------
+//      ワーカースレッド用に独立した系列を生成します.
+//-------------------------------------------------------------------------------------------------
+RandomStream RandomStream::Split( uint32_t streamIndex ) const
+{
+    RandomStream result( *this );
+    for( uint64_t i = 0; i <= streamIndex; ++i )
+    { result.LongJump(); }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数をuint32_t型として配列に格納します.
+//-------------------------------------------------------------------------------------------------
+void RandomStream::FillU32( uint32_t* pValues, size_t count )
+{
+    assert( count == 0 || pValues != nullptr );
+    FillStreamBlocks( m_S, count, [pValues]( uint32_t (&state)[4], size_t begin, size_t end )
+    {
+        for( auto i = begin; i < end; ++i )
+        { pValues[i] = NextStream( state ); }
+    });
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定された値範囲の乱数をfloat型として配列に格納します.
+//-------------------------------------------------------------------------------------------------
+void RandomStream::FillF32( float* pValues, size_t count, float a, float b )
+{
+    assert( count == 0 || pValues != nullptr );
+    auto scale = b - a;
+    FillStreamBlocks( m_S, count, [pValues, scale, a]( uint32_t (&state)[4], size_t begin, size_t end )
+    {
+        for( auto i = begin; i < end; ++i )
+        { pValues[i] = ToUnitF32( NextStream( state ) ) * scale + a; }
+    });
+}
+
+//-------------------------------------------------------------------------------------------------
+//      代入演算子です.
+//-------------------------------------------------------------------------------------------------
+RandomStream& RandomStream::operator = ( const RandomStream& stream )
+{
+    memcpy( m_S, stream.m_S, sizeof(m_S) );
+    return (*this);
+}
+
+//-------------------------------------------------------------------------------------------------
+//      等価演算子です.
+//-------------------------------------------------------------------------------------------------
+bool RandomStream::operator == ( const RandomStream& stream ) const
+{
+    return memcmp( m_S, stream.m_S, sizeof(m_S) ) == 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      非等価演算子です.
+//-------------------------------------------------------------------------------------------------
+bool RandomStream::operator != ( const RandomStream& stream ) const
+{
+    return !( *this == stream );
+}
+
 } // namespace asvk
@@ -0,0 +1,973 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkSpatialHash.cpp
+// Desc : Spatial Hash Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkSpatialHash.h>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr uint32_t MIN_BUCKET_COUNT  = 16;               //!< ハッシュ表の最小の大きさです.
+static constexpr uint32_t MAX_BUCKET_COUNT  = 1u << 24;         //!< ハッシュ表の最大の大きさです.
+static constexpr uint32_t LANE_COUNT        = 4;                //!< 1ブロックに格納する物体数です.
+static constexpr uint32_t FULL_LANES        = 0xfu;             //!< 全てのレーンを表すマスクです.
+static constexpr uint32_t ALL_TESTS         = 0xffffffffu;      //!< セルの判定を省かない場合に判定関数に渡すマスクです.
+static constexpr float    CELL_MARGIN       = 1.0f / 64.0f;     //!< 丸め誤差に備えて検索範囲に足す, セルの大きさに対する割合です.
+static constexpr float    CELL_LIMIT        = 268435456.0f;     //!< セル座標の絶対値の上限です(2^28. 隣接セルを求めても溢れない範囲).
+static constexpr uint64_t CELL_VISIT_COST   = 4;                //!< セルを1つ辿るコストの, ブロックを1つ順に走査するコストに対する比です.
+static constexpr int32_t  LARGE_CELL        = INT32_MIN;        //!< 大きな物体のセル座標です(どのセルとも一致しません).
+
+
+//-------------------------------------------------------------------------------------------------
+//      座標を含むセルの座標を求めます.
+//-------------------------------------------------------------------------------------------------
+inline int32_t ToCell( float value, float invCellSize )
+{
+    auto cell = floorf( value * invCellSize );
+    if ( !( cell >= -CELL_LIMIT ) )     // NaN もここで丸めます.
+    { cell = -CELL_LIMIT; }
+    if ( cell > CELL_LIMIT )
+    { cell = CELL_LIMIT; }
+    return static_cast<int32_t>( cell );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      セル座標のハッシュ値を求めます.
+//      上位ビットをバケット番号に使うため, 最後にフィボナッチハッシュで混ぜます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t HashCell( int32_t x, int32_t y, int32_t z )
+{
+    auto hash = ( uint32_t( x ) * 73856093u ) ^ ( uint32_t( y ) * 19349663u ) ^ ( uint32_t( z ) * 83492791u );
+    return hash * 0x9e3779b1u;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      範囲内のセル数を求めます (上限で打ち切ります).
+//-------------------------------------------------------------------------------------------------
+inline uint64_t CountCells( const int32_t* pLower, const int32_t* pUpper, uint64_t limit )
+{
+    uint64_t result = 1;
+    for( auto i=0; i<3; ++i )
+    {
+        auto count = int64_t( pUpper[i] ) - int64_t( pLower[i] ) + 1;
+        if ( count <= 0 )
+        { return 0; }
+
+        result *= uint64_t( count );
+        if ( result > limit )
+        { return limit + 1; }
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      3平面の交点を求めます.
+//-------------------------------------------------------------------------------------------------
+inline bool IntersectPlanes( const asvk::Vector4& a, const asvk::Vector4& b, const asvk::Vector4& c, asvk::Vector3& result )
+{
+    auto na = asvk::Vector3( a.x, a.y, a.z );
+    auto nb = asvk::Vector3( b.x, b.y, b.z );
+    auto nc = asvk::Vector3( c.x, c.y, c.z );
+
+    auto bc  = asvk::Vector3::Cross( nb, nc );
+    auto det = asvk::Vector3::Dot( na, bc );
+    if ( fabsf( det ) < 1e-6f )
+    { return false; }
+
+    result = ( bc * a.w + asvk::Vector3::Cross( nc, na ) * b.w + asvk::Vector3::Cross( na, nb ) * c.w ) * ( -1.0f / det );
+    return std::isfinite( result.x ) && std::isfinite( result.y ) && std::isfinite( result.z );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物体が入っているレーンを求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t ValidLanes( const uint32_t* pHandle )
+{
+#if ASVK_IS_SIMD
+    auto empty = _mm_cmpeq_epi32( _mm_load_si128( reinterpret_cast<const __m128i*>( pHandle ) ), _mm_set1_epi32( -1 ) );
+    return ~static_cast<uint32_t>( _mm_movemask_ps( _mm_castsi128_ps( empty ) ) ) & FULL_LANES;
+#else
+    uint32_t mask = 0;
+    for( auto i=0u; i<LANE_COUNT; ++i )
+    {
+        if ( pHandle[i] != asvk::SpatialHash::INVALID_HANDLE )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      点からセルまでの1軸の距離を求めます.
+//      offset はセル内での点の位置, step は点を含むセルからのずれです.
+//-------------------------------------------------------------------------------------------------
+inline float CellGap( int32_t step, float offset, float cellSize )
+{
+    if ( step > 0 )
+    { return float( step - 1 ) * cellSize + ( cellSize - offset ); }
+    if ( step < 0 )
+    { return float( -step - 1 ) * cellSize + offset; }
+    return 0.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      近傍検索で ring 層目以降に辿るセル数を見積もります.
+//      count は走査済みの層で見つかった物体数, offset は点から最も近いセルの面までの距離です.
+//      揃っていない場合は, 走査済みのセルの物体密度から maxCount 個を含む球の半径を見積もります.
+//-------------------------------------------------------------------------------------------------
+inline float EstimateNearestCells
+(
+    int32_t     ring,
+    uint32_t    count,
+    uint32_t    maxCount,
+    float       limit,
+    float       offset,
+    float       cellSize
+)
+{
+    auto probed = float( 2 * ring - 1 );
+    probed = probed * probed * probed;
+
+    auto reach = limit;
+    if ( count < maxCount )
+    {
+        // 1つも見つからない場合に備えて, 見つかった数に1を足して密度を求めます.
+        auto volume = probed * float( maxCount ) / float( count + 1 );
+        reach = asvk::Min( limit, cbrtf( volume * ( 3.0f / ( 4.0f * asvk::F_PI ) ) ) * cellSize );
+    }
+
+    // ( last - 1 ) * cellSize + offset が reach を超えない最後の層までを辿ります.
+    auto last = floorf( ( reach - offset ) / cellSize ) + 1.0f;
+    auto side = 2.0f * last + 1.0f;
+    return side * side * side - probed;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      セル座標が一致するレーンを求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t MatchCell
+(
+    const int32_t* pX, const int32_t* pY, const int32_t* pZ,
+    int32_t x, int32_t y, int32_t z
+)
+{
+#if ASVK_IS_SIMD
+    auto mx = _mm_cmpeq_epi32( _mm_load_si128( reinterpret_cast<const __m128i*>( pX ) ), _mm_set1_epi32( x ) );
+    auto my = _mm_cmpeq_epi32( _mm_load_si128( reinterpret_cast<const __m128i*>( pY ) ), _mm_set1_epi32( y ) );
+    auto mz = _mm_cmpeq_epi32( _mm_load_si128( reinterpret_cast<const __m128i*>( pZ ) ), _mm_set1_epi32( z ) );
+    return static_cast<uint32_t>( _mm_movemask_ps( _mm_castsi128_ps( _mm_and_si128( _mm_and_si128( mx, my ), mz ) ) ) );
+#else
+    uint32_t mask = 0;
+    for( auto i=0u; i<LANE_COUNT; ++i )
+    {
+        if ( pX[i] == x && pY[i] == y && pZ[i] == z )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      セル座標が範囲内にあるレーンを求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t MatchCellRange
+(
+    const int32_t* pX, const int32_t* pY, const int32_t* pZ,
+    const int32_t* pLower, const int32_t* pUpper
+)
+{
+#if ASVK_IS_SIMD
+    auto x = _mm_load_si128( reinterpret_cast<const __m128i*>( pX ) );
+    auto y = _mm_load_si128( reinterpret_cast<const __m128i*>( pY ) );
+    auto z = _mm_load_si128( reinterpret_cast<const __m128i*>( pZ ) );
+
+    auto out = _mm_or_si128(
+        _mm_or_si128( _mm_cmplt_epi32( x, _mm_set1_epi32( pLower[0] ) ), _mm_cmpgt_epi32( x, _mm_set1_epi32( pUpper[0] ) ) ),
+        _mm_or_si128( _mm_cmplt_epi32( y, _mm_set1_epi32( pLower[1] ) ), _mm_cmpgt_epi32( y, _mm_set1_epi32( pUpper[1] ) ) ) );
+    out = _mm_or_si128( out,
+        _mm_or_si128( _mm_cmplt_epi32( z, _mm_set1_epi32( pLower[2] ) ), _mm_cmpgt_epi32( z, _mm_set1_epi32( pUpper[2] ) ) ) );
+    return ~static_cast<uint32_t>( _mm_movemask_ps( _mm_castsi128_ps( out ) ) ) & FULL_LANES;
+#else
+    uint32_t mask = 0;
+    for( auto i=0u; i<LANE_COUNT; ++i )
+    {
+        if ( pLower[0] <= pX[i] && pX[i] <= pUpper[0]
+          && pLower[1] <= pY[i] && pY[i] <= pUpper[1]
+          && pLower[2] <= pZ[i] && pZ[i] <= pUpper[2] )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングスフィアと重なるレーンを求めます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t OverlapSphere
+(
+    const float* pX, const float* pY, const float* pZ, const float* pR,
+    const asvk::BoundingSphere& sphere
+)
+{
+#if ASVK_IS_SIMD
+    auto dx = _mm_sub_ps( _mm_load_ps( pX ), _mm_set1_ps( sphere.center.x ) );
+    auto dy = _mm_sub_ps( _mm_load_ps( pY ), _mm_set1_ps( sphere.center.y ) );
+    auto dz = _mm_sub_ps( _mm_load_ps( pZ ), _mm_set1_ps( sphere.center.z ) );
+    auto rr = _mm_add_ps( _mm_load_ps( pR ), _mm_set1_ps( sphere.radius ) );
+    auto d2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+    return static_cast<uint32_t>( _mm_movemask_ps( _mm_cmple_ps( d2, _mm_mul_ps( rr, rr ) ) ) );
+#else
+    uint32_t mask = 0;
+    for( auto i=0u; i<LANE_COUNT; ++i )
+    {
+        auto dx = pX[i] - sphere.center.x;
+        auto dy = pY[i] - sphere.center.y;
+        auto dz = pZ[i] - sphere.center.z;
+        auto rr = pR[i] + sphere.radius;
+        if ( dx * dx + dy * dy + dz * dz <= rr * rr )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスと重なるレーンを求めます.
+//      中心からボックスまでの距離の2乗を半径の2乗と比べます.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t OverlapBox
+(
+    const float* pX, const float* pY, const float* pZ, const float* pR,
+    const asvk::BoundingBox& box
+)
+{
+#if ASVK_IS_SIMD
+    auto zero = _mm_setzero_ps();
+    auto x  = _mm_load_ps( pX );
+    auto y  = _mm_load_ps( pY );
+    auto z  = _mm_load_ps( pZ );
+    auto r  = _mm_load_ps( pR );
+    auto dx = _mm_max_ps( _mm_max_ps( _mm_sub_ps( _mm_set1_ps( box.mini.x ), x ), _mm_sub_ps( x, _mm_set1_ps( box.maxi.x ) ) ), zero );
+    auto dy = _mm_max_ps( _mm_max_ps( _mm_sub_ps( _mm_set1_ps( box.mini.y ), y ), _mm_sub_ps( y, _mm_set1_ps( box.maxi.y ) ) ), zero );
+    auto dz = _mm_max_ps( _mm_max_ps( _mm_sub_ps( _mm_set1_ps( box.mini.z ), z ), _mm_sub_ps( z, _mm_set1_ps( box.maxi.z ) ) ), zero );
+    auto d2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+    return static_cast<uint32_t>( _mm_movemask_ps( _mm_cmple_ps( d2, _mm_mul_ps( r, r ) ) ) );
+#else
+    uint32_t mask = 0;
+    for( auto i=0u; i<LANE_COUNT; ++i )
+    {
+        auto dx = ( box.mini.x - pX[i] > pX[i] - box.maxi.x ) ? box.mini.x - pX[i] : pX[i] - box.maxi.x;
+        auto dy = ( box.mini.y - pY[i] > pY[i] - box.maxi.y ) ? box.mini.y - pY[i] : pY[i] - box.maxi.y;
+        auto dz = ( box.mini.z - pZ[i] > pZ[i] - box.maxi.z ) ? box.mini.z - pZ[i] : pZ[i] - box.maxi.z;
+        dx = ( dx > 0.0f ) ? dx : 0.0f;
+        dy = ( dy > 0.0f ) ? dy : 0.0f;
+        dz = ( dz > 0.0f ) ? dz : 0.0f;
+        if ( dx * dx + dy * dy + dz * dz <= pR[i] * pR[i] )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      錐台と重なるレーンを求めます.
+//      ※ Frustum::Contains( const BoundingSphere& ) と結果を一致させるため，比較の向きや演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t OverlapFrustum
+(
+    const float* pX, const float* pY, const float* pZ, const float* pR,
+    const asvk::Vector4* pPlanes, uint32_t planeMask
+)
+{
+#if ASVK_IS_SIMD
+    auto x   = _mm_load_ps( pX );
+    auto y   = _mm_load_ps( pY );
+    auto z   = _mm_load_ps( pZ );
+    auto r   = _mm_xor_ps( _mm_load_ps( pR ), _mm_set1_ps( -0.0f ) );
+    auto out = _mm_setzero_ps();
+    for( auto i=0u; i<asvk::Frustum::PLANE_COUNT; ++i )
+    {
+        if ( ( planeMask & ( 1u << i ) ) == 0 )
+        { continue; }
+
+        auto d = _mm_add_ps( _mm_add_ps( _mm_add_ps(
+            _mm_mul_ps( _mm_set1_ps( pPlanes[i].x ), x ),
+            _mm_mul_ps( _mm_set1_ps( pPlanes[i].y ), y ) ),
+            _mm_mul_ps( _mm_set1_ps( pPlanes[i].z ), z ) ),
+            _mm_set1_ps( pPlanes[i].w ) );
+        out = _mm_or_ps( out, _mm_cmplt_ps( d, r ) );
+    }
+    return ~static_cast<uint32_t>( _mm_movemask_ps( out ) ) & FULL_LANES;
+#else
+    uint32_t mask = FULL_LANES;
+    for( auto i=0u; i<asvk::Frustum::PLANE_COUNT; ++i )
+    {
+        if ( ( planeMask & ( 1u << i ) ) == 0 )
+        { continue; }
+
+        for( auto j=0u; j<LANE_COUNT; ++j )
+        {
+            auto d = pPlanes[i].x * pX[j]
+                   + pPlanes[i].y * pY[j]
+                   + pPlanes[i].z * pZ[j]
+                   + pPlanes[i].w;
+            if ( d < -pR[j] )
+            { mask &= ~( 1u << j ); }
+        }
+    }
+    return mask;
+#endif//ASVK_IS_SIMD
+}
+
+//-------------------------------------------------------------------------------------------------
+//      点から中心までの距離の2乗を求め, limitSq 以下のレーンを返します.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t DistanceSq
+(
+    const float* pX, const float* pY, const float* pZ,
+    const asvk::Vector3& point,
+    float limitSq,
+    float* pResult
+)
+{
+#if ASVK_IS_SIMD
+    auto dx = _mm_sub_ps( _mm_load_ps( pX ), _mm_set1_ps( point.x ) );
+    auto dy = _mm_sub_ps( _mm_load_ps( pY ), _mm_set1_ps( point.y ) );
+    auto dz = _mm_sub_ps( _mm_load_ps( pZ ), _mm_set1_ps( point.z ) );
+    auto d2 = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+    _mm_storeu_ps( pResult, d2 );
+    return static_cast<uint32_t>( _mm_movemask_ps( _mm_cmple_ps( d2, _mm_set1_ps( limitSq ) ) ) );
+#else
+    uint32_t mask = 0;
+    for( auto i=0u; i<LANE_COUNT; ++i )
+    {
+        auto dx = pX[i] - point.x;
+        auto dy = pY[i] - point.y;
+        auto dz = pZ[i] - point.z;
+        pResult[i] = dx * dx + dy * dy + dz * dz;
+        if ( pResult[i] <= limitSq )
+        { mask |= 1u << i; }
+    }
+    return mask;
+#endif//ASVK_IS_SIMD
+}
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SpatialHash class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t SpatialHash::INVALID_HANDLE;
+constexpr uint32_t SpatialHash::DEFAULT_BUCKET_COUNT;
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+SpatialHash::SpatialHash()
+: m_FreeBlock   ( INVALID_HANDLE )
+, m_FreeHandle  ( INVALID_HANDLE )
+, m_BucketShift ( 32 )
+, m_Count       ( 0 )
+, m_CellSize    ( 1.0f )
+, m_InvCellSize ( 1.0f )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+SpatialHash::~SpatialHash()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      初期化します.
+//-------------------------------------------------------------------------------------------------
+bool SpatialHash::Init( float cellSize, uint32_t bucketCount )
+{
+    if ( !( cellSize > 0.0f ) || !std::isfinite( cellSize ) )
+    { return false; }
+
+    auto shift = 32u - 4u;
+    auto count = MIN_BUCKET_COUNT;
+    while( count < bucketCount && count < MAX_BUCKET_COUNT )
+    {
+        count <<= 1;
+        shift--;
+    }
+
+    m_CellSize    = cellSize;
+    m_InvCellSize = 1.0f / cellSize;
+    m_BucketShift = shift;
+    m_Buckets.resize( count + 1 );
+    Clear();
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      指定物体数分のメモリを予約します.
+//-------------------------------------------------------------------------------------------------
+void SpatialHash::Reserve( size_t count )
+{
+    // 埋まりかけのブロックは物体の入ったバケットごとに高々1個です.
+    auto partial = ( count < m_Buckets.size() ) ? count : m_Buckets.size();
+    m_Blocks   .reserve( ( count + LANE_COUNT - 1 ) / LANE_COUNT + partial );
+    m_Locations.reserve( count );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全ての物体を破棄します.
+//-------------------------------------------------------------------------------------------------
+void SpatialHash::Clear()
+{
+    for( auto& bucket : m_Buckets )
+    {
+        bucket.head  = INVALID_HANDLE;
+        bucket.count = 0;
+    }
+
+    m_Blocks   .clear();
+    m_Locations.clear();
+    m_FreeBlock  = INVALID_HANDLE;
+    m_FreeHandle = INVALID_HANDLE;
+    m_Count      = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物体を追加します.
+//-------------------------------------------------------------------------------------------------
+uint32_t SpatialHash::Insert( const BoundingSphere& sphere )
+{
+    assert( !m_Buckets.empty() );
+
+    uint32_t handle;
+    if ( m_FreeHandle != INVALID_HANDLE )
+    {
+        handle       = m_FreeHandle;
+        m_FreeHandle = m_Locations[handle].block;
+    }
+    else
+    {
+        handle = static_cast<uint32_t>( m_Locations.size() );
+        m_Locations.emplace_back();
+    }
+
+    Link( handle, sphere );
+    m_Count++;
+
+    return handle;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物体を移動します.
+//-------------------------------------------------------------------------------------------------
+void SpatialHash::Move( uint32_t handle, const BoundingSphere& sphere )
+{
+    assert( handle < m_Locations.size() );
+    assert( m_Locations[handle].bucket != INVALID_HANDLE );
+
+    const auto& location = m_Locations[handle];
+    auto& block = m_Blocks[location.block];
+    auto  lane  = location.lane;
+
+    auto large = uint32_t( m_Buckets.size() - 1 );
+    auto stay  = false;
+    if ( sphere.radius <= m_CellSize * 0.5f )
+    {
+        stay = ( location.bucket != large )
+            && block.cellX[lane] == ToCell( sphere.center.x, m_InvCellSize )
+            && block.cellY[lane] == ToCell( sphere.center.y, m_InvCellSize )
+            && block.cellZ[lane] == ToCell( sphere.center.z, m_InvCellSize );
+    }
+    else
+    { stay = ( location.bucket == large ); }
+
+    if ( stay )
+    {
+        block.x[lane] = sphere.center.x;
+        block.y[lane] = sphere.center.y;
+        block.z[lane] = sphere.center.z;
+        block.r[lane] = sphere.radius;
+        return;
+    }
+
+    Unlink( handle );
+    Link( handle, sphere );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物体を削除します.
+//-------------------------------------------------------------------------------------------------
+void SpatialHash::Remove( uint32_t handle )
+{
+    assert( handle < m_Locations.size() );
+    assert( m_Locations[handle].bucket != INVALID_HANDLE );
+
+    Unlink( handle );
+
+    m_Locations[handle].bucket = INVALID_HANDLE;
+    m_Locations[handle].block  = m_FreeHandle;
+    m_FreeHandle = handle;
+    m_Count--;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物体のバウンディングスフィアを取得します.
+//-------------------------------------------------------------------------------------------------
+BoundingSphere SpatialHash::GetSphere( uint32_t handle ) const
+{
+    assert( handle < m_Locations.size() );
+    assert( m_Locations[handle].bucket != INVALID_HANDLE );
+
+    const auto& location = m_Locations[handle];
+    const auto& block    = m_Blocks[location.block];
+    auto lane = location.lane;
+    return BoundingSphere( Vector3( block.x[lane], block.y[lane], block.z[lane] ), block.r[lane] );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物体数を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t SpatialHash::GetCount() const
+{ return m_Count; }
+
+//-------------------------------------------------------------------------------------------------
+//      セルの一辺の長さを取得します.
+//-------------------------------------------------------------------------------------------------
+float SpatialHash::GetCellSize() const
+{ return m_CellSize; }
+
+//-------------------------------------------------------------------------------------------------
+//      範囲と重なるセルの物体を判定します.
+//      範囲のセル数がバケット数を超えるか, セルを辿るより全ブロックを順に読む方が安い場合は, 全ブロックを先頭から順に走査します.
+//-------------------------------------------------------------------------------------------------
+template<typename CellTest, typename LaneTest>
+uint32_t SpatialHash::Query
+(
+    const BoundingBox&  bounds,
+    CellTest&&          cellTest,
+    LaneTest&&          laneTest,
+    uint32_t*           pHandles,
+    uint32_t            maxCount
+) const
+{
+    if ( pHandles == nullptr || maxCount == 0 || m_Count == 0 )
+    { return 0; }
+
+    uint32_t count = 0;
+
+    // mask のうち laneTest を満たす物体を格納します. 満杯になったら false を返します.
+    auto append = [&]( const Block& block, uint32_t mask, uint32_t planeMask )
+    {
+        if ( mask == 0 )
+        { return true; }
+
+        mask &= laneTest( block, planeMask );
+        for( auto i=0u; i<LANE_COUNT; ++i )
+        {
+            if ( ( mask & ( 1u << i ) ) == 0 )
+            { continue; }
+
+            pHandles[count++] = block.handle[i];
+            if ( count == maxCount )
+            { return false; }
+        }
+        return true;
+    };
+
+    // 大きな物体は総当たり.
+    const auto& large = m_Buckets.back();
+    for( auto index = large.head; index != INVALID_HANDLE; index = m_Blocks[index].next )
+    {
+        const auto& block = m_Blocks[index];
+        if ( !append( block, ValidLanes( block.handle ), ALL_TESTS ) )
+        { return count; }
+    }
+
+    // 中心が範囲をセルの半分だけ広げた中にある物体が対象です.
+    auto margin = m_CellSize * ( 0.5f + CELL_MARGIN );
+    int32_t lower[3] = {
+        ToCell( bounds.mini.x - margin, m_InvCellSize ),
+        ToCell( bounds.mini.y - margin, m_InvCellSize ),
+        ToCell( bounds.mini.z - margin, m_InvCellSize ) };
+    int32_t upper[3] = {
+        ToCell( bounds.maxi.x + margin, m_InvCellSize ),
+        ToCell( bounds.maxi.y + margin, m_InvCellSize ),
+        ToCell( bounds.maxi.z + margin, m_InvCellSize ) };
+
+    auto bucketCount = uint64_t( m_Buckets.size() - 1 );
+    auto cellCount   = CountCells( lower, upper, bucketCount );
+    if ( cellCount > bucketCount || cellCount * CELL_VISIT_COST > m_Blocks.size() )
+    {
+        // 空きブロックと大きな物体のブロックはセル座標の判定で除かれます.
+        for( const auto& block : m_Blocks )
+        {
+            auto mask = MatchCellRange( block.cellX, block.cellY, block.cellZ, lower, upper ) & ValidLanes( block.handle );
+            if ( !append( block, mask, ALL_TESTS ) )
+            { return count; }
+        }
+        return count;
+    }
+
+    for( auto z=lower[2]; z<=upper[2]; ++z )
+    {
+        for( auto y=lower[1]; y<=upper[1]; ++y )
+        {
+            for( auto x=lower[0]; x<=upper[0]; ++x )
+            {
+                const auto& bucket = m_Buckets[HashCell( x, y, z ) >> m_BucketShift];
+                if ( bucket.count == 0 )
+                { continue; }
+
+                auto planeMask = ALL_TESTS;
+                if ( !cellTest( x, y, z, planeMask ) )
+                { continue; }
+
+                for( auto index = bucket.head; index != INVALID_HANDLE; index = m_Blocks[index].next )
+                {
+                    const auto& block = m_Blocks[index];
+                    auto mask = MatchCell( block.cellX, block.cellY, block.cellZ, x, y, z ) & ValidLanes( block.handle );
+                    if ( !append( block, mask, planeMask ) )
+                    { return count; }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングスフィアと重なる物体を検索します.
+//-------------------------------------------------------------------------------------------------
+uint32_t SpatialHash::QuerySphere( const BoundingSphere& sphere, uint32_t* pHandles, uint32_t maxCount ) const
+{
+    auto extent = Vector3( sphere.radius, sphere.radius, sphere.radius );
+    return Query( BoundingBox( sphere.center - extent, sphere.center + extent ),
+        []( int32_t, int32_t, int32_t, uint32_t& )
+        { return true; },
+        [&sphere]( const Block& block, uint32_t )
+        { return OverlapSphere( block.x, block.y, block.z, block.r, sphere ); },
+        pHandles, maxCount );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      バウンディングボックスと重なる物体を検索します.
+//-------------------------------------------------------------------------------------------------
+uint32_t SpatialHash::QueryBox( const BoundingBox& box, uint32_t* pHandles, uint32_t maxCount ) const
+{
+    return Query( box,
+        []( int32_t, int32_t, int32_t, uint32_t& )
+        { return true; },
+        [&box]( const Block& block, uint32_t )
+        { return OverlapBox( block.x, block.y, block.z, block.r, box ); },
+        pHandles, maxCount );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      錐台と重なる物体を検索します.
+//-------------------------------------------------------------------------------------------------
+uint32_t SpatialHash::QueryFrustum( const Frustum& frustum, uint32_t* pHandles, uint32_t maxCount ) const
+{
+    Vector4 planes[Frustum::PLANE_COUNT];
+    for( auto i=0u; i<Frustum::PLANE_COUNT; ++i )
+    { planes[i] = frustum.GetPlane( i ); }
+
+    // 平面ごとの判定を通る中心は, 各平面を半径だけ外側へずらした錐台に入ります.
+    // その8頂点を囲む範囲を走査します. 頂点が求まらない(遠平面が無限遠など)場合は全てのセルが対象です.
+    auto margin = m_CellSize * ( 0.5f + CELL_MARGIN );
+    Vector4 expanded[Frustum::PLANE_COUNT];
+    for( auto i=0u; i<Frustum::PLANE_COUNT; ++i )
+    { expanded[i] = Vector4( planes[i].x, planes[i].y, planes[i].z, planes[i].w + margin ); }
+
+    auto bounds = BoundingBox( Vector3( F32_MAX, F32_MAX, F32_MAX ), Vector3( -F32_MAX, -F32_MAX, -F32_MAX ) );
+    for( auto i=0u; i<8; ++i )
+    {
+        Vector3 corner;
+        if ( !IntersectPlanes(
+            expanded[( i & 0x1 ) ? Frustum::PLANE_RIGHT : Frustum::PLANE_LEFT],
+            expanded[( i & 0x2 ) ? Frustum::PLANE_TOP   : Frustum::PLANE_BOTTOM],
+            expanded[( i & 0x4 ) ? Frustum::PLANE_FAR   : Frustum::PLANE_NEAR],
+            corner ) )
+        {
+            bounds.mini = Vector3( -F32_MAX, -F32_MAX, -F32_MAX );
+            bounds.maxi = Vector3(  F32_MAX,  F32_MAX,  F32_MAX );
+            break;
+        }
+        bounds.Merge( corner );
+    }
+
+    return Query( bounds,
+        [&]( int32_t x, int32_t y, int32_t z, uint32_t& planeMask )
+        {
+            // セルに登録された物体を全て囲むルーズな範囲で判定し, 内側にある平面を省きます.
+            auto mini = Vector3( float( x ), float( y ), float( z ) ) * m_CellSize;
+            auto cell = BoundingBox(
+                mini - Vector3( margin, margin, margin ),
+                mini + Vector3( m_CellSize + margin, m_CellSize + margin, m_CellSize + margin ) );
+            planeMask = Frustum::ALL_PLANES;
+            return frustum.Classify( cell, planeMask ) != Containment::Outside;
+        },
+        [&planes]( const Block& block, uint32_t planeMask )
+        { return OverlapFrustum( block.x, block.y, block.z, block.r, planes, planeMask ); },
+        pHandles, maxCount );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      点に近い順に物体を検索します.
+//-------------------------------------------------------------------------------------------------
+uint32_t SpatialHash::QueryNearest
+(
+    const Vector3&  point,
+    float           maxDistance,
+    uint32_t*       pHandles,
+    float*          pDistances,
+    uint32_t        maxCount
+) const
+{
+    if ( pHandles == nullptr || pDistances == nullptr || maxCount == 0 || m_Count == 0 || !( maxDistance >= 0.0f ) )
+    { return 0; }
+
+    uint32_t count = 0;
+    auto     limit = maxDistance;
+
+    // 距離の昇順を保って挿入します. 満杯になったら最も遠いものを検索範囲の上限にします.
+    auto insert = [&]( float distance, uint32_t handle )
+    {
+        if ( distance > limit || ( count == maxCount && distance == limit ) )
+        { return; }
+
+        auto pos = ( count < maxCount ) ? count++ : count - 1;
+        while( pos > 0 && pDistances[pos - 1] > distance )
+        {
+            pHandles  [pos] = pHandles  [pos - 1];
+            pDistances[pos] = pDistances[pos - 1];
+            pos--;
+        }
+        pHandles  [pos] = handle;
+        pDistances[pos] = distance;
+
+        if ( count == maxCount )
+        { limit = pDistances[count - 1]; }
+    };
+
+    // visited が正の場合は, 点を含むセルからのずれが visited 未満の走査済みのセルの物体を除きます.
+    int32_t center[3] = {};
+    auto append = [&]( const Block& block, uint32_t mask, int32_t visited )
+    {
+        if ( mask == 0 )
+        { return; }
+
+        float distSq[LANE_COUNT];
+        mask &= DistanceSq( block.x, block.y, block.z, point, limit * limit, distSq );
+        if ( mask == 0 )
+        { return; }
+
+        for( auto i=0u; i<LANE_COUNT; ++i )
+        {
+            if ( ( mask & ( 1u << i ) ) == 0 )
+            { continue; }
+
+            if ( visited > 0
+              && abs( block.cellX[i] - center[0] ) < visited
+              && abs( block.cellY[i] - center[1] ) < visited
+              && abs( block.cellZ[i] - center[2] ) < visited )
+            { continue; }
+
+            insert( sqrtf( distSq[i] ), block.handle[i] );
+        }
+    };
+
+    // 大きな物体は総当たり.
+    const auto& large = m_Buckets.back();
+    for( auto index = large.head; index != INVALID_HANDLE; index = m_Blocks[index].next )
+    { append( m_Blocks[index], ValidLanes( m_Blocks[index].handle ), 0 ); }
+
+    center[0] = ToCell( point.x, m_InvCellSize );
+    center[1] = ToCell( point.y, m_InvCellSize );
+    center[2] = ToCell( point.z, m_InvCellSize );
+
+    // 点を含むセル内での位置です. 丸め誤差でセルからはみ出した分は詰めます.
+    auto fx = Saturate( point.x * m_InvCellSize - float( center[0] ) ) * m_CellSize;
+    auto fy = Saturate( point.y * m_InvCellSize - float( center[1] ) ) * m_CellSize;
+    auto fz = Saturate( point.z * m_InvCellSize - float( center[2] ) ) * m_CellSize;
+    auto slack  = m_CellSize * CELL_MARGIN;
+    auto inside = Min( Min( Min( fx, m_CellSize - fx ), Min( fy, m_CellSize - fy ) ), Min( fz, m_CellSize - fz ) );
+
+    auto bucketCount = uint64_t( m_Buckets.size() - 1 );
+    for( int32_t ring = 0; ; ++ring )
+    {
+        // ring 層目のセルまでの最短距離は, 点を含むセルの最も近い面までの距離に ring - 1 セル分を足したものです.
+        if ( ring > 0 && float( ring - 1 ) * m_CellSize + inside - slack > limit )
+        { break; }
+
+        // 打ち切りまでに残りの層で辿るセルのコストを見積もり, 全ブロックの走査より高い場合は層を広げずに走査に切り替えます.
+        auto side  = uint64_t( 2 * ring + 1 );
+        auto cells = side * side * side;
+        if ( cells > bucketCount
+          || ( ring > 0 && EstimateNearestCells( ring, count, maxCount, limit, inside - slack, m_CellSize ) * float( CELL_VISIT_COST ) > float( m_Blocks.size() ) ) )
+        {
+            // 残りの層は全ブロックを先頭から順に走査した方が少なく済みます.
+            int32_t lower[3] = { -int32_t( CELL_LIMIT ), -int32_t( CELL_LIMIT ), -int32_t( CELL_LIMIT ) };
+            int32_t upper[3] = {  int32_t( CELL_LIMIT ),  int32_t( CELL_LIMIT ),  int32_t( CELL_LIMIT ) };
+            for( const auto& block : m_Blocks )
+            {
+                // 大半のブロックは距離だけで除けるため, セルと空きレーンの判定は後にします.
+                float distSq[LANE_COUNT];
+                if ( DistanceSq( block.x, block.y, block.z, point, limit * limit, distSq ) == 0 )
+                { continue; }
+
+                append( block, MatchCellRange( block.cellX, block.cellY, block.cellZ, lower, upper ) & ValidLanes( block.handle ), ring );
+            }
+            break;
+        }
+
+        for( auto dz=-ring; dz<=ring; ++dz )
+        {
+            auto gz = CellGap( dz, fz, m_CellSize );
+            for( auto dy=-ring; dy<=ring; ++dy )
+            {
+                auto gy = CellGap( dy, fy, m_CellSize );
+
+                // 外周の面に接していない列は手前と奥の2セルだけが ring 層目です.
+                auto shell = ( abs( dz ) == ring || abs( dy ) == ring );
+                auto step  = ( shell || ring == 0 ) ? 1 : 2 * ring;
+                for( auto dx=-ring; dx<=ring; dx += step )
+                {
+                    // 点からセルまでの距離が上限を超えるセルは飛ばします.
+                    auto gx  = CellGap( dx, fx, m_CellSize );
+                    auto gap = limit + slack;
+                    if ( gx * gx + gy * gy + gz * gz > gap * gap )
+                    { continue; }
+
+                    auto x = center[0] + dx;
+                    auto y = center[1] + dy;
+                    auto z = center[2] + dz;
+
+                    const auto& bucket = m_Buckets[HashCell( x, y, z ) >> m_BucketShift];
+                    for( auto index = bucket.head; index != INVALID_HANDLE; index = m_Blocks[index].next )
+                    {
+                        const auto& block = m_Blocks[index];
+                        append( block, MatchCell( block.cellX, block.cellY, block.cellZ, x, y, z ) & ValidLanes( block.handle ), 0 );
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物体をバケットに登録します.
+//-------------------------------------------------------------------------------------------------
+void SpatialHash::Link( uint32_t handle, const BoundingSphere& sphere )
+{
+    // NaN の半径も大きな物体として扱います.
+    int32_t x = LARGE_CELL, y = LARGE_CELL, z = LARGE_CELL;
+    auto index = uint32_t( m_Buckets.size() - 1 );
+    if ( sphere.radius <= m_CellSize * 0.5f )
+    {
+        x = ToCell( sphere.center.x, m_InvCellSize );
+        y = ToCell( sphere.center.y, m_InvCellSize );
+        z = ToCell( sphere.center.z, m_InvCellSize );
+        index = HashCell( x, y, z ) >> m_BucketShift;
+    }
+
+    auto& bucket = m_Buckets[index];
+    auto  lane   = bucket.count & ( LANE_COUNT - 1 );
+    if ( lane == 0 )
+    {
+        uint32_t head;
+        if ( m_FreeBlock != INVALID_HANDLE )
+        {
+            head        = m_FreeBlock;
+            m_FreeBlock = m_Blocks[head].next;
+        }
+        else
+        {
+            head = static_cast<uint32_t>( m_Blocks.size() );
+            m_Blocks.emplace_back();
+        }
+
+        auto& block = m_Blocks[head];
+        block = Block();
+        std::fill( block.handle, block.handle + LANE_COUNT, INVALID_HANDLE );
+        block.next  = bucket.head;
+        bucket.head = head;
+    }
+
+    auto& block = m_Blocks[bucket.head];
+    block.x     [lane] = sphere.center.x;
+    block.y     [lane] = sphere.center.y;
+    block.z     [lane] = sphere.center.z;
+    block.r     [lane] = sphere.radius;
+    block.cellX [lane] = x;
+    block.cellY [lane] = y;
+    block.cellZ [lane] = z;
+    block.handle[lane] = handle;
+    bucket.count++;
+
+    auto& location = m_Locations[handle];
+    location.bucket = index;
+    location.block  = bucket.head;
+    location.lane   = lane;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      物体をバケットから外します.
+//      バケットの末尾(先頭ブロックの最後のレーン)の物体を空いた位置に移します.
+//-------------------------------------------------------------------------------------------------
+void SpatialHash::Unlink( uint32_t handle )
+{
+    const auto& location = m_Locations[handle];
+    auto& bucket = m_Buckets[location.bucket];
+    auto  head   = bucket.head;
+    auto  last   = ( bucket.count - 1 ) & ( LANE_COUNT - 1 );
+
+    if ( location.block != head || location.lane != last )
+    {
+        const auto& src = m_Blocks[head];
+        auto& dst  = m_Blocks[location.block];
+        auto  lane = location.lane;
+        dst.x     [lane] = src.x     [last];
+        dst.y     [lane] = src.y     [last];
+        dst.z     [lane] = src.z     [last];
+        dst.r     [lane] = src.r     [last];
+        dst.cellX [lane] = src.cellX [last];
+        dst.cellY [lane] = src.cellY [last];
+        dst.cellZ [lane] = src.cellZ [last];
+        dst.handle[lane] = src.handle[last];
+
+        auto& moved = m_Locations[src.handle[last]];
+        moved.block = location.block;
+        moved.lane  = lane;
+    }
+
+    m_Blocks[head].handle[last] = INVALID_HANDLE;
+
+    bucket.count--;
+    if ( last == 0 )
+    {
+        bucket.head = m_Blocks[head].next;
+        m_Blocks[head].next = m_FreeBlock;
+        m_FreeBlock = head;
+    }
+}
+
+} // namespace asvk
@@ -0,0 +1,428 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkSpline.cpp
+// Desc : Spline Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkSpline.h>
+#include <algorithm>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr float GAUSS_NODE[3]   = { -0.77459666924148337704f, 0.0f, 0.77459666924148337704f };   //!< 3点ガウス・ルジャンドル求積の分点です.
+static constexpr float GAUSS_WEIGHT[3] = { 5.0f / 9.0f, 8.0f / 9.0f, 5.0f / 9.0f };                    //!< 3点ガウス・ルジャンドル求積の重みです.
+static constexpr uint32_t REFINE_MAX_DEPTH   = 4;        //!< 弧長の表の分割点を適応的に2分割する最大の回数です.
+static constexpr float    REFINE_CHORD_RATIO = 0.999f;   //!< 弦の長さと弧長の比がこれを下回る場合に2分割します.
+static constexpr float    REFINE_SPEED_RATIO = 1.2f;     //!< 両端と中点の速さの最大値と最小値の比がこれを上回る場合に2分割します.
+
+
+//-------------------------------------------------------------------------------------------------
+//      パラメータを区間番号と区間内の位置に分けます.
+//      ※ SIMD版と結果を一致させるため，比較の向きや演算順序を変えないこと.
+//-------------------------------------------------------------------------------------------------
+inline uint32_t SplitParam( float param, uint32_t segmentCount, float& amount )
+{
+    auto maxParam = static_cast<float>( segmentCount );
+    param = ( param < maxParam ) ? param : maxParam;
+    param = ( param > 0.0f ) ? param : 0.0f;
+
+    auto index = static_cast<uint32_t>( param );
+    index = ( index < segmentCount - 1 ) ? index : segmentCount - 1;
+
+    amount = param - static_cast<float>( index );
+    return index;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Catmull-Rom スプラインの接線ベクトルを求めます.
+//-------------------------------------------------------------------------------------------------
+inline asvk::Vector3 CatmullRomTangent
+(
+    const asvk::Vector3&    a,
+    const asvk::Vector3&    b,
+    const asvk::Vector3&    c,
+    const asvk::Vector3&    d,
+    float                   amount
+)
+{
+    // Vector3::CatmullRom() の多項式をパラメータで微分したもの.
+    return ( ( c - a )
+           + ( a * 2.0f - b * 5.0f + c * 4.0f - d ) * ( 2.0f * amount )
+           + ( b * 3.0f - a - c * 3.0f + d ) * ( 3.0f * amount * amount ) ) * 0.5f;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間内の [t0, t1] の弧長を3点ガウス・ルジャンドル求積で求めます.
+//-------------------------------------------------------------------------------------------------
+inline float ArcLength
+(
+    const asvk::Vector3&    a,
+    const asvk::Vector3&    b,
+    const asvk::Vector3&    c,
+    const asvk::Vector3&    d,
+    float                   t0,
+    float                   t1
+)
+{
+    auto center = ( t0 + t1 ) * 0.5f;
+    auto half   = ( t1 - t0 ) * 0.5f;
+    auto length = 0.0f;
+    for( auto k=0; k<3; ++k )
+    { length += GAUSS_WEIGHT[k] * CatmullRomTangent( a, b, c, d, center + GAUSS_NODE[k] * half ).Length(); }
+    return length * half;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      区間内の [t0, t1] を弧長の表に追加します.
+//      曲がりが急な場合や速さの変化が大きい場合は, 逆引きの誤差が大きくなるので2分割します.
+//-------------------------------------------------------------------------------------------------
+void AppendArc
+(
+    const asvk::Vector3&    a,
+    const asvk::Vector3&    b,
+    const asvk::Vector3&    c,
+    const asvk::Vector3&    d,
+    float                   base,
+    float                   t0,
+    float                   t1,
+    float                   s0,
+    float                   s1,
+    uint32_t                depth,
+    std::vector<float>&     params,
+    std::vector<float>&     distances,
+    std::vector<float>&     speeds
+)
+{
+    auto length = ArcLength( a, b, c, d, t0, t1 );
+
+    if ( depth < REFINE_MAX_DEPTH )
+    {
+        auto tm    = ( t0 + t1 ) * 0.5f;
+        auto sm    = CatmullRomTangent( a, b, c, d, tm ).Length();
+        auto chord = ( asvk::Vector3::CatmullRom( a, b, c, d, t1 ) - asvk::Vector3::CatmullRom( a, b, c, d, t0 ) ).Length();
+        auto sMin  = std::min( std::min( s0, s1 ), sm );
+        auto sMax  = std::max( std::max( s0, s1 ), sm );
+
+        if ( chord < REFINE_CHORD_RATIO * length || sMax > REFINE_SPEED_RATIO * sMin )
+        {
+            AppendArc( a, b, c, d, base, t0, tm, s0, sm, depth + 1, params, distances, speeds );
+            AppendArc( a, b, c, d, base, tm, t1, sm, s1, depth + 1, params, distances, speeds );
+            return;
+        }
+    }
+
+    params   .push_back( base + t1 );
+    distances.push_back( distances.back() + length );
+    speeds   .push_back( s1 );
+}
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Spline class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t Spline::DEFAULT_SUBDIVISION;
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+Spline::Spline()
+: m_Subdivision ( DEFAULT_SUBDIVISION )
+, m_Closed      ( false )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+Spline::~Spline()
+{ Clear(); }
+
+//-------------------------------------------------------------------------------------------------
+//      制御点を設定し，弧長の表を構築します.
+//-------------------------------------------------------------------------------------------------
+bool Spline::Build( const Vector3* pPoints, size_t count, bool closed, uint32_t subdivision )
+{
+    assert( count == 0 || pPoints != nullptr );
+    assert( subdivision > 0 );
+    Clear();
+
+    if ( count < 2 || subdivision == 0 )
+    { return false; }
+
+    m_Closed      = closed;
+    m_Subdivision = subdivision;
+
+    // 全ての区間が4つの制御点で評価できるように端点の外側を補う.
+    m_Points.reserve( count + 3 );
+    if ( closed )
+    {
+        m_Points.push_back( pPoints[count - 1] );
+        m_Points.insert( m_Points.end(), pPoints, pPoints + count );
+        m_Points.push_back( pPoints[0] );
+        m_Points.push_back( pPoints[1] );
+    }
+    else
+    {
+        m_Points.push_back( pPoints[0] * 2.0f - pPoints[1] );
+        m_Points.insert( m_Points.end(), pPoints, pPoints + count );
+        m_Points.push_back( pPoints[count - 1] * 2.0f - pPoints[count - 2] );
+    }
+
+    // 分割点の間の弧長を3点ガウス・ルジャンドル求積で求めて累積する.
+    // 距離からの逆引きで使うため，分割点ごとのパラメータと速さ |dP/dt| も記録しておく.
+    // 曲がりが急な場所や速さが変わる場所は，分割点を適応的に増やす.
+    auto segmentCount = GetSegmentCount();
+    m_Params   .reserve( segmentCount * subdivision + 1 );
+    m_Distances.reserve( segmentCount * subdivision + 1 );
+    m_Speeds   .reserve( segmentCount * subdivision + 1 );
+
+    auto step = 1.0f / static_cast<float>( subdivision );
+    m_Params   .push_back( 0.0f );
+    m_Distances.push_back( 0.0f );
+    m_Speeds   .push_back( CatmullRomTangent( m_Points[0], m_Points[1], m_Points[2], m_Points[3], 0.0f ).Length() );
+
+    for( size_t i=0; i<segmentCount; ++i )
+    {
+        const auto& a = m_Points[i + 0];
+        const auto& b = m_Points[i + 1];
+        const auto& c = m_Points[i + 2];
+        const auto& d = m_Points[i + 3];
+        auto base = static_cast<float>( i );
+
+        for( uint32_t j=0; j<subdivision; ++j )
+        {
+            auto t0 = static_cast<float>( j ) * step;
+            auto t1 = ( j + 1 < subdivision ) ? static_cast<float>( j + 1 ) * step : 1.0f;
+            auto s0 = CatmullRomTangent( a, b, c, d, t0 ).Length();
+            auto s1 = CatmullRomTangent( a, b, c, d, t1 ).Length();
+            AppendArc( a, b, c, d, base, t0, t1, s0, s1, 0, m_Params, m_Distances, m_Speeds );
+        }
+    }
+
+    // 最後の分割点は区間数と一致させる.
+    m_Params.back() = static_cast<float>( segmentCount );
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全てのデータを破棄します.
+//-------------------------------------------------------------------------------------------------
+void Spline::Clear()
+{
+    m_Points   .clear();
+    m_Params   .clear();
+    m_Distances.clear();
+    m_Speeds   .clear();
+    m_Closed = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パラメータを指定して位置を求めます.
+//-------------------------------------------------------------------------------------------------
+Vector3 Spline::Evaluate( float param ) const
+{
+    assert( !m_Points.empty() );
+
+    float amount;
+    auto i = SplitParam( param, static_cast<uint32_t>( GetSegmentCount() ), amount );
+    return Vector3::CatmullRom( m_Points[i], m_Points[i + 1], m_Points[i + 2], m_Points[i + 3], amount );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パラメータを指定して複数の位置をまとめて求めます.
+//-------------------------------------------------------------------------------------------------
+void Spline::Evaluate( const float* pParams, Vector3* pResults, size_t count ) const
+{
+    assert( count == 0 || ( pParams != nullptr && pResults != nullptr && !m_Points.empty() ) );
+    size_t i = 0;
+
+#if ASVK_IS_SIMD
+    auto segmentCount = static_cast<uint32_t>( GetSegmentCount() );
+    const auto* pts = m_Points.data();
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        uint32_t index[4];
+        float    amount[4];
+        for( size_t j=0; j<4; ++j )
+        { index[j] = SplitParam( pParams[i + j], segmentCount, amount[j] ); }
+
+        // 4本分の制御点をSoA形式で読み込む.
+        __m128 p[4][3];
+        for( size_t k=0; k<4; ++k )
+        {
+            const auto& p0 = pts[index[0] + k];
+            const auto& p1 = pts[index[1] + k];
+            const auto& p2 = pts[index[2] + k];
+            const auto& p3 = pts[index[3] + k];
+            p[k][0] = _mm_setr_ps( p0.x, p1.x, p2.x, p3.x );
+            p[k][1] = _mm_setr_ps( p0.y, p1.y, p2.y, p3.y );
+            p[k][2] = _mm_setr_ps( p0.z, p1.z, p2.z, p3.z );
+        }
+
+        // Vector3::CatmullRom() と同じ演算順序.
+        auto t  = _mm_loadu_ps( amount );
+        auto t2 = _mm_mul_ps( t, t );
+        auto t3 = _mm_mul_ps( t2, t );
+        auto k2 = _mm_set1_ps( 2.0f );
+        auto k3 = _mm_set1_ps( 3.0f );
+        auto k4 = _mm_set1_ps( 4.0f );
+        auto k5 = _mm_set1_ps( 5.0f );
+
+        __m128 r[3];
+        for( size_t c=0; c<3; ++c )
+        {
+            auto a = p[0][c];
+            auto b = p[1][c];
+            auto d = p[2][c];
+            auto e = p[3][c];
+
+            auto c1 = _mm_sub_ps( d, a );
+            auto c2 = _mm_sub_ps( _mm_add_ps( _mm_sub_ps( _mm_mul_ps( k2, a ), _mm_mul_ps( k5, b ) ), _mm_mul_ps( k4, d ) ), e );
+            auto c3 = _mm_add_ps( _mm_sub_ps( _mm_sub_ps( _mm_mul_ps( k3, b ), a ), _mm_mul_ps( k3, d ) ), e );
+
+            auto v = _mm_add_ps( _mm_mul_ps( k2, b ), _mm_mul_ps( c1, t ) );
+            v = _mm_add_ps( v, _mm_mul_ps( c2, t2 ) );
+            v = _mm_add_ps( v, _mm_mul_ps( c3, t3 ) );
+            r[c] = _mm_mul_ps( _mm_set1_ps( 0.5f ), v );
+        }
+
+        detail::StoreVector3x4( pResults + i, r[0], r[1], r[2] );
+    }
+#endif//ASVK_IS_SIMD
+
+    for( ; i < count; ++i )
+    { pResults[i] = Evaluate( pParams[i] ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パラメータを指定して接線ベクトルを求めます.
+//-------------------------------------------------------------------------------------------------
+Vector3 Spline::EvaluateTangent( float param ) const
+{
+    assert( !m_Points.empty() );
+
+    float amount;
+    auto i = SplitParam( param, static_cast<uint32_t>( GetSegmentCount() ), amount );
+
+    return CatmullRomTangent( m_Points[i], m_Points[i + 1], m_Points[i + 2], m_Points[i + 3], amount );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      始点からの距離をパラメータに変換します.
+//-------------------------------------------------------------------------------------------------
+float Spline::GetParam( float distance ) const
+{
+    assert( !m_Distances.empty() );
+    auto length = GetLength();
+
+    if ( m_Closed && length > 0.0f )
+    {
+        distance = fmodf( distance, length );
+        if ( distance < 0.0f )
+        { distance += length; }
+    }
+
+    if ( !( distance > 0.0f ) )
+    { return 0.0f; }
+    if ( distance >= length )
+    { return static_cast<float>( GetSegmentCount() ); }
+
+    // 累積距離の表を二分探索する.
+    auto begin = m_Distances.begin();
+    auto pos   = static_cast<size_t>( std::upper_bound( begin, m_Distances.end(), distance ) - begin );
+    auto d0    = m_Distances[pos - 1];
+    auto d1    = m_Distances[pos];
+    auto h     = d1 - d0;
+    auto t0    = m_Params[pos - 1];
+    auto step  = m_Params[pos] - t0;
+    if ( !( h > 0.0f ) )
+    { return t0; }
+
+    // 分割点の間は，両端の dt/ds = 1/|dP/dt| を満たす3次エルミート補間で逆引きする.
+    // 線形補間だと分割点の間で速さがばらつくので，等速移動に使うには不十分.
+    auto u  = ( distance - d0 ) / h;
+    auto u2 = u * u;
+    auto u3 = u2 * u;
+    auto s0 = m_Speeds[pos - 1];
+    auto s1 = m_Speeds[pos];
+    auto m0 = ( s0 > 0.0f ) ? h / s0 : step;
+    auto m1 = ( s1 > 0.0f ) ? h / s1 : step;
+
+    // 速さが0に近い点の付近で逆引きが単調でなくならないように傾きを制限する(Fritsch-Carlson).
+    auto a = m0 / step;
+    auto b = m1 / step;
+    auto r = a * a + b * b;
+    if ( r > 9.0f )
+    {
+        auto k = 3.0f / sqrtf( r );
+        m0 *= k;
+        m1 *= k;
+    }
+
+    auto t = ( 3.0f * u2 - 2.0f * u3 ) * step
+           + ( u3 - 2.0f * u2 + u ) * m0
+           + ( u3 - u2 ) * m1;
+    t = ( t > 0.0f ) ? t : 0.0f;
+    t = ( t < step ) ? t : step;
+    return t0 + t;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      始点からの距離を指定して位置を求めます.
+//-------------------------------------------------------------------------------------------------
+Vector3 Spline::EvaluateAtDistance( float distance ) const
+{ return Evaluate( GetParam( distance ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      始点からの距離を指定して複数の位置をまとめて求めます.
+//-------------------------------------------------------------------------------------------------
+void Spline::EvaluateAtDistance( const float* pDistances, Vector3* pResults, size_t count ) const
+{
+    assert( count == 0 || ( pDistances != nullptr && pResults != nullptr ) );
+
+    // パラメータへの変換は探索なので要素ごとに行い，評価だけをまとめて行う.
+    static constexpr size_t BLOCK_SIZE = 256;
+    float params[BLOCK_SIZE];
+
+    for( size_t i=0; i<count; i+=BLOCK_SIZE )
+    {
+        auto n = ( count - i < BLOCK_SIZE ) ? count - i : BLOCK_SIZE;
+        for( size_t j=0; j<n; ++j )
+        { params[j] = GetParam( pDistances[i + j] ); }
+
+        Evaluate( params, pResults + i, n );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      曲線の長さを取得します.
+//-------------------------------------------------------------------------------------------------
+float Spline::GetLength() const
+{ return m_Distances.empty() ? 0.0f : m_Distances.back(); }
+
+//-------------------------------------------------------------------------------------------------
+//      区間数を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t Spline::GetSegmentCount() const
+{ return m_Points.empty() ? 0 : m_Points.size() - 3; }
+
+//-------------------------------------------------------------------------------------------------
+//      閉じた曲線かどうかを取得します.
+//-------------------------------------------------------------------------------------------------
+bool Spline::IsClosed() const
+{ return m_Closed; }
+
+} // namespace asvk
@@ -0,0 +1,476 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkTransformHierarchy.cpp
+// Desc : Transform Hierarchy Module.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkTransformHierarchy.h>
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr int64_t HIERARCHY_PARALLEL_THRESHOLD = 1024;     //!< 同じ深さのノード更新を並列化する要素数の閾値です.
+static constexpr size_t  HIERARCHY_SPARSE_RATIO       = 8;        //!< 待ち行列の要素数がその深さのノード数の 1/HIERARCHY_SPARSE_RATIO を超えたら全ノードを走査します.
+
+
+//-------------------------------------------------------------------------------------------------
+//      拡大縮小・回転・平行移動の順に適用する行列を生成します.
+//-------------------------------------------------------------------------------------------------
+inline asvk::Matrix ComposeTRS
+(
+    const asvk::Vector3&    translation,
+    const asvk::Quaternion& rotation,
+    const asvk::Vector3&    scale
+)
+{
+    auto result = asvk::Matrix::CreateFromQuaternion( rotation );
+    result._11 *= scale.x; result._12 *= scale.x; result._13 *= scale.x;
+    result._21 *= scale.y; result._22 *= scale.y; result._23 *= scale.y;
+    result._31 *= scale.z; result._32 *= scale.z; result._33 *= scale.z;
+    result._41 = translation.x;
+    result._42 = translation.y;
+    result._43 = translation.z;
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      新しい格納位置に従って配列を並べ替えます.
+//-------------------------------------------------------------------------------------------------
+template<typename T, typename Allocator>
+void Permute( std::vector<T, Allocator>& values, const std::vector<uint32_t>& newSlot )
+{
+    std::vector<T, Allocator> temp( values.size() );
+    for( size_t i = 0; i < values.size(); ++i )
+    { temp[newSlot[i]] = values[i]; }
+    values.swap( temp );
+}
+
+} // namespace /* anonymous */
+
+
+namespace asvk {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TransformHierarchy class
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t TransformHierarchy::INVALID_HANDLE;
+
+//-------------------------------------------------------------------------------------------------
+//      コンストラクタです.
+//-------------------------------------------------------------------------------------------------
+TransformHierarchy::TransformHierarchy()
+: m_LevelOffset ( 1, 0 )
+, m_Sorted      ( true )
+, m_ChildValid  ( true )
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      デストラクタです.
+//-------------------------------------------------------------------------------------------------
+TransformHierarchy::~TransformHierarchy()
+{ /* DO_NOTHING */ }
+
+//-------------------------------------------------------------------------------------------------
+//      指定ノード数分のメモリを予約します.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::Reserve( size_t count )
+{
+    m_Translation .reserve( count );
+    m_Rotation    .reserve( count );
+    m_Scale       .reserve( count );
+    m_World       .reserve( count );
+    m_Parent      .reserve( count );
+    m_Depth       .reserve( count );
+    m_Dirty       .reserve( count );
+    m_Changed     .reserve( count );
+    m_SlotOfHandle.reserve( count );
+    m_HandleOfSlot.reserve( count );
+    m_DirtyHandle .reserve( count );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全てのノードを破棄します.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::Clear()
+{
+    m_Translation .clear();
+    m_Rotation    .clear();
+    m_Scale       .clear();
+    m_World       .clear();
+    m_Parent      .clear();
+    m_Depth       .clear();
+    m_Dirty       .clear();
+    m_Changed     .clear();
+    m_SlotOfHandle.clear();
+    m_HandleOfSlot.clear();
+    m_LevelOffset .assign( 1, 0 );
+    m_DirtyHandle .clear();
+    m_ChildOffset .clear();
+    m_Child       .clear();
+
+    m_Sorted     = true;
+    m_ChildValid = true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを追加します.
+//-------------------------------------------------------------------------------------------------
+uint32_t TransformHierarchy::Add
+(
+    uint32_t            parent,
+    const Vector3&      translation,
+    const Quaternion&   rotation,
+    const Vector3&      scale
+)
+{
+    assert( parent == INVALID_HANDLE || parent < m_SlotOfHandle.size() );
+
+    auto handle     = static_cast<uint32_t>( m_SlotOfHandle.size() );
+    auto slot       = static_cast<uint32_t>( m_Depth.size() );
+    auto parentSlot = ( parent == INVALID_HANDLE ) ? INVALID_HANDLE : m_SlotOfHandle[parent];
+    auto depth      = ( parentSlot == INVALID_HANDLE ) ? 0 : m_Depth[parentSlot] + 1;
+
+    m_Translation .push_back( translation );
+    m_Rotation    .push_back( rotation );
+    m_Scale       .push_back( scale );
+    m_World       .push_back( Matrix::CreateIdentity() );
+    m_Parent      .push_back( parentSlot );
+    m_Depth       .push_back( depth );
+    m_Dirty       .push_back( 1 );
+    m_Changed     .push_back( 0 );
+    m_SlotOfHandle.push_back( slot );
+    m_HandleOfSlot.push_back( handle );
+    m_DirtyHandle .push_back( handle );
+    m_ChildValid = false;
+
+    // 末尾の深さか，その次の深さであれば深さ順が保たれる.
+    if ( m_Sorted )
+    {
+        auto levels = static_cast<uint32_t>( m_LevelOffset.size() - 1 );
+        if ( depth + 1 == levels )
+        { m_LevelOffset.back()++; }
+        else if ( depth == levels )
+        { m_LevelOffset.push_back( slot + 1 ); }
+        else
+        { m_Sorted = false; }
+    }
+
+    return handle;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ローカル変換を設定し，ノードを更新対象にします.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::SetLocal
+(
+    uint32_t            handle,
+    const Vector3&      translation,
+    const Quaternion&   rotation,
+    const Vector3&      scale
+)
+{
+    assert( handle < m_SlotOfHandle.size() );
+    auto slot = m_SlotOfHandle[handle];
+    m_Translation[slot] = translation;
+    m_Rotation   [slot] = rotation;
+    m_Scale      [slot] = scale;
+    MarkDirty( slot );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ローカル平行移動量を設定し，ノードを更新対象にします.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::SetTranslation( uint32_t handle, const Vector3& translation )
+{
+    assert( handle < m_SlotOfHandle.size() );
+    auto slot = m_SlotOfHandle[handle];
+    m_Translation[slot] = translation;
+    MarkDirty( slot );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ローカル回転を設定し，ノードを更新対象にします.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::SetRotation( uint32_t handle, const Quaternion& rotation )
+{
+    assert( handle < m_SlotOfHandle.size() );
+    auto slot = m_SlotOfHandle[handle];
+    m_Rotation[slot] = rotation;
+    MarkDirty( slot );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ローカル拡大縮小率を設定し，ノードを更新対象にします.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::SetScale( uint32_t handle, const Vector3& scale )
+{
+    assert( handle < m_SlotOfHandle.size() );
+    auto slot = m_SlotOfHandle[handle];
+    m_Scale[slot] = scale;
+    MarkDirty( slot );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ローカル平行移動量を取得します.
+//-------------------------------------------------------------------------------------------------
+const Vector3& TransformHierarchy::GetTranslation( uint32_t handle ) const
+{
+    assert( handle < m_SlotOfHandle.size() );
+    return m_Translation[m_SlotOfHandle[handle]];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ローカル回転を取得します.
+//-------------------------------------------------------------------------------------------------
+const Quaternion& TransformHierarchy::GetRotation( uint32_t handle ) const
+{
+    assert( handle < m_SlotOfHandle.size() );
+    return m_Rotation[m_SlotOfHandle[handle]];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ローカル拡大縮小率を取得します.
+//-------------------------------------------------------------------------------------------------
+const Vector3& TransformHierarchy::GetScale( uint32_t handle ) const
+{
+    assert( handle < m_SlotOfHandle.size() );
+    return m_Scale[m_SlotOfHandle[handle]];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      親ノードのハンドルを取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t TransformHierarchy::GetParent( uint32_t handle ) const
+{
+    assert( handle < m_SlotOfHandle.size() );
+    auto parentSlot = m_Parent[m_SlotOfHandle[handle]];
+    return ( parentSlot == INVALID_HANDLE ) ? INVALID_HANDLE : m_HandleOfSlot[parentSlot];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ワールド行列を取得します.
+//-------------------------------------------------------------------------------------------------
+const Matrix& TransformHierarchy::GetWorld( uint32_t handle ) const
+{
+    assert( handle < m_SlotOfHandle.size() );
+    return m_World[m_SlotOfHandle[handle]];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノード数を取得します.
+//-------------------------------------------------------------------------------------------------
+size_t TransformHierarchy::GetCount() const
+{ return m_SlotOfHandle.size(); }
+
+//-------------------------------------------------------------------------------------------------
+//      ハンドルに対応する格納位置を取得します.
+//-------------------------------------------------------------------------------------------------
+uint32_t TransformHierarchy::GetSlot( uint32_t handle ) const
+{
+    assert( handle < m_SlotOfHandle.size() );
+    return m_SlotOfHandle[handle];
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ワールド行列の配列を取得します.
+//-------------------------------------------------------------------------------------------------
+const Matrix* TransformHierarchy::GetWorldMatrices() const
+{ return m_World.data(); }
+
+//-------------------------------------------------------------------------------------------------
+//      更新対象のノードとその子孫のワールド行列を計算します.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::Update()
+{
+    if ( m_DirtyHandle.empty() )
+    { return; }
+
+    if ( !m_Sorted )
+    { Sort(); }
+
+    if ( !m_ChildValid )
+    { BuildChildren(); }
+
+    auto levels = m_LevelOffset.size() - 1;
+    if ( m_LevelQueue.size() < levels )
+    { m_LevelQueue.resize( levels ); }
+
+    // 更新対象を深さごとの待ち行列に振り分ける.
+    for( auto handle : m_DirtyHandle )
+    {
+        auto slot = m_SlotOfHandle[handle];
+        m_LevelQueue[m_Depth[slot]].push_back( slot );
+    }
+    m_DirtyHandle.clear();
+
+    // 親は必ず1つ浅い深さにあるので，深さごとに処理すれば親の更新は済んでいる.
+    // 待ち行列が小さい間は待ち行列のノードだけを計算し，その子を次の深さの待ち行列に積む.
+    // 子は m_Dirty を立ててから積むので，同じノードが2度積まれることはない.
+    size_t level = 0;
+    for( ; level < levels; ++level )
+    {
+        auto& queue = m_LevelQueue[level];
+        auto  width = m_LevelOffset[level + 1] - m_LevelOffset[level];
+        if ( queue.size() * HIERARCHY_SPARSE_RATIO > width )
+        { break; }
+
+        auto count = static_cast<int64_t>( queue.size() );
+
+    #if ASVK_IS_OPENMP
+        #pragma omp parallel for if( count >= HIERARCHY_PARALLEL_THRESHOLD )
+    #endif
+        for( int64_t j=0; j<count; ++j )
+        {
+            auto i      = queue[j];
+            auto parent = m_Parent[i];
+
+            m_Dirty[i] = 0;
+            auto local = ComposeTRS( m_Translation[i], m_Rotation[i], m_Scale[i] );
+            m_World[i] = ( parent == INVALID_HANDLE ) ? local : Matrix::Multiply( local, m_World[parent] );
+        }
+
+        if ( level + 1 < levels )
+        {
+            auto& next = m_LevelQueue[level + 1];
+            for( auto i : queue )
+            {
+                for( auto c = m_ChildOffset[i]; c < m_ChildOffset[i + 1]; ++c )
+                {
+                    auto child = m_Child[c];
+                    if ( m_Dirty[child] )
+                    { continue; }
+
+                    m_Dirty[child] = 1;
+                    next.push_back( child );
+                }
+            }
+        }
+
+        queue.clear();
+    }
+
+    // 残りの深さは全ノードを走査する. 切り替えた深さでは親の変化は m_Dirty に反映済みなので，
+    // 更新されていない m_Changed は参照しない.
+    auto first = level;
+    for( ; level < levels; ++level )
+    {
+        auto begin = static_cast<int64_t>( m_LevelOffset[level + 0] );
+        auto end   = static_cast<int64_t>( m_LevelOffset[level + 1] );
+        auto inherit = ( level > first );
+
+        m_LevelQueue[level].clear();
+
+    #if ASVK_IS_OPENMP
+        #pragma omp parallel for if( end - begin >= HIERARCHY_PARALLEL_THRESHOLD )
+    #endif
+        for( int64_t i=begin; i<end; ++i )
+        {
+            auto parent = m_Parent[i];
+            auto dirty  = m_Dirty[i] || ( inherit && parent != INVALID_HANDLE && m_Changed[parent] );
+
+            m_Changed[i] = dirty ? 1 : 0;
+            if ( !dirty )
+            { continue; }
+
+            m_Dirty[i] = 0;
+            auto local = ComposeTRS( m_Translation[i], m_Rotation[i], m_Scale[i] );
+            m_World[i] = ( parent == INVALID_HANDLE ) ? local : Matrix::Multiply( local, m_World[parent] );
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ノードを更新対象にします.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::MarkDirty( uint32_t slot )
+{
+    if ( m_Dirty[slot] )
+    { return; }
+
+    m_Dirty[slot] = 1;
+    m_DirtyHandle.push_back( m_HandleOfSlot[slot] );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      深さ順に並べ替えます.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::Sort()
+{
+    auto count = m_Depth.size();
+
+    uint32_t levels = 0;
+    for( size_t i = 0; i < count; ++i )
+    { levels = Max( levels, m_Depth[i] + 1 ); }
+
+    // 深さによる計数ソート(同じ深さの中では元の順序を保つ).
+    m_LevelOffset.assign( levels + 1, 0 );
+    for( size_t i = 0; i < count; ++i )
+    { m_LevelOffset[m_Depth[i] + 1]++; }
+    for( uint32_t i = 0; i < levels; ++i )
+    { m_LevelOffset[i + 1] += m_LevelOffset[i]; }
+
+    std::vector<uint32_t> cursor( m_LevelOffset.begin(), m_LevelOffset.end() - 1 );
+    std::vector<uint32_t> newSlot( count );
+    for( size_t i = 0; i < count; ++i )
+    { newSlot[i] = cursor[m_Depth[i]]++; }
+
+    // 親の格納位置は並べ替え後の位置に付け替える.
+    for( size_t i = 0; i < count; ++i )
+    {
+        if ( m_Parent[i] != INVALID_HANDLE )
+        { m_Parent[i] = newSlot[m_Parent[i]]; }
+    }
+
+    Permute( m_Translation,  newSlot );
+    Permute( m_Rotation,     newSlot );
+    Permute( m_Scale,        newSlot );
+    Permute( m_World,        newSlot );
+    Permute( m_Parent,       newSlot );
+    Permute( m_Depth,        newSlot );
+    Permute( m_Dirty,        newSlot );
+    Permute( m_Changed,      newSlot );
+    Permute( m_HandleOfSlot, newSlot );
+
+    for( size_t i = 0; i < count; ++i )
+    { m_SlotOfHandle[m_HandleOfSlot[i]] = static_cast<uint32_t>( i ); }
+
+    m_Sorted     = true;
+    m_ChildValid = false;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      子の対応表を構築します.
+//-------------------------------------------------------------------------------------------------
+void TransformHierarchy::BuildChildren()
+{
+    auto count = m_Parent.size();
+
+    // 親の格納位置による計数ソート.
+    m_ChildOffset.assign( count + 1, 0 );
+    for( size_t i = 0; i < count; ++i )
+    {
+        if ( m_Parent[i] != INVALID_HANDLE )
+        { m_ChildOffset[m_Parent[i] + 1]++; }
+    }
+    for( size_t i = 0; i < count; ++i )
+    { m_ChildOffset[i + 1] += m_ChildOffset[i]; }
+
+    std::vector<uint32_t> cursor( m_ChildOffset.begin(), m_ChildOffset.end() - 1 );
+    m_Child.resize( m_ChildOffset[count] );
+    for( size_t i = 0; i < count; ++i )
+    {
+        if ( m_Parent[i] != INVALID_HANDLE )
+        { m_Child[cursor[m_Parent[i]]++] = static_cast<uint32_t>( i ); }
+    }
+
+    m_ChildValid = true;
+}
+
+} // namespace asvk
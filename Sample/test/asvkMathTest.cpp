@@ -0,0 +1,3111 @@
+﻿//-------------------------------------------------------------------------------------------------
+// File : asvkMathTest.cpp
+// Desc : Math Unit Test.
+// Copyright(c) Project Asura. All right reserved.
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Includes
+//-------------------------------------------------------------------------------------------------
+#include <asvkMath.h>
+#include <asvkAnimation.h>
+#include <asvkGeometry.h>
+#include <asvkTransformHierarchy.h>
+#include <asvkSpline.h>
+#include <asvkBvh.h>
+#include <asvkSpatialHash.h>
+#include <asvkBroadphase.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if ASVK_IS_OPENMP
+#include <omp.h>
+#endif
+
+
+namespace /* anonymous */ {
+
+//-------------------------------------------------------------------------------------------------
+// Using Statements
+//-------------------------------------------------------------------------------------------------
+using namespace asvk;
+
+
+//-------------------------------------------------------------------------------------------------
+// Constant Values
+//-------------------------------------------------------------------------------------------------
+static constexpr int        TEST_SEED               = 0x5eed;   //!< 入力データを生成する乱数の種です.
+static constexpr int        TEST_MATRIX_COUNT       = 100000;   //!< 行列の試験で生成する行列の数です.
+static constexpr double     TEST_INVERT_BOUND       = 4.0;      //!< 逆行列の差の上限です(FLT_EPSILON * 条件数 * 逆行列のノルムに対する比).
+static constexpr size_t     TEST_MAX_REPORT         = 8;        //!< 1項目あたりに表示する失敗の最大数です.
+static constexpr float      TEST_SINCOS_RANGE       = 1e5f;     //!< SinCosFast() の入力の範囲です.
+static constexpr double     TEST_SINCOS_BOUND_PI    = 3e-7;     //!< SinCosFast() の |radian| <= π での最大絶対誤差です.
+static constexpr double     TEST_SINCOS_BOUND       = 2e-6;     //!< SinCosFast() の |radian| <= 1e5 での最大絶対誤差です.
+#if ASVK_IS_SIMD
+static constexpr double     TEST_RSQRT_BOUND        = 5e-7;     //!< RsqrtFast() の最大相対誤差です.
+#else
+static constexpr double     TEST_RSQRT_BOUND        = 5e-6;     //!< RsqrtFast() の最大相対誤差です.
+#endif//ASVK_IS_SIMD
+static constexpr double     TEST_ATAN2_BOUND        = 5e-7;     //!< Atan2Fast() の最大絶対誤差です.
+static constexpr double     TEST_NORMALIZE_BOUND    = TEST_RSQRT_BOUND + 2.0 * FLT_EPSILON;   //!< NormalizeFast() の各成分の最大誤差です(長さの2乗と乗算の丸めを足します).
+static constexpr float      TEST_YPR_RANGE          = F_2PI;    //!< CreateFromYawPitchRollFast() の試験の角度の範囲です.
+static constexpr double     TEST_YPR_QUAT_BOUND     = 1e-6;     //!< Quaternion::CreateFromYawPitchRollFast() の各成分の最大絶対誤差です.
+static constexpr double     TEST_YPR_MATRIX_BOUND   = 4e-6;     //!< Matrix::CreateRotationFromYawPitchRollFast() の各成分の最大絶対誤差です.
+static constexpr int        TEST_YPR_GRID           = 129;      //!< ヨー・ピッチ・ロール角の格子の1辺の点数です(両端を含みます).
+static constexpr int        TEST_BASIS_COUNT        = 100000;   //!< 正規直交基底の試験で生成する方向の数です.
+static constexpr double     TEST_BASIS_BOUND        = 4.0 * FLT_EPSILON;    //!< 正規直交基底の内積, 長さ, 外積の誤差の上限です.
+static constexpr size_t     TEST_BASIS_LARGE_COUNT  = 4099;     //!< CreateFromW() の試験で使う大きな要素数です(4 の倍数 + 3).
+static constexpr size_t     TEST_ANIMATION_TRACKS   = 67;       //!< アニメーションの試験のトラック数です(4 の倍数 + 3).
+static constexpr uint32_t   TEST_ANIMATION_KEYS     = 64;       //!< アニメーションの試験のトラックごとのキー数です.
+static constexpr uint32_t   TEST_ANIMATION_STEPS    = 20000;    //!< アニメーションの試験でサンプリングする回数です.
+static constexpr double     TEST_ANIMATION_BOUND    = 0.1;      //!< Slerp() との回転の差の上限(度)です(nlerp の 0.08° と量子化の誤差).
+static constexpr int        TEST_QUATERNION_COUNT   = 100000;   //!< 四元数の積の試験で生成する組の数です.
+static constexpr double     TEST_QUATERNION_BOUND   = 8.0 * FLT_EPSILON;    //!< 四元数の積と回転行列の積の各成分の差の上限です.
+static constexpr int        TEST_DUALQUAT_COUNT     = 100000;   //!< 双対四元数の変換の試験で生成する変換の数です.
+static constexpr double     TEST_DUALQUAT_BOUND     = 1e-5;     //!< 双対四元数と行列の変換結果の差の上限です(max(1, |期待値|) に対する比).
+static constexpr size_t     TEST_SKIN_BONES         = 64;       //!< スキニングの試験のボーン数です(4 の倍数).
+static constexpr size_t     TEST_SKIN_COUNT         = 4099;     //!< スキニングの試験の頂点数です(4 の倍数 + 3).
+static constexpr int        TEST_HIERARCHY_TRIALS   = 100;      //!< 階層構造の試験で作成する階層の数です.
+static constexpr uint32_t   TEST_HIERARCHY_NODES    = 2000;     //!< 階層構造の試験で最初に追加するノード数の上限です.
+static constexpr int        TEST_HIERARCHY_STEPS    = 20;       //!< 階層構造の試験で1つの階層を更新する回数です.
+static constexpr int        TEST_SPLINE_CURVES      = 50;       //!< スプラインの試験で生成する曲線の数です.
+static constexpr uint32_t   TEST_SPLINE_POINTS      = 64;       //!< スプラインの試験の制御点の数の上限です.
+static constexpr uint32_t   TEST_SPLINE_STEPS       = 256;      //!< 等速移動の試験で区間ごとに進める回数です.
+static constexpr double     TEST_SPLINE_SPEED_BOUND = 0.01;     //!< 等速移動の試験の1歩ごとの弧長と距離の相対誤差の上限です.
+static constexpr double     TEST_SPLINE_TOTAL_BOUND = 1e-5;     //!< 曲線の全長の相対誤差の上限です.
+static constexpr size_t     TEST_SPLINE_PARAMS      = 4099;     //!< まとめて評価する試験のパラメータの数です(4 の倍数 + 3).
+static constexpr int        TEST_BVH_SCENES         = 40;       //!< BVH の試験で生成する配置の数です.
+static constexpr uint32_t   TEST_BVH_MAX_BOXES      = 4099;     //!< BVH の試験の箱の数の上限です.
+static constexpr int        TEST_BVH_RAYS           = 500;      //!< BVH の試験で配置ごとに判定するレイの数です.
+static constexpr int        TEST_HASH_TRIALS        = 24;       //!< 空間ハッシュの試験で作成するハッシュの数です.
+static constexpr int        TEST_HASH_STEPS         = 8;        //!< 空間ハッシュの試験で1つのハッシュを更新する回数です.
+static constexpr int        TEST_HASH_OPERATIONS    = 400;      //!< 1回の更新で行う追加・移動・削除の回数です.
+static constexpr int        TEST_HASH_QUERIES       = 40;       //!< 1回の更新ごとに検索する回数です.
+static constexpr int        TEST_BROADPHASE_SCENES  = 20;       //!< ブロードフェーズの試験で生成する配置の数です.
+static constexpr size_t     TEST_BROADPHASE_COUNT   = 4099;     //!< ブロードフェーズの試験の大きな配置の物体数です(並列化する閾値を超える数).
+static constexpr int        TEST_BROADPHASE_STEPS   = 3;        //!< ブロードフェーズの試験で1つの配置を動かして求め直す回数です.
+static constexpr int        TEST_FRUSTUM_COUNT      = 200;      //!< 錐台カリングの試験で生成する錐台の数です.
+static constexpr size_t     TEST_CULL_COUNT         = 4099;     //!< 錐台カリングの試験で錐台ごとに生成する物体の数です(32 の倍数 + 3).
+static constexpr size_t     TEST_STREAM_FILL_COUNT  = 16384 * 67 + 5;   //!< RandomStream::FillU32() の試験の要素数です(並列化の1巡を超える数).
+static constexpr int        TEST_STREAM_THREADS     = 4;        //!< RandomStream::FillU32() の試験で比べるスレッド数です.
+static constexpr uint32_t   TEST_STREAM_SPLITS      = 4;        //!< RandomStream::Split() の試験で確かめる系列の数です.
+static constexpr size_t     TEST_STREAM_OUTPUTS     = 16;       //!< RandomStream のジャンプの試験で比べる出力の数です.
+static constexpr size_t     TEST_PACKING_COUNT      = 1000000;  //!< 八面体写像と QTangent の試験で生成する方向の数です.
+static constexpr double     TEST_OCTAHEDRAL16_BOUND = 0.004;    //!< EncodeOctahedral16() の往復の角度誤差の上限(度)です.
+static constexpr double     TEST_OCTAHEDRAL8_BOUND  = 1.0;      //!< EncodeOctahedral8() の往復の角度誤差の上限(度)です.
+static constexpr double     TEST_QTANGENT_BOUND     = 0.5;      //!< EncodeQTangent() の往復の法線と接線の角度誤差の上限(度)です.
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestOption structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TestOption
+{
+    uint32_t        Stride;         //!< 全ての float を走査する試験で, ビット列を進める幅です(1 の場合は全て).
+    const char*     Filter;         //!< 名前に含まれる文字列で項目を絞り込みます(nullptrの場合は全項目).
+    bool            List;           //!< 項目名の一覧だけを表示する場合は true.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    TestOption()
+    : Stride    ( 1 )
+    , Filter    ( nullptr )
+    , List      ( false )
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SweepResult structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct SweepResult
+{
+    double      MaxError;       //!< 誤差の最大値です.
+    float       Worst;          //!< 誤差が最大になった入力値です.
+    uint64_t    Count;          //!< 誤差を求めた入力値の数です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    SweepResult()
+    : MaxError  ( 0.0 )
+    , Worst     ( 0.0f )
+    , Count     ( 0 )
+    { /* DO_NOTHING */ }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      入力値の誤差を記録します.
+    //---------------------------------------------------------------------------------------------
+    void Add( float value, double error )
+    {
+        Count++;
+        if ( error > MaxError || error != error )
+        {
+            MaxError = ( error != error ) ? HUGE_VAL : error;
+            Worst    = value;
+        }
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      別の結果を統合します.
+    //---------------------------------------------------------------------------------------------
+    void Merge( const SweepResult& value )
+    {
+        Count += value.Count;
+        if ( value.MaxError > MaxError )
+        {
+            MaxError = value.MaxError;
+            Worst    = value.Worst;
+        }
+    }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestContext structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TestContext
+{
+    size_t      Checks;         //!< 判定の数です.
+    size_t      Failures;       //!< 失敗した判定の数です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //---------------------------------------------------------------------------------------------
+    TestContext()
+    : Checks    ( 0 )
+    , Failures  ( 0 )
+    { /* DO_NOTHING */ }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// TestEntry structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct TestEntry
+{
+    std::string                         Name;   //!< 試験対象の名前です.
+    std::function<void(TestContext&)>  Run;    //!< 試験を行う関数です.
+};
+
+
+//-------------------------------------------------------------------------------------------------
+//      判定結果を記録します. 失敗した場合は先頭の数件だけ内容を表示します.
+//-------------------------------------------------------------------------------------------------
+void Check( TestContext& context, bool condition, const char* format, ... )
+{
+    context.Checks++;
+    if ( condition )
+    { return; }
+
+    if ( context.Failures++ < TEST_MAX_REPORT )
+    {
+        va_list args;
+        va_start( args, format );
+        fprintf( stdout, "    " );
+        vfprintf( stdout, format, args );
+        fprintf( stdout, "\n" );
+        va_end( args );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ビット単位で一致するかどうかチェックします(-0 と +0 は区別します).
+//-------------------------------------------------------------------------------------------------
+bool IsSameBits( const float* a, const float* b, size_t count )
+{ return memcmp( a, b, sizeof(float) * count ) == 0; }
+
+//-------------------------------------------------------------------------------------------------
+//      ビット列から float を求めます.
+//-------------------------------------------------------------------------------------------------
+float FromBits( uint32_t bits )
+{
+    float result;
+    memcpy( &result, &bits, sizeof(result) );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      float のビット列を求めます.
+//-------------------------------------------------------------------------------------------------
+uint32_t ToBits( float value )
+{
+    uint32_t result;
+    memcpy( &result, &value, sizeof(result) );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ビット列が [first, last] の範囲にある全ての float について誤差を求めます.
+//      stride が 1 より大きい場合は stride ごとに間引きますが, 両端は必ず含めます.
+//      error は double( float value ) の形式で, 入力値の誤差を返します.
+//-------------------------------------------------------------------------------------------------
+template<typename ErrorFunc>
+SweepResult Sweep( uint32_t first, uint32_t last, uint32_t stride, const ErrorFunc& error )
+{
+    SweepResult result;
+    auto steps = int64_t( ( uint64_t( last ) - uint64_t( first ) ) / stride );
+
+#if ASVK_IS_OPENMP
+    #pragma omp parallel
+#endif
+    {
+        SweepResult local;
+
+    #if ASVK_IS_OPENMP
+        #pragma omp for schedule(static)
+    #endif
+        for( int64_t i=0; i<=steps; ++i )
+        {
+            auto value = FromBits( uint32_t( first + uint64_t( i ) * stride ) );
+            local.Add( value, error( value ) );
+        }
+
+    #if ASVK_IS_OPENMP
+        #pragma omp critical
+    #endif
+        { result.Merge( local ); }
+    }
+
+    if ( ( uint64_t( last ) - uint64_t( first ) ) % stride != 0 )
+    { result.Add( FromBits( last ), error( FromBits( last ) ) ); }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      正負両方の符号で, 絶対値のビット列が [first, last] の範囲にある全ての float の誤差を求めます.
+//-------------------------------------------------------------------------------------------------
+template<typename ErrorFunc>
+SweepResult SweepSigned( uint32_t first, uint32_t last, uint32_t stride, const ErrorFunc& error )
+{
+    auto result = Sweep( first, last, stride, error );
+    result.Merge( Sweep( first | 0x80000000u, last | 0x80000000u, stride, error ) );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数で行列を生成します.
+//-------------------------------------------------------------------------------------------------
+Matrix RandomMatrix( Random& random, float range )
+{
+    Matrix result;
+    for( auto i=0; i<4; ++i )
+    {
+        for( auto j=0; j<4; ++j )
+        { result.m[i][j] = random.GetAsF32( -range, range ); }
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行ごとの絶対値の和の最大値(無限大ノルム)を求めます.
+//-------------------------------------------------------------------------------------------------
+double NormInf( const Matrix& value )
+{
+    double result = 0.0;
+    for( auto i=0; i<4; ++i )
+    {
+        double sum = 0.0;
+        for( auto j=0; j<4; ++j )
+        { sum += fabs( double( value.m[i][j] ) ); }
+        result = std::max( result, sum );
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列同士を乗算します(スカラー版と同じ加算順序の参照実装).
+//-------------------------------------------------------------------------------------------------
+Matrix MultiplyRef( const Matrix& a, const Matrix& b )
+{
+    Matrix result;
+    for( auto i=0; i<4; ++i )
+    {
+        for( auto j=0; j<4; ++j )
+        { result.m[i][j] = ( a.m[i][0] * b.m[0][j] ) + ( a.m[i][1] * b.m[1][j] ) + ( a.m[i][2] * b.m[2][j] ) + ( a.m[i][3] * b.m[3][j] ); }
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数でアフィン変換行列を生成します. 積が -0 になるように約1/4の要素を ±0 にします.
+//-------------------------------------------------------------------------------------------------
+Matrix3x4 RandomMatrix3x4( Random& random, float range )
+{
+    Matrix3x4 result;
+    for( auto i=0; i<3; ++i )
+    {
+        for( auto j=0; j<4; ++j )
+        {
+            auto value = random.GetAsF32( -range, range );
+            switch( random.GetAsU32() % 8 )
+            {
+            case 0:  result.m[i][j] =  0.0f; break;
+            case 1:  result.m[i][j] = -0.0f; break;
+            default: result.m[i][j] = value; break;
+            }
+        }
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      アフィン変換行列同士を合成します(スカラー版と同じ加算順序の参照実装).
+//-------------------------------------------------------------------------------------------------
+Matrix3x4 MultiplyRef3x4( const Matrix3x4& a, const Matrix3x4& b )
+{
+    Matrix3x4 result;
+    for( auto i=0; i<3; ++i )
+    {
+        for( auto j=0; j<4; ++j )
+        {
+            auto value = ( ( a.m[0][j] * b.m[i][0] ) + ( a.m[1][j] * b.m[i][1] ) ) + ( a.m[2][j] * b.m[i][2] );
+            result.m[i][j] = ( j == 3 ) ? value + b.m[i][3] : value;
+        }
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      行列を転置します(参照実装).
+//-------------------------------------------------------------------------------------------------
+Matrix TransposeRef( const Matrix& value )
+{
+    Matrix result;
+    for( auto i=0; i<4; ++i )
+    {
+        for( auto j=0; j<4; ++j )
+        { result.m[i][j] = value.m[j][i]; }
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ベクトルを行列で変換します(スカラー版と同じ加算順序の参照実装).
+//-------------------------------------------------------------------------------------------------
+Vector4 TransformRef( const Vector4& value, const Matrix& matrix )
+{
+    float result[4];
+    for( auto j=0; j<4; ++j )
+    { result[j] = ( ( ( value.x * matrix.m[0][j] ) + ( value.y * matrix.m[1][j] ) ) + ( value.z * matrix.m[2][j] ) ) + ( value.w * matrix.m[3][j] ); }
+    return Vector4( result[0], result[1], result[2], result[3] );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆行列を求めます(スカラー版と同じ余因子展開の参照実装).
+//-------------------------------------------------------------------------------------------------
+Matrix InvertRef( const Matrix& value )
+{
+    auto det = value.Determinant();
+
+    auto m11 = value._22*value._33*value._44 + value._23*value._34*value._42 + value._24*value._32*value._43 - value._22*value._34*value._43 - value._23*value._32*value._44 - value._24*value._33*value._42;
+    auto m12 = value._12*value._34*value._43 + value._13*value._32*value._44 + value._14*value._33*value._42 - value._12*value._33*value._44 - value._13*value._34*value._42 - value._14*value._32*value._43;
+    auto m13 = value._12*value._23*value._44 + value._13*value._24*value._42 + value._14*value._22*value._43 - value._12*value._24*value._43 - value._13*value._22*value._44 - value._14*value._23*value._42;
+    auto m14 = value._12*value._24*value._33 + value._13*value._22*value._34 + value._14*value._23*value._32 - value._12*value._23*value._34 - value._13*value._24*value._32 - value._14*value._22*value._33;
+
+    auto m21 = value._21*value._34*value._43 + value._23*value._31*value._44 + value._24*value._33*value._41 - value._21*value._33*value._44 - value._23*value._34*value._41 - value._24*value._31*value._43;
+    auto m22 = value._11*value._33*value._44 + value._13*value._34*value._41 + value._14*value._31*value._43 - value._11*value._34*value._43 - value._13*value._31*value._44 - value._14*value._33*value._41;
+    auto m23 = value._11*value._24*value._43 + value._13*value._21*value._44 + value._14*value._23*value._41 - value._11*value._23*value._44 - value._13*value._24*value._41 - value._14*value._21*value._43;
+    auto m24 = value._11*value._23*value._34 + value._13*value._24*value._31 + value._14*value._21*value._33 - value._11*value._24*value._33 - value._13*value._21*value._34 - value._14*value._23*value._31;
+
+    auto m31 = value._21*value._32*value._44 + value._22*value._34*value._41 + value._24*value._31*value._42 - value._21*value._34*value._42 - value._22*value._31*value._44 - value._24*value._32*value._41;
+    auto m32 = value._11*value._34*value._42 + value._12*value._31*value._44 + value._14*value._32*value._41 - value._11*value._32*value._44 - value._12*value._34*value._41 - value._14*value._31*value._42;
+    auto m33 = value._11*value._22*value._44 + value._12*value._24*value._41 + value._14*value._21*value._42 - value._11*value._24*value._42 - value._12*value._21*value._44 - value._14*value._22*value._41;
+    auto m34 = value._11*value._24*value._32 + value._12*value._21*value._34 + value._14*value._22*value._31 - value._11*value._22*value._34 - value._12*value._24*value._31 - value._14*value._21*value._32;
+
+    auto m41 = value._21*value._33*value._42 + value._22*value._31*value._43 + value._23*value._32*value._41 - value._21*value._32*value._43 - value._22*value._33*value._41 - value._23*value._31*value._42;
+    auto m42 = value._11*value._32*value._43 + value._12*value._33*value._41 + value._13*value._31*value._42 - value._11*value._33*value._42 - value._12*value._31*value._43 - value._13*value._32*value._41;
+    auto m43 = value._11*value._23*value._42 + value._12*value._21*value._43 + value._13*value._22*value._41 - value._11*value._22*value._43 - value._12*value._23*value._41 - value._13*value._21*value._42;
+    auto m44 = value._11*value._22*value._33 + value._12*value._23*value._31 + value._13*value._21*value._32 - value._11*value._23*value._32 - value._12*value._21*value._33 - value._13*value._22*value._31;
+
+    return Matrix(
+        m11 / det, m12 / det, m13 / det, m14 / det,
+        m21 / det, m22 / det, m23 / det, m24 / det,
+        m31 / det, m32 / det, m33 / det, m34 / det,
+        m41 / det, m42 / det, m43 / det, m44 / det );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      逆行列を求める試験用の行列を生成します.
+//      一般の行列, アフィン変換, ビュー射影変換を順に生成します.
+//-------------------------------------------------------------------------------------------------
+Matrix InvertibleMatrix( Random& random, int index )
+{
+    switch( index % 3 )
+    {
+    case 0:
+        {
+            // 行列式が小さすぎるものは条件数が桁外れになるため作り直す.
+            auto result = RandomMatrix( random, 1.0f );
+            while( fabsf( result.Determinant() ) < 1e-2f )
+            { result = RandomMatrix( random, 1.0f ); }
+            return result;
+        }
+
+    case 1:
+        {
+            auto rotation = Quaternion::Normalize( Quaternion(
+                random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( 0.1f, 1.0f ) ) );
+            auto scale = Matrix::CreateScale( random.GetAsF32( 0.1f, 10.0f ), random.GetAsF32( 0.1f, 10.0f ), random.GetAsF32( 0.1f, 10.0f ) );
+            auto translation = Matrix::CreateTranslation( random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ) );
+            return Matrix::Multiply( Matrix::Multiply( scale, Matrix::CreateFromQuaternion( rotation ) ), translation );
+        }
+
+    default:
+        {
+            auto eye  = Vector3( random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ) );
+            auto view = Matrix::CreateLookAt( eye, Vector3( 0.0f, 0.0f, 0.0f ), Vector3( 0.0f, 1.0f, 0.0f ) );
+            auto proj = Matrix::CreatePerspectiveFieldOfView( ToRadian( random.GetAsF32( 30.0f, 90.0f ) ), 16.0f / 9.0f, 0.1f, 1000.0f );
+            return Matrix::Multiply( view, proj );
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Matrix::Multiply() がスカラー版とビット単位で一致するか試験します.
+//-------------------------------------------------------------------------------------------------
+void TestMatrixMultiply( TestContext& context )
+{
+    Random random( TEST_SEED );
+    for( auto n=0; n<TEST_MATRIX_COUNT; ++n )
+    {
+        auto a = RandomMatrix( random, 100.0f );
+        auto b = RandomMatrix( random, 100.0f );
+        auto expected = MultiplyRef( a, b );
+
+        Matrix result0 = Matrix::Multiply( a, b );
+        Matrix result1;
+        Matrix::Multiply( a, b, result1 );
+        Matrix result2 = a;
+        result2 *= b;
+
+        Check( context, IsSameBits( &result0._11, &expected._11, 16 ), "Multiply( a, b ) differs at #%d", n );
+        Check( context, IsSameBits( &result1._11, &expected._11, 16 ), "Multiply( a, b, result ) differs at #%d", n );
+        Check( context, IsSameBits( &result2._11, &expected._11, 16 ), "operator *= differs at #%d", n );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Matrix3x4::Multiply() がスカラー版とビット単位で一致するか試験します(-0 の保持も含みます).
+//-------------------------------------------------------------------------------------------------
+void TestMatrix3x4Multiply( TestContext& context )
+{
+    Random random( TEST_SEED );
+    for( auto n=0; n<TEST_MATRIX_COUNT; ++n )
+    {
+        auto a = RandomMatrix3x4( random, 100.0f );
+        auto b = RandomMatrix3x4( random, 100.0f );
+        auto expected = MultiplyRef3x4( a, b );
+
+        Matrix3x4 result0 = Matrix3x4::Multiply( a, b );
+        Matrix3x4 result1;
+        Matrix3x4::Multiply( a, b, result1 );
+        Matrix3x4 result2 = a * b;
+        Matrix3x4 result3 = a;
+        result3 *= b;
+
+        Check( context, IsSameBits( &result0._11, &expected._11, 12 ), "Multiply( a, b ) differs at #%d", n );
+        Check( context, IsSameBits( &result1._11, &expected._11, 12 ), "Multiply( a, b, result ) differs at #%d", n );
+        Check( context, IsSameBits( &result2._11, &expected._11, 12 ), "operator * differs at #%d", n );
+        Check( context, IsSameBits( &result3._11, &expected._11, 12 ), "operator *= differs at #%d", n );
+    }
+
+    // 全ての項が -0 になる要素は -0 のままであること.
+    auto a = Matrix3x4( 0.0f, 0.0f, 0.0f, 0.0f,  0.0f, 0.0f, 0.0f, 0.0f,  0.0f, 0.0f, 0.0f, 0.0f );
+    auto b = Matrix3x4( -1.0f, -1.0f, -1.0f, -0.0f,  -1.0f, -1.0f, -1.0f, -0.0f,  -1.0f, -1.0f, -1.0f, -0.0f );
+    auto result = Matrix3x4::Multiply( a, b );
+    auto expected = MultiplyRef3x4( a, b );
+    Check( context, IsSameBits( &result._11, &expected._11, 12 ) && std::signbit( result._11 ) && std::signbit( result._14 ),
+        "Multiply() does not keep -0 (_11 = %g, _14 = %g)", result._11, result._14 );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Matrix::Transpose() がスカラー版とビット単位で一致するか試験します.
+//-------------------------------------------------------------------------------------------------
+void TestMatrixTranspose( TestContext& context )
+{
+    Random random( TEST_SEED );
+    for( auto n=0; n<TEST_MATRIX_COUNT; ++n )
+    {
+        auto value = RandomMatrix( random, 100.0f );
+        auto expected = TransposeRef( value );
+
+        Matrix result0 = Matrix::Transpose( value );
+        Matrix result1;
+        Matrix::Transpose( value, result1 );
+
+        Check( context, IsSameBits( &result0._11, &expected._11, 16 ), "Transpose( value ) differs at #%d", n );
+        Check( context, IsSameBits( &result1._11, &expected._11, 16 ), "Transpose( value, result ) differs at #%d", n );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Matrix::MultiplyTranspose() がスカラー版とビット単位で一致するか試験します.
+//-------------------------------------------------------------------------------------------------
+void TestMatrixMultiplyTranspose( TestContext& context )
+{
+    Random random( TEST_SEED );
+    for( auto n=0; n<TEST_MATRIX_COUNT; ++n )
+    {
+        auto a = RandomMatrix( random, 100.0f );
+        auto b = RandomMatrix( random, 100.0f );
+        auto expected = TransposeRef( MultiplyRef( a, b ) );
+
+        Matrix result0 = Matrix::MultiplyTranspose( a, b );
+        Matrix result1;
+        Matrix::MultiplyTranspose( a, b, result1 );
+
+        Check( context, IsSameBits( &result0._11, &expected._11, 16 ), "MultiplyTranspose( a, b ) differs at #%d", n );
+        Check( context, IsSameBits( &result1._11, &expected._11, 16 ), "MultiplyTranspose( a, b, result ) differs at #%d", n );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Vector4::Transform() がスカラー版とビット単位で一致するか試験します.
+//-------------------------------------------------------------------------------------------------
+void TestVector4Transform( TestContext& context )
+{
+    Random random( TEST_SEED );
+    for( auto n=0; n<TEST_MATRIX_COUNT; ++n )
+    {
+        auto matrix = RandomMatrix( random, 100.0f );
+        auto value  = Vector4( random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ) );
+        auto expected = TransformRef( value, matrix );
+
+        Vector4 result0 = Vector4::Transform( value, matrix );
+        Vector4 result1;
+        Vector4::Transform( value, matrix, result1 );
+
+        Check( context, IsSameBits( &result0.x, &expected.x, 4 ), "Transform( value, matrix ) differs at #%d", n );
+        Check( context, IsSameBits( &result1.x, &expected.x, 4 ), "Transform( value, matrix, result ) differs at #%d", n );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Matrix::Invert() とスカラー版の差が上限に収まるか試験します.
+//      余因子の加算順序が異なるため SIMD 版はビット単位では一致しません. 差の上限は
+//      max|Δij| <= TEST_INVERT_BOUND * FLT_EPSILON * κ(M) * ||M^-1|| (無限大ノルム) とします.
+//-------------------------------------------------------------------------------------------------
+void TestMatrixInvert( TestContext& context )
+{
+    Random random( TEST_SEED );
+    for( auto n=0; n<TEST_MATRIX_COUNT; ++n )
+    {
+        auto value    = InvertibleMatrix( random, n );
+        auto expected = InvertRef( value );
+
+        auto normInv = NormInf( expected );
+        auto bound   = TEST_INVERT_BOUND * double( FLT_EPSILON ) * NormInf( value ) * normInv * normInv;
+
+        Matrix result0 = Matrix::Invert( value );
+        Matrix result1;
+        Matrix::Invert( value, result1 );
+
+        double diff0 = 0.0;
+        double diff1 = 0.0;
+        for( auto i=0; i<4; ++i )
+        {
+            for( auto j=0; j<4; ++j )
+            {
+                diff0 = std::max( diff0, fabs( double( result0.m[i][j] ) - double( expected.m[i][j] ) ) );
+                diff1 = std::max( diff1, fabs( double( result1.m[i][j] ) - double( expected.m[i][j] ) ) );
+            }
+        }
+
+        Check( context, diff0 <= bound, "Invert( value ) differs by %g (bound %g) at #%d", diff0, bound, n );
+        Check( context, diff1 <= bound, "Invert( value, result ) differs by %g (bound %g) at #%d", diff1, bound, n );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SinCosFast() の正弦と余弦の絶対誤差の大きい方を求めます.
+//-------------------------------------------------------------------------------------------------
+double SinCosError( float radian )
+{
+    float s, c;
+    SinCosFast( radian, s, c );
+    auto errorS = fabs( double( s ) - sin( double( radian ) ) );
+    auto errorC = fabs( double( c ) - cos( double( radian ) ) );
+    return std::max( errorS, errorC );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      RsqrtFast() の相対誤差を求めます.
+//-------------------------------------------------------------------------------------------------
+double RsqrtError( float value )
+{
+    auto expected = 1.0 / sqrt( double( value ) );
+    return fabs( double( RsqrtFast( value ) ) - expected ) / expected;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Atan2Fast() の絶対誤差を求めます.
+//-------------------------------------------------------------------------------------------------
+double Atan2Error( float y, float x )
+{ return fabs( double( Atan2Fast( y, x ) ) - atan2( double( y ), double( x ) ) ); }
+
+//-------------------------------------------------------------------------------------------------
+//      x 成分を value とするベクトルと四元数の NormalizeFast() の各成分の誤差の最大値を求めます.
+//      長さの2乗が正規化数にならない場合は RsqrtFast() の範囲外のため 0 を返します.
+//-------------------------------------------------------------------------------------------------
+double NormalizeError( float value )
+{
+    auto q = Quaternion( value, value * 0.75f, value * 0.5f, value * 0.25f );
+    auto v = Vector3( q.x, q.y, q.z );
+    if ( !( q.LengthSq() >= FLT_MIN ) || !( q.LengthSq() <= FLT_MAX ) || !( v.LengthSq() >= FLT_MIN ) )
+    { return 0.0; }
+
+    auto lengthV = sqrt( double( v.x ) * v.x + double( v.y ) * v.y + double( v.z ) * v.z );
+    auto lengthQ = sqrt( double( q.x ) * q.x + double( q.y ) * q.y + double( q.z ) * q.z + double( q.w ) * q.w );
+    auto resultV = Vector3::NormalizeFast( v );
+    auto resultQ = Quaternion::NormalizeFast( q );
+
+    double error = 0.0;
+    error = std::max( error, fabs( double( resultV.x ) - v.x / lengthV ) );
+    error = std::max( error, fabs( double( resultV.y ) - v.y / lengthV ) );
+    error = std::max( error, fabs( double( resultV.z ) - v.z / lengthV ) );
+    error = std::max( error, fabs( double( resultQ.x ) - q.x / lengthQ ) );
+    error = std::max( error, fabs( double( resultQ.y ) - q.y / lengthQ ) );
+    error = std::max( error, fabs( double( resultQ.z ) - q.z / lengthQ ) );
+    error = std::max( error, fabs( double( resultQ.w ) - q.w / lengthQ ) );
+    return error;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      全ての float を走査した結果を判定します.
+//-------------------------------------------------------------------------------------------------
+void CheckSweep( TestContext& context, const char* label, const SweepResult& result, double bound )
+{
+    fprintf( stdout, "    %-28s max error %.3g at %.9g (bound %.3g, %llu values)\n",
+        label, result.MaxError, result.Worst, bound, static_cast<unsigned long long>( result.Count ) );
+    Check( context, result.MaxError <= bound, "%s exceeds the bound", label );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SinCosFast() の誤差が上限に収まるか, 定義域の全ての float で試験します.
+//-------------------------------------------------------------------------------------------------
+void TestSinCosFast( TestContext& context, uint32_t stride )
+{
+    auto inner = SweepSigned( 0, ToBits( F_PI ), stride, SinCosError );
+    auto outer = SweepSigned( ToBits( F_PI ), ToBits( TEST_SINCOS_RANGE ), stride, SinCosError );
+    outer.Merge( inner );
+
+    CheckSweep( context, "|radian| <= pi", inner, TEST_SINCOS_BOUND_PI );
+    CheckSweep( context, "|radian| <= 1e5", outer, TEST_SINCOS_BOUND );
+
+    // 定義域の端と縮約の境界.
+    const float edges[] = { TEST_SINCOS_RANGE, -TEST_SINCOS_RANGE, F_PI, -F_PI, F_PIDIV2, -F_PIDIV2, 0.0f, -0.0f };
+    for( auto radian : edges )
+    {
+        auto bound = ( fabsf( radian ) <= F_PI ) ? TEST_SINCOS_BOUND_PI : TEST_SINCOS_BOUND;
+        Check( context, SinCosError( radian ) <= bound, "SinCosFast( %.9g ) error %g", radian, SinCosError( radian ) );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      RsqrtFast() の誤差が上限に収まるか, 全ての正の正規化数で試験します.
+//-------------------------------------------------------------------------------------------------
+void TestRsqrtFast( TestContext& context, uint32_t stride )
+{
+    auto result = Sweep( ToBits( FLT_MIN ), ToBits( FLT_MAX ), stride, RsqrtError );
+    CheckSweep( context, "FLT_MIN <= value <= FLT_MAX", result, TEST_RSQRT_BOUND );
+
+    // 定義域の端(最小の正規化数と最大の有限値).
+    const float edges[] = { FLT_MIN, FLT_MAX, 1.0f };
+    for( auto value : edges )
+    { Check( context, RsqrtError( value ) <= TEST_RSQRT_BOUND, "RsqrtFast( %.9g ) error %g", value, RsqrtError( value ) ); }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Atan2Fast() の誤差が上限に収まるか, 全ての有限の y と x = ±1 で試験します.
+//      |y| < 1 と |y| > 1 で近似する比 min / max の全ての値と, 全ての象限を辿ります.
+//-------------------------------------------------------------------------------------------------
+void TestAtan2Fast( TestContext& context, uint32_t stride )
+{
+    auto last = ToBits( FLT_MAX );
+    auto positive = SweepSigned( 0, last, stride, []( float y ) { return Atan2Error( y,  1.0f ); } );
+    auto negative = SweepSigned( 0, last, stride, []( float y ) { return Atan2Error( y, -1.0f ); } );
+
+    CheckSweep( context, "x = +1", positive, TEST_ATAN2_BOUND );
+    CheckSweep( context, "x = -1", negative, TEST_ATAN2_BOUND );
+
+    // 原点は 0 を返します. 負の x 軸上では y の符号で ±π になります.
+    Check( context, Atan2Fast(  0.0f,  0.0f ) == 0.0f, "Atan2Fast( 0, 0 ) = %g", Atan2Fast(  0.0f,  0.0f ) );
+    Check( context, Atan2Fast( -0.0f,  0.0f ) == 0.0f, "Atan2Fast( -0, 0 ) = %g", Atan2Fast( -0.0f,  0.0f ) );
+    Check( context, Atan2Fast(  0.0f, -0.0f ) == 0.0f, "Atan2Fast( 0, -0 ) = %g", Atan2Fast(  0.0f, -0.0f ) );
+    Check( context, Atan2Fast( -0.0f, -0.0f ) == 0.0f, "Atan2Fast( -0, -0 ) = %g", Atan2Fast( -0.0f, -0.0f ) );
+
+    const float edges[][2] = {
+        {  0.0f, -1.0f }, { -0.0f, -1.0f }, {  0.0f, 1.0f }, { -0.0f, 1.0f },
+        {  1.0f,  0.0f }, {  1.0f, -0.0f }, { -1.0f, 0.0f }, { -1.0f, -0.0f },
+        {  FLT_MAX, FLT_MIN }, { FLT_MIN, -FLT_MAX }, { 1.0f, 1.0f }, { -1.0f, -1.0f } };
+    for( const auto& edge : edges )
+    {
+        Check( context, Atan2Error( edge[0], edge[1] ) <= TEST_ATAN2_BOUND,
+            "Atan2Fast( %g, %g ) error %g", edge[0], edge[1], Atan2Error( edge[0], edge[1] ) );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Vector3::NormalizeFast() と Quaternion::NormalizeFast() の誤差が上限に収まるか試験します.
+//      長さの2乗が正規化数になる全ての float を x 成分として, 他の成分はその定数倍とします.
+//-------------------------------------------------------------------------------------------------
+void TestNormalizeFast( TestContext& context, uint32_t stride )
+{
+    auto result = SweepSigned( 0, ToBits( FLT_MAX ), stride, NormalizeError );
+    CheckSweep( context, "x = value", result, TEST_NORMALIZE_BOUND );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Quaternion::CreateFromYawPitchRollFast() と sinf/cosf 版の各成分の差の最大値を求めます.
+//-------------------------------------------------------------------------------------------------
+double YawPitchRollQuatError( float yaw, float pitch, float roll )
+{
+    auto expected = Quaternion::CreateFromYawPitchRoll( yaw, pitch, roll );
+    auto result0  = Quaternion::CreateFromYawPitchRollFast( yaw, pitch, roll );
+    Quaternion result1;
+    Quaternion::CreateFromYawPitchRollFast( yaw, pitch, roll, result1 );
+
+    double error = 0.0;
+    const float* e = &expected.x;
+    const float* r0 = &result0.x;
+    const float* r1 = &result1.x;
+    for( auto i=0; i<4; ++i )
+    { error = std::max( error, std::max( fabs( double( r0[i] ) - e[i] ), fabs( double( r1[i] ) - e[i] ) ) ); }
+    return error;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Matrix::CreateRotationFromYawPitchRollFast() と sinf/cosf 版の各成分の差の最大値を求めます.
+//-------------------------------------------------------------------------------------------------
+double YawPitchRollMatrixError( float yaw, float pitch, float roll )
+{
+    auto expected = Matrix::CreateRotationFromYawPitchRoll( yaw, pitch, roll );
+    auto result0  = Matrix::CreateRotationFromYawPitchRollFast( yaw, pitch, roll );
+    Matrix result1;
+    Matrix::CreateRotationFromYawPitchRollFast( yaw, pitch, roll, result1 );
+
+    double error = 0.0;
+    for( auto i=0; i<4; ++i )
+    {
+        for( auto j=0; j<4; ++j )
+        {
+            auto e = double( expected.m[i][j] );
+            error = std::max( error, std::max( fabs( result0.m[i][j] - e ), fabs( result1.m[i][j] - e ) ) );
+        }
+    }
+    return error;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      CreateFromYawPitchRollFast() と CreateRotationFromYawPitchRollFast() の誤差が上限に収まるか試験します.
+//      |角度| <= 2π の全ての float を3つの角度に同時に与える走査と, 3次元の格子で試験します.
+//-------------------------------------------------------------------------------------------------
+void TestYawPitchRollFast( TestContext& context, uint32_t stride )
+{
+    auto last = ToBits( TEST_YPR_RANGE );
+    auto quat = SweepSigned( 0, last, stride, []( float value ) { return YawPitchRollQuatError( value, value, value ); } );
+    CheckSweep( context, "quaternion, y = p = r", quat, TEST_YPR_QUAT_BOUND );
+
+    auto matrix = SweepSigned( 0, last, stride, []( float value ) { return YawPitchRollMatrixError( value, value, value ); } );
+    CheckSweep( context, "matrix, y = p = r", matrix, TEST_YPR_MATRIX_BOUND );
+
+    // 各角度を独立に変える格子 (端点 ±2π, ±π, 0 を含みます).
+    SweepResult gridQuat;
+    SweepResult gridMatrix;
+    for( auto i=0; i<TEST_YPR_GRID; ++i )
+    {
+        auto yaw = TEST_YPR_RANGE * ( 2.0f * float( i ) / float( TEST_YPR_GRID - 1 ) - 1.0f );
+        for( auto j=0; j<TEST_YPR_GRID; ++j )
+        {
+            auto pitch = TEST_YPR_RANGE * ( 2.0f * float( j ) / float( TEST_YPR_GRID - 1 ) - 1.0f );
+            for( auto k=0; k<TEST_YPR_GRID; ++k )
+            {
+                auto roll = TEST_YPR_RANGE * ( 2.0f * float( k ) / float( TEST_YPR_GRID - 1 ) - 1.0f );
+                gridQuat  .Add( yaw, YawPitchRollQuatError  ( yaw, pitch, roll ) );
+                gridMatrix.Add( yaw, YawPitchRollMatrixError( yaw, pitch, roll ) );
+            }
+        }
+    }
+    CheckSweep( context, "quaternion, grid", gridQuat, TEST_YPR_QUAT_BOUND );
+    CheckSweep( context, "matrix, grid", gridMatrix, TEST_YPR_MATRIX_BOUND );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      正規直交基底の試験に使う方向を生成します.
+//      一様な方向に加えて, 両極の近傍, 極そのもの, z = -0 の方向を含めます.
+//-------------------------------------------------------------------------------------------------
+std::vector<Vector3> BasisInputs()
+{
+    Random random( TEST_SEED );
+    std::vector<Vector3> result;
+    result.reserve( TEST_BASIS_COUNT );
+
+    // 極と z = -0.
+    result.push_back( Vector3( 0.0f, 0.0f,  1.0f ) );
+    result.push_back( Vector3( 0.0f, 0.0f, -1.0f ) );
+    result.push_back( Vector3( -0.0f, -0.0f, -1.0f ) );
+    result.push_back( Vector3( 1.0f, 0.0f, -0.0f ) );
+    result.push_back( Vector3( 0.0f, 1.0f, -0.0f ) );
+    result.push_back( Vector3( -1.0f, -1.0f, -0.0f ) );
+    result.push_back( Vector3( 1.0f, 0.0f, 0.0f ) );
+
+    // 両極の近傍 (1e-1 から非正規化数まで).
+    for( auto scale = 0.1f; scale > 0.0f; scale *= 0.1f )
+    {
+        for( auto pole : { 1.0f, -1.0f } )
+        {
+            result.push_back( Vector3(  scale,  scale, pole ) );
+            result.push_back( Vector3( -scale,  scale, pole ) );
+            result.push_back( Vector3(  scale, -scale, pole ) );
+            result.push_back( Vector3( -scale, -scale, pole ) );
+            result.push_back( Vector3( scale, 0.0f, pole ) );
+            result.push_back( Vector3( 0.0f, scale, pole ) );
+        }
+    }
+
+    // z = -0 の赤道上.
+    for( auto i=0; i<64; ++i )
+    {
+        float s, c;
+        SinCos( F_2PI * float( i ) / 64.0f, s, c );
+        result.push_back( Vector3( c, s, -0.0f ) );
+    }
+
+    // 一様な方向 (長さも変えます).
+    while( result.size() < size_t( TEST_BASIS_COUNT ) )
+    {
+        auto value = Vector3( random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ) );
+        auto lengthSq = value.LengthSq();
+        if ( lengthSq < 1e-4f || lengthSq > 1.0f )
+        { continue; }
+
+        result.push_back( value * random.GetAsF32( 1e-3f, 1e3f ) );
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      倍精度で内積を求めます.
+//-------------------------------------------------------------------------------------------------
+double DotD( const Vector3& a, const Vector3& b )
+{ return double( a.x ) * b.x + double( a.y ) * b.y + double( a.z ) * b.z; }
+
+//-------------------------------------------------------------------------------------------------
+//      基底の誤差(内積, 長さ, u x v と w の差)の最大値を求めます.
+//-------------------------------------------------------------------------------------------------
+double BasisError( const OrthonormalBasis& basis )
+{
+    const auto& u = basis.u;
+    const auto& v = basis.v;
+    const auto& w = basis.w;
+
+    double error = 0.0;
+    error = std::max( error, fabs( DotD( u, v ) ) );
+    error = std::max( error, fabs( DotD( u, w ) ) );
+    error = std::max( error, fabs( DotD( v, w ) ) );
+    error = std::max( error, fabs( sqrt( DotD( u, u ) ) - 1.0 ) );
+    error = std::max( error, fabs( sqrt( DotD( v, v ) ) - 1.0 ) );
+    error = std::max( error, fabs( sqrt( DotD( w, w ) ) - 1.0 ) );
+
+    // u x v = w (右手系).
+    error = std::max( error, fabs( ( double( u.y ) * v.z - double( u.z ) * v.y ) - w.x ) );
+    error = std::max( error, fabs( ( double( u.z ) * v.x - double( u.x ) * v.z ) - w.y ) );
+    error = std::max( error, fabs( ( double( u.x ) * v.y - double( u.y ) * v.x ) - w.z ) );
+    return error;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      基底が正規直交かつ右手系であるか判定します.
+//-------------------------------------------------------------------------------------------------
+void CheckBasis( TestContext& context, SweepResult& worst, const char* label, const OrthonormalBasis& basis, const Vector3& input )
+{
+    auto error = BasisError( basis );
+    worst.Add( 0.0f, error );
+    Check( context, error <= TEST_BASIS_BOUND,
+        "%s( %g, %g, %g ) error %g : u = ( %g, %g, %g ), v = ( %g, %g, %g ), w = ( %g, %g, %g )",
+        label, input.x, input.y, input.z, error,
+        basis.u.x, basis.u.y, basis.u.z, basis.v.x, basis.v.y, basis.v.z, basis.w.x, basis.w.y, basis.w.z );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      InitFromW() などの1方向からの構築が正規直交かつ u x v = w になるか試験します.
+//-------------------------------------------------------------------------------------------------
+void TestOrthonormalBasisInit( TestContext& context )
+{
+    SweepResult worst;
+    for( const auto& input : BasisInputs() )
+    {
+        OrthonormalBasis basis;
+        basis.InitFromW( input );
+        CheckBasis( context, worst, "InitFromW", basis, input );
+
+        // 構築した w は入力の方向と一致すること.
+        auto length = sqrt( DotD( input, input ) );
+        auto error  = std::max( std::max(
+            fabs( basis.w.x - input.x / length ),
+            fabs( basis.w.y - input.y / length ) ),
+            fabs( basis.w.z - input.z / length ) );
+        Check( context, error <= TEST_BASIS_BOUND, "InitFromW( %g, %g, %g ) w differs by %g", input.x, input.y, input.z, error );
+
+        basis.InitFromU( input );
+        CheckBasis( context, worst, "InitFromU", basis, input );
+
+        basis.InitFromV( input );
+        CheckBasis( context, worst, "InitFromV", basis, input );
+    }
+
+    fprintf( stdout, "    %-28s max error %.3g (bound %.3g, %llu bases)\n",
+        "u, v, w", worst.MaxError, TEST_BASIS_BOUND, static_cast<unsigned long long>( worst.Count ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      InitFromUV() などの2方向からの構築が正規直交かつ u x v = w になるか試験します.
+//-------------------------------------------------------------------------------------------------
+void TestOrthonormalBasisInitPair( TestContext& context )
+{
+    SweepResult worst;
+    auto inputs = BasisInputs();
+    for( size_t i=0; i + 1 < inputs.size(); ++i )
+    {
+        const auto& a = inputs[i];
+        const auto& b = inputs[i + 1];
+
+        // 平行に近い組は外積の桁落ちで誤差が大きくなるため除きます.
+        auto cross = Vector3::Cross( Vector3::Normalize( a ), Vector3::Normalize( b ) );
+        if ( cross.LengthSq() < 1e-2f )
+        { continue; }
+
+        OrthonormalBasis basis;
+        basis.InitFromUV( a, b ); CheckBasis( context, worst, "InitFromUV", basis, a );
+        basis.InitFromVU( a, b ); CheckBasis( context, worst, "InitFromVU", basis, a );
+        basis.InitFromUW( a, b ); CheckBasis( context, worst, "InitFromUW", basis, a );
+        basis.InitFromWU( a, b ); CheckBasis( context, worst, "InitFromWU", basis, a );
+        basis.InitFromVW( a, b ); CheckBasis( context, worst, "InitFromVW", basis, a );
+        basis.InitFromWV( a, b ); CheckBasis( context, worst, "InitFromWV", basis, a );
+    }
+
+    fprintf( stdout, "    %-28s max error %.3g (bound %.3g, %llu bases)\n",
+        "u, v, w", worst.MaxError, TEST_BASIS_BOUND, static_cast<unsigned long long>( worst.Count ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      CreateFromW() が要素ごとの InitFromW() とビット単位で一致するか試験します.
+//      SIMD 版の 4 要素単位の処理と端数の処理の両方を通るように要素数と先頭位置を変えます.
+//-------------------------------------------------------------------------------------------------
+void TestOrthonormalBasisCreateFromW( TestContext& context )
+{
+    auto inputs = BasisInputs();
+    const size_t counts[] = { 0, 1, 3, 5, TEST_BASIS_LARGE_COUNT };
+
+    for( auto count : counts )
+    {
+        for( size_t offset=0; offset<4; ++offset )
+        {
+            // 出力の前後を番兵で埋め, 範囲外に書き込まないことも確かめます.
+            std::vector<OrthonormalBasis> results( count + 2 );
+            for( auto& basis : results )
+            { basis = OrthonormalBasis( Vector3( -7.0f, -7.0f, -7.0f ), Vector3( -7.0f, -7.0f, -7.0f ), Vector3( -7.0f, -7.0f, -7.0f ) ); }
+            auto sentinel = results.front();
+
+            OrthonormalBasis::CreateFromW( inputs.data() + offset, results.data() + 1, count );
+
+            size_t mismatch = 0;
+            for( size_t i=0; i<count; ++i )
+            {
+                OrthonormalBasis expected;
+                expected.InitFromW( inputs[offset + i] );
+                if ( !IsSameBits( &results[i + 1].u.x, &expected.u.x, 9 ) )
+                { mismatch++; }
+            }
+
+            Check( context, mismatch == 0, "CreateFromW( count = %zu, offset = %zu ) differs from InitFromW() in %zu bases", count, offset, mismatch );
+            Check( context, IsSameBits( &results.front().u.x, &sentinel.u.x, 9 ) && IsSameBits( &results.back().u.x, &sentinel.u.x, 9 ),
+                "CreateFromW( count = %zu, offset = %zu ) writes out of range", count, offset );
+        }
+    }
+
+    // 全ての入力をまとめて構築した結果も一致すること.
+    std::vector<OrthonormalBasis> results( inputs.size() );
+    OrthonormalBasis::CreateFromW( inputs.data(), results.data(), inputs.size() );
+    size_t mismatch = 0;
+    for( size_t i=0; i<inputs.size(); ++i )
+    {
+        OrthonormalBasis expected;
+        expected.InitFromW( inputs[i] );
+        if ( !IsSameBits( &results[i].u.x, &expected.u.x, 9 ) )
+        { mismatch++; }
+    }
+    Check( context, mismatch == 0, "CreateFromW( count = %zu ) differs from InitFromW() in %zu bases", inputs.size(), mismatch );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2つの四元数が表す回転の差の角度(度)を求めます.
+//-------------------------------------------------------------------------------------------------
+double RotationAngle( const Quaternion& a, const Quaternion& b )
+{
+    double qa[4] = { a.x, a.y, a.z, a.w };
+    double qb[4] = { b.x, b.y, b.z, b.w };
+    auto la  = sqrt( qa[0] * qa[0] + qa[1] * qa[1] + qa[2] * qa[2] + qa[3] * qa[3] );
+    auto lb  = sqrt( qb[0] * qb[0] + qb[1] * qb[1] + qb[2] * qb[2] + qb[3] * qb[3] );
+    auto dot = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3];
+    auto sign = ( dot < 0.0 ) ? -1.0 : 1.0;
+
+    // acos は 0 付近で精度が落ちるので, 差と和の長さの比から角度を求めます.
+    double diff = 0.0;
+    double sum  = 0.0;
+    for( auto i=0; i<4; ++i )
+    {
+        auto p = qa[i] / la;
+        auto q = qb[i] / lb * sign;
+        diff += ( p - q ) * ( p - q );
+        sum  += ( p + q ) * ( p + q );
+    }
+    return 4.0 * atan2( sqrt( diff ), sqrt( sum ) ) * 180.0 / D_PI;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数で単位四元数を生成します.
+//-------------------------------------------------------------------------------------------------
+Quaternion RandomRotation( Random& random )
+{
+    for( ;; )
+    {
+        auto value = Quaternion( random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ) );
+        auto lengthSq = Quaternion::Dot( value, value );
+        if ( lengthSq > 1e-4f && lengthSq <= 1.0f )
+        { return Quaternion::Normalize( value ); }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Quaternion::Multiply() の回転が, それぞれの回転行列の積 (a を適用してから b) と一致するか試験します.
+//      4 つの API の結果はビット単位で一致することも確認します.
+//-------------------------------------------------------------------------------------------------
+void TestQuaternionMultiply( TestContext& context )
+{
+    Random random( TEST_SEED );
+    SweepResult worst;
+    for( auto n=0; n<TEST_QUATERNION_COUNT; ++n )
+    {
+        auto a = RandomRotation( random );
+        auto b = RandomRotation( random );
+
+        Quaternion result0 = Quaternion::Multiply( a, b );
+        Quaternion result1;
+        Quaternion::Multiply( a, b, result1 );
+        Quaternion result2 = a * b;
+        Quaternion result3 = a;
+        result3 *= b;
+
+        Check( context, IsSameBits( &result1.x, &result0.x, 4 ), "Multiply( a, b, result ) differs at #%d", n );
+        Check( context, IsSameBits( &result2.x, &result0.x, 4 ), "operator * differs at #%d", n );
+        Check( context, IsSameBits( &result3.x, &result0.x, 4 ), "operator *= differs at #%d", n );
+
+        auto expected = MultiplyRef( Matrix::CreateFromQuaternion( a ), Matrix::CreateFromQuaternion( b ) );
+        auto actual   = Matrix::CreateFromQuaternion( result0 );
+
+        double error = 0.0;
+        for( auto i=0; i<4; ++i )
+        {
+            for( auto j=0; j<4; ++j )
+            { error = std::max( error, fabs( double( actual.m[i][j] ) - double( expected.m[i][j] ) ) ); }
+        }
+        worst.Add( float( n ), error );
+    }
+
+    CheckSweep( context, "rotation matrix", worst, TEST_QUATERNION_BOUND );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      剛体変換行列による座標変換を倍精度で求め, 結果との差を max(1, |期待値|) に対する比で返します.
+//      w = 1 で位置座標, w = 0 で法線ベクトルとして変換します.
+//-------------------------------------------------------------------------------------------------
+double TransformError( const Vector3& actual, const Vector3& value, const Matrix& matrix, double w )
+{
+    const float  a[3] = { actual.x, actual.y, actual.z };
+    const double v[4] = { value.x, value.y, value.z, w };
+
+    double expected[3];
+    double length = 0.0;
+    for( auto j=0; j<3; ++j )
+    {
+        expected[j] = 0.0;
+        for( auto i=0; i<4; ++i )
+        { expected[j] += v[i] * matrix.m[i][j]; }
+        length += expected[j] * expected[j];
+    }
+
+    double error = 0.0;
+    for( auto j=0; j<3; ++j )
+    { error = std::max( error, fabs( double( a[j] ) - expected[j] ) ); }
+    return error / std::max( 1.0, sqrt( length ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      回転と平行移動から剛体変換行列を生成します.
+//-------------------------------------------------------------------------------------------------
+Matrix RigidRef( const Quaternion& rotation, const Vector3& translation )
+{
+    auto result = Matrix::CreateFromQuaternion( rotation );
+    result._41 = translation.x;
+    result._42 = translation.y;
+    result._43 = translation.z;
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DualQuaternion の変換, 合成, 逆変換が剛体変換行列と一致するか試験します.
+//      合成の双対部で使う Quaternion の加減算と Normalize() も確かめます.
+//-------------------------------------------------------------------------------------------------
+void TestDualQuaternionTransform( TestContext& context )
+{
+    Random random( TEST_SEED );
+    auto randomVector = [&]( float range )
+    { return Vector3( random.GetAsF32( -range, range ), random.GetAsF32( -range, range ), random.GetAsF32( -range, range ) ); };
+
+    SweepResult position;
+    SweepResult normal;
+    SweepResult translation;
+    SweepResult fromMatrix;
+    SweepResult composite;
+    SweepResult inverse;
+    size_t mismatch = 0;
+
+    for( auto n=0; n<TEST_DUALQUAT_COUNT; ++n )
+    {
+        auto ra = RandomRotation( random );
+        auto rb = RandomRotation( random );
+        auto ta = randomVector( 10.0f );
+        auto tb = randomVector( 10.0f );
+        auto p  = randomVector( 10.0f );
+        auto v  = Vector3::Normalize( randomVector( 1.0f ) + Vector3( 0.0f, 0.0f, 1e-3f ) );
+        auto ma = RigidRef( ra, ta );
+        auto mb = RigidRef( rb, tb );
+        auto a  = DualQuaternion::CreateFromRotationTranslation( ra, ta );
+        auto b  = DualQuaternion::CreateFromRotationTranslation( rb, tb );
+
+        position   .Add( float( n ), TransformError( DualQuaternion::Transform( p, a ), p, ma, 1.0 ) );
+        normal     .Add( float( n ), TransformError( DualQuaternion::TransformNormal( v, a ), v, ma, 0.0 ) );
+        translation.Add( float( n ), TransformError( a.GetTranslation(), Vector3( 0.0f, 0.0f, 0.0f ), ma, 1.0 ) );
+        fromMatrix .Add( float( n ), TransformError( DualQuaternion::Transform( p, DualQuaternion::CreateFromMatrix( ma ) ), p, ma, 1.0 ) );
+
+        // a を適用してから b を適用します.
+        auto ab = DualQuaternion::Multiply( a, b );
+        composite.Add( float( n ), TransformError( DualQuaternion::Transform( p, ab ), p, MultiplyRef( ma, mb ), 1.0 ) );
+
+        auto back = DualQuaternion::Transform( DualQuaternion::Transform( p, a ), DualQuaternion::Conjugate( a ) );
+        inverse.Add( float( n ), TransformError( back, p, Matrix::CreateIdentity(), 1.0 ) );
+
+        // 成分ごとの加減算と, 正規化の2つの形式が一致することを確かめます.
+        auto qa = Quaternion( ra.x * 3.0f, ra.y * 3.0f, ra.z * 3.0f, ra.w * 3.0f );
+        auto sum  = qa + rb;
+        auto diff = qa - rb;
+        const float expectedSum [4] = { qa.x + rb.x, qa.y + rb.y, qa.z + rb.z, qa.w + rb.w };
+        const float expectedDiff[4] = { qa.x - rb.x, qa.y - rb.y, qa.z - rb.z, qa.w - rb.w };
+        Quaternion normalized;
+        Quaternion::Normalize( qa, normalized );
+        auto expectedNormalized = Quaternion::Normalize( qa );
+        if ( !IsSameBits( &sum.x, expectedSum, 4 )
+          || !IsSameBits( &diff.x, expectedDiff, 4 )
+          || !IsSameBits( &normalized.x, &expectedNormalized.x, 4 ) )
+        { mismatch++; }
+    }
+
+    Check( context, mismatch == 0, "Quaternion operator + / - or Normalize( value, result ) differs in %zu values", mismatch );
+    CheckSweep( context, "Transform", position, TEST_DUALQUAT_BOUND );
+    CheckSweep( context, "TransformNormal", normal, TEST_DUALQUAT_BOUND );
+    CheckSweep( context, "GetTranslation", translation, TEST_DUALQUAT_BOUND );
+    CheckSweep( context, "CreateFromMatrix", fromMatrix, TEST_DUALQUAT_BOUND );
+    CheckSweep( context, "Multiply", composite, TEST_DUALQUAT_BOUND );
+    CheckSweep( context, "Conjugate", inverse, TEST_DUALQUAT_BOUND );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DualQuaternion::Skin() を試験します.
+//      影響するボーンの回転が揃っている場合は, 行列パレットによる Matrix::Skin() と一致します.
+//      その場合でも符号を反転したボーンを混ぜて, Blend() の半球の揃え方を通ります.
+//      回転がばらばらな場合は, 頂点ごとの Blend() と Transform() にビット単位で一致することを確かめます.
+//-------------------------------------------------------------------------------------------------
+void TestDualQuaternionSkin( TestContext& context )
+{
+    Random random( TEST_SEED );
+    auto randomVector = [&]( float range )
+    { return Vector3( random.GetAsF32( -range, range ), random.GetAsF32( -range, range ), random.GetAsF32( -range, range ) ); };
+
+    std::vector<Vector3>  positions( TEST_SKIN_COUNT );
+    std::vector<Vector3>  normals  ( TEST_SKIN_COUNT );
+    std::vector<uint16_t> indices  ( TEST_SKIN_COUNT * 4 );
+    std::vector<float>    weights  ( TEST_SKIN_COUNT * 4 );
+    for( auto& p : positions )
+    { p = randomVector( 10.0f ); }
+    random.FillUnitVector3( normals.data(), normals.size() );
+    for( size_t i=0; i<TEST_SKIN_COUNT; ++i )
+    {
+        float sum = 0.0f;
+        for( auto k=0; k<4; ++k )
+        {
+            // 重みが 0 の影響も含めます.
+            weights[i * 4 + k] = ( random.GetAsU32() % 8 == 0 ) ? 0.0f : random.GetAsF32( 0.0f, 1.0f );
+            sum += weights[i * 4 + k];
+        }
+        if ( sum == 0.0f )
+        {
+            weights[i * 4] = 1.0f;
+            sum = 1.0f;
+        }
+        for( auto k=0; k<4; ++k )
+        { weights[i * 4 + k] /= sum; }
+    }
+
+    std::vector<DualQuaternion> dqBones( TEST_SKIN_BONES );
+    std::vector<Matrix>         matrixBones( TEST_SKIN_BONES );
+    std::vector<Vector3>        dqPositions( TEST_SKIN_COUNT );
+    std::vector<Vector3>        dqNormals  ( TEST_SKIN_COUNT );
+
+    // 4 本ずつ回転が同じで平行移動が異なるボーンを作り, 半数は符号を反転します.
+    {
+        for( size_t g=0; g<TEST_SKIN_BONES; g+=4 )
+        {
+            auto rotation = RandomRotation( random );
+            for( size_t k=0; k<4; ++k )
+            {
+                auto translation = randomVector( 10.0f );
+                matrixBones[g + k] = RigidRef( rotation, translation );
+                dqBones    [g + k] = DualQuaternion::CreateFromRotationTranslation( rotation, translation );
+                if ( random.GetAsU32() % 2 == 0 )
+                { dqBones[g + k] = DualQuaternion( dqBones[g + k].real * -1.0f, dqBones[g + k].dual * -1.0f ); }
+            }
+        }
+        for( size_t i=0; i<TEST_SKIN_COUNT; ++i )
+        {
+            auto group = uint16_t( random.GetAsU32() % ( TEST_SKIN_BONES / 4 ) * 4 );
+            for( auto k=0; k<4; ++k )
+            { indices[i * 4 + k] = uint16_t( group + random.GetAsU32() % 4 ); }
+        }
+
+        std::vector<Vector3> matrixPositions( TEST_SKIN_COUNT );
+        std::vector<Vector3> matrixNormals  ( TEST_SKIN_COUNT );
+        DualQuaternion::Skin( dqBones.data(), positions.data(), normals.data(), indices.data(), weights.data(),
+            dqPositions.data(), dqNormals.data(), TEST_SKIN_COUNT );
+        Matrix::Skin( matrixBones.data(), positions.data(), normals.data(), indices.data(), weights.data(),
+            matrixPositions.data(), matrixNormals.data(), TEST_SKIN_COUNT );
+
+        SweepResult position;
+        SweepResult normal;
+        for( size_t i=0; i<TEST_SKIN_COUNT; ++i )
+        {
+            auto identity = Matrix::CreateIdentity();
+            position.Add( float( i ), TransformError( dqPositions[i], matrixPositions[i], identity, 1.0 ) );
+            normal  .Add( float( i ), TransformError( dqNormals  [i], matrixNormals  [i], identity, 1.0 ) );
+        }
+        CheckSweep( context, "position vs Matrix::Skin", position, TEST_DUALQUAT_BOUND );
+        CheckSweep( context, "normal vs Matrix::Skin", normal, TEST_DUALQUAT_BOUND );
+    }
+
+    // 回転がばらばらなボーンでは頂点ごとのスカラー版と比べます(端数の頂点も含みます).
+    {
+        for( auto& bone : dqBones )
+        { bone = DualQuaternion::CreateFromRotationTranslation( RandomRotation( random ), randomVector( 10.0f ) ); }
+        for( auto& index : indices )
+        { index = uint16_t( random.GetAsU32() % TEST_SKIN_BONES ); }
+
+        std::vector<Vector3> positionsOnly( TEST_SKIN_COUNT );
+        DualQuaternion::Skin( dqBones.data(), positions.data(), normals.data(), indices.data(), weights.data(),
+            dqPositions.data(), dqNormals.data(), TEST_SKIN_COUNT );
+        DualQuaternion::Skin( dqBones.data(), positions.data(), nullptr, indices.data(), weights.data(),
+            positionsOnly.data(), nullptr, TEST_SKIN_COUNT );
+
+        size_t mismatch = 0;
+        for( size_t i=0; i<TEST_SKIN_COUNT; ++i )
+        {
+            DualQuaternion bones[4];
+            for( auto k=0; k<4; ++k )
+            { bones[k] = dqBones[ indices[i * 4 + k] ]; }
+            auto blended  = DualQuaternion::Blend( bones, &weights[i * 4], 4 );
+            auto position = DualQuaternion::Transform( positions[i], blended );
+            auto normal   = DualQuaternion::TransformNormal( normals[i], blended );
+            if ( !IsSameBits( &dqPositions[i].x, &position.x, 3 )
+              || !IsSameBits( &dqNormals[i].x, &normal.x, 3 )
+              || !IsSameBits( &positionsOnly[i].x, &position.x, 3 ) )
+            { mismatch++; }
+        }
+        Check( context, mismatch == 0, "Skin() differs from Blend() + Transform() in %zu vertices", mismatch );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      AnimationClip::Sample() の回転がキーの Quaternion::Slerp() との差の上限に収まるか,
+//      また 4 トラック単位の処理が 1 トラックだけのクリップ(端数の処理)とビット単位で一致するか試験します.
+//      キー間の回転角が 180° 近くまでの全ての範囲を含むように, キーの半数は一様な乱数の回転とします.
+//-------------------------------------------------------------------------------------------------
+void TestAnimationClipSample( TestContext& context )
+{
+    Random random( TEST_SEED );
+    auto keyCount = TEST_ANIMATION_KEYS;
+
+    std::vector<float>      times       ( TEST_ANIMATION_TRACKS * keyCount );
+    std::vector<Vector3>    translations( TEST_ANIMATION_TRACKS * keyCount );
+    std::vector<Quaternion> rotations   ( TEST_ANIMATION_TRACKS * keyCount );
+    std::vector<Vector3>    scales      ( TEST_ANIMATION_TRACKS * keyCount );
+    std::vector<AnimationTrack> tracks  ( TEST_ANIMATION_TRACKS );
+
+    for( size_t i=0; i<TEST_ANIMATION_TRACKS; ++i )
+    {
+        auto base = i * keyCount;
+        auto time = 0.0f;
+        for( uint32_t k=0; k<keyCount; ++k )
+        {
+            time += random.GetAsF32( 0.01f, 0.1f );
+            times       [base + k] = time;
+            translations[base + k] = Vector3( random.GetAsF32( -10.0f, 10.0f ), random.GetAsF32( -10.0f, 10.0f ), random.GetAsF32( -10.0f, 10.0f ) );
+            scales      [base + k] = Vector3( random.GetAsF32( 0.5f, 2.0f ), random.GetAsF32( 0.5f, 2.0f ), random.GetAsF32( 0.5f, 2.0f ) );
+
+            // 奇数番目のトラックは前のキーから少しだけ回転させます.
+            auto rotation = RandomRotation( random );
+            if ( k > 0 && ( i & 0x1 ) != 0 )
+            {
+                auto weight = random.GetAsF32( 0.0f, 0.3f );
+                rotation = Quaternion::Normalize( rotations[base + k - 1] + weight * rotation );
+            }
+            rotations[base + k] = rotation;
+        }
+
+        tracks[i].Times        = &times       [base];
+        tracks[i].Translations = &translations[base];
+        tracks[i].Rotations    = &rotations   [base];
+        tracks[i].Scales       = &scales      [base];
+        tracks[i].KeyCount     = keyCount;
+    }
+
+    AnimationClip clip;
+    AnimationCursor cursor;
+    Check( context, clip.Build( tracks.data(), tracks.size() ), "AnimationClip::Build() failed" );
+    clip.ResetCursor( cursor );
+
+    // 各トラックを単独で持つクリップは端数の処理だけを通ります.
+    std::vector<AnimationClip>   singles( TEST_ANIMATION_TRACKS );
+    std::vector<AnimationCursor> singleCursors( TEST_ANIMATION_TRACKS );
+    for( size_t i=0; i<TEST_ANIMATION_TRACKS; ++i )
+    {
+        Check( context, singles[i].Build( &tracks[i], 1 ), "AnimationClip::Build( track %zu ) failed", i );
+        singles[i].ResetCursor( singleCursors[i] );
+    }
+
+    std::vector<Vector3>    outTranslations( TEST_ANIMATION_TRACKS );
+    std::vector<Quaternion> outRotations   ( TEST_ANIMATION_TRACKS );
+    std::vector<Vector3>    outScales      ( TEST_ANIMATION_TRACKS );
+
+    SweepResult worst;
+    size_t mismatch = 0;
+    for( uint32_t step=0; step<=TEST_ANIMATION_STEPS; ++step )
+    {
+        auto time = clip.GetDuration() * float( step ) / float( TEST_ANIMATION_STEPS );
+        clip.Sample( time, cursor, outTranslations.data(), outRotations.data(), outScales.data() );
+
+        for( size_t i=0; i<TEST_ANIMATION_TRACKS; ++i )
+        {
+            Vector3    t, s;
+            Quaternion r;
+            singles[i].Sample( time, singleCursors[i], &t, &r, &s );
+            if ( !IsSameBits( &r.x, &outRotations[i].x, 4 ) || !IsSameBits( &t.x, &outTranslations[i].x, 3 ) || !IsSameBits( &s.x, &outScales[i].x, 3 ) )
+            { mismatch++; }
+
+            // 量子化前のキーの球面線形補間と比べます.
+            const auto* keyTimes = tracks[i].Times;
+            uint32_t k = 0;
+            while( k + 2 < keyCount && time >= keyTimes[k + 1] )
+            { k++; }
+            auto amount   = Saturate( ( time - keyTimes[k] ) / ( keyTimes[k + 1] - keyTimes[k] ) );
+            auto expected = Quaternion::Slerp( tracks[i].Rotations[k], tracks[i].Rotations[k + 1], amount );
+            auto error    = RotationAngle( outRotations[i], expected );
+            worst.Add( time, error );
+            Check( context, error <= TEST_ANIMATION_BOUND,
+                "track %zu at time %g (keys %u-%u, gap %g deg) differs from Slerp by %g deg",
+                i, time, k, k + 1, RotationAngle( tracks[i].Rotations[k], tracks[i].Rotations[k + 1] ), error );
+        }
+    }
+
+    Check( context, mismatch == 0, "Sample() of 4 tracks differs from single track clips in %zu samples", mismatch );
+    fprintf( stdout, "    %-28s max error %.3g deg (bound %.3g deg, %llu samples)\n",
+        "rotation vs Slerp", worst.MaxError, TEST_ANIMATION_BOUND, static_cast<unsigned long long>( worst.Count ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ViewFrustum::Contains() が既知の内外判定と一致するか試験します.
+//      +Z 向き, 垂直視野角 90° (uFactor = 1), アスペクト比 2 (rFactor = 2), 近 1, 遠 100 の錐台を,
+//      同じ回転と平行移動を加えた錐台と入力でも試験します(SetLookAt() の基底の向きを確かめます).
+//-------------------------------------------------------------------------------------------------
+void TestViewFrustumContains( TestContext& context )
+{
+    struct PointCase  { Vector3 point;  bool inside; };
+    struct SphereCase { Vector3 center; float radius; bool inside; };
+    struct BoxCase    { Vector3 mini; Vector3 maxi; bool inside; };
+
+    static const PointCase points[] = {
+        { Vector3(   0.0f,  0.0f,  50.0f ), true  },
+        { Vector3(   0.0f,  0.0f,   0.5f ), false },     // 近平面の手前.
+        { Vector3(   0.0f,  0.0f, 101.0f ), false },     // 遠平面の奥.
+        { Vector3(   0.0f,  0.0f, -10.0f ), false },     // 視点の後ろ.
+        { Vector3(  99.0f,  0.0f,  50.0f ), true  },     // 右平面は x = 2z.
+        { Vector3( 101.0f,  0.0f,  50.0f ), false },
+        { Vector3( -99.0f,  0.0f,  50.0f ), true  },
+        { Vector3(-101.0f,  0.0f,  50.0f ), false },
+        { Vector3(   0.0f, 49.0f,  50.0f ), true  },     // 上平面は y = z.
+        { Vector3(   0.0f, 51.0f,  50.0f ), false },
+        { Vector3(   0.0f,-49.0f,  50.0f ), true  },
+        { Vector3(   0.0f,-51.0f,  50.0f ), false },
+    };
+
+    // 側面までの距離は (x - 2z) / sqrt(5), (y - z) / sqrt(2) です.
+    static const SphereCase spheres[] = {
+        { Vector3(   0.0f,  0.0f,  50.0f ), 1.0f, true  },
+        { Vector3(   0.0f,  0.0f,   0.5f ), 1.0f, true  },     // 近平面と交差.
+        { Vector3(   0.0f,  0.0f,  -1.0f ), 1.5f, false },     // 近平面の手前.
+        { Vector3(   0.0f,  0.0f, 102.0f ), 2.5f, true  },     // 遠平面と交差.
+        { Vector3(   0.0f,  0.0f, 102.0f ), 1.5f, false },
+        { Vector3( 105.0f,  0.0f,  50.0f ), 2.3f, true  },     // 右平面まで 2.236.
+        { Vector3( 105.0f,  0.0f,  50.0f ), 2.2f, false },
+        { Vector3(-105.0f,  0.0f,  50.0f ), 2.3f, true  },
+        { Vector3(-105.0f,  0.0f,  50.0f ), 2.2f, false },
+        { Vector3(   0.0f, 53.0f,  50.0f ), 2.2f, true  },     // 上平面まで 2.121.
+        { Vector3(   0.0f, 53.0f,  50.0f ), 2.0f, false },
+        { Vector3(   0.0f,-53.0f,  50.0f ), 2.2f, true  },
+        { Vector3(   0.0f,-53.0f,  50.0f ), 2.0f, false },
+    };
+
+    static const BoxCase boxes[] = {
+        { Vector3(  -1.0f,  -1.0f,  40.0f ), Vector3(   1.0f,   1.0f,  60.0f ), true  },     // 内側.
+        { Vector3( 110.0f,  -1.0f,  40.0f ), Vector3( 120.0f,   1.0f,  50.0f ), false },     // 右の外側.
+        { Vector3(  -1.0f,  60.0f,  40.0f ), Vector3(   1.0f,  70.0f,  50.0f ), false },     // 上の外側.
+        { Vector3(  -1.0f,  -1.0f,  -5.0f ), Vector3(   1.0f,   1.0f,   0.5f ), false },     // 近平面の手前.
+        { Vector3(  -1.0f,  -1.0f,  -5.0f ), Vector3(   1.0f,   1.0f,   2.0f ), true  },     // 近平面と交差.
+        { Vector3(  -1.0f,  -1.0f,  99.0f ), Vector3(   1.0f,   1.0f, 110.0f ), true  },     // 遠平面と交差.
+        { Vector3(  -1.0f,  -1.0f, 101.0f ), Vector3(   1.0f,   1.0f, 110.0f ), false },     // 遠平面の奥.
+        { Vector3( -500.0f,-500.0f,-500.0f ), Vector3( 500.0f, 500.0f, 500.0f ), true  },     // 錐台全体を含む.
+        { Vector3(  95.0f,  -1.0f,  45.0f ), Vector3( 105.0f,   1.0f,  55.0f ), true  },     // 右平面と交差.
+        { Vector3(  -1.0f,  45.0f,  40.0f ), Vector3(   1.0f,  60.0f,  50.0f ), true  },     // 上平面と交差(内側は y が最小で z が最大の頂点だけ).
+    };
+
+    // 軸に沿った錐台と, 同じ回転と平行移動を加えた錐台.
+    Random random( TEST_SEED );
+    for( auto pass=0; pass<8; ++pass )
+    {
+        auto rotation = ( pass == 0 ) ? Quaternion::CreateIdentity() : RandomRotation( random );
+        auto offset   = ( pass == 0 ) ? Vector3( 0.0f, 0.0f, 0.0f ) : Vector3( random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ), random.GetAsF32( -100.0f, 100.0f ) );
+        auto place    = [&]( const Vector3& value ) { return Vector3::Rotate( value, rotation ) + offset; };
+
+        ViewFrustum frustum;
+        frustum.SetPerspective( F_PIDIV2, 2.0f, 1.0f, 100.0f );
+        frustum.SetLookAt( place( Vector3( 0.0f, 0.0f, 0.0f ) ), place( Vector3( 0.0f, 0.0f, 10.0f ) ), Vector3::Rotate( Vector3( 0.0f, 1.0f, 0.0f ), rotation ) );
+
+        for( const auto& item : points )
+        {
+            auto point = place( item.point );
+            Check( context, frustum.Contains( point ) == item.inside,
+                "pass %d: point (%g, %g, %g) expected %s", pass, item.point.x, item.point.y, item.point.z, item.inside ? "inside" : "outside" );
+            Check( context, frustum.Contains( &point, 1 ) == item.inside,
+                "pass %d: hull of point (%g, %g, %g) expected %s", pass, item.point.x, item.point.y, item.point.z, item.inside ? "inside" : "outside" );
+        }
+
+        for( const auto& item : spheres )
+        {
+            Check( context, frustum.Contains( BoundingSphere( place( item.center ), item.radius ) ) == item.inside,
+                "pass %d: sphere (%g, %g, %g) r = %g expected %s", pass, item.center.x, item.center.y, item.center.z, item.radius, item.inside ? "inside" : "outside" );
+        }
+
+        // 回転した箱は軸に沿わないため, 箱の判定は pass 0 だけで行い, 他は8頂点の凸包で判定します.
+        for( const auto& item : boxes )
+        {
+            Vector3 corners[8];
+            for( auto i=0; i<8; ++i )
+            {
+                auto corner = Vector3( ( i & 1 ) ? item.maxi.x : item.mini.x, ( i & 2 ) ? item.maxi.y : item.mini.y, ( i & 4 ) ? item.maxi.z : item.mini.z );
+                corners[i] = place( corner );
+            }
+
+            if ( pass == 0 )
+            {
+                Check( context, frustum.Contains( BoundingBox( item.mini, item.maxi ) ) == item.inside,
+                    "box (%g, %g, %g)-(%g, %g, %g) expected %s",
+                    item.mini.x, item.mini.y, item.mini.z, item.maxi.x, item.maxi.y, item.maxi.z, item.inside ? "inside" : "outside" );
+            }
+            Check( context, frustum.Contains( corners, 8 ) == item.inside,
+                "pass %d: hull of box (%g, %g, %g)-(%g, %g, %g) expected %s", pass,
+                item.mini.x, item.mini.y, item.mini.z, item.maxi.x, item.maxi.y, item.maxi.z, item.inside ? "inside" : "outside" );
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ViewFrustum::CullSpheres() / CullBoxes() のマスクが, 物体ごとの Contains() と一致するか試験します.
+//      要素数を変えて端数の処理と, 末尾の語の使わないビットが0であることも確認します.
+//-------------------------------------------------------------------------------------------------
+void TestViewFrustumCull( TestContext& context )
+{
+    Random random( TEST_SEED );
+    auto randomVector = [&]( float a, float b )
+    { return Vector3( random.GetAsF32( a, b ), random.GetAsF32( a, b ), random.GetAsF32( a, b ) ); };
+
+    std::vector<float> centerX( TEST_CULL_COUNT ), centerY( TEST_CULL_COUNT ), centerZ( TEST_CULL_COUNT ), radius( TEST_CULL_COUNT );
+    std::vector<float> minX( TEST_CULL_COUNT ), minY( TEST_CULL_COUNT ), minZ( TEST_CULL_COUNT );
+    std::vector<float> maxX( TEST_CULL_COUNT ), maxY( TEST_CULL_COUNT ), maxZ( TEST_CULL_COUNT );
+    std::vector<uint32_t> sphereMask( ( TEST_CULL_COUNT + 31 ) / 32 );
+    std::vector<uint32_t> boxMask   ( ( TEST_CULL_COUNT + 31 ) / 32 );
+
+    for( auto n=0; n<TEST_FRUSTUM_COUNT; ++n )
+    {
+        auto position  = randomVector( -50.0f, 50.0f );
+        auto direction = RandomRotation( random );
+        auto farClip   = random.GetAsF32( 20.0f, 200.0f );
+
+        ViewFrustum frustum;
+        frustum.SetPerspective( random.GetAsF32( ToRadian( 30.0f ), ToRadian( 120.0f ) ), random.GetAsF32( 0.5f, 2.5f ), random.GetAsF32( 0.1f, 2.0f ), farClip );
+        frustum.SetLookTo( position, Vector3::Rotate( Vector3( 0.0f, 0.0f, 1.0f ), direction ), Vector3::Rotate( Vector3( 0.0f, 1.0f, 0.0f ), direction ) );
+
+        // 物体は錐台を囲む範囲に置き, 境界付近のものも含まれるようにします.
+        for( size_t i=0; i<TEST_CULL_COUNT; ++i )
+        {
+            auto center = position + randomVector( -farClip, farClip );
+            auto extent = randomVector( 0.01f, farClip * 0.1f );
+            centerX[i] = center.x;
+            centerY[i] = center.y;
+            centerZ[i] = center.z;
+            radius [i] = extent.x;
+            minX[i] = center.x - extent.x; maxX[i] = center.x + extent.x;
+            minY[i] = center.y - extent.y; maxY[i] = center.y + extent.y;
+            minZ[i] = center.z - extent.z; maxZ[i] = center.z + extent.z;
+        }
+
+        // 要素数は全数と, 32 の倍数の前後を試します.
+        auto count = ( n % 4 == 0 ) ? TEST_CULL_COUNT : size_t( random.GetAsU32() % 100 );
+        std::fill( sphereMask.begin(), sphereMask.end(), 0xffffffffu );
+        std::fill( boxMask   .begin(), boxMask   .end(), 0xffffffffu );
+        frustum.CullSpheres( centerX.data(), centerY.data(), centerZ.data(), radius.data(), count, sphereMask.data() );
+        frustum.CullBoxes( minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), count, boxMask.data() );
+
+        size_t sphereMismatch = 0;
+        size_t boxMismatch    = 0;
+        for( size_t i=0; i<( count + 31 ) / 32 * 32; ++i )
+        {
+            auto sphereBit = ( sphereMask[i / 32] >> ( i % 32 ) ) & 0x1;
+            auto boxBit    = ( boxMask   [i / 32] >> ( i % 32 ) ) & 0x1;
+            auto sphereExpected = ( i < count ) && frustum.Contains( BoundingSphere( Vector3( centerX[i], centerY[i], centerZ[i] ), radius[i] ) );
+            auto boxExpected    = ( i < count ) && frustum.Contains( BoundingBox( Vector3( minX[i], minY[i], minZ[i] ), Vector3( maxX[i], maxY[i], maxZ[i] ) ) );
+            if ( sphereBit != ( sphereExpected ? 1u : 0u ) )
+            { sphereMismatch++; }
+            if ( boxBit != ( boxExpected ? 1u : 0u ) )
+            { boxMismatch++; }
+        }
+
+        Check( context, sphereMismatch == 0, "frustum #%d: CullSpheres() differs from Contains() in %zu of %zu", n, sphereMismatch, count );
+        Check( context, boxMismatch    == 0, "frustum #%d: CullBoxes() differs from Contains() in %zu of %zu", n, boxMismatch, count );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// StreamMatrix structure
+// xoshiro128** の状態遷移 (GF(2) 上の 128x128 行列) です. 列ごとに128bitの状態として保持します.
+// ジャンプ表を使わずに 2^64, 2^96 個先の状態を求めるための参照実装です.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct StreamMatrix
+{
+    uint32_t    Column[128][4];     //!< 各列(単位ベクトルを変換した状態)です.
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      状態を1つ進めます(xoshiro128** の状態の更新).
+    //---------------------------------------------------------------------------------------------
+    static void Step( uint32_t (&s)[4] )
+    {
+        auto t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = ( s[3] << 11 ) | ( s[3] >> 21 );
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      状態の出力を求めます(xoshiro128** の出力).
+    //---------------------------------------------------------------------------------------------
+    static uint32_t Output( const uint32_t (&s)[4] )
+    {
+        auto x = s[1] * 5;
+        return ( ( x << 7 ) | ( x >> 25 ) ) * 9;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      1つ進める遷移行列を生成します.
+    //---------------------------------------------------------------------------------------------
+    static StreamMatrix CreateStep()
+    {
+        StreamMatrix result;
+        for( auto j=0; j<128; ++j )
+        {
+            uint32_t s[4] = { 0, 0, 0, 0 };
+            s[j / 32] = 1u << ( j % 32 );
+            Step( s );
+            memcpy( result.Column[j], s, sizeof(s) );
+        }
+        return result;
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      状態に行列を適用します.
+    //---------------------------------------------------------------------------------------------
+    void Apply( const uint32_t (&s)[4], uint32_t (&result)[4] ) const
+    {
+        uint32_t r[4] = { 0, 0, 0, 0 };
+        for( auto j=0; j<128; ++j )
+        {
+            if ( ( s[j / 32] >> ( j % 32 ) ) & 0x1 )
+            {
+                for( auto k=0; k<4; ++k )
+                { r[k] ^= Column[j][k]; }
+            }
+        }
+        memcpy( result, r, sizeof(r) );
+    }
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      行列を2乗します(進める個数が2倍になります).
+    //---------------------------------------------------------------------------------------------
+    StreamMatrix Square() const
+    {
+        StreamMatrix result;
+        for( auto j=0; j<128; ++j )
+        { Apply( Column[j], result.Column[j] ); }
+        return result;
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+//      RandomStream の種から xoshiro128** の初期状態を求めます (SplitMix64 で展開).
+//-------------------------------------------------------------------------------------------------
+void StreamSeedRef( uint64_t seed, uint32_t (&state)[4] )
+{
+    for( auto i=0; i<2; ++i )
+    {
+        seed += 0x9e3779b97f4a7c15ull;
+        auto z = seed;
+        z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+        z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebull;
+        z = z ^ ( z >> 31 );
+        state[i * 2 + 0] = static_cast<uint32_t>( z );
+        state[i * 2 + 1] = static_cast<uint32_t>( z >> 32 );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      RandomStream の出力が参照実装の状態からの出力と一致するか判定します.
+//-------------------------------------------------------------------------------------------------
+bool IsSameStream( RandomStream stream, const uint32_t (&state)[4] )
+{
+    uint32_t s[4];
+    memcpy( s, state, sizeof(s) );
+    for( size_t i=0; i<TEST_STREAM_OUTPUTS; ++i )
+    {
+        if ( stream.GetAsU32() != StreamMatrix::Output( s ) )
+        { return false; }
+        StreamMatrix::Step( s );
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      RandomStream の出力, Jump(), LongJump(), Split() が, 遷移行列の累乗で求めた
+//      xoshiro128** の状態と一致するか試験します(ジャンプ表とは独立に求めます).
+//-------------------------------------------------------------------------------------------------
+void TestRandomStreamJump( TestContext& context )
+{
+    // 2^64 個と 2^96 個進める行列.
+    auto jump = StreamMatrix::CreateStep();
+    for( auto i=0; i<64; ++i )
+    { jump = jump.Square(); }
+    auto longJump = jump;
+    for( auto i=0; i<32; ++i )
+    { longJump = longJump.Square(); }
+
+    for( auto seed : { uint64_t( 0 ), uint64_t( 1 ), uint64_t( TEST_SEED ), uint64_t( 0xffffffffffffffffull ) } )
+    {
+        uint32_t state[4];
+        StreamSeedRef( seed, state );
+
+        RandomStream stream( seed );
+        Check( context, IsSameStream( stream, state ), "seed %llx: output differs from xoshiro128**", static_cast<unsigned long long>( seed ) );
+
+        // Jump() を繰り返します.
+        uint32_t expected[4];
+        memcpy( expected, state, sizeof(expected) );
+        auto jumped = stream;
+        for( auto n=1; n<=3; ++n )
+        {
+            jump.Apply( expected, expected );
+            jumped.Jump();
+            Check( context, IsSameStream( jumped, expected ), "seed %llx: Jump() x %d differs", static_cast<unsigned long long>( seed ), n );
+        }
+
+        // LongJump() と Split() は (streamIndex + 1) 回の LongJump() に等しいこと.
+        memcpy( expected, state, sizeof(expected) );
+        auto longJumped = stream;
+        for( auto index=0u; index<TEST_STREAM_SPLITS; ++index )
+        {
+            longJump.Apply( expected, expected );
+            longJumped.LongJump();
+            Check( context, IsSameStream( longJumped, expected ), "seed %llx: LongJump() x %u differs", static_cast<unsigned long long>( seed ), index + 1 );
+            Check( context, IsSameStream( stream.Split( index ), expected ), "seed %llx: Split( %u ) differs", static_cast<unsigned long long>( seed ), index );
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      RandomStream::FillU32() / FillF32() の結果と呼び出し後の状態がスレッド数によらないか試験します.
+//      OpenMP 無効時は1スレッドの結果同士を比べます.
+//-------------------------------------------------------------------------------------------------
+void TestRandomStreamFill( TestContext& context )
+{
+    std::vector<uint32_t> u32s[2];
+    std::vector<float>    f32s[2];
+    uint32_t              next[2];
+
+#if ASVK_IS_OPENMP
+    auto threads = omp_get_max_threads();
+#endif
+
+    for( auto pass=0; pass<2; ++pass )
+    {
+    #if ASVK_IS_OPENMP
+        omp_set_num_threads( ( pass == 0 ) ? 1 : TEST_STREAM_THREADS );
+    #endif
+
+        RandomStream stream( TEST_SEED );
+        u32s[pass].resize( TEST_STREAM_FILL_COUNT );
+        f32s[pass].resize( TEST_STREAM_FILL_COUNT );
+        stream.FillU32( u32s[pass].data(), u32s[pass].size() );
+        stream.FillF32( f32s[pass].data(), f32s[pass].size(), -1.0f, 1.0f );
+        next[pass] = stream.GetAsU32();
+    }
+
+#if ASVK_IS_OPENMP
+    omp_set_num_threads( threads );
+#endif
+
+    Check( context, u32s[0] == u32s[1], "FillU32() depends on the thread count" );
+    Check( context, IsSameBits( f32s[0].data(), f32s[1].data(), TEST_STREAM_FILL_COUNT ), "FillF32() depends on the thread count" );
+    Check( context, next[0] == next[1], "the state after Fill depends on the thread count" );
+
+    // 先頭のブロックは元の系列そのものであること.
+    RandomStream stream( TEST_SEED );
+    auto head = true;
+    for( size_t i=0; i<1024; ++i )
+    { head = head && ( u32s[0][i] == stream.GetAsU32() ); }
+    Check( context, head, "the first block of FillU32() differs from GetAsU32()" );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      2つのベクトルのなす角(度)を倍精度で求めます.
+//-------------------------------------------------------------------------------------------------
+double VectorAngle( const Vector3& a, const Vector3& b )
+{
+    auto cx = double( a.y ) * b.z - double( a.z ) * b.y;
+    auto cy = double( a.z ) * b.x - double( a.x ) * b.z;
+    auto cz = double( a.x ) * b.y - double( a.y ) * b.x;
+    return atan2( sqrt( cx * cx + cy * cy + cz * cz ), DotD( a, b ) ) * 180.0 / D_PI;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      八面体写像と QTangent の試験に使う単位ベクトルを生成します.
+//      一様な方向に加えて, 座標軸, 八面体の辺と面の中心, -0 を含む方向を含めます.
+//-------------------------------------------------------------------------------------------------
+std::vector<Vector3> PackingInputs()
+{
+    std::vector<Vector3> result;
+    result.reserve( TEST_PACKING_COUNT );
+
+    for( auto x : { -1.0f, -0.0f, 0.0f, 1.0f } )
+    {
+        for( auto y : { -1.0f, -0.0f, 0.0f, 1.0f } )
+        {
+            for( auto z : { -1.0f, -0.0f, 0.0f, 1.0f } )
+            {
+                auto value = Vector3( x, y, z );
+                if ( value.LengthSq() > 0.0f )
+                { result.push_back( Vector3::Normalize( value ) ); }
+            }
+        }
+    }
+
+    auto offset = result.size();
+    result.resize( TEST_PACKING_COUNT );
+    Random( TEST_SEED ).FillUnitVector3( result.data() + offset, result.size() - offset );
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      八面体写像の往復の角度誤差が上限に収まるか, また配列版がスカラー版とビット単位で一致するか試験します.
+//-------------------------------------------------------------------------------------------------
+template<typename Code, typename Encode, typename Decode, typename EncodeArray, typename DecodeArray>
+void TestOctahedral
+(
+    TestContext&        context,
+    double              bound,
+    Encode              encode,
+    Decode              decode,
+    EncodeArray         encodeArray,
+    DecodeArray         decodeArray
+)
+{
+    auto inputs = PackingInputs();
+    std::vector<Code>    codes  ( inputs.size() );
+    std::vector<Vector3> outputs( inputs.size() );
+    encodeArray( inputs.data(), codes.data(), inputs.size() );
+    decodeArray( codes.data(), outputs.data(), codes.size() );
+
+    SweepResult worst;
+    size_t mismatch = 0;
+    for( size_t i=0; i<inputs.size(); ++i )
+    {
+        auto code   = encode( inputs[i] );
+        auto output = decode( code );
+        if ( code != codes[i] || !IsSameBits( &output.x, &outputs[i].x, 3 ) )
+        { mismatch++; }
+
+        auto error = VectorAngle( inputs[i], output );
+        worst.Add( float( i ), error );
+        Check( context, error <= bound, "(%.9g, %.9g, %.9g) round trip differs by %g deg", inputs[i].x, inputs[i].y, inputs[i].z, error );
+    }
+
+    Check( context, mismatch == 0, "array version differs from scalar version in %zu values", mismatch );
+    fprintf( stdout, "    %-28s max error %.3g deg (bound %.3g deg, %llu values)\n",
+        "round trip", worst.MaxError, bound, static_cast<unsigned long long>( worst.Count ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      EncodeOctahedral16() / DecodeOctahedral16() を試験します.
+//-------------------------------------------------------------------------------------------------
+void TestOctahedral16( TestContext& context )
+{
+    TestOctahedral<uint32_t>( context, TEST_OCTAHEDRAL16_BOUND,
+        []( const Vector3& value ) { return EncodeOctahedral16( value ); },
+        []( uint32_t value ) { return DecodeOctahedral16( value ); },
+        []( const Vector3* pValues, uint32_t* pResults, size_t count ) { EncodeOctahedral16( pValues, pResults, count ); },
+        []( const uint32_t* pValues, Vector3* pResults, size_t count ) { DecodeOctahedral16( pValues, pResults, count ); } );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      EncodeOctahedral8() / DecodeOctahedral8() を試験します.
+//-------------------------------------------------------------------------------------------------
+void TestOctahedral8( TestContext& context )
+{
+    TestOctahedral<uint16_t>( context, TEST_OCTAHEDRAL8_BOUND,
+        []( const Vector3& value ) { return EncodeOctahedral8( value ); },
+        []( uint16_t value ) { return DecodeOctahedral8( value ); },
+        []( const Vector3* pValues, uint16_t* pResults, size_t count ) { EncodeOctahedral8( pValues, pResults, count ); },
+        []( const uint16_t* pValues, Vector3* pResults, size_t count ) { DecodeOctahedral8( pValues, pResults, count ); } );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      EncodeQTangent() / DecodeQTangent() の往復の法線と接線の角度誤差が上限に収まるか,
+//      従接線の向きが保たれるか, また配列版がスカラー版とビット単位で一致するか試験します.
+//-------------------------------------------------------------------------------------------------
+void TestQTangent( TestContext& context )
+{
+    Random random( TEST_SEED );
+    auto normals = PackingInputs();
+
+    std::vector<Quaternion> rotations  ( normals.size() );
+    std::vector<float>      handedness ( normals.size() );
+    std::vector<uint32_t>   codes      ( normals.size() );
+    std::vector<Quaternion> outRotations ( normals.size() );
+    std::vector<float>      outHandedness( normals.size() );
+
+    SweepResult worstNormal;
+    SweepResult worstTangent;
+    size_t flipped = 0;
+    for( size_t i=0; i<normals.size(); ++i )
+    {
+        // 法線に直交する乱数の方向を接線とします.
+        const auto& normal = normals[i];
+        Vector3 tangent;
+        do
+        {
+            auto value = Vector3( random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ), random.GetAsF32( -1.0f, 1.0f ) );
+            tangent = Vector3::Cross( normal, value );
+        }
+        while( tangent.LengthSq() < 1e-4f );
+        tangent = Vector3::Normalize( tangent );
+
+        auto sign = ( i & 0x1 ) ? -1.0f : 1.0f;
+        auto code = EncodeQTangent( normal, Vector4( tangent.x, tangent.y, tangent.z, sign ) );
+
+        Vector3 outNormal;
+        Vector4 outTangent;
+        DecodeQTangent( code, outNormal, outTangent );
+        if ( outTangent.w != sign )
+        { flipped++; }
+
+        auto normalError  = VectorAngle( normal,  outNormal );
+        auto tangentError = VectorAngle( tangent, Vector3( outTangent.x, outTangent.y, outTangent.z ) );
+        worstNormal .Add( float( i ), normalError );
+        worstTangent.Add( float( i ), tangentError );
+        Check( context, normalError <= TEST_QTANGENT_BOUND && tangentError <= TEST_QTANGENT_BOUND,
+            "#%zu round trip differs by %g deg (normal), %g deg (tangent)", i, normalError, tangentError );
+
+        // 配列版の入力は回転の形式で作ります.
+        DecodeQTangent( code, rotations[i], handedness[i] );
+        codes[i] = code;
+    }
+
+    // 配列版はスカラー版と一致すること.
+    std::vector<uint32_t> outCodes( normals.size() );
+    EncodeQTangent( rotations.data(), handedness.data(), outCodes.data(), rotations.size() );
+    DecodeQTangent( codes.data(), outRotations.data(), outHandedness.data(), codes.size() );
+
+    size_t mismatch = 0;
+    for( size_t i=0; i<codes.size(); ++i )
+    {
+        Quaternion rotation;
+        float      sign;
+        DecodeQTangent( codes[i], rotation, sign );
+        if ( outCodes[i] != EncodeQTangent( rotations[i], handedness[i] )
+          || !IsSameBits( &outRotations[i].x, &rotation.x, 4 )
+          || outHandedness[i] != sign )
+        { mismatch++; }
+    }
+
+    Check( context, flipped == 0, "handedness flipped in %zu values", flipped );
+    Check( context, mismatch == 0, "array version differs from scalar version in %zu values", mismatch );
+    fprintf( stdout, "    %-28s max error %.3g deg (bound %.3g deg, %llu values)\n",
+        "normal round trip", worstNormal.MaxError, TEST_QTANGENT_BOUND, static_cast<unsigned long long>( worstNormal.Count ) );
+    fprintf( stdout, "    %-28s max error %.3g deg (bound %.3g deg, %llu values)\n",
+        "tangent round trip", worstTangent.MaxError, TEST_QTANGENT_BOUND, static_cast<unsigned long long>( worstTangent.Count ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      拡大縮小・回転・平行移動の順に適用する行列を生成します (TransformHierarchy と同じ演算順序).
+//-------------------------------------------------------------------------------------------------
+Matrix ComposeRef( const Vector3& translation, const Quaternion& rotation, const Vector3& scale )
+{
+    auto result = Matrix::CreateFromQuaternion( rotation );
+    result._11 *= scale.x; result._12 *= scale.x; result._13 *= scale.x;
+    result._21 *= scale.y; result._22 *= scale.y; result._23 *= scale.y;
+    result._31 *= scale.z; result._32 *= scale.z; result._33 *= scale.z;
+    result._41 = translation.x;
+    result._42 = translation.y;
+    result._43 = translation.z;
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      TransformHierarchy::Update() が全ノードを計算し直した結果とビット単位で一致するか試験します.
+//      更新対象の数を変えて, 子孫だけを辿る更新と全ノードを走査する更新の両方を通ります.
+//      途中でノードを追加して並べ替えも通ります.
+//-------------------------------------------------------------------------------------------------
+void TestTransformHierarchyUpdate( TestContext& context )
+{
+    Random random( TEST_SEED );
+    auto randomVector = [&]( float a, float b )
+    { return Vector3( random.GetAsF32( a, b ), random.GetAsF32( a, b ), random.GetAsF32( a, b ) ); };
+
+    for( auto trial=0; trial<TEST_HIERARCHY_TRIALS; ++trial )
+    {
+        TransformHierarchy hierarchy;
+        std::vector<uint32_t> parents;
+
+        // 1/8 をルートとし, 残りは追加済みのノードを親とする森を作ります.
+        auto add = [&]()
+        {
+            auto count  = uint32_t( parents.size() );
+            auto parent = ( count == 0 || random.GetAsU32() % 8 == 0 ) ? TransformHierarchy::INVALID_HANDLE : random.GetAsU32() % count;
+            parents.push_back( parent );
+            hierarchy.Add( parent, randomVector( -10.0f, 10.0f ), RandomRotation( random ), randomVector( 0.5f, 2.0f ) );
+        };
+
+        auto nodeCount = 1 + random.GetAsU32() % TEST_HIERARCHY_NODES;
+        for( auto i=0u; i<nodeCount; ++i )
+        { add(); }
+
+        std::vector<Matrix> expected;
+        for( auto step=0; step<TEST_HIERARCHY_STEPS; ++step )
+        {
+            // 少数の変更(子孫だけを辿る更新)と多数の変更(全ノードを走査する更新)を交互に行います.
+            auto count = uint32_t( parents.size() );
+            auto dirty = ( step % 3 == 0 ) ? count / 2 : random.GetAsU32() % 8;
+            for( auto i=0u; i<dirty; ++i )
+            {
+                auto handle = random.GetAsU32() % count;
+                switch( random.GetAsU32() % 4 )
+                {
+                case 0:  hierarchy.SetTranslation( handle, randomVector( -10.0f, 10.0f ) ); break;
+                case 1:  hierarchy.SetRotation   ( handle, RandomRotation( random ) );      break;
+                case 2:  hierarchy.SetScale      ( handle, randomVector( 0.5f, 2.0f ) );    break;
+                default: hierarchy.SetLocal      ( handle, randomVector( -10.0f, 10.0f ), RandomRotation( random ), randomVector( 0.5f, 2.0f ) ); break;
+                }
+            }
+
+            if ( step % 5 == 4 )
+            {
+                auto added = random.GetAsU32() % 16;
+                for( auto i=0u; i<added; ++i )
+                { add(); }
+            }
+
+            hierarchy.Update();
+
+            // 親は子より先に追加されているので, ハンドル順に計算できます.
+            expected.resize( parents.size() );
+            size_t mismatch = 0;
+            for( auto i=0u; i<uint32_t( parents.size() ); ++i )
+            {
+                auto local = ComposeRef( hierarchy.GetTranslation( i ), hierarchy.GetRotation( i ), hierarchy.GetScale( i ) );
+                expected[i] = ( parents[i] == TransformHierarchy::INVALID_HANDLE ) ? local : Matrix::Multiply( local, expected[parents[i]] );
+                if ( !IsSameBits( &hierarchy.GetWorld( i )._11, &expected[i]._11, 16 ) )
+                { mismatch++; }
+            }
+
+            Check( context, mismatch == 0, "trial %d step %d (%zu nodes, %u dirty): %zu world matrices differ",
+                trial, step, parents.size(), dirty, mismatch );
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Spline::Build() と同じように端点の外側を補った制御点を求めます.
+//-------------------------------------------------------------------------------------------------
+std::vector<Vector3> SplinePointsRef( const std::vector<Vector3>& points, bool closed )
+{
+    auto count = points.size();
+    std::vector<Vector3> result;
+    result.push_back( closed ? points[count - 1] : points[0] * 2.0f - points[1] );
+    result.insert( result.end(), points.begin(), points.end() );
+    if ( closed )
+    {
+        result.push_back( points[0] );
+        result.push_back( points[1] );
+    }
+    else
+    { result.push_back( points[count - 1] * 2.0f - points[count - 2] ); }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Catmull-Rom スプラインの速さ |dP/dt| を倍精度で求めます.
+//-------------------------------------------------------------------------------------------------
+double SplineSpeedRef( const std::vector<Vector3>& points, double param )
+{
+    auto segmentCount = points.size() - 3;
+    auto index  = std::min( static_cast<size_t>( param ), segmentCount - 1 );
+    auto amount = param - double( index );
+    const auto* p = &points[index];
+
+    double lengthSq = 0.0;
+    for( auto c=0; c<3; ++c )
+    {
+        double a = ( &p[0].x )[c];
+        double b = ( &p[1].x )[c];
+        double e = ( &p[2].x )[c];
+        double d = ( &p[3].x )[c];
+        auto v = 0.5 * ( ( e - a )
+                       + ( 2.0 * a - 5.0 * b + 4.0 * e - d ) * 2.0 * amount
+                       + ( 3.0 * b - a - 3.0 * e + d ) * 3.0 * amount * amount );
+        lengthSq += v * v;
+    }
+    return sqrt( lengthSq );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      パラメータ [t0, t1] の弧長を倍精度のシンプソン則で求めます.
+//-------------------------------------------------------------------------------------------------
+double SplineArcRef( const std::vector<Vector3>& points, double t0, double t1 )
+{
+    auto n = std::max( 8, static_cast<int>( ( t1 - t0 ) * 512.0 ) );
+    auto h = ( t1 - t0 ) / n;
+    double sum = 0.0;
+    for( auto k=0; k<n; ++k )
+    {
+        auto t = t0 + k * h;
+        sum += SplineSpeedRef( points, t ) + 4.0 * SplineSpeedRef( points, t + 0.5 * h ) + SplineSpeedRef( points, t + h );
+    }
+    return sum * h / 6.0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      乱数の制御点で曲線を生成します.
+//-------------------------------------------------------------------------------------------------
+std::vector<Vector3> RandomSplinePoints( Random& random )
+{
+    std::vector<Vector3> result( 4 + random.GetAsU32() % ( TEST_SPLINE_POINTS - 3 ) );
+    for( auto& p : result )
+    { p = Vector3( random.GetAsF32( -10.0f, 10.0f ), random.GetAsF32( -10.0f, 10.0f ), random.GetAsF32( -10.0f, 10.0f ) ); }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Spline::GetParam() で一定の距離ずつ進めたとき, 1歩ごとの弧長が距離と一致するか試験します.
+//      制御点が乱数なので, 急な曲がりや速さが0に近い点も含みます.
+//-------------------------------------------------------------------------------------------------
+void TestSplineUniformSpeed( TestContext& context )
+{
+    Random random( TEST_SEED );
+    SweepResult speed;
+    SweepResult length;
+
+    for( auto n=0; n<TEST_SPLINE_CURVES; ++n )
+    {
+        auto closed = ( n % 2 != 0 );
+        auto points = RandomSplinePoints( random );
+
+        Spline spline;
+        Check( context, spline.Build( points.data(), points.size(), closed ), "Build() failed for curve #%d", n );
+
+        auto reference    = SplinePointsRef( points, closed );
+        auto segmentCount = spline.GetSegmentCount();
+        auto total        = SplineArcRef( reference, 0.0, double( segmentCount ) );
+        length.Add( float( n ), fabs( spline.GetLength() - total ) / total );
+
+        // 閉じた曲線では全長で循環するので, 終点の手前まで進めます.
+        auto steps = static_cast<uint32_t>( segmentCount ) * TEST_SPLINE_STEPS;
+        auto step  = double( spline.GetLength() ) / steps;
+        double prev = 0.0;
+        for( auto k=1u; k<steps; ++k )
+        {
+            double param = spline.GetParam( float( k * step ) );
+            speed.Add( float( n ), fabs( SplineArcRef( reference, prev, param ) / step - 1.0 ) );
+            prev = param;
+        }
+    }
+
+    CheckSweep( context, "length", length, TEST_SPLINE_TOTAL_BOUND );
+    CheckSweep( context, "arc per step / distance", speed, TEST_SPLINE_SPEED_BOUND );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Spline::Evaluate() と EvaluateAtDistance() の配列版がスカラー版とビット単位で一致するか試験します.
+//      範囲外でクランプされるパラメータや, 区間の境界のパラメータも含みます.
+//-------------------------------------------------------------------------------------------------
+void TestSplineEvaluate( TestContext& context )
+{
+    Random random( TEST_SEED );
+
+    for( auto n=0; n<TEST_SPLINE_CURVES; ++n )
+    {
+        auto closed = ( n % 2 != 0 );
+        auto points = RandomSplinePoints( random );
+
+        Spline spline;
+        spline.Build( points.data(), points.size(), closed );
+        auto maxParam = static_cast<float>( spline.GetSegmentCount() );
+        auto length   = spline.GetLength();
+
+        std::vector<float> params   ( TEST_SPLINE_PARAMS );
+        std::vector<float> distances( TEST_SPLINE_PARAMS );
+        for( size_t i=0; i<TEST_SPLINE_PARAMS; ++i )
+        {
+            params   [i] = ( i % 8 == 0 ) ? static_cast<float>( random.GetAsU32() % ( spline.GetSegmentCount() + 1 ) ) : random.GetAsF32( -1.0f, maxParam + 1.0f );
+            distances[i] = random.GetAsF32( -length, length * 2.0f );
+        }
+
+        std::vector<Vector3> results( TEST_SPLINE_PARAMS );
+        std::vector<Vector3> atDistance( TEST_SPLINE_PARAMS );
+        spline.Evaluate( params.data(), results.data(), results.size() );
+        spline.EvaluateAtDistance( distances.data(), atDistance.data(), atDistance.size() );
+
+        size_t mismatch = 0;
+        size_t mismatchAtDistance = 0;
+        for( size_t i=0; i<TEST_SPLINE_PARAMS; ++i )
+        {
+            auto expected = spline.Evaluate( params[i] );
+            if ( !IsSameBits( &results[i].x, &expected.x, 3 ) )
+            { mismatch++; }
+
+            expected = spline.EvaluateAtDistance( distances[i] );
+            if ( !IsSameBits( &atDistance[i].x, &expected.x, 3 ) )
+            { mismatchAtDistance++; }
+        }
+
+        Check( context, mismatch == 0, "curve #%d (%zu segments): Evaluate() array version differs in %zu values",
+            n, spline.GetSegmentCount(), mismatch );
+        Check( context, mismatchAtDistance == 0, "curve #%d (%zu segments): EvaluateAtDistance() array version differs in %zu values",
+            n, spline.GetSegmentCount(), mismatchAtDistance );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BVH の試験に使う箱を生成します.
+//      厚みが0の箱と, 同じ箱が重なった塊(分割の評価が同値になる)も含めます.
+//-------------------------------------------------------------------------------------------------
+std::vector<BoundingBox> BvhBoxes( Random& random, uint32_t count )
+{
+    std::vector<BoundingBox> result( count );
+    for( auto i=0u; i<count; ++i )
+    {
+        if ( i > 0 && random.GetAsU32() % 16 == 0 )
+        {
+            result[i] = result[random.GetAsU32() % i];
+            continue;
+        }
+
+        auto center = Vector3( random.GetAsF32( -50.0f, 50.0f ), random.GetAsF32( -50.0f, 50.0f ), random.GetAsF32( -50.0f, 50.0f ) );
+        auto extent = Vector3( random.GetAsF32( 0.0f, 2.0f ), random.GetAsF32( 0.0f, 2.0f ), random.GetAsF32( 0.0f, 2.0f ) );
+        if ( random.GetAsU32() % 8 == 0 )
+        { extent.y = 0.0f; }
+        result[i] = BoundingBox( center - extent, center + extent );
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BVH の試験に使うレイを生成します. 座標軸に平行な(方向の成分が0の)レイも含めます.
+//-------------------------------------------------------------------------------------------------
+std::vector<Ray> BvhRays( Random& random, size_t count )
+{
+    std::vector<Ray> result;
+    result.reserve( count );
+    for( size_t i=0; i<count; ++i )
+    {
+        auto origin = Vector3( random.GetAsF32( -60.0f, 60.0f ), random.GetAsF32( -60.0f, 60.0f ), random.GetAsF32( -60.0f, 60.0f ) );
+        Vector3 direction;
+        random.FillUnitVector3( &direction, 1 );
+        if ( i % 8 == 0 )
+        {
+            auto axis = random.GetAsU32() % 3;
+            direction = Vector3( 0.0f, 0.0f, 0.0f );
+            ( &direction.x )[axis] = ( random.GetAsU32() % 2 == 0 ) ? 1.0f : -1.0f;
+        }
+        result.push_back( Ray( origin, direction ) );
+    }
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      箱 a が箱 b を含むか判定します.
+//-------------------------------------------------------------------------------------------------
+bool Encloses( const BoundingBox& a, const BoundingBox& b )
+{
+    return a.mini.x <= b.mini.x && a.mini.y <= b.mini.y && a.mini.z <= b.mini.z
+        && a.maxi.x >= b.maxi.x && a.maxi.y >= b.maxi.y && a.maxi.z >= b.maxi.z;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      BVH の構造と交差判定を総当たりと比べて試験します.
+//      全てのプリミティブがちょうど1つの葉にあり, ノードの箱が子を含むことを確かめます.
+//      最も近い交差の距離は全ての箱との総当たりの最小値とビット単位で一致します.
+//-------------------------------------------------------------------------------------------------
+void CheckBvh
+(
+    TestContext&                    context,
+    const char*                     label,
+    const Bvh&                      bvh,
+    const std::vector<BoundingBox>& boxes,
+    const std::vector<Ray>&         rays,
+    const std::vector<float>&       maxDistances
+)
+{
+    auto nodes     = bvh.GetNodes();
+    auto nodeCount = bvh.GetNodeCount();
+    auto indices   = bvh.GetIndices();
+
+    // 深さ優先で辿り, 左の子は直後, 右の子は offset にあることを使います.
+    std::vector<uint32_t> visits( boxes.size(), 0 );
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    size_t badBounds = 0;
+    size_t badLinks  = 0;
+    uint32_t maxDepth = 0;
+    stack.push_back( std::make_pair( 0u, 1u ) );
+    while( !stack.empty() )
+    {
+        auto index = stack.back().first;
+        auto depth = stack.back().second;
+        stack.pop_back();
+        maxDepth = std::max( maxDepth, depth );
+
+        const auto& node = nodes[index];
+        if ( node.IsLeaf() )
+        {
+            for( auto i=0u; i<node.count; ++i )
+            {
+                auto primitive = indices[node.offset + i];
+                if ( primitive >= boxes.size() )
+                {
+                    badLinks++;
+                    continue;
+                }
+                visits[primitive]++;
+                if ( !Encloses( node.bounds, boxes[primitive] ) )
+                { badBounds++; }
+            }
+            continue;
+        }
+
+        auto left  = index + 1;
+        auto right = node.offset;
+        if ( left >= nodeCount || right >= nodeCount || right <= left )
+        {
+            badLinks++;
+            continue;
+        }
+        if ( !Encloses( node.bounds, nodes[left].bounds ) || !Encloses( node.bounds, nodes[right].bounds ) )
+        { badBounds++; }
+        stack.push_back( std::make_pair( right, depth + 1 ) );
+        stack.push_back( std::make_pair( left,  depth + 1 ) );
+    }
+
+    auto missing = size_t( std::count( visits.begin(), visits.end(), 0u ) );
+    auto twice   = size_t( std::count_if( visits.begin(), visits.end(), []( uint32_t value ) { return value > 1; } ) );
+    Check( context, badLinks == 0, "%s (%zu boxes): %zu invalid child or primitive links", label, boxes.size(), badLinks );
+    Check( context, missing == 0 && twice == 0, "%s (%zu boxes): %zu primitives missing, %zu referenced twice", label, boxes.size(), missing, twice );
+    Check( context, badBounds == 0, "%s (%zu boxes): %zu node bounds do not enclose their children", label, boxes.size(), badBounds );
+    Check( context, maxDepth <= Bvh::MAX_DEPTH, "%s (%zu boxes): depth %u exceeds MAX_DEPTH", label, boxes.size(), maxDepth );
+
+    size_t closestMismatch = 0;
+    size_t anyMismatch     = 0;
+    size_t customMismatch  = 0;
+    for( size_t r=0; r<rays.size(); ++r )
+    {
+        const auto& ray = rays[r];
+        auto limit = maxDistances[r];
+
+        // 総当たりで最も近い交差を求めます.
+        auto  expectedHit = false;
+        auto  expected    = limit;
+        float distance;
+        for( const auto& box : boxes )
+        {
+            if ( box.Intersects( ray, expected, distance ) && distance <= expected )
+            {
+                expected    = distance;
+                expectedHit = true;
+            }
+        }
+
+        BvhHit hit;
+        auto found = bvh.IntersectClosest( ray, limit, hit );
+        if ( found != expectedHit
+          || ( found && ( hit.distance != expected || hit.index >= boxes.size()
+                       || !boxes[hit.index].Intersects( ray, limit, distance ) || distance != hit.distance ) ) )
+        { closestMismatch++; }
+
+        if ( bvh.IntersectAny( ray, limit ) != expectedHit )
+        { anyMismatch++; }
+
+        // 判定関数を指定する版は, 箱の判定を渡すと組み込みの判定と一致します.
+        auto intersector = [&boxes, &ray]( uint32_t index, float maxDistance, float& value )
+        { return boxes[index].Intersects( ray, maxDistance, value ); };
+        BvhHit customHit;
+        auto customFound = bvh.IntersectClosest( ray, limit, intersector, customHit );
+        if ( customFound != found
+          || ( found && ( customHit.index != hit.index || customHit.distance != hit.distance ) )
+          || bvh.IntersectAny( ray, limit, intersector ) != expectedHit )
+        { customMismatch++; }
+    }
+
+    Check( context, closestMismatch == 0, "%s (%zu boxes): IntersectClosest() differs from brute force for %zu rays", label, boxes.size(), closestMismatch );
+    Check( context, anyMismatch == 0, "%s (%zu boxes): IntersectAny() differs from brute force for %zu rays", label, boxes.size(), anyMismatch );
+    Check( context, customMismatch == 0, "%s (%zu boxes): intersector overloads differ for %zu rays", label, boxes.size(), customMismatch );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Bvh::Build() で構築した木を総当たりと比べて試験します.
+//      葉の最大プリミティブ数を変えて, 小さな木(1個, 2個)と大きな木の両方を通ります.
+//-------------------------------------------------------------------------------------------------
+void TestBvhBuild( TestContext& context )
+{
+    Random random( TEST_SEED );
+    const uint32_t leafSizes[] = { 1, Bvh::DEFAULT_LEAF_SIZE, 16 };
+
+    for( auto n=0; n<TEST_BVH_SCENES; ++n )
+    {
+        auto count = ( n < 3 ) ? uint32_t( n + 1 ) : 1 + random.GetAsU32() % TEST_BVH_MAX_BOXES;
+        auto boxes = BvhBoxes( random, count );
+        auto rays  = BvhRays( random, TEST_BVH_RAYS );
+        std::vector<float> maxDistances( rays.size() );
+        for( auto& value : maxDistances )
+        { value = random.GetAsF32( 0.0f, 200.0f ); }
+
+        for( auto leafSize : leafSizes )
+        {
+            Bvh bvh;
+            Check( context, bvh.Build( boxes.data(), boxes.size(), leafSize ), "Build( %u boxes, leaf %u ) failed", count, leafSize );
+            CheckBvh( context, "Build", bvh, boxes, rays, maxDistances );
+        }
+    }
+
+    Bvh empty;
+    Check( context, !empty.Build( nullptr, 0 ), "Build() with no boxes succeeded" );
+    Check( context, !empty.IntersectAny( Ray( Vector3( 0.0f, 0.0f, 0.0f ), Vector3( 1.0f, 0.0f, 0.0f ) ), 1.0f ), "empty tree reports a hit" );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Bvh::BuildLinear() で構築した木を総当たりと比べて試験します.
+//      モートン符号が全て同じになる(全ての箱が同じ)配置と, 1つの軸に並んだ配置も含めます.
+//-------------------------------------------------------------------------------------------------
+void TestBvhBuildLinear( TestContext& context )
+{
+    Random random( TEST_SEED );
+    const MortonPrecision precisions[] = { MortonPrecision::Bits30, MortonPrecision::Bits63 };
+
+    for( auto n=0; n<TEST_BVH_SCENES; ++n )
+    {
+        auto count = ( n < 3 ) ? uint32_t( n + 1 ) : 1 + random.GetAsU32() % TEST_BVH_MAX_BOXES;
+        auto boxes = BvhBoxes( random, count );
+        if ( n == 3 )
+        { std::fill( boxes.begin(), boxes.end(), boxes[0] ); }
+        if ( n == 4 )
+        {
+            for( auto i=0u; i<count; ++i )
+            { boxes[i] = BoundingBox( Vector3( float( i ), 0.0f, 0.0f ), Vector3( float( i ) + 0.5f, 1.0f, 1.0f ) ); }
+        }
+
+        auto rays = BvhRays( random, TEST_BVH_RAYS );
+        std::vector<float> maxDistances( rays.size() );
+        for( auto& value : maxDistances )
+        { value = random.GetAsF32( 0.0f, 200.0f ); }
+
+        for( auto precision : precisions )
+        {
+            Bvh bvh;
+            Check( context, bvh.BuildLinear( boxes.data(), boxes.size(), precision ), "BuildLinear( %u boxes ) failed", count );
+            Check( context, bvh.GetNodeCount() == 2 * size_t( count ) - 1, "BuildLinear( %u boxes ): %zu nodes (expected %zu)",
+                count, bvh.GetNodeCount(), 2 * size_t( count ) - 1 );
+            CheckBvh( context, ( precision == MortonPrecision::Bits30 ) ? "BuildLinear(30bit)" : "BuildLinear(63bit)", bvh, boxes, rays, maxDistances );
+        }
+    }
+
+    Bvh empty;
+    Check( context, !empty.BuildLinear( nullptr, 0 ), "BuildLinear() with no boxes succeeded" );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      レイパケットで BVH を走査した結果が, レーンごとに1本ずつ走査した結果と一致するか試験します.
+//      方向の揃ったパケットとばらばらなパケット, 判定しない(最大距離が負の)レーンを含めます.
+//-------------------------------------------------------------------------------------------------
+template<typename Packet>
+void CheckBvhPacket( TestContext& context, const char* label, const Bvh& bvh, const std::vector<Ray>& rays, const std::vector<float>& maxDistances )
+{
+    static constexpr uint32_t WIDTH = Packet::WIDTH;
+    size_t closestMismatch = 0;
+    size_t anyMismatch     = 0;
+
+    for( size_t first=0; first + WIDTH <= rays.size(); first += WIDTH )
+    {
+        Packet packet;
+        float  limit[WIDTH];
+        for( auto lane=0u; lane<WIDTH; ++lane )
+        {
+            packet.Set( lane, rays[first + lane] );
+            limit[lane] = ( ( first / WIDTH + lane ) % 7 == 0 ) ? -1.0f : maxDistances[first + lane];
+        }
+
+        BvhHit hits[WIDTH];
+        auto closestMask = bvh.IntersectClosest( packet, limit, hits );
+        auto anyMask     = bvh.IntersectAny( packet, limit );
+
+        for( auto lane=0u; lane<WIDTH; ++lane )
+        {
+            BvhHit expected;
+            auto expectedHit = ( limit[lane] >= 0.0f ) && bvh.IntersectClosest( rays[first + lane], limit[lane], expected );
+            auto hit         = ( ( closestMask >> lane ) & 0x1 ) != 0;
+
+            // 同じ距離の箱が複数ある場合は番号が異なってもよいので, 距離だけを比べます.
+            if ( hit != expectedHit || ( hit && hits[lane].distance != expected.distance ) )
+            { closestMismatch++; }
+            if ( ( ( anyMask >> lane ) & 0x1 ) != ( expectedHit ? 1u : 0u ) )
+            { anyMismatch++; }
+        }
+    }
+
+    Check( context, closestMismatch == 0, "%s: packet IntersectClosest() differs from single rays in %zu lanes", label, closestMismatch );
+    Check( context, anyMismatch == 0, "%s: packet IntersectAny() differs from single rays in %zu lanes", label, anyMismatch );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Bvh のレイパケット版の走査を1本ずつの走査と比べて試験します.
+//-------------------------------------------------------------------------------------------------
+void TestBvhPacket( TestContext& context )
+{
+    Random random( TEST_SEED );
+
+    for( auto n=0; n<TEST_BVH_SCENES; ++n )
+    {
+        auto count = 1 + random.GetAsU32() % TEST_BVH_MAX_BOXES;
+        auto boxes = BvhBoxes( random, count );
+
+        // 半分は1点から扇状に広がる方向の揃ったレイ, 残りはばらばらなレイです.
+        auto rays = BvhRays( random, TEST_BVH_RAYS );
+        auto eye  = Vector3( random.GetAsF32( -60.0f, 60.0f ), random.GetAsF32( -60.0f, 60.0f ), -80.0f );
+        for( size_t i=0; i<rays.size() / 2; ++i )
+        {
+            auto target = Vector3( random.GetAsF32( -50.0f, 50.0f ), random.GetAsF32( -50.0f, 50.0f ), 0.0f );
+            rays[i] = Ray( eye, Vector3::Normalize( target - eye ) );
+        }
+        std::vector<float> maxDistances( rays.size() );
+        for( auto& value : maxDistances )
+        { value = random.GetAsF32( 0.0f, 200.0f ); }
+
+        Bvh bvh;
+        bvh.Build( boxes.data(), boxes.size() );
+        CheckBvhPacket<RayPacket4>( context, "RayPacket4", bvh, rays, maxDistances );
+        CheckBvhPacket<RayPacket8>( context, "RayPacket8", bvh, rays, maxDistances );
+
+        // GetRay() は Set() したレイをビット単位で復元します.
+        RayPacket8 packet;
+        size_t restored = 0;
+        for( auto lane=0u; lane<RayPacket8::WIDTH; ++lane )
+        {
+            const auto& ray = rays[lane * 3];
+            packet.Set( lane, ray );
+            auto value = packet.GetRay( lane );
+            if ( IsSameBits( &value.pos.x, &ray.pos.x, 3 ) && IsSameBits( &value.dir.x, &ray.dir.x, 3 )
+              && IsSameBits( &value.invDir.x, &ray.invDir.x, 3 )
+              && value.sign.x == ray.sign.x && value.sign.y == ray.sign.y && value.sign.z == ray.sign.z )
+            { restored++; }
+        }
+        Check( context, restored == RayPacket8::WIDTH, "GetRay() does not restore %zu of %u lanes", RayPacket8::WIDTH - restored, RayPacket8::WIDTH );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SpatialHash::QueryNearest() の結果を総当たりと比べます.
+//      同じ距離の物体が複数ある場合は番号が異なってもよいので, 距離の並びと, 各ハンドルの距離を確かめます.
+//-------------------------------------------------------------------------------------------------
+bool CheckNearest
+(
+    const SpatialHash&                  hash,
+    const std::vector<BoundingSphere>&  spheres,
+    const std::vector<bool>&            alive,
+    const Vector3&                      point,
+    float                               maxDistance,
+    uint32_t                            maxCount
+)
+{
+    std::vector<float> expected;
+    for( size_t h=0; h<spheres.size(); ++h )
+    {
+        if ( !alive[h] )
+        { continue; }
+
+        auto dx = spheres[h].center.x - point.x;
+        auto dy = spheres[h].center.y - point.y;
+        auto dz = spheres[h].center.z - point.z;
+        auto distance = sqrtf( dx * dx + dy * dy + dz * dz );
+        if ( distance <= maxDistance )
+        { expected.push_back( distance ); }
+    }
+    std::sort( expected.begin(), expected.end() );
+    if ( expected.size() > maxCount )
+    { expected.resize( maxCount ); }
+
+    std::vector<uint32_t> handles  ( maxCount );
+    std::vector<float>    distances( maxCount );
+    auto count = hash.QueryNearest( point, maxDistance, handles.data(), distances.data(), maxCount );
+    if ( count != expected.size() )
+    { return false; }
+
+    std::vector<bool> found( spheres.size(), false );
+    for( auto i=0u; i<count; ++i )
+    {
+        auto handle = handles[i];
+        if ( handle >= spheres.size() || !alive[handle] || found[handle] )
+        { return false; }
+        found[handle] = true;
+
+        auto dx = spheres[handle].center.x - point.x;
+        auto dy = spheres[handle].center.y - point.y;
+        auto dz = spheres[handle].center.z - point.z;
+        if ( distances[i] != sqrtf( dx * dx + dy * dy + dz * dz ) )
+        { return false; }
+
+        // 検索範囲の2乗で絞り込む際の丸めで, 境界上の物体が入れ替わる分だけ許容します.
+        if ( fabsf( distances[i] - expected[i] ) > expected[i] * 4.0f * FLT_EPSILON )
+        { return false; }
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      SpatialHash の検索結果を総当たりと比べて試験します.
+//      追加・移動・削除を繰り返し, セルに入らない大きな物体と, 同じセルに集まった物体も含めます.
+//      QuerySphere() / QueryBox() / QueryFrustum() は総当たりと同じ式で判定するため, 集合が完全に一致します.
+//-------------------------------------------------------------------------------------------------
+void TestSpatialHashQuery( TestContext& context )
+{
+    Random random( TEST_SEED );
+    auto randomVector = [&]( float a, float b )
+    { return Vector3( random.GetAsF32( a, b ), random.GetAsF32( a, b ), random.GetAsF32( a, b ) ); };
+
+    size_t mismatch[4] = {};
+    size_t truncated   = 0;
+    size_t stored      = 0;
+    const char* labels[4] = { "QuerySphere()", "QueryBox()", "QueryFrustum()", "QueryNearest()" };
+
+    for( auto n=0; n<TEST_HASH_TRIALS; ++n )
+    {
+        // 4回に1回は狭い範囲に集めて, 1つのセルに多くの物体が入るようにします.
+        // ハッシュ表は小さなものも使い, 異なるセルが同じバケットに入る場合を含めます.
+        auto cellSize = random.GetAsF32( 0.5f, 4.0f );
+        auto range    = ( n % 4 == 0 ) ? 2.0f : 40.0f;
+        SpatialHash hash;
+        Check( context, hash.Init( cellSize, 1u << ( n % 13 ) ), "Init( %f ) failed", cellSize );
+
+        auto randomSphere = [&]()
+        {
+            auto radius = ( random.GetAsU32() % 16 == 0 )
+                ? random.GetAsF32( cellSize, cellSize * 8.0f )
+                : random.GetAsF32( 0.0f, cellSize * 0.5f );
+            return BoundingSphere( randomVector( -range, range ), radius );
+        };
+
+        std::vector<BoundingSphere> spheres;
+        std::vector<bool>           alive;
+        std::vector<uint32_t>       live;
+        for( auto step=0; step<TEST_HASH_STEPS; ++step )
+        {
+            for( auto i=0; i<TEST_HASH_OPERATIONS; ++i )
+            {
+                auto op = random.GetAsU32() % 10;
+                if ( op < 5 || live.empty() )
+                {
+                    auto sphere = randomSphere();
+                    auto handle = hash.Insert( sphere );
+                    if ( handle >= spheres.size() )
+                    {
+                        spheres.resize( handle + 1 );
+                        alive  .resize( handle + 1, false );
+                    }
+                    Check( context, !alive[handle], "Insert() returned the live handle %u", handle );
+                    spheres[handle] = sphere;
+                    alive  [handle] = true;
+                    live.push_back( handle );
+                }
+                else if ( op < 8 )
+                {
+                    // 半分はセルをまたがない程度の小さな移動です.
+                    auto handle = live[random.GetAsU32() % live.size()];
+                    auto sphere = randomSphere();
+                    if ( random.GetAsU32() % 2 == 0 )
+                    { sphere.center = spheres[handle].center + randomVector( -0.1f, 0.1f ) * cellSize; }
+                    hash.Move( handle, sphere );
+                    spheres[handle] = sphere;
+                }
+                else
+                {
+                    auto pos    = random.GetAsU32() % live.size();
+                    auto handle = live[pos];
+                    hash.Remove( handle );
+                    alive[handle] = false;
+                    live[pos] = live.back();
+                    live.pop_back();
+                }
+            }
+
+            Check( context, hash.GetCount() == live.size(), "GetCount() returned %zu (expected %zu)", hash.GetCount(), live.size() );
+            for( auto handle : live )
+            {
+                auto sphere = hash.GetSphere( handle );
+                if ( !IsSameBits( &sphere.center.x, &spheres[handle].center.x, 3 ) || !IsSameBits( &sphere.radius, &spheres[handle].radius, 1 ) )
+                { stored++; }
+            }
+
+            std::vector<uint32_t> handles( spheres.size() + 1 );
+            for( auto q=0; q<TEST_HASH_QUERIES; ++q )
+            {
+                auto center  = randomVector( -range * 1.2f, range * 1.2f );
+                auto radius  = random.GetAsF32( 0.0f, range * 0.25f );
+                auto extent  = randomVector( 0.0f, range * 0.25f );
+                auto sphere  = BoundingSphere( center, radius );
+                auto box     = BoundingBox( center - extent, center + extent );
+                auto eye     = randomVector( -range * 1.5f, range * 1.5f );
+                auto view    = Matrix::CreateLookAt( eye, center, Vector3( 0.0f, 1.0f, 0.0f ) );
+                auto proj    = Matrix::CreatePerspectiveFieldOfView( ToRadian( random.GetAsF32( 20.0f, 90.0f ) ), random.GetAsF32( 0.5f, 2.5f ), 0.1f, random.GetAsF32( 1.0f, range * 3.0f ) );
+                auto frustum = Frustum( Matrix::Multiply( view, proj ) );
+
+                for( auto kind=0; kind<3; ++kind )
+                {
+                    std::vector<uint32_t> expected;
+                    for( auto handle : live )
+                    {
+                        const auto& s = spheres[handle];
+                        bool hit = false;
+                        if ( kind == 0 )
+                        {
+                            auto dx = s.center.x - center.x;
+                            auto dy = s.center.y - center.y;
+                            auto dz = s.center.z - center.z;
+                            auto rr = s.radius + radius;
+                            hit = ( dx * dx + dy * dy + dz * dz <= rr * rr );
+                        }
+                        else if ( kind == 1 )
+                        {
+                            auto dx = Max( Max( box.mini.x - s.center.x, s.center.x - box.maxi.x ), 0.0f );
+                            auto dy = Max( Max( box.mini.y - s.center.y, s.center.y - box.maxi.y ), 0.0f );
+                            auto dz = Max( Max( box.mini.z - s.center.z, s.center.z - box.maxi.z ), 0.0f );
+                            hit = ( dx * dx + dy * dy + dz * dz <= s.radius * s.radius );
+                        }
+                        else
+                        { hit = frustum.Contains( s ); }
+
+                        if ( hit )
+                        { expected.push_back( handle ); }
+                    }
+                    std::sort( expected.begin(), expected.end() );
+
+                    auto query = [&]( uint32_t maxCount ) -> uint32_t
+                    {
+                        switch( kind )
+                        {
+                        case 0:  return hash.QuerySphere ( sphere,  handles.data(), maxCount );
+                        case 1:  return hash.QueryBox    ( box,     handles.data(), maxCount );
+                        default: return hash.QueryFrustum( frustum, handles.data(), maxCount );
+                        }
+                    };
+
+                    auto count = query( uint32_t( handles.size() ) );
+                    std::vector<uint32_t> actual( handles.begin(), handles.begin() + count );
+                    std::sort( actual.begin(), actual.end() );
+                    if ( actual != expected )
+                    { mismatch[kind]++; }
+
+                    // 打ち切った場合は, 重なる物体を重複なく maxCount 個返します.
+                    if ( expected.size() >= 2 )
+                    {
+                        auto maxCount = uint32_t( expected.size() / 2 );
+                        count = query( maxCount );
+                        std::vector<uint32_t> partial( handles.begin(), handles.begin() + count );
+                        std::sort( partial.begin(), partial.end() );
+                        if ( count != maxCount
+                          || std::adjacent_find( partial.begin(), partial.end() ) != partial.end()
+                          || !std::includes( expected.begin(), expected.end(), partial.begin(), partial.end() ) )
+                        { truncated++; }
+                    }
+                }
+
+                auto maxDistance = ( q % 4 == 0 ) ? FLT_MAX : random.GetAsF32( 0.0f, range );
+                auto maxCount    = 1 + random.GetAsU32() % 32;
+                if ( !CheckNearest( hash, spheres, alive, center, maxDistance, maxCount ) )
+                { mismatch[3]++; }
+            }
+        }
+    }
+
+    for( auto kind=0; kind<4; ++kind )
+    { Check( context, mismatch[kind] == 0, "%s differs from brute force in %zu queries", labels[kind], mismatch[kind] ); }
+    Check( context, truncated == 0, "queries limited by maxCount returned a wrong set %zu times", truncated );
+    Check( context, stored == 0, "GetSphere() differs from the inserted sphere for %zu handles", stored );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Broadphase::FindPairs() の結果を総当たりと比べます.
+//      組の集合が一致し, 全ての組が a < b で重複がないことを確かめます.
+//-------------------------------------------------------------------------------------------------
+bool IsSamePairs( const std::vector<OverlapPair>& actual, size_t count, const std::vector<OverlapPair>& expected )
+{
+    if ( count != actual.size() || actual.size() != expected.size() )
+    { return false; }
+
+    auto sorted = actual;
+    std::sort( sorted.begin(), sorted.end(), []( const OverlapPair& lhs, const OverlapPair& rhs )
+    { return ( lhs.a != rhs.a ) ? ( lhs.a < rhs.a ) : ( lhs.b < rhs.b ); } );
+    for( size_t i=0; i<sorted.size(); ++i )
+    {
+        if ( sorted[i].a >= sorted[i].b || sorted[i].a != expected[i].a || sorted[i].b != expected[i].b )
+        { return false; }
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      組の並びが完全に一致するか判定します.
+//-------------------------------------------------------------------------------------------------
+bool IsSameOrder( const std::vector<OverlapPair>& a, const std::vector<OverlapPair>& b )
+{
+    if ( a.size() != b.size() )
+    { return false; }
+
+    for( size_t i=0; i<a.size(); ++i )
+    {
+        if ( a[i].a != b[i].a || a[i].b != b[i].b )
+        { return false; }
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Broadphase の重なる組を総当たりと比べて試験します.
+//      NaN を含む物体, 半径が負の球, 最小値が最大値を超える箱を混ぜ, どの物体とも重ならないことを確かめます.
+//      少しずつ動かして並び順を引き継いだ結果の並びが, 新しく求めた結果やスレッド数を変えた結果と一致することも確かめます.
+//-------------------------------------------------------------------------------------------------
+void TestBroadphaseFindPairs( TestContext& context )
+{
+    Random random( TEST_SEED );
+    auto randomVector = [&]( float a, float b )
+    { return Vector3( random.GetAsF32( a, b ), random.GetAsF32( a, b ), random.GetAsF32( a, b ) ); };
+    auto nan = std::numeric_limits<float>::quiet_NaN();
+
+    size_t mismatch[2] = {};
+    size_t coherent[2] = {};
+    size_t threaded[2] = {};
+    const char* labels[2] = { "spheres", "boxes" };
+
+#if ASVK_IS_OPENMP
+    auto threads = omp_get_max_threads();
+#endif
+
+    for( auto n=0; n<TEST_BROADPHASE_SCENES; ++n )
+    {
+        // 4回に1回は並列化する閾値を超える数にします.
+        auto count = ( n < 3 ) ? size_t( n )
+                   : ( n % 4 == 0 ) ? TEST_BROADPHASE_COUNT
+                   : size_t( 1 + random.GetAsU32() % 1000 );
+        auto range = cbrtf( float( count ) );
+
+        std::vector<BoundingSphere> spheres( count );
+        std::vector<BoundingBox>    boxes  ( count );
+        std::vector<bool>           valid  ( count, true );
+        for( size_t i=0; i<count; ++i )
+        {
+            auto center = randomVector( -range, range );
+            auto extent = randomVector( 0.0f, 1.0f );
+            spheres[i] = BoundingSphere( center, extent.x );
+            boxes  [i] = BoundingBox( center - extent, center + extent );
+            switch( random.GetAsU32() % 64 )
+            {
+            case 0:
+                spheres[i].center.y = nan;
+                boxes  [i].maxi.z   = nan;
+                valid  [i] = false;
+                break;
+
+            case 1:
+                spheres[i].radius = -0.5f;
+                boxes  [i].mini.x = boxes[i].maxi.x + 0.5f;
+                valid  [i] = false;
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        Broadphase broadphase[2];
+        for( auto step=0; step<TEST_BROADPHASE_STEPS; ++step )
+        {
+            // 2回目以降は少しずつ動かし, 前回の並び順を引き継ぎます. 最後は並び順を捨てます.
+            if ( step > 0 )
+            {
+                for( size_t i=0; i<count; ++i )
+                {
+                    auto offset = randomVector( -0.1f, 0.1f );
+                    spheres[i].center += offset;
+                    boxes  [i].mini   += offset;
+                    boxes  [i].maxi   += offset;
+                }
+            }
+            if ( step == TEST_BROADPHASE_STEPS - 1 )
+            {
+                broadphase[0].Reset();
+                broadphase[1].Reset();
+            }
+
+            for( auto shape=0; shape<2; ++shape )
+            {
+                auto find = [&]( Broadphase& target, std::vector<OverlapPair>& pairs )
+                {
+                    return ( shape == 0 )
+                        ? target.FindPairs( spheres.data(), count, pairs )
+                        : target.FindPairs( boxes.data(), count, pairs );
+                };
+
+                std::vector<OverlapPair> expected;
+                for( size_t a=0; a<count; ++a )
+                {
+                    for( size_t b=a + 1; b<count; ++b )
+                    {
+                        if ( !valid[a] || !valid[b] )
+                        { continue; }
+
+                        auto hit = ( shape == 0 ) ? spheres[a].Contains( spheres[b] ) : boxes[a].Contains( boxes[b] );
+                        if ( hit )
+                        { expected.push_back( OverlapPair{ uint32_t( a ), uint32_t( b ) } ); }
+                    }
+                }
+
+            #if ASVK_IS_OPENMP
+                omp_set_num_threads( 1 );
+            #endif
+                std::vector<OverlapPair> pairs;
+                auto result = find( broadphase[shape], pairs );
+                if ( !IsSamePairs( pairs, result, expected ) )
+                { mismatch[shape]++; }
+
+                // 前回の呼び出しのない新しいインスタンスと, スレッド数を変えた場合に並びが一致すること.
+                Broadphase fresh;
+                std::vector<OverlapPair> freshPairs;
+                find( fresh, freshPairs );
+                if ( !IsSameOrder( pairs, freshPairs ) )
+                { coherent[shape]++; }
+
+            #if ASVK_IS_OPENMP
+                omp_set_num_threads( TEST_STREAM_THREADS );
+            #endif
+                Broadphase parallel;
+                std::vector<OverlapPair> parallelPairs;
+                find( parallel, parallelPairs );
+                if ( !IsSameOrder( pairs, parallelPairs ) )
+                { threaded[shape]++; }
+            }
+        }
+    }
+
+#if ASVK_IS_OPENMP
+    omp_set_num_threads( threads );
+#endif
+
+    for( auto shape=0; shape<2; ++shape )
+    {
+        Check( context, mismatch[shape] == 0, "FindPairs( %s ) differs from brute force in %zu calls", labels[shape], mismatch[shape] );
+        Check( context, coherent[shape] == 0, "FindPairs( %s ) order depends on the previous call in %zu calls", labels[shape], coherent[shape] );
+        Check( context, threaded[shape] == 0, "FindPairs( %s ) order depends on the thread count in %zu calls", labels[shape], threaded[shape] );
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+//      試験項目を登録します.
+//-------------------------------------------------------------------------------------------------
+void RegisterEntries( const TestOption& option, std::vector<TestEntry>& entries )
+{
+    auto stride = option.Stride;
+
+    auto add = [&]( const char* name, std::function<void(TestContext&)> run )
+    {
+        TestEntry entry;
+        entry.Name = name;
+        entry.Run  = std::move( run );
+        entries.push_back( std::move( entry ) );
+    };
+
+    add( "Matrix::Multiply",            TestMatrixMultiply );
+    add( "Matrix3x4::Multiply",         TestMatrix3x4Multiply );
+    add( "Matrix::Transpose",           TestMatrixTranspose );
+    add( "Matrix::MultiplyTranspose",   TestMatrixMultiplyTranspose );
+    add( "Vector4::Transform",          TestVector4Transform );
+    add( "Matrix::Invert",              TestMatrixInvert );
+    add( "Quaternion::Multiply",        TestQuaternionMultiply );
+    add( "DualQuaternion::Transform",   TestDualQuaternionTransform );
+    add( "DualQuaternion::Skin",        TestDualQuaternionSkin );
+    add( "OrthonormalBasis::InitFromW",     TestOrthonormalBasisInit );
+    add( "OrthonormalBasis::InitFromUV",    TestOrthonormalBasisInitPair );
+    add( "OrthonormalBasis::CreateFromW",   TestOrthonormalBasisCreateFromW );
+    add( "AnimationClip::Sample",       TestAnimationClipSample );
+    add( "TransformHierarchy::Update",  TestTransformHierarchyUpdate );
+    add( "Spline::GetParam",            TestSplineUniformSpeed );
+    add( "Spline::Evaluate",            TestSplineEvaluate );
+    add( "RandomStream::Jump",          TestRandomStreamJump );
+    add( "RandomStream::Fill",          TestRandomStreamFill );
+    add( "ViewFrustum::Contains",       TestViewFrustumContains );
+    add( "ViewFrustum::Cull",           TestViewFrustumCull );
+    add( "Bvh::Build",                  TestBvhBuild );
+    add( "Bvh::BuildLinear",            TestBvhBuildLinear );
+    add( "Bvh::RayPacket",              TestBvhPacket );
+    add( "SpatialHash::Query",          TestSpatialHashQuery );
+    add( "Broadphase::FindPairs",       TestBroadphaseFindPairs );
+    add( "Octahedral16",                TestOctahedral16 );
+    add( "Octahedral8",                 TestOctahedral8 );
+    add( "QTangent",                    TestQTangent );
+    add( "SinCosFast",                  [stride]( TestContext& context ) { TestSinCosFast   ( context, stride ); } );
+    add( "RsqrtFast",                   [stride]( TestContext& context ) { TestRsqrtFast    ( context, stride ); } );
+    add( "Atan2Fast",                   [stride]( TestContext& context ) { TestAtan2Fast    ( context, stride ); } );
+    add( "YawPitchRollFast",            [stride]( TestContext& context ) { TestYawPitchRollFast( context, stride ); } );
+    add( "NormalizeFast",               [stride]( TestContext& context ) { TestNormalizeFast( context, stride ); } );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      使い方を表示します.
+//-------------------------------------------------------------------------------------------------
+void PrintUsage( const char* program )
+{
+    fprintf( stderr,
+        "usage: %s [options]\n"
+        "  --filter <text>     run only entries whose name contains <text>\n"
+        "  --stride <n>        test every n-th float in the full float sweeps (default 1 = all)\n"
+        "  --list              list entry names and exit\n",
+        program );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      コマンドライン引数を解析します.
+//-------------------------------------------------------------------------------------------------
+bool ParseArgs( int argc, char** argv, TestOption& option )
+{
+    for( auto i=1; i<argc; ++i )
+    {
+        auto arg     = argv[i];
+        auto hasNext = ( i + 1 < argc );
+
+        if ( strcmp( arg, "--filter" ) == 0 && hasNext )
+        { option.Filter = argv[++i]; }
+        else if ( strcmp( arg, "--stride" ) == 0 && hasNext )
+        { option.Stride = static_cast<uint32_t>( strtoul( argv[++i], nullptr, 10 ) ); }
+        else if ( strcmp( arg, "--list" ) == 0 )
+        { option.List = true; }
+        else
+        { return false; }
+    }
+
+    return option.Stride > 0;
+}
+
+} // namespace /* anonymous */
+
+
+//-------------------------------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//-------------------------------------------------------------------------------------------------
+int main( int argc, char** argv )
+{
+    TestOption option;
+    if ( !ParseArgs( argc, argv, option ) )
+    {
+        PrintUsage( argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    std::vector<TestEntry> entries;
+    RegisterEntries( option, entries );
+
+    size_t failed = 0;
+    for( const auto& entry : entries )
+    {
+        if ( option.Filter != nullptr && entry.Name.find( option.Filter ) == std::string::npos )
+        { continue; }
+
+        if ( option.List )
+        {
+            fprintf( stdout, "%s\n", entry.Name.c_str() );
+            continue;
+        }
+
+        TestContext context;
+        entry.Run( context );
+        fprintf( stdout, "%-40s %s (%zu / %zu checks failed)\n",
+            entry.Name.c_str(), ( context.Failures == 0 ) ? "PASS" : "FAIL", context.Failures, context.Checks );
+        fflush( stdout );
+
+        if ( context.Failures != 0 )
+        { failed++; }
+    }
+
+    return ( failed == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}